@@ -2,8 +2,10 @@
 # be lost! Modify scripts/gen_android_mk.py instead.
 
 LOCAL_SRC_FILES := \
+	execserver/xsCompression.cpp \
 	execserver/xsDefs.cpp \
 	execserver/xsExecutionServer.cpp \
+	execserver/xsIoEvent.cpp \
 	execserver/xsPosixFileReader.cpp \
 	execserver/xsPosixTestProcess.cpp \
 	execserver/xsProtocol.cpp \
@@ -13,10 +15,13 @@ LOCAL_SRC_FILES := \
 	executor/xeBatchExecutor.cpp \
 	executor/xeBatchResult.cpp \
 	executor/xeCallQueue.cpp \
+	executor/xeCaseHistory.cpp \
 	executor/xeCommLink.cpp \
 	executor/xeContainerFormatParser.cpp \
 	executor/xeDefs.cpp \
 	executor/xeLocalTcpIpLink.cpp \
+	executor/xeResultStore.cpp \
+	executor/xeShardedBatchExecutor.cpp \
 	executor/xeTcpIpLink.cpp \
 	executor/xeTestCase.cpp \
 	executor/xeTestCaseListParser.cpp \
@@ -38,6 +43,7 @@ LOCAL_SRC_FILES := \
 	external/vulkancts/framework/vulkan/vkMemUtil.cpp \
 	external/vulkancts/framework/vulkan/vkNullDriver.cpp \
 	external/vulkancts/framework/vulkan/vkPlatform.cpp \
+	external/vulkancts/framework/vulkan/vkProgramBinaryCache.cpp \
 	external/vulkancts/framework/vulkan/vkPrograms.cpp \
 	external/vulkancts/framework/vulkan/vkQueryUtil.cpp \
 	external/vulkancts/framework/vulkan/vkRef.cpp \
@@ -265,6 +271,7 @@ LOCAL_SRC_FILES := \
 	framework/common/tcuInterval.cpp \
 	framework/common/tcuMatrix.cpp \
 	framework/common/tcuMaybe.cpp \
+	framework/common/tcuParallelRows.cpp \
 	framework/common/tcuPlatform.cpp \
 	framework/common/tcuRGBA.cpp \
 	framework/common/tcuRandomValueIterator.cpp \
@@ -278,6 +285,7 @@ LOCAL_SRC_FILES := \
 	framework/common/tcuSurfaceAccess.cpp \
 	framework/common/tcuTestCase.cpp \
 	framework/common/tcuTestContext.cpp \
+	framework/common/tcuTestHierarchyIndex.cpp \
 	framework/common/tcuTestHierarchyIterator.cpp \
 	framework/common/tcuTestHierarchyUtil.cpp \
 	framework/common/tcuTestLog.cpp \
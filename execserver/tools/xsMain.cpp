@@ -32,20 +32,25 @@
 #endif
 
 #include <iostream>
+#include <vector>
 
 namespace opt
 {
 
-DE_DECLARE_COMMAND_LINE_OPT(Port,		int);
-DE_DECLARE_COMMAND_LINE_OPT(SingleExec,	bool);
+DE_DECLARE_COMMAND_LINE_OPT(Port,			int);
+DE_DECLARE_COMMAND_LINE_OPT(SingleExec,		bool);
+DE_DECLARE_COMMAND_LINE_OPT(MaxProcesses,	int);
+DE_DECLARE_COMMAND_LINE_OPT(LogPipe,		bool);
 
 void registerOptions (de::cmdline::Parser& parser)
 {
 	using de::cmdline::Option;
 	using de::cmdline::NamedValue;
 
-	parser << Option<Port>		("p", "port",	"Port", "50016")
-		   << Option<SingleExec>("s", "single",	"Kill execserver after first session");
+	parser << Option<Port>			("p", "port",			"Port", "50016")
+		   << Option<SingleExec>	("s", "single",			"Kill execserver after first session")
+		   << Option<MaxProcesses>	("n", "max-processes",	"Number of test processes that can run concurrently, one per connection", "1")
+		   << Option<LogPipe>		(DE_NULL, "log-pipe",	"Read test log through a named pipe instead of a file (not supported on Windows)");
 }
 
 }
@@ -54,11 +59,7 @@ int main (int argc, const char* const* argv)
 {
 	de::cmdline::CommandLine	cmdLine;
 
-#if (DE_OS == DE_OS_WIN32)
-	xs::Win32TestProcess		testProcess;
-#else
-	xs::PosixTestProcess		testProcess;
-
+#if (DE_OS != DE_OS_WIN32)
 	// Set line buffered mode to stdout so executor gets any log messages in a timely manner.
 	setvbuf(stdout, DE_NULL, _IOLBF, 4*1024);
 #endif
@@ -75,22 +76,52 @@ int main (int argc, const char* const* argv)
 		}
 	}
 
+	const int						numProcesses	= cmdLine.getOption<opt::MaxProcesses>();
+	std::vector<xs::TestProcess*>	testProcesses;
+	int								exitCode		= 0;
+
+	if (numProcesses < 1)
+	{
+		std::cerr << "--max-processes must be at least 1\n";
+		return -1;
+	}
+
 	try
 	{
 		const xs::ExecutionServer::RunMode	runMode		= cmdLine.getOption<opt::SingleExec>()
 														? xs::ExecutionServer::RUNMODE_SINGLE_EXEC
 														: xs::ExecutionServer::RUNMODE_FOREVER;
 		const int							port		= cmdLine.getOption<opt::Port>();
-		xs::ExecutionServer					server		(&testProcess, DE_SOCKETFAMILY_INET4, port, runMode);
 
-		std::cout << "Listening on port " << port << ".\n";
-		server.runServer();
+		for (int ndx = 0; ndx < numProcesses; ndx++)
+		{
+#if (DE_OS == DE_OS_WIN32)
+			if (cmdLine.getOption<opt::LogPipe>())
+				throw std::runtime_error("--log-pipe is not supported on Windows");
+
+			testProcesses.push_back(new xs::Win32TestProcess());
+#else
+			testProcesses.push_back(new xs::PosixTestProcess(cmdLine.getOption<opt::LogPipe>()
+															 ? xs::PosixTestProcess::LOGTRANSPORT_PIPE
+															 : xs::PosixTestProcess::LOGTRANSPORT_FILE));
+#endif
+		}
+
+		{
+			xs::ExecutionServer server (testProcesses, DE_SOCKETFAMILY_INET4, port, runMode);
+
+			std::cout << "Listening on port " << port << ", running up to " << numProcesses << " test process(es).\n";
+			server.runServer();
+		}
 	}
 	catch (const std::exception& e)
 	{
 		std::cerr << e.what() << "\n";
-		return -1;
+		exitCode = -1;
 	}
 
-	return 0;
+	for (std::vector<xs::TestProcess*>::iterator i = testProcesses.begin(); i != testProcesses.end(); ++i)
+		delete *i;
+
+	return exitCode;
 }
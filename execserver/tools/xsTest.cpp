@@ -131,14 +131,24 @@ Message* readMessage (de::Socket& socket)
 		case MESSAGETYPE_HELLO:					return new HelloMessage(&messageBuf[0], (int)messageBuf.size());
 		case MESSAGETYPE_TEST:					return new TestMessage(&messageBuf[0], (int)messageBuf.size());
 		case MESSAGETYPE_PROCESS_LOG_DATA:		return new ProcessLogDataMessage(&messageBuf[0], (int)messageBuf.size());
+		case MESSAGETYPE_PROCESS_LOG_DATA_COMPRESSED:	return new ProcessLogDataCompressedMessage(&messageBuf[0], (int)messageBuf.size());
 		case MESSAGETYPE_INFO:					return new InfoMessage(&messageBuf[0], (int)messageBuf.size());
 		case MESSAGETYPE_PROCESS_LAUNCH_FAILED:	return new ProcessLaunchFailedMessage(&messageBuf[0], (int)messageBuf.size());
 		case MESSAGETYPE_PROCESS_FINISHED:		return new ProcessFinishedMessage(&messageBuf[0], (int)messageBuf.size());
+		case MESSAGETYPE_CAPACITY:				return new CapacityMessage(&messageBuf[0], (int)messageBuf.size());
 		default:
 			XS_FAIL("Unknown message");
 	}
 }
 
+const std::string& getLogData (const Message& msg)
+{
+	if (msg.type == MESSAGETYPE_PROCESS_LOG_DATA_COMPRESSED)
+		return static_cast<const ProcessLogDataCompressedMessage&>(msg).logData;
+	else
+		return static_cast<const ProcessLogDataMessage&>(msg).logData;
+}
+
 class TestClock
 {
 public:
@@ -360,6 +370,59 @@ public:
 	{
 		xs::HelloMessage msg;
 		sendMessage(socket, (const xs::Message&)msg);
+
+		// Server confirms negotiated version.
+		for (;;)
+		{
+			ScopedMsgPtr reply(readMessage(socket));
+
+			if (reply->type == MESSAGETYPE_KEEPALIVE)
+				continue;
+
+			XS_CHECK_MSG(reply->type == MESSAGETYPE_HELLO, "Expected HELLO reply");
+			XS_CHECK_MSG(static_cast<const HelloMessage*>(reply.get())->version == PROTOCOL_VERSION, "Wrong protocol version in HELLO reply");
+			break;
+		}
+	}
+
+	void runProgram (void) { /* nothing */ }
+};
+
+class CapacityTest : public TestCase
+{
+public:
+	CapacityTest (TestContext& testCtx)
+		: TestCase(testCtx, "capacity")
+	{
+	}
+
+	void runClient (de::Socket& socket)
+	{
+		sendMessage(socket, xs::QueryCapacityMessage());
+
+		for (;;)
+		{
+			ScopedMsgPtr msg(readMessage(socket));
+
+			if (msg->type == MESSAGETYPE_KEEPALIVE)
+				continue;
+			else if (msg->type == MESSAGETYPE_CAPACITY)
+			{
+				const CapacityMessage* capacity = static_cast<const CapacityMessage*>(msg.get());
+
+				printf("  %d processes, %d available\n", capacity->maxProcesses, capacity->numAvailable);
+
+				if (capacity->maxProcesses < 1)
+					XS_FAIL("Invalid number of processes");
+
+				if (capacity->numAvailable < 0 || capacity->numAvailable > capacity->maxProcesses)
+					XS_FAIL("Invalid number of available processes");
+
+				break;
+			}
+			else
+				XS_FAIL("Invalid message");
+		}
 	}
 
 	void runProgram (void) { /* nothing */ }
@@ -529,24 +592,30 @@ public:
 class LogDataTest : public TestCase
 {
 public:
-	LogDataTest (TestContext& testCtx)
-		: TestCase(testCtx, "logdata")
+	LogDataTest (TestContext& testCtx, bool compressLog)
+		: TestCase		(testCtx, compressLog ? "logdata-compressed" : "logdata")
+		, m_compressLog	(compressLog)
 	{
 	}
 
 	void runClient (de::Socket& socket)
 	{
+		if (m_compressLog)
+			sendMessage(socket, xs::HelloMessage());
+
 		xs::ExecuteBinaryMessage execMsg;
 		execMsg.name		= m_testCtx.testerPath;
-		execMsg.params		= "--program=logdata";
+		execMsg.params		= "--program=" + m_name;
 		execMsg.caseList	= "";
 		execMsg.workDir		= "";
 
 		sendMessage(socket, execMsg);
 
-		const int		timeout		= 10000; // 10s.
-		TestClock		clock;
+		const int			timeout			= 10000; // 10s.
+		const MessageType	logDataType		= m_compressLog ? MESSAGETYPE_PROCESS_LOG_DATA_COMPRESSED : MESSAGETYPE_PROCESS_LOG_DATA;
+		TestClock			clock;
 
+		bool			gotHello			= false;
 		bool			gotProcessStarted	= false;
 		bool			gotProcessFinished	= false;
 		std::string		receivedData		= "";
@@ -558,12 +627,14 @@ public:
 
 			ScopedMsgPtr msg(readMessage(socket));
 
-			if (msg->type == MESSAGETYPE_PROCESS_STARTED)
+			if (m_compressLog && msg->type == MESSAGETYPE_HELLO && !gotHello)
+				gotHello = true;
+			else if (msg->type == MESSAGETYPE_PROCESS_STARTED)
 				gotProcessStarted = true;
 			else if (msg->type == MESSAGETYPE_PROCESS_LAUNCH_FAILED)
 				XS_FAIL("Got PROCESS_LAUNCH_FAILED");
-			else if (gotProcessStarted && msg->type == MESSAGETYPE_PROCESS_LOG_DATA)
-				receivedData += static_cast<const ProcessLogDataMessage*>(msg.get())->logData;
+			else if (gotProcessStarted && msg->type == logDataType)
+				receivedData += getLogData(*msg);
 			else if (gotProcessStarted && msg->type == MESSAGETYPE_PROCESS_FINISHED)
 			{
 				gotProcessFinished = true;
@@ -577,6 +648,9 @@ public:
 				XS_FAIL("Invalid message");
 		}
 
+		if (m_compressLog && !gotHello)
+			XS_FAIL("Did't get HELLO reply");
+
 		if (!gotProcessStarted)
 			XS_FAIL("Did't get PROCESS_STARTED message");
 
@@ -611,6 +685,9 @@ public:
 
 		deFile_destroy(file);
 	}
+
+private:
+	const bool	m_compressLog;
 };
 
 class BigLogDataTest : public TestCase
@@ -621,24 +698,30 @@ public:
 		DATA_SIZE = 100*1024*1024
 	};
 
-	BigLogDataTest (TestContext& testCtx)
-		: TestCase(testCtx, "biglogdata")
+	BigLogDataTest (TestContext& testCtx, bool compressLog)
+		: TestCase		(testCtx, compressLog ? "biglogdata-compressed" : "biglogdata")
+		, m_compressLog	(compressLog)
 	{
 	}
 
 	void runClient (de::Socket& socket)
 	{
+		if (m_compressLog)
+			sendMessage(socket, xs::HelloMessage());
+
 		xs::ExecuteBinaryMessage execMsg;
 		execMsg.name		= m_testCtx.testerPath;
-		execMsg.params		= "--program=biglogdata";
+		execMsg.params		= "--program=" + m_name;
 		execMsg.caseList	= "";
 		execMsg.workDir		= "";
 
 		sendMessage(socket, execMsg);
 
-		const int		timeout		= 30000; // 30s.
-		TestClock		clock;
+		const int			timeout			= 30000; // 30s.
+		const MessageType	logDataType		= m_compressLog ? MESSAGETYPE_PROCESS_LOG_DATA_COMPRESSED : MESSAGETYPE_PROCESS_LOG_DATA;
+		TestClock			clock;
 
+		bool			gotHello			= false;
 		bool			gotProcessStarted	= false;
 		bool			gotProcessFinished	= false;
 		int				receivedBytes		= 0;
@@ -650,12 +733,14 @@ public:
 
 			ScopedMsgPtr msg(readMessage(socket));
 
-			if (msg->type == MESSAGETYPE_PROCESS_STARTED)
+			if (m_compressLog && msg->type == MESSAGETYPE_HELLO && !gotHello)
+				gotHello = true;
+			else if (msg->type == MESSAGETYPE_PROCESS_STARTED)
 				gotProcessStarted = true;
 			else if (msg->type == MESSAGETYPE_PROCESS_LAUNCH_FAILED)
 				XS_FAIL("Got PROCESS_LAUNCH_FAILED");
-			else if (gotProcessStarted && msg->type == MESSAGETYPE_PROCESS_LOG_DATA)
-				receivedBytes += (int)static_cast<const ProcessLogDataMessage*>(msg.get())->logData.length();
+			else if (gotProcessStarted && msg->type == logDataType)
+				receivedBytes += (int)getLogData(*msg).length();
 			else if (gotProcessStarted && msg->type == MESSAGETYPE_PROCESS_FINISHED)
 			{
 				gotProcessFinished = true;
@@ -673,6 +758,9 @@ public:
 				XS_FAIL("Invalid message");
 		}
 
+		if (m_compressLog && !gotHello)
+			XS_FAIL("Did't get HELLO reply");
+
 		if (!gotProcessStarted)
 			XS_FAIL("Did't get PROCESS_STARTED message");
 
@@ -708,6 +796,9 @@ public:
 
 		deFile_destroy(file);
 	}
+
+private:
+	const bool	m_compressLog;
 };
 
 class KeepAliveTest : public TestCase
@@ -891,12 +982,15 @@ void runExecServerTests (int argc, const char* const* argv)
 	std::vector<TestCase*> testCases;
 	testCases.push_back(new ConnectTest(testCtx));
 	testCases.push_back(new HelloTest(testCtx));
+	testCases.push_back(new CapacityTest(testCtx));
 	testCases.push_back(new ExecFailTest(testCtx));
 	testCases.push_back(new SimpleExecTest(testCtx));
 	testCases.push_back(new InfoTest(testCtx));
-	testCases.push_back(new LogDataTest(testCtx));
+	testCases.push_back(new LogDataTest(testCtx, false));
+	testCases.push_back(new LogDataTest(testCtx, true));
 	testCases.push_back(new KeepAliveTest(testCtx));
-	testCases.push_back(new BigLogDataTest(testCtx));
+	testCases.push_back(new BigLogDataTest(testCtx, false));
+	testCases.push_back(new BigLogDataTest(testCtx, true));
 
 	try
 	{
@@ -0,0 +1,107 @@
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Execution Server
+ * ---------------------------------------------
+ *
+ * Copyright 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Log data compression.
+ *//*--------------------------------------------------------------------*/
+
+#include "xsCompression.hpp"
+#include "deMemory.h"
+
+#include <zlib.h>
+
+namespace xs
+{
+
+// Compressor
+
+Compressor::Compressor (void)
+	: m_stream(new z_stream)
+{
+	deMemset(m_stream, 0, sizeof(z_stream));
+
+	// \note Log XML compresses nearly as well with fastest setting as with default one, and much faster.
+	if (deflateInit(m_stream, Z_BEST_SPEED) != Z_OK)
+	{
+		delete m_stream;
+		XS_FAIL("Failed to initialize zlib compressor");
+	}
+}
+
+Compressor::~Compressor (void)
+{
+	deflateEnd(m_stream);
+	delete m_stream;
+}
+
+size_t Compressor::getMaxCompressedSize (size_t srcSize)
+{
+	return (size_t)deflateBound(m_stream, (uLong)srcSize);
+}
+
+size_t Compressor::compress (const deUint8* src, size_t srcSize, deUint8* dst, size_t dstSize)
+{
+	DE_ASSERT(dstSize >= getMaxCompressedSize(srcSize));
+
+	XS_CHECK(deflateReset(m_stream) == Z_OK);
+
+	m_stream->next_in	= const_cast<Bytef*>(src);
+	m_stream->avail_in	= (uInt)srcSize;
+	m_stream->next_out	= dst;
+	m_stream->avail_out	= (uInt)dstSize;
+
+	XS_CHECK(deflate(m_stream, Z_FINISH) == Z_STREAM_END);
+
+	return dstSize - (size_t)m_stream->avail_out;
+}
+
+// Decompressor
+
+Decompressor::Decompressor (void)
+	: m_stream(new z_stream)
+{
+	deMemset(m_stream, 0, sizeof(z_stream));
+
+	if (inflateInit(m_stream) != Z_OK)
+	{
+		delete m_stream;
+		XS_FAIL("Failed to initialize zlib decompressor");
+	}
+}
+
+Decompressor::~Decompressor (void)
+{
+	inflateEnd(m_stream);
+	delete m_stream;
+}
+
+void Decompressor::decompress (const deUint8* src, size_t srcSize, deUint8* dst, size_t dstSize)
+{
+	XS_CHECK(inflateReset(m_stream) == Z_OK);
+
+	m_stream->next_in	= const_cast<Bytef*>(src);
+	m_stream->avail_in	= (uInt)srcSize;
+	m_stream->next_out	= dst;
+	m_stream->avail_out	= (uInt)dstSize;
+
+	if (inflate(m_stream, Z_FINISH) != Z_STREAM_END || m_stream->avail_in != 0 || m_stream->avail_out != 0)
+		throw ProtocolError("Corrupt compressed log data");
+}
+
+} // xs
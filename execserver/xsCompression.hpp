@@ -0,0 +1,82 @@
+#ifndef _XSCOMPRESSION_HPP
+#define _XSCOMPRESSION_HPP
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Execution Server
+ * ---------------------------------------------
+ *
+ * Copyright 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Log data compression.
+ *//*--------------------------------------------------------------------*/
+
+#include "xsDefs.hpp"
+
+#include <vector>
+
+struct z_stream_s;
+
+namespace xs
+{
+
+/*--------------------------------------------------------------------*//*!
+ * \brief zlib compressor for log data frames
+ *
+ * Each call to compress() produces a complete, independent zlib stream.
+ * Compressor state is reused between calls to avoid re-allocating zlib
+ * internal buffers for every frame.
+ *//*--------------------------------------------------------------------*/
+class Compressor
+{
+public:
+							Compressor				(void);
+							~Compressor				(void);
+
+	//! Upper bound for compressed size of srcSize bytes.
+	size_t					getMaxCompressedSize	(size_t srcSize);
+
+	//! Compress src to dst, returns compressed size. dstSize must be at least getMaxCompressedSize(srcSize).
+	size_t					compress				(const deUint8* src, size_t srcSize, deUint8* dst, size_t dstSize);
+
+private:
+							Compressor				(const Compressor&);
+	Compressor&				operator=				(const Compressor&);
+
+	z_stream_s*				m_stream;
+};
+
+/*--------------------------------------------------------------------*//*!
+ * \brief zlib decompressor for log data frames
+ *//*--------------------------------------------------------------------*/
+class Decompressor
+{
+public:
+							Decompressor			(void);
+							~Decompressor			(void);
+
+	//! Decompress a single zlib stream to dst. Throws ProtocolError if data is corrupt or doesn't decompress to exactly dstSize bytes.
+	void					decompress				(const deUint8* src, size_t srcSize, deUint8* dst, size_t dstSize);
+
+private:
+							Decompressor			(const Decompressor&);
+	Decompressor&			operator=				(const Decompressor&);
+
+	z_stream_s*				m_stream;
+};
+
+} // xs
+
+#endif // _XSCOMPRESSION_HPP
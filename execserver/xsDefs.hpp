@@ -42,6 +42,7 @@ enum
 	SERVER_IDLE_THRESHOLD		= 10,
 	SERVER_IDLE_SLEEP			= 50,
 	FILEREADER_IDLE_SLEEP		= 100,
+	LOG_FRAME_MAX_DELAY			= 20,	//!< Max time to gather log data before sending partial compressed frame.
 
 	LOG_BUFFER_BLOCK_SIZE		= 1024,
 	LOG_BUFFER_NUM_BLOCKS		= 512,
@@ -49,11 +50,13 @@ enum
 	INFO_BUFFER_BLOCK_SIZE		= 64,
 	INFO_BUFFER_NUM_BLOCKS		= 128,
 
-	SEND_BUFFER_SIZE			= 16*1024,
+	SEND_BUFFER_SIZE			= 64*1024,
 	RECV_BUFFER_SIZE			= 4*1024,
 
 	FILEREADER_TMP_BUFFER_SIZE	= 1024,
-	SEND_RECV_TMP_BUFFER_SIZE	= 4*1024,
+	SEND_RECV_TMP_BUFFER_SIZE	= 16*1024,
+
+	LOG_FRAME_SIZE				= 32*1024,	//!< Uncompressed size of full compressed log frame.
 
 	MIN_MSG_PAYLOAD_SIZE		= 32
 };
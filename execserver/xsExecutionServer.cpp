@@ -25,6 +25,7 @@
 #include "deClock.h"
 
 #include <cstdio>
+#include <algorithm>
 
 using std::vector;
 using std::string;
@@ -100,28 +101,74 @@ void MessageBuilder::clear (void)
 
 ExecutionServer::ExecutionServer (xs::TestProcess* testProcess, deSocketFamily family, int port, RunMode runMode)
 	: TcpServer		(family, port)
-	, m_testDriver	(testProcess)
 	, m_runMode		(runMode)
 {
+	createTestDrivers(vector<xs::TestProcess*>(1, testProcess));
+}
+
+ExecutionServer::ExecutionServer (const vector<xs::TestProcess*>& testProcesses, deSocketFamily family, int port, RunMode runMode)
+	: TcpServer		(family, port)
+	, m_runMode		(runMode)
+{
+	createTestDrivers(testProcesses);
 }
 
 ExecutionServer::~ExecutionServer (void)
 {
+	for (vector<TestDriver*>::iterator i = m_testDrivers.begin(); i != m_testDrivers.end(); ++i)
+		delete *i;
+}
+
+void ExecutionServer::createTestDrivers (const vector<xs::TestProcess*>& testProcesses)
+{
+	XS_CHECK(!testProcesses.empty());
+
+	m_testDrivers.reserve(testProcesses.size());
+	m_freeTestDrivers.reserve(testProcesses.size());
+
+	try
+	{
+		for (vector<xs::TestProcess*>::const_iterator i = testProcesses.begin(); i != testProcesses.end(); ++i)
+			m_testDrivers.push_back(new TestDriver(*i));
+	}
+	catch (...)
+	{
+		for (vector<TestDriver*>::iterator i = m_testDrivers.begin(); i != m_testDrivers.end(); ++i)
+			delete *i;
+		throw;
+	}
+
+	// \note Drivers are handed out from the back, first driver is used first.
+	m_freeTestDrivers.assign(m_testDrivers.rbegin(), m_testDrivers.rend());
 }
 
 TestDriver* ExecutionServer::acquireTestDriver (void)
 {
-	if (!m_testDriverLock.tryLock())
+	de::ScopedLock lock (m_testDriverLock);
+
+	if (m_freeTestDrivers.empty())
 		throw Error("Failed to acquire test driver");
 
-	return &m_testDriver;
+	TestDriver* const driver = m_freeTestDrivers.back();
+	m_freeTestDrivers.pop_back();
+
+	return driver;
 }
 
 void ExecutionServer::releaseTestDriver (TestDriver* driver)
 {
-	DE_ASSERT(&m_testDriver == driver);
-	DE_UNREF(driver);
-	m_testDriverLock.unlock();
+	de::ScopedLock lock (m_testDriverLock);
+
+	DE_ASSERT(std::find(m_testDrivers.begin(), m_testDrivers.end(), driver) != m_testDrivers.end());
+	DE_ASSERT(std::find(m_freeTestDrivers.begin(), m_freeTestDrivers.end(), driver) == m_freeTestDrivers.end());
+
+	m_freeTestDrivers.push_back(driver);
+}
+
+int ExecutionServer::getNumFreeTestDrivers (void)
+{
+	de::ScopedLock lock (m_testDriverLock);
+	return (int)m_freeTestDrivers.size();
 }
 
 ConnectionHandler* ExecutionServer::createHandler (de::Socket* socket, const de::SocketAddress& clientAddress)
@@ -139,13 +186,16 @@ void ExecutionServer::connectionDone (ConnectionHandler* handler)
 }
 
 ExecutionRequestHandler::ExecutionRequestHandler (ExecutionServer* server, de::Socket* socket)
-	: ConnectionHandler	(server, socket)
-	, m_execServer		(server)
-	, m_testDriver		(DE_NULL)
-	, m_bufferIn		(RECV_BUFFER_SIZE)
-	, m_bufferOut		(SEND_BUFFER_SIZE)
-	, m_run				(false)
-	, m_sendRecvTmpBuf	(SEND_RECV_TMP_BUFFER_SIZE)
+	: ConnectionHandler			(server, socket)
+	, m_execServer				(server)
+	, m_testDriver				(DE_NULL)
+	, m_bufferIn				(RECV_BUFFER_SIZE)
+	, m_bufferOut				(SEND_BUFFER_SIZE)
+	, m_run						(false)
+	, m_protocolVersion			(PROTOCOL_VERSION_MIN_SUPPORTED)
+	, m_helloReplyPending		(false)
+	, m_capacityQueryPending	(false)
+	, m_sendRecvTmpBuf			(SEND_RECV_TMP_BUFFER_SIZE)
 {
 	// Set flags.
 	m_socket->setFlags(DE_SOCKET_NONBLOCKING|DE_SOCKET_KEEPALIVE|DE_SOCKET_CLOSE_ON_EXEC);
@@ -186,6 +236,7 @@ void ExecutionRequestHandler::handle (void)
 		catch (...)
 		{
 		}
+		m_testDriver->setDataEvent(DE_NULL);
 		m_execServer->releaseTestDriver(m_testDriver);
 		m_testDriver = DE_NULL;
 	}
@@ -203,7 +254,8 @@ void ExecutionRequestHandler::acquireTestDriver (void)
 	m_testDriver = m_execServer->acquireTestDriver();
 	DE_ASSERT(m_testDriver);
 	m_testDriver->reset();
-
+	m_testDriver->setDataEvent(&m_ioEvent);
+	m_testDriver->setLogCompression(m_protocolVersion >= PROTOCOL_VERSION_COMPRESSED_LOG);
 }
 
 void ExecutionRequestHandler::processSession (void)
@@ -235,13 +287,23 @@ void ExecutionRequestHandler::processSession (void)
 			processMessage(m_msgBuilder.getMessageType(), m_msgBuilder.getMessageData(), m_msgBuilder.getMessageDataSize());
 
 			m_msgBuilder.clear();
+
+			// Buffer may contain more messages.
+			anyIO = true;
 		}
 
 		// Keepalives, anyone?
 		pollKeepAlives();
 
-		// Poll test driver for IO.
-		if (m_testDriver)
+		// Answer hello and capacity query once there is room for it.
+		if (m_helloReplyPending)
+			pollHelloReply();
+
+		if (m_capacityQueryPending)
+			pollCapacityQuery();
+
+		// Poll test driver for IO. \note Hello reply must be sent before any log data.
+		if (m_testDriver && !m_helloReplyPending)
 			anyIO = getTestDriver()->poll(m_bufferOut) || anyIO;
 
 		// If no IO happens in a reasonable amount of time, go to sleep.
@@ -249,6 +311,12 @@ void ExecutionRequestHandler::processSession (void)
 			deUint64 curTime = deGetMicroseconds();
 			if (anyIO)
 				lastIoTime = curTime;
+			else if (m_ioEvent.isSupported())
+			{
+				// Sleep until socket is ready, test process has new data or it is time to poll again.
+				const deUint32 waitFlags = IoEvent::WAIT_READ | (m_bufferOut.getNumElements() > 0 ? IoEvent::WAIT_WRITE : 0);
+				m_ioEvent.wait(m_socket->getHandle(), waitFlags, SERVER_IDLE_SLEEP);
+			}
 			else if (curTime-lastIoTime > SERVER_IDLE_THRESHOLD*1000)
 				deSleep(SERVER_IDLE_SLEEP); // Too long since last IO, sleep for a while.
 			else
@@ -265,8 +333,17 @@ void ExecutionRequestHandler::processMessage (MessageType type, const deUint8* d
 		{
 			HelloMessage msg(data, dataSize);
 			DBG_PRINT(("HelloMessage: version = %d\n", msg.version));
-			if (msg.version != PROTOCOL_VERSION)
+			if (msg.version < PROTOCOL_VERSION_MIN_SUPPORTED || msg.version > PROTOCOL_VERSION)
 				throw ProtocolError("Unsupported protocol version");
+
+			m_protocolVersion = msg.version;
+
+			if (m_testDriver)
+				m_testDriver->setLogCompression(m_protocolVersion >= PROTOCOL_VERSION_COMPRESSED_LOG);
+
+			// \note Older clients don't expect a reply.
+			if (m_protocolVersion >= PROTOCOL_VERSION_COMPRESSED_LOG)
+				m_helloReplyPending = true;
 			break;
 		}
 
@@ -294,6 +371,14 @@ void ExecutionRequestHandler::processMessage (MessageType type, const deUint8* d
 			break;
 		}
 
+		case MESSAGETYPE_QUERY_CAPACITY:
+		{
+			QueryCapacityMessage msg(data, dataSize);
+			DBG_PRINT(("QueryCapacityMessage\n"));
+			m_capacityQueryPending = true;
+			break;
+		}
+
 		case MESSAGETYPE_STOP_EXECUTION:
 		{
 			StopExecutionMessage msg(data, dataSize);
@@ -339,6 +424,33 @@ void ExecutionRequestHandler::pollKeepAlives (void)
 	}
 }
 
+void ExecutionRequestHandler::pollHelloReply (void)
+{
+	HelloMessage	reply;
+	vector<deUint8>	buf;
+
+	reply.version = m_protocolVersion;
+	reply.write(buf);
+
+	if (m_bufferOut.getNumFree() >= (int)buf.size())
+	{
+		m_bufferOut.pushFront(&buf[0], (int)buf.size());
+		m_helloReplyPending = false;
+	}
+}
+
+void ExecutionRequestHandler::pollCapacityQuery (void)
+{
+	vector<deUint8> buf;
+	CapacityMessage(m_execServer->getNumTestDrivers(), m_execServer->getNumFreeTestDrivers()).write(buf);
+
+	if (m_bufferOut.getNumFree() >= (int)buf.size())
+	{
+		m_bufferOut.pushFront(&buf[0], (int)buf.size());
+		m_capacityQueryPending = false;
+	}
+}
+
 bool ExecutionRequestHandler::receive (void)
 {
 	size_t maxLen = de::min(m_sendRecvTmpBuf.size(), (size_t)m_bufferIn.getNumFree());
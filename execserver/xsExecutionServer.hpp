@@ -28,6 +28,7 @@
 #include "xsTestDriver.hpp"
 #include "xsProtocol.hpp"
 #include "xsTestProcess.hpp"
+#include "xsIoEvent.hpp"
 
 #include <vector>
 
@@ -46,6 +47,7 @@ public:
 	};
 
 							ExecutionServer			(xs::TestProcess* testProcess, deSocketFamily family, int port, RunMode runMode);
+							ExecutionServer			(const std::vector<xs::TestProcess*>& testProcesses, deSocketFamily family, int port, RunMode runMode);
 							~ExecutionServer		(void);
 
 	ConnectionHandler*		createHandler			(de::Socket* socket, const de::SocketAddress& clientAddress);
@@ -53,12 +55,21 @@ public:
 	TestDriver*				acquireTestDriver		(void);
 	void					releaseTestDriver		(TestDriver* driver);
 
+	int						getNumTestDrivers		(void) const { return (int)m_testDrivers.size(); }
+	int						getNumFreeTestDrivers	(void);
+
 	void					connectionDone			(ConnectionHandler* handler);
 
 private:
-	TestDriver				m_testDriver;
-	de::Mutex				m_testDriverLock;
-	RunMode					m_runMode;
+							ExecutionServer			(const ExecutionServer& other);
+	ExecutionServer&		operator=				(const ExecutionServer& other);
+
+	void					createTestDrivers		(const std::vector<xs::TestProcess*>& testProcesses);
+
+	std::vector<TestDriver*>	m_testDrivers;
+	std::vector<TestDriver*>	m_freeTestDrivers;		//!< Drivers not acquired by any connection, protected by m_testDriverLock.
+	de::Mutex					m_testDriverLock;
+	RunMode						m_runMode;
 };
 
 class MessageBuilder
@@ -105,6 +116,9 @@ private:
 	void						keepAliveReceived				(void);
 	void						pollKeepAlives					(void);
 
+	void						pollHelloReply					(void);
+	void						pollCapacityQuery				(void);
+
 	bool						receive							(void);
 	bool						send							(void);
 
@@ -116,6 +130,10 @@ private:
 
 	bool						m_run;
 	MessageBuilder				m_msgBuilder;
+	IoEvent						m_ioEvent;		//!< Wakes up idle session on test process data.
+	int							m_protocolVersion;
+	bool						m_helloReplyPending;
+	bool						m_capacityQueryPending;
 
 	// \todo [2011-09-30 pyry] Move to some watchdog class instead.
 	deUint64					m_lastKeepAliveSent;
@@ -0,0 +1,157 @@
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Execution Server
+ * ---------------------------------------------
+ *
+ * Copyright 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief I/O wakeup event.
+ *//*--------------------------------------------------------------------*/
+
+#include "xsIoEvent.hpp"
+#include "deThread.h"
+
+#if (DE_OS == DE_OS_UNIX) || (DE_OS == DE_OS_OSX) || (DE_OS == DE_OS_IOS) || (DE_OS == DE_OS_ANDROID) || (DE_OS == DE_OS_QNX)
+#	define XS_USE_POLL 1
+#	include <unistd.h>
+#	include <fcntl.h>
+#	include <poll.h>
+#endif
+
+namespace xs
+{
+
+#if defined(XS_USE_POLL)
+
+static bool setPipeFlags (int fd)
+{
+	const int statusFlags	= fcntl(fd, F_GETFL, 0);
+	const int fdFlags		= fcntl(fd, F_GETFD, 0);
+
+	return statusFlags >= 0 && fcntl(fd, F_SETFL, statusFlags | O_NONBLOCK) == 0 &&
+		   fdFlags >= 0 && fcntl(fd, F_SETFD, fdFlags | FD_CLOEXEC) == 0;
+}
+
+IoEvent::IoEvent (void)
+	: m_readFd	(-1)
+	, m_writeFd	(-1)
+{
+	int fds[2];
+
+	if (pipe(fds) != 0)
+		return; // Not supported, wait() falls back to sleeping.
+
+	if (!setPipeFlags(fds[0]) || !setPipeFlags(fds[1]))
+	{
+		close(fds[0]);
+		close(fds[1]);
+		return;
+	}
+
+	m_readFd	= fds[0];
+	m_writeFd	= fds[1];
+}
+
+IoEvent::~IoEvent (void)
+{
+	if (m_readFd >= 0)
+	{
+		close(m_readFd);
+		close(m_writeFd);
+	}
+}
+
+void IoEvent::signal (void)
+{
+	if (m_writeFd >= 0)
+	{
+		// \note Write fails with EAGAIN only if pipe is full, in which case event is already signaled.
+		const deUint8	data	= 0;
+		const ssize_t	result	= write(m_writeFd, &data, sizeof(data));
+		DE_UNREF(result);
+	}
+}
+
+void IoEvent::wait (int timeoutMs)
+{
+	wait(0, 0, timeoutMs);
+}
+
+void IoEvent::wait (deUintptr handle, deUint32 waitFlags, int timeoutMs)
+{
+	if (m_readFd < 0)
+	{
+		deSleep((deUint32)timeoutMs);
+		return;
+	}
+
+	struct pollfd	fds[2];
+	nfds_t			numFds	= 1;
+
+	fds[0].fd		= m_readFd;
+	fds[0].events	= POLLIN;
+	fds[0].revents	= 0;
+
+	if (waitFlags != 0)
+	{
+		fds[1].fd		= (int)handle;
+		fds[1].events	= (short)(((waitFlags & WAIT_READ) ? POLLIN : 0) | ((waitFlags & WAIT_WRITE) ? POLLOUT : 0));
+		fds[1].revents	= 0;
+		numFds			= 2;
+	}
+
+	// \note Errors (such as EINTR) are treated as spurious wakeups, callers re-check their state anyway.
+	poll(&fds[0], numFds, timeoutMs);
+
+	if (fds[0].revents & POLLIN)
+	{
+		// Clear signaled state.
+		deUint8 tmpBuf[64];
+		while (read(m_readFd, &tmpBuf[0], sizeof(tmpBuf)) > 0);
+	}
+}
+
+#else
+
+IoEvent::IoEvent (void)
+	: m_readFd	(-1)
+	, m_writeFd	(-1)
+{
+}
+
+IoEvent::~IoEvent (void)
+{
+}
+
+void IoEvent::signal (void)
+{
+}
+
+void IoEvent::wait (int timeoutMs)
+{
+	deSleep((deUint32)timeoutMs);
+}
+
+void IoEvent::wait (deUintptr handle, deUint32 waitFlags, int timeoutMs)
+{
+	DE_UNREF(handle);
+	DE_UNREF(waitFlags);
+	deSleep((deUint32)timeoutMs);
+}
+
+#endif
+
+} // xs
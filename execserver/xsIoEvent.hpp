@@ -0,0 +1,72 @@
+#ifndef _XSIOEVENT_HPP
+#define _XSIOEVENT_HPP
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Execution Server
+ * ---------------------------------------------
+ *
+ * Copyright 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief I/O wakeup event.
+ *//*--------------------------------------------------------------------*/
+
+#include "xsDefs.hpp"
+
+namespace xs
+{
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Event for waking up idle I/O loops
+ *
+ * Event can be signaled from any thread. wait() blocks until the event has
+ * been signaled, the given native file or socket handle becomes ready or
+ * the timeout expires, whichever happens first, and clears the signaled
+ * state.
+ *
+ * On platforms where the event is not supported, wait() simply sleeps for
+ * the given timeout and callers should fall back to polling.
+ *//*--------------------------------------------------------------------*/
+class IoEvent
+{
+public:
+	enum WaitFlag
+	{
+		WAIT_READ	= (1<<0),	//!< Wake when handle has data to read or has been closed.
+		WAIT_WRITE	= (1<<1)	//!< Wake when handle can be written to.
+	};
+
+							IoEvent			(void);
+							~IoEvent		(void);
+
+	bool					isSupported		(void) const { return m_readFd >= 0; }
+
+	void					signal			(void);
+
+	void					wait			(int timeoutMs);
+	void					wait			(deUintptr handle, deUint32 waitFlags, int timeoutMs);
+
+private:
+							IoEvent			(const IoEvent& other);
+	IoEvent&				operator=		(const IoEvent& other);
+
+	// \note Pipe used for waking up poll(), -1 if not supported.
+	int						m_readFd;
+	int						m_writeFd;
+};
+
+} // xs
+
+#endif // _XSIOEVENT_HPP
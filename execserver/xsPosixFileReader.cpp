@@ -25,6 +25,15 @@
 
 #include <vector>
 
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#	include <sys/inotify.h>
+#endif
+
 namespace xs
 {
 namespace posix
@@ -32,8 +41,11 @@ namespace posix
 
 FileReader::FileReader (int blockSize, int numBlocks)
 	: m_file		(DE_NULL)
+	, m_notifyFd	(-1)
+	, m_fifoWriteFd	(-1)
 	, m_buf			(blockSize, numBlocks)
 	, m_isRunning	(false)
+	, m_dataEvent	(DE_NULL)
 {
 }
 
@@ -41,10 +53,49 @@ FileReader::~FileReader (void)
 {
 }
 
-void FileReader::start (const char* filename)
+static bool isFifo (const char* filename)
+{
+	struct stat st;
+	return stat(filename, &st) == 0 && S_ISFIFO(st.st_mode);
+}
+
+void FileReader::start (const char* filename, IoEvent* dataEvent)
 {
 	DE_ASSERT(!m_isRunning);
 
+	if (isFifo(filename))
+		openFifo(filename);
+	else
+		openFile(filename);
+
+	m_dataEvent	= dataEvent;
+	m_isRunning	= true;
+
+	de::Thread::start();
+}
+
+void FileReader::openFifo (const char* filename)
+{
+	// \note Read end must be opened in non-blocking mode, otherwise open() blocks until a writer appears.
+	const int readFd = open(filename, O_RDONLY|O_NONBLOCK|O_CLOEXEC);
+	XS_CHECK_MSG(readFd >= 0, "Failed to open log pipe");
+
+	m_file = deFile_createFromHandle((deUintptr)readFd);
+	XS_CHECK(m_file);
+
+	// Keep the pipe open for writing as well, so that reading doesn't hit end of file and poll() doesn't
+	// report hang-up once the test process has closed its end. Reader is stopped explicitly instead.
+	m_fifoWriteFd = open(filename, O_WRONLY|O_NONBLOCK|O_CLOEXEC);
+	if (m_fifoWriteFd < 0)
+	{
+		deFile_destroy(m_file);
+		m_file = DE_NULL;
+		XS_FAIL("Failed to open log pipe");
+	}
+}
+
+void FileReader::openFile (const char* filename)
+{
 	m_file = deFile_create(filename, DE_FILEMODE_OPEN|DE_FILEMODE_READ);
 	XS_CHECK(m_file);
 
@@ -58,9 +109,19 @@ void FileReader::start (const char* filename)
 	}
 #endif
 
-	m_isRunning	= true;
+#if defined(__linux__)
+	// Watch for writes so that reader can sleep until there is more data.
+	if (m_stopEvent.isSupported())
+	{
+		m_notifyFd = inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
 
-	de::Thread::start();
+		if (m_notifyFd >= 0 && inotify_add_watch(m_notifyFd, filename, IN_MODIFY|IN_CLOSE_WRITE) < 0)
+		{
+			close(m_notifyFd);
+			m_notifyFd = -1;
+		}
+	}
+#endif
 }
 
 void FileReader::run (void)
@@ -85,24 +146,55 @@ void FileReader::run (void)
 				// Canceled.
 				break;
 			}
+
+			if (m_dataEvent)
+				m_dataEvent->signal();
 		}
 		else if (result == DE_FILERESULT_END_OF_FILE ||
 				 result == DE_FILERESULT_WOULD_BLOCK)
 		{
 			// Wait for more data.
-			deSleep(FILEREADER_IDLE_SLEEP);
+			waitForData();
 		}
 		else
 			break; // Error.
 	}
 }
 
+void FileReader::waitForData (void)
+{
+	if (m_fifoWriteFd >= 0)
+	{
+		m_stopEvent.wait(deFile_getHandle(m_file), IoEvent::WAIT_READ, FILEREADER_IDLE_SLEEP);
+		return;
+	}
+
+#if defined(__linux__)
+	if (m_notifyFd >= 0)
+	{
+		m_stopEvent.wait((deUintptr)m_notifyFd, IoEvent::WAIT_READ, FILEREADER_IDLE_SLEEP);
+
+		// Discard events, file is read until end anyway. Writes after this point
+		// queue new events, so no data can be missed.
+		{
+			deUint8 eventBuf[1024];
+			while (::read(m_notifyFd, &eventBuf[0], sizeof(eventBuf)) > 0);
+		}
+
+		return;
+	}
+#endif
+
+	m_stopEvent.wait(FILEREADER_IDLE_SLEEP);
+}
+
 void FileReader::stop (void)
 {
 	if (!m_isRunning)
 		return; // Nothing to do.
 
 	m_buf.cancel();
+	m_stopEvent.signal();
 
 	// Join thread.
 	join();
@@ -111,6 +203,20 @@ void FileReader::stop (void)
 	deFile_destroy(m_file);
 	m_file = DE_NULL;
 
+	if (m_fifoWriteFd >= 0)
+	{
+		close(m_fifoWriteFd);
+		m_fifoWriteFd = -1;
+	}
+
+	if (m_notifyFd >= 0)
+	{
+		close(m_notifyFd);
+		m_notifyFd = -1;
+	}
+
+	m_dataEvent = DE_NULL;
+
 	// Reset buffer.
 	m_buf.clear();
 
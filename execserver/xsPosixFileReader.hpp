@@ -24,6 +24,7 @@
  *//*--------------------------------------------------------------------*/
 
 #include "xsDefs.hpp"
+#include "xsIoEvent.hpp"
 #include "deFile.h"
 #include "deThread.hpp"
 
@@ -38,7 +39,7 @@ public:
 							FileReader			(int blockSize, int numBlocks);
 							~FileReader			(void);
 
-	void					start				(const char* filename);
+	void					start				(const char* filename, IoEvent* dataEvent);
 	void					stop				(void);
 
 	bool					isRunning			(void) const					{ return m_isRunning;					}
@@ -47,9 +48,18 @@ public:
 	void					run					(void);
 
 private:
+	void					openFile			(const char* filename);
+	void					openFifo			(const char* filename);
+	void					waitForData			(void);
+
 	deFile*					m_file;
+	int						m_notifyFd;		//!< inotify instance watching the file, -1 if not available.
+	int						m_fifoWriteFd;	//!< Write end of a named pipe kept open by the reader, -1 if reading a file.
 	ThreadedByteBuffer		m_buf;
 	bool					m_isRunning;
+
+	IoEvent*				m_dataEvent;	//!< Signaled when new data is written to buffer.
+	IoEvent					m_stopEvent;
 };
 
 } // posix
@@ -23,10 +23,15 @@
 
 #include "xsPosixTestProcess.hpp"
 #include "deFilePath.hpp"
+#include "deStringUtil.hpp"
+#include "deAtomic.h"
 #include "deClock.h"
 
 #include <string.h>
 #include <stdio.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 using std::string;
 using std::vector;
@@ -76,7 +81,10 @@ void CaseListWriter::run (void)
 		if (result == DE_FILERESULT_SUCCESS)
 			pos += numWritten;
 		else if (result == DE_FILERESULT_WOULD_BLOCK)
-			deSleep(1); // Yield.
+		{
+			// Wait until process has consumed some of the case list. \note Just yields if events are not supported.
+			m_stopEvent.wait(deFile_getHandle(m_file), IoEvent::WAIT_WRITE, m_stopEvent.isSupported() ? FILEREADER_IDLE_SLEEP : 1);
+		}
 		else
 			break; // Error.
 	}
@@ -88,6 +96,7 @@ void CaseListWriter::stop (void)
 		return; // Nothing to do.
 
 	m_run = false;
+	m_stopEvent.signal();
 
 	// Join thread.
 	join();
@@ -96,8 +105,9 @@ void CaseListWriter::stop (void)
 }
 
 PipeReader::PipeReader (ThreadedByteBuffer* dst)
-	: m_file	(DE_NULL)
-	, m_buf		(dst)
+	: m_file		(DE_NULL)
+	, m_buf			(dst)
+	, m_dataEvent	(DE_NULL)
 {
 }
 
@@ -105,7 +115,7 @@ PipeReader::~PipeReader (void)
 {
 }
 
-void PipeReader::start (deFile* file)
+void PipeReader::start (deFile* file, IoEvent* dataEvent)
 {
 	DE_ASSERT(!isStarted());
 
@@ -113,7 +123,8 @@ void PipeReader::start (deFile* file)
 	if (!deFile_setFlags(file, DE_FILE_NONBLOCKING))
 		XS_FAIL("Failed to set non-blocking mode");
 
-	m_file = file;
+	m_file		= file;
+	m_dataEvent	= dataEvent;
 
 	de::Thread::start();
 }
@@ -122,6 +133,7 @@ void PipeReader::run (void)
 {
 	std::vector<deUint8>	tmpBuf		(FILEREADER_TMP_BUFFER_SIZE);
 	deInt64					numRead		= 0;
+	bool					gotEof		= false;
 
 	while (!m_buf->isCanceled())
 	{
@@ -140,12 +152,28 @@ void PipeReader::run (void)
 				// Canceled.
 				break;
 			}
+
+			if (m_dataEvent)
+				m_dataEvent->signal();
 		}
-		else if (result == DE_FILERESULT_END_OF_FILE ||
-				 result == DE_FILERESULT_WOULD_BLOCK)
+		else if (result == DE_FILERESULT_WOULD_BLOCK)
 		{
 			// Wait for more data.
-			deSleep(FILEREADER_IDLE_SLEEP);
+			m_stopEvent.wait(deFile_getHandle(m_file), IoEvent::WAIT_READ, FILEREADER_IDLE_SLEEP);
+		}
+		else if (result == DE_FILERESULT_END_OF_FILE)
+		{
+			// Pipe was closed, most likely because process exited. Let the owner know
+			// and wait for stop() since there is nothing more to read.
+			if (!gotEof)
+			{
+				gotEof = true;
+
+				if (m_dataEvent)
+					m_dataEvent->signal();
+			}
+
+			m_stopEvent.wait(FILEREADER_IDLE_SLEEP);
 		}
 		else
 			break; // Error.
@@ -159,19 +187,27 @@ void PipeReader::stop (void)
 
 	// Buffer must be in canceled state or otherwise stopping reader might block.
 	DE_ASSERT(m_buf->isCanceled());
+	m_stopEvent.signal();
 
 	// Join thread.
 	join();
 
-	m_file = DE_NULL;
+	m_file		= DE_NULL;
+	m_dataEvent	= DE_NULL;
 }
 
 } // unix
 
-PosixTestProcess::PosixTestProcess (void)
-	: m_process				(DE_NULL)
+static volatile deInt32 s_numInstances = 0;
+
+PosixTestProcess::PosixTestProcess (LogTransport logTransport)
+	: m_instanceNdx			(deAtomicIncrementInt32(&s_numInstances) - 1)
+	, m_logTransport		(logTransport)
+	, m_process				(DE_NULL)
 	, m_processStartTime	(0)
+	, m_hasLogPipe			(false)
 	, m_infoBuffer			(INFO_BUFFER_BLOCK_SIZE, INFO_BUFFER_NUM_BLOCKS)
+	, m_dataEvent			(DE_NULL)
 	, m_stdOutReader		(&m_infoBuffer)
 	, m_stdErrReader		(&m_infoBuffer)
 	, m_logReader			(LOG_BUFFER_BLOCK_SIZE, LOG_BUFFER_NUM_BLOCKS)
@@ -189,7 +225,9 @@ void PosixTestProcess::start (const char* name, const char* params, const char*
 
 	XS_CHECK(!m_process);
 
-	de::FilePath logFilePath = de::FilePath::join(workingDir, "TestResults.qpa");
+	// \note Log file name is unique per execserver and test process so that several servers and concurrent
+	//		 processes can share a working directory.
+	de::FilePath logFilePath = de::FilePath::join(workingDir, "TestResults-" + de::toString(getpid()) + "-" + de::toString(m_instanceNdx) + ".qpa");
 	m_logFileName = logFilePath.getPath();
 
 	// Remove old file if such exists.
@@ -199,6 +237,26 @@ void PosixTestProcess::start (const char* name, const char* params, const char*
 			throw TestProcessException(string("Failed to remove '") + m_logFileName + "'");
 	}
 
+	if (m_logTransport == LOGTRANSPORT_PIPE)
+	{
+		// Test process opens the pipe like a regular log file. Reading must start before the
+		// process is launched, as opening the write end blocks until there is a reader.
+		if (mkfifo(m_logFileName.c_str(), 0600) != 0)
+			throw TestProcessException(string("Failed to create log pipe '") + m_logFileName + "'");
+
+		m_hasLogPipe = true;
+
+		try
+		{
+			m_logReader.start(m_logFileName.c_str(), m_dataEvent);
+		}
+		catch (const std::exception& e)
+		{
+			cleanup();
+			throw TestProcessException(e.what());
+		}
+	}
+
 	// Construct command line.
 	string cmdLine = de::FilePath(name).isAbsolutePath() ? name : de::FilePath::join(workingDir, name).getPath();
 	cmdLine += string(" --deqp-log-filename=") + logFilePath.getBaseName();
@@ -220,6 +278,7 @@ void PosixTestProcess::start (const char* name, const char* params, const char*
 	{
 		delete m_process;
 		m_process = DE_NULL;
+		cleanup(); // Stop log pipe reader.
 		throw TestProcessException(e.what());
 	}
 
@@ -227,10 +286,10 @@ void PosixTestProcess::start (const char* name, const char* params, const char*
 
 	// Create stdout & stderr readers.
 	if (m_process->getStdOut())
-		m_stdOutReader.start(m_process->getStdOut());
+		m_stdOutReader.start(m_process->getStdOut(), m_dataEvent);
 
 	if (m_process->getStdErr())
-		m_stdErrReader.start(m_process->getStdErr());
+		m_stdErrReader.start(m_process->getStdErr(), m_dataEvent);
 
 	// Start case list writer.
 	if (hasCaseList)
@@ -266,6 +325,12 @@ void PosixTestProcess::cleanup (void)
 	m_caseListWriter.stop();
 	m_logReader.stop();
 
+	if (m_hasLogPipe)
+	{
+		deDeleteFile(m_logFileName.c_str());
+		m_hasLogPipe = false;
+	}
+
 	// \note Info buffer must be canceled before stopping pipe readers.
 	m_infoBuffer.cancel();
 
@@ -326,7 +391,7 @@ int PosixTestProcess::readTestLog (deUint8* dst, int numBytes)
 			return 0;
 
 		// Start reader.
-		m_logReader.start(m_logFileName.c_str());
+		m_logReader.start(m_logFileName.c_str(), m_dataEvent);
 	}
 
 	DE_ASSERT(m_logReader.isRunning());
@@ -26,6 +26,7 @@
 #include "xsDefs.hpp"
 #include "xsTestProcess.hpp"
 #include "xsPosixFileReader.hpp"
+#include "xsIoEvent.hpp"
 #include "deProcess.hpp"
 #include "deThread.hpp"
 
@@ -52,6 +53,7 @@ private:
 	deFile*					m_file;
 	std::vector<char>		m_caseList;
 	bool					m_run;
+	IoEvent					m_stopEvent;
 };
 
 class PipeReader : public de::Thread
@@ -60,7 +62,7 @@ public:
 							PipeReader			(ThreadedByteBuffer* dst);
 							~PipeReader			(void);
 
-	void					start				(deFile* file);
+	void					start				(deFile* file, IoEvent* dataEvent);
 	void					stop				(void);
 
 	void					run					(void);
@@ -68,6 +70,8 @@ public:
 private:
 	deFile*					m_file;
 	ThreadedByteBuffer*		m_buf;
+	IoEvent*				m_dataEvent;
+	IoEvent					m_stopEvent;
 };
 
 } // posix
@@ -75,7 +79,15 @@ private:
 class PosixTestProcess : public TestProcess
 {
 public:
-							PosixTestProcess		(void);
+	enum LogTransport
+	{
+		LOGTRANSPORT_FILE = 0,	//!< Test process writes log into a file that is read as it grows.
+		LOGTRANSPORT_PIPE,		//!< Log file is replaced with a named pipe, no data goes through the disk.
+
+		LOGTRANSPORT_LAST
+	};
+
+							PosixTestProcess		(LogTransport logTransport = LOGTRANSPORT_FILE);
 	virtual					~PosixTestProcess		(void);
 
 	virtual void			start					(const char* name, const char* params, const char* workingDir, const char* caseList);
@@ -89,14 +101,20 @@ public:
 	virtual int				readTestLog				(deUint8* dst, int numBytes);
 	virtual int				readInfoLog				(deUint8* dst, int numBytes) { return m_infoBuffer.tryRead(numBytes, dst); }
 
+	virtual void			setDataEvent			(IoEvent* event) { m_dataEvent = event; }
+
 private:
 							PosixTestProcess		(const PosixTestProcess& other);
 	PosixTestProcess&		operator=				(const PosixTestProcess& other);
 
+	const int				m_instanceNdx;			//!< Distinguishes log files of test processes in the same execserver.
+	const LogTransport		m_logTransport;
 	de::Process*			m_process;
 	deUint64				m_processStartTime;		//!< Used for determining log file timeout.
 	std::string				m_logFileName;
+	bool					m_hasLogPipe;			//!< Log file is a named pipe created by start().
 	ThreadedByteBuffer		m_infoBuffer;
+	IoEvent*				m_dataEvent;
 
 	// Threads.
 	posix::CaseListWriter	m_caseListWriter;
@@ -22,6 +22,7 @@
  *//*--------------------------------------------------------------------*/
 
 #include "xsProtocol.hpp"
+#include "xsCompression.hpp"
 
 using std::string;
 using std::vector;
@@ -222,6 +223,46 @@ void ProcessLogDataMessage::write (vector<deUint8>& buf) const
 	writer.put(logData.c_str());
 }
 
+ProcessLogDataCompressedMessage::ProcessLogDataCompressedMessage (const deUint8* data, size_t dataSize)
+	: Message(MESSAGETYPE_PROCESS_LOG_DATA_COMPRESSED)
+{
+	Decompressor	decompressor;
+	vector<deUint8>	buf;
+
+	read(buf, decompressor, data, dataSize);
+	logData.assign((const char*)&buf[0], buf.size());
+}
+
+void ProcessLogDataCompressedMessage::write (vector<deUint8>& buf) const
+{
+	Compressor compressor;
+	write(buf, compressor, (const deUint8*)logData.c_str(), logData.length());
+}
+
+void ProcessLogDataCompressedMessage::write (vector<deUint8>& buf, Compressor& compressor, const deUint8* src, size_t srcSize)
+{
+	DE_ASSERT(srcSize > 0 && srcSize <= LOG_FRAME_SIZE);
+
+	MessageWriter writer(MESSAGETYPE_PROCESS_LOG_DATA_COMPRESSED, buf);
+	writer.put((int)srcSize);
+
+	const size_t dataPos = buf.size();
+	buf.resize(dataPos + compressor.getMaxCompressedSize(srcSize));
+	buf.resize(dataPos + compressor.compress(src, srcSize, &buf[dataPos], buf.size() - dataPos));
+}
+
+void ProcessLogDataCompressedMessage::read (vector<deUint8>& dst, Decompressor& decompressor, const deUint8* data, size_t dataSize)
+{
+	MessageParser	parser				(data, dataSize);
+	const int		uncompressedSize	= parser.get<int>();
+
+	// \note Sender never compresses more than one log frame into a message.
+	XS_CHECK_MSG(uncompressedSize > 0 && uncompressedSize <= LOG_FRAME_SIZE, "Invalid payload size");
+
+	dst.resize(uncompressedSize);
+	decompressor.decompress(data + sizeof(int), dataSize - sizeof(int), &dst[0], dst.size());
+}
+
 ProcessLaunchFailedMessage::ProcessLaunchFailedMessage (const deUint8* data, size_t dataSize)
 	: Message(MESSAGETYPE_PROCESS_LAUNCH_FAILED)
 {
@@ -250,6 +291,22 @@ void ProcessFinishedMessage::write (vector<deUint8>& buf) const
 	writer.put(exitCode);
 }
 
+CapacityMessage::CapacityMessage (const deUint8* data, size_t dataSize)
+	: Message(MESSAGETYPE_CAPACITY)
+{
+	MessageParser parser(data, dataSize);
+	maxProcesses	= parser.get<int>();
+	numAvailable	= parser.get<int>();
+	parser.assumEnd();
+}
+
+void CapacityMessage::write (vector<deUint8>& buf) const
+{
+	MessageWriter writer(type, buf);
+	writer.put(maxProcesses);
+	writer.put(numAvailable);
+}
+
 InfoMessage::InfoMessage (const deUint8* data, size_t dataSize)
 	: Message(MESSAGETYPE_INFO)
 {
@@ -34,12 +34,15 @@ namespace xs
 
 enum
 {
-	PROTOCOL_VERSION			= 18,
-	MESSAGE_HEADER_SIZE			= 8,
+	PROTOCOL_VERSION					= 19,
+	PROTOCOL_VERSION_MIN_SUPPORTED		= 18,
+	PROTOCOL_VERSION_COMPRESSED_LOG		= 19,	//!< First version where ExecServer sends log data compressed.
+
+	MESSAGE_HEADER_SIZE					= 8,
 
 	// Times are in milliseconds.
-	KEEPALIVE_SEND_INTERVAL		= 5000,
-	KEEPALIVE_TIMEOUT			= 30000,
+	KEEPALIVE_SEND_INTERVAL				= 5000,
+	KEEPALIVE_TIMEOUT					= 30000,
 };
 
 enum MessageType
@@ -47,10 +50,11 @@ enum MessageType
 	MESSAGETYPE_NONE					= 0,	//!< Not valid.
 
 	// Commands (from Client to ExecServer).
-	MESSAGETYPE_HELLO					= 100,	//!< First message from client, specifies the protocol version
+	MESSAGETYPE_HELLO					= 100,	//!< First message from client, specifies the protocol version. ExecServer replies with HELLO if version >= PROTOCOL_VERSION_COMPRESSED_LOG.
 	MESSAGETYPE_TEST					= 101,	//!< Debug only
 	MESSAGETYPE_EXECUTE_BINARY			= 111,	//!< Request execution of a test package binary.
 	MESSAGETYPE_STOP_EXECUTION			= 112,	//!< Request cancellation of the currently executing binary.
+	MESSAGETYPE_QUERY_CAPACITY			= 113,	//!< Request number of test processes ExecServer can run.
 
 	// Responses (from ExecServer to Client)
 	MESSAGETYPE_PROCESS_STARTED			= 200,	//!< Requested process has started.
@@ -58,11 +62,15 @@ enum MessageType
 	MESSAGETYPE_PROCESS_FINISHED		= 202,	//!< Requested process has finished (for any reason).
 	MESSAGETYPE_PROCESS_LOG_DATA		= 203,	//!< Unprocessed log data from TestResults.qpa.
 	MESSAGETYPE_INFO					= 204,	//!< Generic info message from ExecServer (for debugging purposes).
+	MESSAGETYPE_CAPACITY				= 205,	//!< Response to QUERY_CAPACITY.
+	MESSAGETYPE_PROCESS_LOG_DATA_COMPRESSED	= 206,	//!< zlib-compressed log data, replaces PROCESS_LOG_DATA if negotiated in HELLO.
 
 	MESSAGETYPE_KEEPALIVE				= 102	//!< Keep-alive packet
 };
 
 class MessageWriter;
+class Compressor;
+class Decompressor;
 
 class Message
 {
@@ -99,6 +107,7 @@ public:
 typedef SimpleMessage<MESSAGETYPE_STOP_EXECUTION>			StopExecutionMessage;
 typedef SimpleMessage<MESSAGETYPE_PROCESS_STARTED>			ProcessStartedMessage;
 typedef SimpleMessage<MESSAGETYPE_KEEPALIVE>				KeepAliveMessage;
+typedef SimpleMessage<MESSAGETYPE_QUERY_CAPACITY>			QueryCapacityMessage;
 
 class HelloMessage : public Message
 {
@@ -138,6 +147,25 @@ public:
 	void			write						(std::vector<deUint8>& buf) const;
 };
 
+// \note Payload is uncompressed size (at most LOG_FRAME_SIZE) followed by a complete zlib stream.
+class ProcessLogDataCompressedMessage : public Message
+{
+public:
+	std::string		logData;
+
+					ProcessLogDataCompressedMessage		(const deUint8* data, size_t dataSize);
+					ProcessLogDataCompressedMessage		(const char* logData_) : Message(MESSAGETYPE_PROCESS_LOG_DATA_COMPRESSED), logData(logData_) {}
+					~ProcessLogDataCompressedMessage	(void) {}
+
+	void			write								(std::vector<deUint8>& buf) const;
+
+	//! Write message with srcSize bytes of log data from src, without constructing message object.
+	static void		write								(std::vector<deUint8>& buf, Compressor& compressor, const deUint8* src, size_t srcSize);
+
+	//! Decompress log data from message payload to dst, without constructing message object.
+	static void		read								(std::vector<deUint8>& dst, Decompressor& decompressor, const deUint8* data, size_t dataSize);
+};
+
 class ProcessLaunchFailedMessage : public Message
 {
 public:
@@ -162,6 +190,19 @@ public:
 	void			write							(std::vector<deUint8>& buf) const;
 };
 
+class CapacityMessage : public Message
+{
+public:
+	int				maxProcesses;		//!< Number of test processes ExecServer can run concurrently.
+	int				numAvailable;		//!< Number of those not currently in use by any connection.
+
+					CapacityMessage		(const deUint8* data, size_t dataSize);
+					CapacityMessage		(int maxProcesses_, int numAvailable_) : Message(MESSAGETYPE_CAPACITY), maxProcesses(maxProcesses_), numAvailable(numAvailable_) {}
+					~CapacityMessage	(void) {}
+
+	void			write				(std::vector<deUint8>& buf) const;
+};
+
 class InfoMessage : public Message
 {
 public:
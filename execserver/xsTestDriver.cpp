@@ -46,7 +46,13 @@ TestDriver::TestDriver (xs::TestProcess* testProcess)
 	, m_process				(testProcess)
 	, m_lastProcessDataTime	(0)
 	, m_dataMsgTmpBuf		(SEND_RECV_TMP_BUFFER_SIZE)
+	, m_compressLog			(false)
+	, m_logFrame			(LOG_FRAME_SIZE)
+	, m_logFrameSize		(0)
+	, m_logFrameStartTime	(0)
 {
+	// \note Compressed frame must always fit in message buffer, or it could never be sent.
+	DE_STATIC_ASSERT(LOG_FRAME_SIZE*2 <= SEND_BUFFER_SIZE);
 }
 
 TestDriver::~TestDriver (void)
@@ -58,7 +64,9 @@ void TestDriver::reset (void)
 {
 	m_process->cleanup();
 
-	m_state = STATE_NOT_STARTED;
+	m_state			= STATE_NOT_STARTED;
+	m_logFrameSize	= 0;
+	m_logFrameMsg.clear();
 }
 
 void TestDriver::startProcess (const char* name, const char* params, const char* workingDir, const char* caseList)
@@ -149,7 +157,7 @@ bool TestDriver::poll (ByteBuffer& messageBuffer)
 				m_lastProcessDataTime = deGetMicroseconds();
 				return true;
 			}
-			else if (deGetMicroseconds() - m_lastProcessDataTime > READ_DATA_TIMEOUT*1000)
+			else if (!hasPendingLogData() && deGetMicroseconds() - m_lastProcessDataTime > READ_DATA_TIMEOUT*1000)
 			{
 				// Read timeout occurred.
 				m_state = STATE_PROCESS_FINISHED;
@@ -181,7 +189,68 @@ bool TestDriver::poll (ByteBuffer& messageBuffer)
 
 bool TestDriver::pollLogFile (ByteBuffer& messageBuffer)
 {
-	return pollBuffer(messageBuffer, MESSAGETYPE_PROCESS_LOG_DATA);
+	if (m_compressLog)
+		return pollCompressedLog(messageBuffer);
+	else
+		return pollBuffer(messageBuffer, MESSAGETYPE_PROCESS_LOG_DATA);
+}
+
+bool TestDriver::pollCompressedLog (ByteBuffer& messageBuffer)
+{
+	bool	gotData	= false;
+	int		numRead	= 0;
+
+	// Previous frame must be sent before next one is compressed.
+	if (!m_logFrameMsg.empty())
+	{
+		if (messageBuffer.getNumFree() < (int)m_logFrameMsg.size())
+			return false; // Not enough space in message buffer.
+
+		messageBuffer.pushFront(&m_logFrameMsg[0], (int)m_logFrameMsg.size());
+		m_logFrameMsg.clear();
+		gotData = true;
+	}
+
+	// Gather more data to current frame.
+	if (m_logFrameSize < m_logFrame.size())
+	{
+		numRead = m_process->readTestLog(&m_logFrame[m_logFrameSize], (int)(m_logFrame.size() - m_logFrameSize));
+
+		if (numRead > 0)
+		{
+			if (m_logFrameSize == 0)
+				m_logFrameStartTime = deGetMicroseconds();
+
+			m_logFrameSize	+= (size_t)numRead;
+			gotData			= true;
+		}
+	}
+
+	if (m_logFrameSize == 0)
+		return gotData;
+
+	// Send frame when it is full, data has waited long enough, or process has exited and there is no more data available.
+	{
+		const bool	isFull		= m_logFrameSize == m_logFrame.size();
+		const bool	isExpired	= deGetMicroseconds() - m_logFrameStartTime > LOG_FRAME_MAX_DELAY*1000;
+		const bool	isDrained	= m_state == STATE_READING_DATA && numRead <= 0;
+
+		if (!isFull && !isExpired && !isDrained)
+			return gotData;
+	}
+
+	ProcessLogDataCompressedMessage::write(m_logFrameMsg, m_compressor, &m_logFrame[0], m_logFrameSize);
+	m_logFrameSize = 0;
+
+	DBG_PRINT(("  wrote %d bytes of compressed log data\n", (int)m_logFrameMsg.size()));
+
+	if (messageBuffer.getNumFree() >= (int)m_logFrameMsg.size())
+	{
+		messageBuffer.pushFront(&m_logFrameMsg[0], (int)m_logFrameMsg.size());
+		m_logFrameMsg.clear();
+	}
+
+	return true;
 }
 
 bool TestDriver::pollInfo (ByteBuffer& messageBuffer)
@@ -26,6 +26,8 @@
 #include "xsDefs.hpp"
 #include "xsProtocol.hpp"
 #include "xsTestProcess.hpp"
+#include "xsIoEvent.hpp"
+#include "xsCompression.hpp"
 
 #include <vector>
 
@@ -45,6 +47,9 @@ public:
 
 	bool					poll				(ByteBuffer& messageBuffer);
 
+	void					setDataEvent		(IoEvent* event)	{ m_process->setDataEvent(event); }
+	void					setLogCompression	(bool enabled)		{ m_compressLog = enabled; }
+
 private:
 	enum State
 	{
@@ -59,6 +64,8 @@ private:
 	};
 
 	bool					pollLogFile			(ByteBuffer& messageBuffer);
+	bool					pollCompressedLog	(ByteBuffer& messageBuffer);
+	bool					hasPendingLogData	(void) const { return m_logFrameSize > 0 || !m_logFrameMsg.empty(); }
 	bool					pollInfo			(ByteBuffer& messageBuffer);
 	bool					pollBuffer			(ByteBuffer& messageBuffer, MessageType msgType);
 
@@ -73,6 +80,13 @@ private:
 	deUint64				m_lastProcessDataTime;
 
 	std::vector<deUint8>	m_dataMsgTmpBuf;
+
+	bool					m_compressLog;
+	Compressor				m_compressor;
+	std::vector<deUint8>	m_logFrame;				//!< Log data gathered for next compressed frame.
+	size_t					m_logFrameSize;
+	deUint64				m_logFrameStartTime;
+	std::vector<deUint8>	m_logFrameMsg;			//!< Compressed frame waiting for space in message buffer.
 };
 
 } // xs
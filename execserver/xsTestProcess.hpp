@@ -30,6 +30,8 @@
 namespace xs
 {
 
+class IoEvent;
+
 class TestProcessException : public std::runtime_error
 {
 public:
@@ -51,6 +53,9 @@ public:
 	virtual int				readTestLog				(deUint8* dst, int numBytes)	= DE_NULL;
 	virtual int				readInfoLog				(deUint8* dst, int numBytes)	= DE_NULL;
 
+	//! Set event to signal when new data is available or process may have exited. Not called while process is running.
+	virtual void			setDataEvent			(IoEvent* event)				{ DE_UNREF(event); }
+
 protected:
 							TestProcess				(void) {}
 };
@@ -27,6 +27,8 @@
 #include "deMemory.h"
 #include "deClock.h"
 #include "deFile.h"
+#include "deStringUtil.hpp"
+#include "deAtomic.h"
 
 #include <sstream>
 #include <string.h>
@@ -626,8 +628,11 @@ void Process::kill (void)
 
 } // win32
 
+static volatile deInt32 s_numInstances = 0;
+
 Win32TestProcess::Win32TestProcess (void)
-	: m_process				(DE_NULL)
+	: m_instanceNdx			(deAtomicIncrementInt32(&s_numInstances) - 1)
+	, m_process				(DE_NULL)
 	, m_processStartTime	(0)
 	, m_infoBuffer			(INFO_BUFFER_BLOCK_SIZE, INFO_BUFFER_NUM_BLOCKS)
 	, m_stdOutReader		(&m_infoBuffer)
@@ -646,7 +651,9 @@ void Win32TestProcess::start (const char* name, const char* params, const char*
 
 	XS_CHECK(!m_process);
 
-	de::FilePath logFilePath = de::FilePath::join(workingDir, "TestResults.qpa");
+	// \note Log file name is unique per execserver and test process so that several servers and concurrent
+	//		 processes can share a working directory.
+	de::FilePath logFilePath = de::FilePath::join(workingDir, "TestResults-" + de::toString(GetCurrentProcessId()) + "-" + de::toString(m_instanceNdx) + ".qpa");
 	m_logFileName = logFilePath.getPath();
 
 	// Remove old file if such exists.
@@ -196,6 +196,7 @@ private:
 							Win32TestProcess		(const Win32TestProcess& other);
 	Win32TestProcess&		operator=				(const Win32TestProcess& other);
 
+	const int				m_instanceNdx;			//!< Distinguishes log files of test processes in the same execserver.
 	win32::Process*			m_process;
 	deUint64				m_processStartTime;
 	std::string				m_logFileName;
@@ -23,6 +23,7 @@
 
 #include "xeTestLogParser.hpp"
 #include "xeTestResultParser.hpp"
+#include "xeResultStore.hpp"
 #include "xeXMLWriter.hpp"
 #include "deFilePath.hpp"
 #include "deString.h"
@@ -50,7 +51,7 @@ struct CommandLine
 
 static void printHelp (const char* binName)
 {
-	printf("%s: [testlog] [output file]\n", binName);
+	printf("%s: [testlog or result store] [output file]\n", binName);
 }
 
 static void parseCommandLine (CommandLine& cmdLine, int argc, const char* const* argv)
@@ -80,6 +81,29 @@ static void parseBatchResult (xe::TestLogParser& parser, const char* filename)
 	}
 }
 
+static void writeTestCase (xe::xml::Writer& writer, const std::string& casePath, xe::TestStatusCode statusCode, const std::string& statusDetails)
+{
+	using xe::xml::Writer;
+
+	// Split group and case names.
+	size_t			sepPos		= casePath.find_last_of('.');
+	std::string		caseName	= casePath.substr(sepPos+1);
+	std::string		groupName	= casePath.substr(0, sepPos);
+
+	// Write result.
+	writer << Writer::BeginElement("testcase")
+		   << Writer::Attribute("name", caseName)
+		   << Writer::Attribute("classname", groupName);
+
+	if (statusCode != xe::TESTSTATUSCODE_PASS)
+		writer << Writer::BeginElement("failure")
+			   << Writer::Attribute("type", xe::getTestStatusCodeName(statusCode))
+			   << statusDetails
+			   << Writer::EndElement;
+
+	writer << Writer::EndElement;
+}
+
 class ResultToJUnitHandler : public xe::TestLogHandler
 {
 public:
@@ -103,29 +127,11 @@ public:
 
 	void testCaseResultComplete (const xe::TestCaseResultPtr& resultData)
 	{
-		using xe::xml::Writer;
-
 		xe::TestCaseResult result;
 
 		xe::parseTestCaseResultFromData(&m_resultParser, &result, *resultData.get());
 
-		// Split group and case names.
-		size_t			sepPos		= result.casePath.find_last_of('.');
-		std::string		caseName	= result.casePath.substr(sepPos+1);
-		std::string		groupName	= result.casePath.substr(0, sepPos);
-
-		// Write result.
-		m_writer << Writer::BeginElement("testcase")
-				 << Writer::Attribute("name", caseName)
-				 << Writer::Attribute("classname", groupName);
-
-		if (result.statusCode != xe::TESTSTATUSCODE_PASS)
-			m_writer << Writer::BeginElement("failure")
-					 << Writer::Attribute("type", xe::getTestStatusCodeName(result.statusCode))
-					 << result.statusDetails
-					 << Writer::EndElement;
-
-		m_writer << Writer::EndElement;
+		writeTestCase(m_writer, result.casePath, result.statusCode, result.statusDetails);
 	}
 
 private:
@@ -137,8 +143,6 @@ static void batchResultToJUnitReport (const char* batchResultFilename, const cha
 {
 	std::ofstream				out			(dstFileName, std::ios_base::binary);
 	xe::xml::Writer				writer		(out);
-	ResultToJUnitHandler		handler		(writer);
-	xe::TestLogParser			parser		(&handler);
 
 	XE_CHECK(out.good());
 
@@ -147,8 +151,25 @@ static void batchResultToJUnitReport (const char* batchResultFilename, const cha
 	writer << xe::xml::Writer::BeginElement("testsuites")
 		   << xe::xml::Writer::BeginElement("testsuite");
 
-	// Parse and write individual cases
-	parseBatchResult(parser, batchResultFilename);
+	if (xe::isResultStoreFile(batchResultFilename))
+	{
+		// Result store has final status for each case, no need to parse case logs.
+		const xe::ResultStore store (batchResultFilename);
+
+		for (int caseNdx = 0; caseNdx < store.getNumCases(); caseNdx++)
+		{
+			if (store.isComplete(caseNdx))
+				writeTestCase(writer, store.getCasePath(caseNdx), store.getStatusCode(caseNdx), store.getStatusDetails(caseNdx));
+		}
+	}
+	else
+	{
+		ResultToJUnitHandler	handler		(writer);
+		xe::TestLogParser		parser		(&handler);
+
+		// Parse and write individual cases
+		parseBatchResult(parser, batchResultFilename);
+	}
 
 	writer << xe::xml::Writer::EndElement << xe::xml::Writer::EndElement;
 }
@@ -25,6 +25,7 @@
 #include "xeTestResultParser.hpp"
 #include "xeXMLWriter.hpp"
 #include "xeTestLogWriter.hpp"
+#include "xeResultStore.hpp"
 #include "deFilePath.hpp"
 #include "deString.h"
 #include "deStringUtil.hpp"
@@ -95,7 +96,7 @@ static bool parseCommandLine (CommandLine& cmdLine, int argc, const char* const*
 	if (!parser.parse(argc-1, argv+1, &opts, std::cerr) ||
 		opts.getArgs().size() != 2)
 	{
-		printf("%s: [options] [testlog] [destination path]\n", argv[0]);
+		printf("%s: [options] [testlog or result store] [destination path]\n", argv[0]);
 		parser.help(std::cout);
 		return false;
 	}
@@ -107,10 +108,17 @@ static bool parseCommandLine (CommandLine& cmdLine, int argc, const char* const*
 	return true;
 }
 
-static void parseBatchResult (xe::TestLogParser& parser, const char* filename)
+static void parseBatchResult (xe::TestLogHandler& handler, const char* filename)
 {
-	std::ifstream	in			(filename, std::ios_base::binary);
-	deUint8			buf[2048];
+	if (xe::isResultStoreFile(filename))
+	{
+		xe::ResultStore(filename).replay(handler);
+		return;
+	}
+
+	xe::TestLogParser	parser		(&handler);
+	std::ifstream		in			(filename, std::ios_base::binary);
+	deUint8				buf[2048];
 
 	for (;;)
 	{
@@ -204,7 +212,6 @@ static void batchResultToSingleXmlFile (const char* batchResultFilename, const c
 	xe::xml::Writer				writer		(out);
 	BatchResultTotals			totals;
 	ResultToSingleXmlLogHandler	handler		(writer, totals);
-	xe::TestLogParser			parser		(&handler);
 
 	XE_CHECK(out.good());
 
@@ -215,7 +222,7 @@ static void batchResultToSingleXmlFile (const char* batchResultFilename, const c
 		   << xe::xml::Writer::Attribute("FileName", de::FilePath(batchResultFilename).getBaseName());
 
 	// Parse and write individual cases
-	parseBatchResult(parser, batchResultFilename);
+	parseBatchResult(handler, batchResultFilename);
 
 	// Write ResultTotals
 	writeTotals(writer, totals);
@@ -346,9 +353,8 @@ static void batchResultToSeparateXmlFiles (const char* batchResultFilename, cons
 	// Parse batch result and write out test cases.
 	{
 		ResultToXmlFilesLogHandler	handler		(shortResults, dstPath);
-		xe::TestLogParser			parser		(&handler);
 
-		parseBatchResult(parser, batchResultFilename);
+		parseBatchResult(handler, batchResultFilename);
 	}
 
 	// Build case hierarchy & short result map.
@@ -21,25 +21,29 @@
  * \brief Command line test executor.
  *//*--------------------------------------------------------------------*/
 
-#include "xeBatchExecutor.hpp"
+#include "xeShardedBatchExecutor.hpp"
 #include "xeLocalTcpIpLink.hpp"
 #include "xeTcpIpLink.hpp"
 #include "xeTestCaseListParser.hpp"
 #include "xeTestLogWriter.hpp"
 #include "xeTestResultParser.hpp"
+#include "xeResultStore.hpp"
 
 #include "deCommandLine.hpp"
 #include "deDirectoryIterator.hpp"
+#include "deFilePath.hpp"
 #include "deStringUtil.hpp"
 
 #include "deString.h"
 
 #include <algorithm>
+#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -59,15 +63,20 @@ namespace opt
 {
 
 DE_DECLARE_COMMAND_LINE_OPT(StartServer,	string);
-DE_DECLARE_COMMAND_LINE_OPT(Host,			string);
+DE_DECLARE_COMMAND_LINE_OPT(Host,			vector<string>);
 DE_DECLARE_COMMAND_LINE_OPT(Port,			int);
+DE_DECLARE_COMMAND_LINE_OPT(NumShards,		int);
 DE_DECLARE_COMMAND_LINE_OPT(CaseListDir,	string);
 DE_DECLARE_COMMAND_LINE_OPT(TestSet,		vector<string>);
 DE_DECLARE_COMMAND_LINE_OPT(ExcludeSet,		vector<string>);
 DE_DECLARE_COMMAND_LINE_OPT(ContinueFile,	string);
+DE_DECLARE_COMMAND_LINE_OPT(DurationFile,	string);
+DE_DECLARE_COMMAND_LINE_OPT(HistoryFile,	string);
 DE_DECLARE_COMMAND_LINE_OPT(TestLogFile,	string);
 DE_DECLARE_COMMAND_LINE_OPT(InfoLogFile,	string);
+DE_DECLARE_COMMAND_LINE_OPT(ResultStore,	string);
 DE_DECLARE_COMMAND_LINE_OPT(Summary,		bool);
+DE_DECLARE_COMMAND_LINE_OPT(CompressLog,	bool);
 
 // TargetConfiguration
 DE_DECLARE_COMMAND_LINE_OPT(BinaryName,		string);
@@ -95,15 +104,20 @@ void registerOptions (de::cmdline::Parser& parser)
 	};
 
 	parser << Option<StartServer>	("s",		"start-server",	"Start local execserver. Path to the execserver binary.")
-		   << Option<Host>			("c",		"connect",		"Connect to host. Address of the execserver.")
+		   << Option<Host>			("c",		"connect",		"Connect to host. Comma-separated list of execserver addresses, optionally with :port.",	parseCommaSeparatedList)
 		   << Option<Port>			("p",		"port",			"TCP port of the execserver.",											"50016")
+		   << Option<NumShards>		(DE_NULL,	"shards",		"Number of local execservers to start. Ports are allocated from --port upwards.")
 		   << Option<CaseListDir>	("cd",		"caselistdir",	"Path to the directory containing test case XML files.",				".")
 		   << Option<TestSet>		("t",		"testset",		"Comma-separated list of include filters.",								parseCommaSeparatedList)
 		   << Option<ExcludeSet>	("e",		"exclude",		"Comma-separated list of exclude filters.",								parseCommaSeparatedList, "")
-		   << Option<ContinueFile>	(DE_NULL,	"continue",		"Continue execution by initializing results from existing test log.")
+		   << Option<ContinueFile>	(DE_NULL,	"continue",		"Continue execution by initializing results from existing test log or result store.")
+		   << Option<DurationFile>	(DE_NULL,	"durations",	"Balance shards using case durations from existing test log or result store.")
+		   << Option<HistoryFile>	(DE_NULL,	"history",		"Case duration and crash history file. Used for scheduling and updated after execution.")
 		   << Option<TestLogFile>	("o",		"out",			"Output test log filename.",											"TestLog.qpa")
 		   << Option<InfoLogFile>	("i",		"info",			"Output info log filename.",											"InfoLog.txt")
+		   << Option<ResultStore>	(DE_NULL,	"result-store",	"Also write results to indexed result store file.")
 		   << Option<Summary>		(DE_NULL,	"summary",		"Print summary after running tests.",									s_yesNo, "yes")
+		   << Option<CompressLog>	(DE_NULL,	"compress-log",	"Request compressed test log from remote execserver. Requires protocol version 19.")
 		   << Option<BinaryName>	("b",		"binaryname",	"Test binary path. Relative to working directory.",						"<Unused>")
 		   << Option<WorkingDir>	("wd",		"workdir",		"Working directory for the test execution.",							".")
 		   << Option<CmdLineArgs>	(DE_NULL,	"cmdline",		"Additional command line arguments for the test binary.",				"");
@@ -120,22 +134,30 @@ enum RunMode
 struct CommandLine
 {
 	CommandLine (void)
-		: port		(0)
-		, summary	(false)
+		: port			(0)
+		, numShards		(1)
+		, summary		(false)
+		, compressLog	(false)
 	{
 	}
 
 	xe::TargetConfiguration	targetCfg;
 	RunMode					runMode;
-	string					serverBinOrAddress;
+	string					serverBin;
+	vector<string>			hosts;
 	int						port;
+	int						numShards;
 	string					caseListDir;
 	vector<string>			testset;
 	vector<string>			exclude;
 	string					inFile;
+	string					durationFile;
+	string					historyFile;
 	string					outFile;
 	string					infoFile;
+	string					storeFile;
 	bool					summary;
+	bool					compressLog;
 };
 
 bool parseCommandLine (CommandLine& cmdLine, int argc, const char* const* argv)
@@ -174,12 +196,32 @@ bool parseCommandLine (CommandLine& cmdLine, int argc, const char* const* argv)
 	if (opts.hasOption<opt::StartServer>())
 	{
 		cmdLine.runMode				= RUNMODE_START_SERVER;
-		cmdLine.serverBinOrAddress	= opts.getOption<opt::StartServer>();
+		cmdLine.serverBin			= opts.getOption<opt::StartServer>();
+		cmdLine.numShards			= opts.hasOption<opt::NumShards>() ? opts.getOption<opt::NumShards>() : 1;
+
+		if (cmdLine.numShards < 1)
+		{
+			std::cout << "Invalid command line arguments. --shards must be at least 1." << std::endl;
+			return false;
+		}
 	}
 	else
 	{
 		cmdLine.runMode				= RUNMODE_CONNECT;
-		cmdLine.serverBinOrAddress	= opts.getOption<opt::Host>();
+		cmdLine.hosts				= opts.getOption<opt::Host>();
+		cmdLine.numShards			= (int)cmdLine.hosts.size();
+
+		if (cmdLine.hosts.empty())
+		{
+			std::cout << "Invalid command line arguments. --connect argument is empty." << std::endl;
+			return false;
+		}
+
+		if (opts.hasOption<opt::NumShards>())
+		{
+			std::cout << "Invalid command line arguments. --shards can only be used with --start-server, list hosts in --connect instead." << std::endl;
+			return false;
+		}
 	}
 
 	if (opts.hasOption<opt::ContinueFile>())
@@ -193,6 +235,15 @@ bool parseCommandLine (CommandLine& cmdLine, int argc, const char* const* argv)
 		}
 	}
 
+	if (opts.hasOption<opt::DurationFile>())
+		cmdLine.durationFile = opts.getOption<opt::DurationFile>();
+
+	if (opts.hasOption<opt::HistoryFile>())
+		cmdLine.historyFile = opts.getOption<opt::HistoryFile>();
+
+	if (opts.hasOption<opt::ResultStore>())
+		cmdLine.storeFile = opts.getOption<opt::ResultStore>();
+
 	cmdLine.port					= opts.getOption<opt::Port>();
 	cmdLine.caseListDir				= opts.getOption<opt::CaseListDir>();
 	cmdLine.testset					= opts.getOption<opt::TestSet>();
@@ -200,6 +251,7 @@ bool parseCommandLine (CommandLine& cmdLine, int argc, const char* const* argv)
 	cmdLine.outFile					= opts.getOption<opt::TestLogFile>();
 	cmdLine.infoFile				= opts.getOption<opt::InfoLogFile>();
 	cmdLine.summary					= opts.getOption<opt::Summary>();
+	cmdLine.compressLog				= opts.getOption<opt::CompressLog>();
 	cmdLine.targetCfg.binaryName	= opts.getOption<opt::BinaryName>();
 	cmdLine.targetCfg.workingDir	= opts.getOption<opt::WorkingDir>();
 	cmdLine.targetCfg.cmdLineArgs	= opts.getOption<opt::CmdLineArgs>();
@@ -385,8 +437,15 @@ private:
 
 void readLogFile (xe::BatchResult* batchResult, const char* filename)
 {
+	BatchResultHandler handler (batchResult);
+
+	if (xe::isResultStoreFile(filename))
+	{
+		xe::ResultStore(filename).replay(handler);
+		return;
+	}
+
 	std::ifstream		in		(filename, std::ifstream::binary|std::ifstream::in);
-	BatchResultHandler	handler	(batchResult);
 	xe::TestLogParser	parser	(&handler);
 	deUint8				buf		[1024];
 	int					numRead	= 0;
@@ -405,6 +464,20 @@ void readLogFile (xe::BatchResult* batchResult, const char* filename)
 	in.close();
 }
 
+void writeCaseHistory (xe::CaseHistory& history, const xe::BatchResult& batchResult, const std::set<string>& previousCases, const char* filename)
+{
+	for (int ndx = 0; ndx < batchResult.getNumTestCaseResults(); ndx++)
+	{
+		const xe::ConstTestCaseResultPtr data = batchResult.getTestCaseResult(ndx);
+
+		if (previousCases.find(data->getTestCasePath()) == previousCases.end())
+			history.addResult(*data);
+	}
+
+	history.write(filename);
+	printf("Case history written to %s\n", filename);
+}
+
 void printBatchResultSummary (const xe::TestNode* root, const xe::TestSet& testSet, const xe::BatchResult& batchResult)
 {
 	int countByStatusCode[xe::TESTSTATUSCODE_LAST];
@@ -455,60 +528,88 @@ void writeInfoLog (const xe::InfoLog& log, const char* filename)
 	out.close();
 }
 
-xe::CommLink* createCommLink (const CommandLine& cmdLine)
+xe::CommLink* startLocalServer (const string& serverBin, int port)
 {
-	if (cmdLine.runMode == RUNMODE_START_SERVER)
+	xe::LocalTcpIpLink* link = new xe::LocalTcpIpLink();
+	try
 	{
-		xe::LocalTcpIpLink* link = new xe::LocalTcpIpLink();
-		try
-		{
-			link->start(cmdLine.serverBinOrAddress.c_str(), DE_NULL, cmdLine.port);
-			return link;
-		}
-		catch (...)
-		{
-			delete link;
-			throw;
-		}
+		link->start(serverBin.c_str(), DE_NULL, port);
+		return link;
 	}
-	else if (cmdLine.runMode == RUNMODE_CONNECT)
+	catch (...)
 	{
-		de::SocketAddress address;
+		delete link;
+		throw;
+	}
+}
 
-		address.setFamily(DE_SOCKETFAMILY_INET4);
-		address.setProtocol(DE_SOCKETPROTOCOL_TCP);
-		address.setHost(cmdLine.serverBinOrAddress.c_str());
-		address.setPort(cmdLine.port);
+int parsePort (const string& hostAndPort, size_t portPos)
+{
+	const char*	portStr	= hostAndPort.c_str() + portPos + 1;
+	char*		end		= DE_NULL;
+	long		port;
 
-		xe::TcpIpLink* link = new xe::TcpIpLink();
-		try
-		{
-			std::string error;
+	errno	= 0;
+	port	= strtol(portStr, &end, 10);
 
-			link->connect(address);
-			return link;
-		}
-		catch (const std::exception& error)
-		{
-			delete link;
-			throw xe::Error("Failed to connect to ExecServer at: " + cmdLine.serverBinOrAddress + ":" + de::toString(cmdLine.port) + ", " + error.what());
-		}
-		catch (...)
-		{
-			delete link;
-			throw;
-		}
+	if (end == portStr || *end != 0 || errno != 0 || port < 1 || port > 65535)
+		throw xe::Error("Invalid port in '" + hostAndPort + "', expected value in range 1..65535");
+
+	return (int)port;
+}
+
+xe::CommLink* connectToServer (const string& hostAndPort, int defaultPort, bool compressLog)
+{
+	const size_t		portPos	= hostAndPort.rfind(':');
+	const string		host	= portPos != string::npos ? hostAndPort.substr(0, portPos) : hostAndPort;
+	const int			port	= portPos != string::npos ? parsePort(hostAndPort, portPos) : defaultPort;
+	de::SocketAddress	address;
+
+	address.setFamily(DE_SOCKETFAMILY_INET4);
+	address.setProtocol(DE_SOCKETPROTOCOL_TCP);
+	address.setHost(host.c_str());
+	address.setPort(port);
+
+	xe::TcpIpLink* link = new xe::TcpIpLink();
+	try
+	{
+		link->setLogCompression(compressLog);
+		link->connect(address);
+		return link;
 	}
-	else
+	catch (const std::exception& error)
 	{
-		DE_ASSERT(false);
-		return DE_NULL;
+		delete link;
+		throw xe::Error("Failed to connect to ExecServer at: " + host + ":" + de::toString(port) + ", " + error.what());
+	}
+	catch (...)
+	{
+		delete link;
+		throw;
 	}
 }
 
+typedef de::SharedPtr<xe::CommLink> CommLinkSp;
+
+void createCommLinks (vector<CommLinkSp>& dst, const CommandLine& cmdLine)
+{
+	if (cmdLine.runMode == RUNMODE_START_SERVER)
+	{
+		for (int shardNdx = 0; shardNdx < cmdLine.numShards; shardNdx++)
+			dst.push_back(CommLinkSp(startLocalServer(cmdLine.serverBin, cmdLine.port + shardNdx)));
+	}
+	else if (cmdLine.runMode == RUNMODE_CONNECT)
+	{
+		for (vector<string>::const_iterator hostIter = cmdLine.hosts.begin(); hostIter != cmdLine.hosts.end(); ++hostIter)
+			dst.push_back(CommLinkSp(connectToServer(*hostIter, cmdLine.port, cmdLine.compressLog)));
+	}
+	else
+		DE_ASSERT(false);
+}
+
 #if (DE_OS == DE_OS_UNIX) || (DE_OS == DE_OS_ANDROID)
 
-static xe::BatchExecutor* s_executor = DE_NULL;
+static xe::ShardedBatchExecutor* s_executor = DE_NULL;
 
 void signalHandler (int, siginfo_t*, void*)
 {
@@ -516,7 +617,7 @@ void signalHandler (int, siginfo_t*, void*)
 		s_executor->cancel();
 }
 
-void setupSignalHandler (xe::BatchExecutor* executor)
+void setupSignalHandler (xe::ShardedBatchExecutor* executor)
 {
 	s_executor = executor;
 	struct sigaction sa;
@@ -542,7 +643,7 @@ void resetSignalHandler (void)
 
 #elif (DE_OS == DE_OS_WIN32)
 
-static xe::BatchExecutor* s_executor = DE_NULL;
+static xe::ShardedBatchExecutor* s_executor = DE_NULL;
 
 void signalHandler (int)
 {
@@ -550,7 +651,7 @@ void signalHandler (int)
 		s_executor->cancel();
 }
 
-void setupSignalHandler (xe::BatchExecutor* executor)
+void setupSignalHandler (xe::ShardedBatchExecutor* executor)
 {
 	s_executor = executor;
 	signal(SIGINT, signalHandler);
@@ -564,7 +665,7 @@ void resetSignalHandler (void)
 
 #else
 
-void setupSignalHandler (xe::BatchExecutor*)
+void setupSignalHandler (xe::ShardedBatchExecutor*)
 {
 }
 
@@ -603,10 +704,44 @@ void runExecutor (const CommandLine& cmdLine)
 	if (!cmdLine.inFile.empty())
 		readLogFile(&batchResult, cmdLine.inFile.c_str());
 
-	// Initialize commLink.
-	std::auto_ptr<xe::CommLink> commLink(createCommLink(cmdLine));
+	// Read case history and historical durations for scheduling.
+	xe::CaseHistory		history;
+	std::set<string>	previousCases;
+
+	if (!cmdLine.historyFile.empty() && de::FilePath(cmdLine.historyFile).exists())
+		history.read(cmdLine.historyFile.c_str());
+
+	if (!cmdLine.durationFile.empty())
+	{
+		xe::BatchResult		durationResult;
+		xe::CaseDurationMap	durations;
+
+		readLogFile(&durationResult, cmdLine.durationFile.c_str());
+		xe::readCaseDurations(durations, durationResult);
+
+		for (xe::CaseDurationMap::const_iterator iter = durations.begin(); iter != durations.end(); ++iter)
+			history.setDuration(iter->first.c_str(), iter->second);
+	}
+
+	// Cases completed in continued log must not be recorded to history again.
+	for (int ndx = 0; ndx < batchResult.getNumTestCaseResults(); ndx++)
+	{
+		const xe::ConstTestCaseResultPtr data = batchResult.getTestCaseResult(ndx);
+
+		if (data->getStatusCode() != xe::TESTSTATUSCODE_PENDING && data->getStatusCode() != xe::TESTSTATUSCODE_RUNNING)
+			previousCases.insert(data->getTestCasePath());
+	}
+
+	// Initialize commLinks.
+	vector<CommLinkSp>		commLinks;
+	vector<xe::CommLink*>	commLinkPtrs;
+
+	createCommLinks(commLinks, cmdLine);
+
+	for (vector<CommLinkSp>::const_iterator linkIter = commLinks.begin(); linkIter != commLinks.end(); ++linkIter)
+		commLinkPtrs.push_back(linkIter->get());
 
-	xe::BatchExecutor executor(cmdLine.targetCfg, commLink.get(), &root, testSet, &batchResult, &infoLog);
+	xe::ShardedBatchExecutor executor(cmdLine.targetCfg, commLinkPtrs, &root, testSet, &history, &batchResult, &infoLog);
 
 	try
 	{
@@ -624,6 +759,15 @@ void runExecutor (const CommandLine& cmdLine)
 			printf("Test log written to %s\n", cmdLine.outFile.c_str());
 		}
 
+		if (!cmdLine.storeFile.empty())
+		{
+			xe::writeResultStore(batchResult, cmdLine.storeFile.c_str());
+			printf("Result store written to %s\n", cmdLine.storeFile.c_str());
+		}
+
+		if (!cmdLine.historyFile.empty())
+			writeCaseHistory(history, batchResult, previousCases, cmdLine.historyFile.c_str());
+
 		if (!cmdLine.infoFile.empty())
 		{
 			writeInfoLog(infoLog, cmdLine.infoFile.c_str());
@@ -642,6 +786,15 @@ void runExecutor (const CommandLine& cmdLine)
 		printf("Test log written to %s\n", cmdLine.outFile.c_str());
 	}
 
+	if (!cmdLine.storeFile.empty())
+	{
+		xe::writeResultStore(batchResult, cmdLine.storeFile.c_str());
+		printf("Result store written to %s\n", cmdLine.storeFile.c_str());
+	}
+
+	if (!cmdLine.historyFile.empty())
+		writeCaseHistory(history, batchResult, previousCases, cmdLine.historyFile.c_str());
+
 	if (!cmdLine.infoFile.empty())
 	{
 		writeInfoLog(infoLog, cmdLine.infoFile.c_str());
@@ -651,10 +804,11 @@ void runExecutor (const CommandLine& cmdLine)
 	if (cmdLine.summary)
 		printBatchResultSummary(&root, testSet, batchResult);
 
+	for (vector<CommLinkSp>::const_iterator linkIter = commLinks.begin(); linkIter != commLinks.end(); ++linkIter)
 	{
 		string err;
 
-		if (commLink->getState(err) == xe::COMMLINKSTATE_ERROR)
+		if ((*linkIter)->getState(err) == xe::COMMLINKSTATE_ERROR)
 			throw xe::Error(err);
 	}
 }
@@ -23,6 +23,7 @@
 
 #include "xeTestLogParser.hpp"
 #include "xeTestResultParser.hpp"
+#include "xeResultStore.hpp"
 #include "deFilePath.hpp"
 #include "deString.h"
 
@@ -195,8 +196,15 @@ private:
 
 static void readLogFile (BatchResultValues& batchResult, const char* filename)
 {
+	TagParser resultHandler (batchResult);
+
+	if (xe::isResultStoreFile(filename))
+	{
+		xe::ResultStore(filename).replay(resultHandler);
+		return;
+	}
+
 	std::ifstream		in				(filename, std::ifstream::binary|std::ifstream::in);
-	TagParser			resultHandler	(batchResult);
 	xe::TestLogParser	parser			(&resultHandler);
 	deUint8				buf				[1024];
 	int					numRead			= 0;
@@ -253,7 +261,7 @@ static void printTaggedValues (const CommandLine& cmdLine, std::ostream& dst)
 
 static void printHelp (const char* binName)
 {
-	printf("%s: [filename] [name 1] [[name 2]...]\n", binName);
+	printf("%s: [testlog or result store] [name 1] [[name 2]...]\n", binName);
 	printf(" --statuscode     Include status code as first entry.\n");
 }
 
@@ -20,16 +20,25 @@
  * \file
  * \brief Merge two test logs.
  *
- * \todo [2013-11-08 pyry] Write variant that can operate with less memory.
+ * Logs are merged in two passes. First all input files are indexed in
+ * parallel: only session info, case paths and the location of each case
+ * block in the file are kept in memory. Then the final case list is
+ * resolved and case blocks are copied from the input files to the output
+ * as-is, so memory use doesn't depend on the size of the case logs.
  *//*--------------------------------------------------------------------*/
 
+#include "xeContainerFormatParser.hpp"
 #include "xeTestLogParser.hpp"
-#include "xeTestResultParser.hpp"
 #include "xeTestLogWriter.hpp"
 #include "deString.h"
+#include "deThread.h"
+#include "deAtomic.h"
+#include "deThread.hpp"
+#include "deSharedPtr.hpp"
 
 #include <vector>
 #include <string>
+#include <map>
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
@@ -38,7 +47,6 @@
 
 using std::vector;
 using std::string;
-using std::set;
 using std::map;
 
 enum Flags
@@ -46,6 +54,11 @@ enum Flags
 	FLAG_USE_LAST_INFO = (1<<0)
 };
 
+enum
+{
+	READ_BUFFER_SIZE	= 64*1024
+};
+
 struct CommandLine
 {
 	CommandLine (void)
@@ -58,104 +71,335 @@ struct CommandLine
 	deUint32		flags;
 };
 
-class LogHandler : public xe::TestLogHandler
+struct CaseBlock
+{
+	string			casePath;
+	deUint64		offset;			//!< Offset of #beginTestCaseResult line in file.
+	deUint64		size;			//!< Size of block, including #endTestCaseResult or #terminateTestCaseResult line if present.
+	bool			isComplete;		//!< Block ends with #endTestCaseResult or #terminateTestCaseResult.
+	bool			endsInNewline;
+
+	CaseBlock (void)
+		: offset		(0)
+		, size			(0)
+		, isComplete	(false)
+		, endsInNewline	(true)
+	{
+	}
+};
+
+struct LogIndex
+{
+	string				filename;
+	xe::SessionInfo		sessionInfo;
+	vector<CaseBlock>	cases;
+};
+
+class LogIndexBuilder
 {
 public:
-	LogHandler (xe::BatchResult* batchResult, deUint32 flags)
-		: m_batchResult	(batchResult)
-		, m_flags		(flags)
+	LogIndexBuilder (LogIndex& index)
+		: m_index		(index)
+		, m_curCase		(DE_NULL)
 	{
 	}
 
-	void setSessionInfo (const xe::SessionInfo& info)
+	void indexFile (void)
 	{
-		xe::SessionInfo& combinedInfo = m_batchResult->getSessionInfo();
+		std::ifstream		in			(m_index.filename.c_str(), std::ifstream::binary|std::ifstream::in);
+		vector<deUint8>		buf			(READ_BUFFER_SIZE);
+		deUint64			numTotal	= 0;
+
+		if (!in.good())
+			throw std::runtime_error(string("Failed to open '") + m_index.filename + "'");
 
-		if (m_flags & FLAG_USE_LAST_INFO)
+		for (;;)
 		{
-			if (!info.targetName.empty())		combinedInfo.targetName			= info.targetName;
-			if (!info.releaseId.empty())		combinedInfo.releaseId			= info.releaseId;
-			if (!info.releaseName.empty())		combinedInfo.releaseName		= info.releaseName;
-			if (!info.candyTargetName.empty())	combinedInfo.candyTargetName	= info.candyTargetName;
-			if (!info.configName.empty())		combinedInfo.configName			= info.configName;
-			if (!info.resultName.empty())		combinedInfo.resultName			= info.resultName;
-			if (!info.timestamp.empty())		combinedInfo.timestamp			= info.timestamp;
+			in.read((char*)&buf[0], (std::streamsize)buf.size());
+
+			const int numRead = (int)in.gcount();
+
+			if (numRead <= 0)
+				break;
+
+			m_parser.feed(&buf[0], numRead);
+			numTotal += (deUint64)numRead;
+
+			processElements();
 		}
-		else
+
+		// Case that is still open at the end of file covers rest of the file.
+		if (m_curCase)
+			endCase(numTotal, false);
+	}
+
+private:
+	void processElements (void)
+	{
+		for (;;)
 		{
-			if (combinedInfo.targetName.empty())		combinedInfo.targetName			= info.targetName;
-			if (combinedInfo.releaseId.empty())			combinedInfo.releaseId			= info.releaseId;
-			if (combinedInfo.releaseName.empty())		combinedInfo.releaseName		= info.releaseName;
-			if (combinedInfo.candyTargetName.empty())	combinedInfo.candyTargetName	= info.candyTargetName;
-			if (combinedInfo.configName.empty())		combinedInfo.configName			= info.configName;
-			if (combinedInfo.resultName.empty())		combinedInfo.resultName			= info.resultName;
-			if (combinedInfo.timestamp.empty())			combinedInfo.timestamp			= info.timestamp;
+			const xe::ContainerElement	element	= m_parser.getElement();
+			const deUint64				offset	= m_parser.getElementOffset();
+
+			if (element == xe::CONTAINERELEMENT_INCOMPLETE)
+				break;
+
+			switch (element)
+			{
+				case xe::CONTAINERELEMENT_SESSION_INFO:
+					xe::setSessionInfoAttribute(m_index.sessionInfo, m_parser.getSessionInfoAttribute(), m_parser.getSessionInfoValue());
+					break;
+
+				case xe::CONTAINERELEMENT_BEGIN_TEST_CASE_RESULT:
+				{
+					if (m_curCase)
+						endCase(offset, false);
+
+					m_index.cases.push_back(CaseBlock());
+					m_curCase			= &m_index.cases.back();
+					m_curCase->casePath	= m_parser.getTestCasePath();
+					m_curCase->offset	= offset;
+					break;
+				}
+
+				case xe::CONTAINERELEMENT_END_TEST_CASE_RESULT:
+				case xe::CONTAINERELEMENT_TERMINATE_TEST_CASE_RESULT:
+					if (m_curCase)
+						endCase(offset + (deUint64)m_parser.getElementSize(), true);
+					break;
+
+				case xe::CONTAINERELEMENT_TEST_LOG_DATA:
+					if (m_curCase)
+					{
+						deUint8 lastChar = 0;
+						m_parser.getData(&lastChar, 1, m_parser.getDataSize()-1);
+						m_curCase->endsInNewline = lastChar == '\n' || lastChar == '\r';
+					}
+					break;
+
+				case xe::CONTAINERELEMENT_BEGIN_SESSION:
+				case xe::CONTAINERELEMENT_END_SESSION:
+				case xe::CONTAINERELEMENT_END_OF_STRING:
+					if (m_curCase)
+						endCase(offset, false);
+					break;
+
+				default:
+					throw xe::ContainerParseError("Unknown container element");
+			}
+
+			m_parser.advance();
 		}
 	}
 
-	xe::TestCaseResultPtr startTestCaseResult (const char* casePath)
+	void endCase (deUint64 endOffset, bool isComplete)
+	{
+		DE_ASSERT(m_curCase && endOffset >= m_curCase->offset);
+
+		m_curCase->size			= endOffset - m_curCase->offset;
+		m_curCase->isComplete	= isComplete;
+		m_curCase				= DE_NULL;
+	}
+
+	LogIndex&					m_index;
+	xe::ContainerFormatParser	m_parser;
+	CaseBlock*					m_curCase;
+};
+
+class LogIndexThread : public de::Thread
+{
+public:
+	LogIndexThread (vector<LogIndex>& indices, volatile deInt32* nextNdx)
+		: m_indices	(indices)
+		, m_nextNdx	(nextNdx)
+	{
+	}
+
+	void run (void)
 	{
-		if (m_batchResult->hasTestCaseResult(casePath))
+		try
 		{
-			xe::TestCaseResultPtr existingResult = m_batchResult->getTestCaseResult(casePath);
-			existingResult->clear();
-			return existingResult;
+			for (;;)
+			{
+				const int ndx = deAtomicIncrementInt32(m_nextNdx) - 1;
+
+				if (ndx >= (int)m_indices.size())
+					break;
+
+				LogIndexBuilder(m_indices[ndx]).indexFile();
+			}
 		}
-		else
-			return m_batchResult->createTestCaseResult(casePath);
+		catch (const std::exception& e)
+		{
+			m_error = e.what();
+		}
+	}
+
+	const string& getError (void) const { return m_error; }
+
+private:
+	vector<LogIndex>&	m_indices;
+	volatile deInt32*	m_nextNdx;
+	string				m_error;
+};
+
+static void indexLogFiles (vector<LogIndex>& indices)
+{
+	const int										numThreads	= de::min((int)indices.size(), (int)deGetNumAvailableLogicalCores());
+	volatile deInt32								nextNdx		= 0;
+	vector<de::SharedPtr<LogIndexThread> >			threads;
+
+	for (int ndx = 0; ndx < numThreads; ndx++)
+	{
+		threads.push_back(de::SharedPtr<LogIndexThread>(new LogIndexThread(indices, &nextNdx)));
+		threads.back()->start();
 	}
 
-	void testCaseResultUpdated (const xe::TestCaseResultPtr&)
+	for (int ndx = 0; ndx < numThreads; ndx++)
+		threads[ndx]->join();
+
+	for (int ndx = 0; ndx < numThreads; ndx++)
 	{
-		// Ignored.
+		if (!threads[ndx]->getError().empty())
+			throw std::runtime_error(threads[ndx]->getError());
 	}
+}
 
-	void testCaseResultComplete (const xe::TestCaseResultPtr&)
+static void mergeSessionInfo (xe::SessionInfo& combinedInfo, const xe::SessionInfo& info, deUint32 flags)
+{
+	if (flags & FLAG_USE_LAST_INFO)
 	{
-		// Ignored.
+		if (!info.targetName.empty())		combinedInfo.targetName			= info.targetName;
+		if (!info.releaseId.empty())		combinedInfo.releaseId			= info.releaseId;
+		if (!info.releaseName.empty())		combinedInfo.releaseName		= info.releaseName;
+		if (!info.candyTargetName.empty())	combinedInfo.candyTargetName	= info.candyTargetName;
+		if (!info.configName.empty())		combinedInfo.configName			= info.configName;
+		if (!info.resultName.empty())		combinedInfo.resultName			= info.resultName;
+		if (!info.timestamp.empty())		combinedInfo.timestamp			= info.timestamp;
 	}
+	else
+	{
+		if (combinedInfo.targetName.empty())		combinedInfo.targetName			= info.targetName;
+		if (combinedInfo.releaseId.empty())			combinedInfo.releaseId			= info.releaseId;
+		if (combinedInfo.releaseName.empty())		combinedInfo.releaseName		= info.releaseName;
+		if (combinedInfo.candyTargetName.empty())	combinedInfo.candyTargetName	= info.candyTargetName;
+		if (combinedInfo.configName.empty())		combinedInfo.configName			= info.configName;
+		if (combinedInfo.resultName.empty())		combinedInfo.resultName			= info.resultName;
+		if (combinedInfo.timestamp.empty())			combinedInfo.timestamp			= info.timestamp;
+	}
+}
 
-private:
-	xe::BatchResult* const	m_batchResult;
-	const deUint32			m_flags;
+struct CaseRef
+{
+	int		fileNdx;
+	int		caseNdx;
+
+	CaseRef (int fileNdx_, int caseNdx_) : fileNdx(fileNdx_), caseNdx(caseNdx_) {}
 };
 
-static void readLogFile (xe::BatchResult* dstResult, const char* filename, deUint32 flags)
+//! Cases are listed in order of first appearance. Later results of the same case replace earlier ones.
+static void resolveCaseList (vector<CaseRef>& caseList, const vector<LogIndex>& indices)
 {
-	std::ifstream		in				(filename, std::ifstream::binary|std::ifstream::in);
-	LogHandler			resultHandler	(dstResult, flags);
-	xe::TestLogParser	parser			(&resultHandler);
-	deUint8				buf				[2048];
-	int					numRead			= 0;
+	map<string, int> caseMap;
+
+	for (int fileNdx = 0; fileNdx < (int)indices.size(); fileNdx++)
+	{
+		const vector<CaseBlock>& cases = indices[fileNdx].cases;
+
+		for (int caseNdx = 0; caseNdx < (int)cases.size(); caseNdx++)
+		{
+			const map<string, int>::iterator pos = caseMap.find(cases[caseNdx].casePath);
 
-	if (!in.good())
-		throw std::runtime_error(string("Failed to open '") + filename + "'");
+			if (pos != caseMap.end())
+				caseList[pos->second] = CaseRef(fileNdx, caseNdx);
+			else
+			{
+				caseMap[cases[caseNdx].casePath] = (int)caseList.size();
+				caseList.push_back(CaseRef(fileNdx, caseNdx));
+			}
+		}
+	}
+}
 
-	for (;;)
+static void copyCaseBlock (std::ostream& dst, std::istream& src, const CaseBlock& block, vector<deUint8>& buf)
+{
+	deUint64 numLeft = block.size;
+
+	src.clear();
+	src.seekg((std::streamoff)block.offset);
+
+	while (numLeft > 0)
+	{
+		const std::streamsize numToRead = (std::streamsize)de::min<deUint64>(numLeft, (deUint64)buf.size());
+
+		src.read((char*)&buf[0], numToRead);
+
+		if (src.gcount() != numToRead)
+			throw std::runtime_error("Failed to read test case '" + block.casePath + "'");
+
+		dst.write((const char*)&buf[0], numToRead);
+		numLeft -= (deUint64)numToRead;
+	}
+
+	// \note Case that has been cut short is written as if it had finished normally, as in previous result writer.
+	if (!block.isComplete)
+	{
+		if (!block.endsInNewline)
+			dst << "\n";
+		dst << "#endTestCaseResult\n";
+	}
+}
+
+static void writeMergedLog (std::ostream& dst, const vector<LogIndex>& indices, deUint32 flags)
+{
+	xe::SessionInfo									sessionInfo;
+	vector<CaseRef>									caseList;
+	vector<de::SharedPtr<std::ifstream> >			srcFiles;
+	vector<deUint8>									buf			(READ_BUFFER_SIZE);
+
+	for (vector<LogIndex>::const_iterator index = indices.begin(); index != indices.end(); ++index)
 	{
-		in.read((char*)&buf[0], DE_LENGTH_OF_ARRAY(buf));
-		numRead = (int)in.gcount();
+		mergeSessionInfo(sessionInfo, index->sessionInfo, flags);
+		srcFiles.push_back(de::SharedPtr<std::ifstream>(new std::ifstream(index->filename.c_str(), std::ifstream::binary|std::ifstream::in)));
+
+		if (!srcFiles.back()->good())
+			throw std::runtime_error("Failed to open '" + index->filename + "'");
+	}
+
+	resolveCaseList(caseList, indices);
 
-		if (numRead <= 0)
-			break;
+	xe::writeSessionInfo(sessionInfo, dst);
+	dst << "#beginSession\n";
 
-		parser.parse(&buf[0], numRead);
+	for (vector<CaseRef>::const_iterator caseRef = caseList.begin(); caseRef != caseList.end(); ++caseRef)
+	{
+		dst << "\n";
+		copyCaseBlock(dst, *srcFiles[caseRef->fileNdx], indices[caseRef->fileNdx].cases[caseRef->caseNdx], buf);
 	}
 
-	in.close();
+	dst << "\n#endSession\n";
 }
 
 static void mergeTestLogs (const CommandLine& cmdLine)
 {
-	xe::BatchResult batchResult;
+	vector<LogIndex> indices (cmdLine.srcFilenames.size());
+
+	for (int ndx = 0; ndx < (int)indices.size(); ndx++)
+		indices[ndx].filename = cmdLine.srcFilenames[ndx];
 
-	for (vector<string>::const_iterator filename = cmdLine.srcFilenames.begin(); filename != cmdLine.srcFilenames.end(); ++filename)
-		readLogFile(&batchResult, filename->c_str(), cmdLine.flags);
+	indexLogFiles(indices);
 
 	if (!cmdLine.dstFilename.empty())
-		xe::writeBatchResultToFile(batchResult, cmdLine.dstFilename.c_str());
+	{
+		std::ofstream out (cmdLine.dstFilename.c_str(), std::ofstream::binary|std::ofstream::trunc);
+
+		if (!out.good())
+			throw std::runtime_error("Failed to open '" + cmdLine.dstFilename + "'");
+
+		writeMergedLog(out, indices, cmdLine.flags);
+	}
 	else
-		xe::writeTestLog(batchResult, std::cout);
+		writeMergedLog(std::cout, indices, cmdLine.flags);
 }
 
 static void printHelp (const char* binName)
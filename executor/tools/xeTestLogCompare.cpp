@@ -19,13 +19,20 @@
  *//*!
  * \file
  * \brief Test log compare utility.
+ *
+ * Only result headers (case path, status code and details) are kept in
+ * memory. Case logs are parsed one at a time as they are read.
  *//*--------------------------------------------------------------------*/
 
 #include "xeTestLogParser.hpp"
 #include "xeTestResultParser.hpp"
+#include "xeResultStore.hpp"
 #include "deFilePath.hpp"
 #include "deString.h"
 #include "deThread.hpp"
+#include "deThread.h"
+#include "deAtomic.h"
+#include "deSharedPtr.hpp"
 #include "deCommandLine.hpp"
 
 #include <vector>
@@ -34,12 +41,10 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
-#include <set>
 #include <map>
 
 using std::vector;
 using std::string;
-using std::set;
 using std::map;
 
 enum OutputMode
@@ -116,10 +121,15 @@ struct CommandLine
 	vector<string>		filenames;
 };
 
+enum
+{
+	READ_BUFFER_SIZE	= 64*1024
+};
+
 struct ShortBatchResult
 {
+	string								filename;
 	vector<xe::TestCaseResultHeader>	resultHeaders;
-	map<string, int>					resultMap;
 };
 
 class ShortResultHandler : public xe::TestLogHandler
@@ -148,7 +158,6 @@ public:
 	void testCaseResultComplete (const xe::TestCaseResultPtr& caseData)
 	{
 		xe::TestCaseResultHeader	header;
-		int							caseNdx	= (int)m_result.resultHeaders.size();
 
 		header.casePath			= caseData->getTestCasePath();
 		header.caseType			= xe::TESTCASETYPE_SELF_VALIDATE;
@@ -164,9 +173,7 @@ public:
 			header = xe::TestCaseResultHeader(fullResult);
 		}
 
-		// Insert into result list & map.
 		m_result.resultHeaders.push_back(header);
-		m_result.resultMap[header.casePath] = caseNdx;
 	}
 
 private:
@@ -174,17 +181,48 @@ private:
 	xe::TestResultParser	m_testResultParser;
 };
 
-static void readLogFile (ShortBatchResult& batchResult, const char* filename)
+static void readResultStore (ShortBatchResult& batchResult)
+{
+	const xe::ResultStore store (batchResult.filename.c_str());
+
+	batchResult.resultHeaders.reserve(store.getNumCases());
+
+	for (int caseNdx = 0; caseNdx < store.getNumCases(); caseNdx++)
+	{
+		if (!store.isComplete(caseNdx))
+			continue;
+
+		batchResult.resultHeaders.push_back(xe::TestCaseResultHeader());
+
+		xe::TestCaseResultHeader& header = batchResult.resultHeaders.back();
+
+		header.casePath			= store.getCasePath(caseNdx);
+		header.caseType			= store.getCaseType(caseNdx);
+		header.statusCode		= store.getStatusCode(caseNdx);
+		header.statusDetails	= store.getStatusDetails(caseNdx);
+	}
+}
+
+static void readLogFile (ShortBatchResult& batchResult)
 {
-	std::ifstream		in				(filename, std::ifstream::binary|std::ifstream::in);
+	if (xe::isResultStoreFile(batchResult.filename.c_str()))
+	{
+		readResultStore(batchResult);
+		return;
+	}
+
+	std::ifstream		in				(batchResult.filename.c_str(), std::ifstream::binary|std::ifstream::in);
 	ShortResultHandler	resultHandler	(batchResult);
 	xe::TestLogParser	parser			(&resultHandler);
-	deUint8				buf				[1024];
+	vector<deUint8>		buf				(READ_BUFFER_SIZE);
 	int					numRead			= 0;
 
+	if (!in.good())
+		throw std::runtime_error("Failed to open '" + batchResult.filename + "'");
+
 	for (;;)
 	{
-		in.read((char*)&buf[0], DE_LENGTH_OF_ARRAY(buf));
+		in.read((char*)&buf[0], (std::streamsize)buf.size());
 		numRead = (int)in.gcount();
 
 		if (numRead <= 0)
@@ -199,54 +237,118 @@ static void readLogFile (ShortBatchResult& batchResult, const char* filename)
 class LogFileReader : public de::Thread
 {
 public:
-	LogFileReader (ShortBatchResult& batchResult, const char* filename)
-		: m_batchResult	(batchResult)
-		, m_filename	(filename)
+	LogFileReader (vector<ShortBatchResult>& batchResults, volatile deInt32* nextNdx)
+		: m_batchResults	(batchResults)
+		, m_nextNdx			(nextNdx)
 	{
 	}
 
 	void run (void)
 	{
-		readLogFile(m_batchResult, m_filename.c_str());
+		try
+		{
+			for (;;)
+			{
+				const int ndx = deAtomicIncrementInt32(m_nextNdx) - 1;
+
+				if (ndx >= (int)m_batchResults.size())
+					break;
+
+				readLogFile(m_batchResults[ndx]);
+			}
+		}
+		catch (const std::exception& e)
+		{
+			m_error = e.what();
+		}
 	}
 
+	const string& getError (void) const { return m_error; }
+
 private:
-	ShortBatchResult&	m_batchResult;
-	std::string			m_filename;
+	vector<ShortBatchResult>&	m_batchResults;
+	volatile deInt32*			m_nextNdx;
+	string						m_error;
+};
+
+//! Read logs in parallel, using at most one thread per core.
+static void readLogFiles (vector<ShortBatchResult>& batchResults)
+{
+	const int								numThreads	= de::min((int)batchResults.size(), (int)deGetNumAvailableLogicalCores());
+	volatile deInt32						nextNdx		= 0;
+	vector<de::SharedPtr<LogFileReader> >	readers;
+
+	for (int ndx = 0; ndx < numThreads; ndx++)
+	{
+		readers.push_back(de::SharedPtr<LogFileReader>(new LogFileReader(batchResults, &nextNdx)));
+		readers.back()->start();
+	}
+
+	for (int ndx = 0; ndx < numThreads; ndx++)
+		readers[ndx]->join();
+
+	for (int ndx = 0; ndx < numThreads; ndx++)
+	{
+		if (!readers[ndx]->getError().empty())
+			throw std::runtime_error(readers[ndx]->getError());
+	}
+}
+
+//! Unified case list. Rows are in order of first appearance, resultNdx[batchNdx][rowNdx] is index to batch result headers or -1 if missing.
+struct CaseList
+{
+	vector<string>			cases;
+	vector<vector<int> >	resultNdx;
 };
 
-static void computeCaseList (vector<string>& cases, const vector<ShortBatchResult>& batchResults)
+static void computeCaseList (CaseList& caseList, const vector<ShortBatchResult>& batchResults)
 {
 	// \todo [2012-07-10 pyry] Do proper case ordering (eg. handle missing cases nicely).
-	set<string> addedCases;
+	map<string, int> caseRows;
 
-	for (vector<ShortBatchResult>::const_iterator batchIter = batchResults.begin(); batchIter != batchResults.end(); batchIter++)
+	caseList.resultNdx.resize(batchResults.size());
+
+	for (int batchNdx = 0; batchNdx < (int)batchResults.size(); batchNdx++)
 	{
-		for (vector<xe::TestCaseResultHeader>::const_iterator caseIter = batchIter->resultHeaders.begin(); caseIter != batchIter->resultHeaders.end(); caseIter++)
+		const vector<xe::TestCaseResultHeader>& headers = batchResults[batchNdx].resultHeaders;
+
+		for (int headerNdx = 0; headerNdx < (int)headers.size(); headerNdx++)
 		{
-			if (addedCases.find(caseIter->casePath) == addedCases.end())
+			const map<string, int>::const_iterator	pos		= caseRows.find(headers[headerNdx].casePath);
+			int										rowNdx	= 0;
+
+			if (pos == caseRows.end())
 			{
-				cases.push_back(caseIter->casePath);
-				addedCases.insert(caseIter->casePath);
+				rowNdx = (int)caseList.cases.size();
+				caseRows[headers[headerNdx].casePath] = rowNdx;
+				caseList.cases.push_back(headers[headerNdx].casePath);
 			}
+			else
+				rowNdx = pos->second;
+
+			// \note Last result wins if same case appears multiple times.
+			vector<int>& batchRows = caseList.resultNdx[batchNdx];
+			if ((int)batchRows.size() <= rowNdx)
+				batchRows.resize(rowNdx+1, -1);
+			batchRows[rowNdx] = headerNdx;
 		}
 	}
 }
 
-static void getTestResultHeaders (vector<xe::TestCaseResultHeader>& headers, const vector<ShortBatchResult>& batchResults, const char* casePath)
+static void getTestResultHeaders (vector<xe::TestCaseResultHeader>& headers, const vector<ShortBatchResult>& batchResults, const CaseList& caseList, int rowNdx)
 {
 	headers.resize(batchResults.size());
 
 	for (int ndx = 0; ndx < (int)batchResults.size(); ndx++)
 	{
-		const ShortBatchResult&				batchResult	= batchResults[ndx];
-		map<string, int>::const_iterator	resultPos	= batchResult.resultMap.find(casePath);
+		const vector<int>&	batchRows	= caseList.resultNdx[ndx];
+		const int			headerNdx	= rowNdx < (int)batchRows.size() ? batchRows[rowNdx] : -1;
 
-		if (resultPos != batchResult.resultMap.end())
-			headers[ndx] = batchResult.resultHeaders[resultPos->second];
+		if (headerNdx >= 0)
+			headers[ndx] = batchResults[ndx].resultHeaders[headerNdx];
 		else
 		{
-			headers[ndx].casePath	= casePath;
+			headers[ndx].casePath	= caseList.cases[rowNdx];
 			headers[ndx].caseType	= xe::TESTCASETYPE_SELF_VALIDATE;
 			headers[ndx].statusCode	= xe::TESTSTATUSCODE_LAST;
 		}
@@ -273,30 +375,23 @@ static bool runCompare (const CommandLine& cmdLine, std::ostream& dst)
 	{
 		// Read in batch results
 		results.resize(cmdLine.filenames.size());
-		{
-			std::vector<de::SharedPtr<LogFileReader> > readers;
 
-			for (int ndx = 0; ndx < (int)cmdLine.filenames.size(); ndx++)
-			{
-				readers.push_back(de::SharedPtr<LogFileReader>(new LogFileReader(results[ndx], cmdLine.filenames[ndx].c_str())));
-				readers.back()->start();
-			}
-
-			for (int ndx = 0; ndx < (int)cmdLine.filenames.size(); ndx++)
-			{
-				readers[ndx]->join();
+		for (int ndx = 0; ndx < (int)cmdLine.filenames.size(); ndx++)
+		{
+			results[ndx].filename = cmdLine.filenames[ndx];
 
-				// Use file name as batch name.
-				batchNames.push_back(de::FilePath(cmdLine.filenames[ndx].c_str()).getBaseName());
-			}
+			// Use file name as batch name.
+			batchNames.push_back(de::FilePath(cmdLine.filenames[ndx].c_str()).getBaseName());
 		}
 
+		readLogFiles(results);
+
 		// Compute unified case list.
-		vector<string> caseList;
+		CaseList caseList;
 		computeCaseList(caseList, results);
 
 		// Stats.
-		int		numCases		= (int)caseList.size();
+		int		numCases		= (int)caseList.cases.size();
 		int		numEqual		= 0;
 
 		if (cmdLine.outFormat == OUTPUTFORMAT_CSV)
@@ -308,13 +403,13 @@ static bool runCompare (const CommandLine& cmdLine, std::ostream& dst)
 		}
 
 		// Compare cases.
-		for (vector<string>::const_iterator caseIter = caseList.begin(); caseIter != caseList.end(); caseIter++)
+		for (int rowNdx = 0; rowNdx < numCases; rowNdx++)
 		{
-			const string&						caseName	= *caseIter;
+			const string&						caseName	= caseList.cases[rowNdx];
 			vector<xe::TestCaseResultHeader>	headers;
 			bool								allEqual	= true;
 
-			getTestResultHeaders(headers, results, caseName.c_str());
+			getTestResultHeaders(headers, results, caseList, rowNdx);
 
 			for (vector<xe::TestCaseResultHeader>::const_iterator iter = headers.begin()+1; iter != headers.end(); iter++)
 			{
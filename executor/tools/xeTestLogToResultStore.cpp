@@ -0,0 +1,115 @@
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Test Executor
+ * ------------------------------------------
+ *
+ * Copyright 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Test log to result store conversion tool.
+ *//*--------------------------------------------------------------------*/
+
+#include "xeTestLogParser.hpp"
+#include "xeResultStore.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+using std::string;
+
+class BatchResultHandler : public xe::TestLogHandler
+{
+public:
+	BatchResultHandler (xe::BatchResult& batchResult)
+		: m_batchResult(batchResult)
+	{
+	}
+
+	void setSessionInfo (const xe::SessionInfo& sessionInfo)
+	{
+		m_batchResult.getSessionInfo() = sessionInfo;
+	}
+
+	xe::TestCaseResultPtr startTestCaseResult (const char* casePath)
+	{
+		// \note TestLogParser clears old data, last result wins if case appears multiple times.
+		if (m_batchResult.hasTestCaseResult(casePath))
+			return m_batchResult.getTestCaseResult(casePath);
+		else
+			return m_batchResult.createTestCaseResult(casePath);
+	}
+
+	void testCaseResultUpdated (const xe::TestCaseResultPtr&)
+	{
+	}
+
+	void testCaseResultComplete (const xe::TestCaseResultPtr&)
+	{
+	}
+
+private:
+	xe::BatchResult& m_batchResult;
+};
+
+static void readLogFile (xe::BatchResult& batchResult, const char* filename)
+{
+	std::ifstream		in		(filename, std::ifstream::binary|std::ifstream::in);
+	BatchResultHandler	handler	(batchResult);
+	xe::TestLogParser	parser	(&handler);
+	deUint8				buf		[64*1024];
+	int					numRead	= 0;
+
+	if (!in.good())
+		throw std::runtime_error(string("Failed to open '") + filename + "'");
+
+	for (;;)
+	{
+		in.read((char*)&buf[0], DE_LENGTH_OF_ARRAY(buf));
+		numRead = (int)in.gcount();
+
+		if (numRead <= 0)
+			break;
+
+		parser.parse(&buf[0], numRead);
+	}
+
+	in.close();
+}
+
+int main (int argc, const char* const* argv)
+{
+	if (argc != 3)
+	{
+		printf("%s: [testlog] [result store]\n", argv[0]);
+		return -1;
+	}
+
+	try
+	{
+		xe::BatchResult batchResult;
+
+		readLogFile(batchResult, argv[1]);
+		xe::writeResultStore(batchResult, argv[2]);
+	}
+	catch (const std::exception& e)
+	{
+		printf("%s\n", e.what());
+		return -1;
+	}
+
+	return 0;
+}
@@ -76,7 +76,21 @@ static void computeExecuteSet (TestSet& executeSet, const TestNode* root, const
 	}
 }
 
-static void computeBatchRequest (TestSet& requestSet, const TestSet& executeSet, const TestNode* root, int maxCasesInSet)
+static void computeIsolatedSet (TestSet& isolatedSet, const TestNode* root, const TestSet& executeSet, const CaseHistory* history)
+{
+	if (!history)
+		return;
+
+	for (ConstTestNodeIterator iter = ConstTestNodeIterator::begin(root); iter != ConstTestNodeIterator::end(root); ++iter)
+	{
+		const TestNode* node = *iter;
+
+		if (node->getNodeType() == TESTNODETYPE_TEST_CASE && executeSet.hasNode(node) && history->isCrashProne(node->getFullPath().c_str()))
+			isolatedSet.addCase(static_cast<const TestCase*>(node));
+	}
+}
+
+static void computeBatchRequest (TestSet& requestSet, const TestSet& executeSet, const TestSet& isolatedSet, const TestNode* root, int maxCasesInSet)
 {
 	ConstTestNodeIterator	iter		= ConstTestNodeIterator::begin(root);
 	ConstTestNodeIterator	end			= ConstTestNodeIterator::end(root);
@@ -86,13 +100,43 @@ static void computeBatchRequest (TestSet& requestSet, const TestSet& executeSet,
 	{
 		const TestNode* node = *iter;
 
-		if (node->getNodeType() == TESTNODETYPE_TEST_CASE && executeSet.hasNode(node))
+		if (node->getNodeType() == TESTNODETYPE_TEST_CASE && executeSet.hasNode(node) && !isolatedSet.hasNode(node))
 		{
 			const TestCase* testCase = static_cast<const TestCase*>(node);
 			requestSet.addCase(testCase);
 			numCases += 1;
 		}
 	}
+
+	// Crash-prone cases are run last, one per test process, so that a crash doesn't cost results of other cases.
+	if (numCases == 0)
+	{
+		for (iter = ConstTestNodeIterator::begin(root); iter != end; ++iter)
+		{
+			const TestNode* node = *iter;
+
+			if (node->getNodeType() == TESTNODETYPE_TEST_CASE && executeSet.hasNode(node))
+			{
+				requestSet.addCase(static_cast<const TestCase*>(node));
+				break;
+			}
+		}
+	}
+}
+
+static string formatDuration (deInt64 microseconds)
+{
+	const deInt64		seconds	= microseconds / 1000000;
+	std::ostringstream	str;
+
+	if (seconds >= 3600)
+		str << (seconds / 3600) << "h " << ((seconds / 60) % 60) << "m";
+	else if (seconds >= 60)
+		str << (seconds / 60) << "m " << (seconds % 60) << "s";
+	else
+		str << seconds << "s";
+
+	return str.str();
 }
 
 static int removeExecuted (TestSet& set, const TestNode* root, const BatchResult* batchResult)
@@ -121,8 +165,10 @@ static int removeExecuted (TestSet& set, const TestNode* root, const BatchResult
 	return numRemoved;
 }
 
-BatchExecutorLogHandler::BatchExecutorLogHandler (BatchResult* batchResult)
-	: m_batchResult(batchResult)
+BatchExecutorLogHandler::BatchExecutorLogHandler (BatchResult* batchResult, const CaseHistory* history)
+	: m_batchResult			(batchResult)
+	, m_history				(history)
+	, m_remainingDuration	(0)
 {
 }
 
@@ -130,6 +176,31 @@ BatchExecutorLogHandler::~BatchExecutorLogHandler (void)
 {
 }
 
+void BatchExecutorLogHandler::setPendingCases (const TestNode* root, const TestSet& pendingCases)
+{
+	m_pendingDurations.clear();
+	m_remainingDuration = 0;
+
+	if (!m_history || !m_history->hasDurations())
+		return;
+
+	for (ConstTestNodeIterator iter = ConstTestNodeIterator::begin(root); iter != ConstTestNodeIterator::end(root); ++iter)
+	{
+		const TestNode* node = *iter;
+
+		if (node->getNodeType() == TESTNODETYPE_TEST_CASE && pendingCases.hasNode(node))
+		{
+			const string	fullPath	= node->getFullPath();
+			const deInt64	duration	= m_history->getExpectedDuration(fullPath.c_str());
+
+			m_pendingDurations[fullPath]	 = duration;
+			m_remainingDuration				+= duration;
+		}
+	}
+
+	printf("Predicted execution time for %d cases: %s\n", (int)m_pendingDurations.size(), formatDuration(m_remainingDuration).c_str());
+}
+
 void BatchExecutorLogHandler::setSessionInfo (const SessionInfo& sessionInfo)
 {
 	m_batchResult->getSessionInfo() = sessionInfo;
@@ -151,15 +222,26 @@ void BatchExecutorLogHandler::testCaseResultUpdated (const TestCaseResultPtr&)
 void BatchExecutorLogHandler::testCaseResultComplete (const TestCaseResultPtr& result)
 {
 	// \todo [2012-11-01 pyry] Remove from execute set here instead of updating it between sessions.
-	printf("%s\n", result->getTestCasePath());
+	const std::map<string, deInt64>::iterator pos = m_pendingDurations.find(result->getTestCasePath());
+
+	if (pos != m_pendingDurations.end())
+	{
+		m_remainingDuration -= pos->second;
+		m_pendingDurations.erase(pos);
+
+		printf("%s (%d cases left, ~%s)\n", result->getTestCasePath(), (int)m_pendingDurations.size(), formatDuration(m_remainingDuration).c_str());
+	}
+	else
+		printf("%s\n", result->getTestCasePath());
 }
 
-BatchExecutor::BatchExecutor (const TargetConfiguration& config, CommLink* commLink, const TestNode* root, const TestSet& testSet, BatchResult* batchResult, InfoLog* infoLog)
+BatchExecutor::BatchExecutor (const TargetConfiguration& config, CommLink* commLink, const TestNode* root, const TestSet& testSet, const CaseHistory* history, BatchResult* batchResult, InfoLog* infoLog)
 	: m_config			(config)
 	, m_commLink		(commLink)
 	, m_root			(root)
 	, m_testSet			(testSet)
-	, m_logHandler		(batchResult)
+	, m_history			(history)
+	, m_logHandler		(batchResult, history)
 	, m_batchResult		(batchResult)
 	, m_infoLog			(infoLog)
 	, m_state			(STATE_NOT_STARTED)
@@ -193,6 +275,8 @@ void BatchExecutor::run (void)
 
 	// Compute initial execute set.
 	computeExecuteSet(m_casesToExecute, m_root, m_testSet, m_batchResult);
+	computeIsolatedSet(m_isolatedCases, m_root, m_casesToExecute, m_history);
+	m_logHandler.setPendingCases(m_root, m_casesToExecute);
 
 	// Register callbacks.
 	m_commLink->setCallbacks(enqueueStateChanged, enqueueTestLogData, enqueueInfoLogData, this);
@@ -202,7 +286,7 @@ void BatchExecutor::run (void)
 		if (!m_casesToExecute.empty())
 		{
 			TestSet batchRequest;
-			computeBatchRequest(batchRequest, m_casesToExecute, m_root, m_config.maxCasesPerSession);
+			computeBatchRequest(batchRequest, m_casesToExecute, m_isolatedCases, m_root, m_config.maxCasesPerSession);
 			launchTestSet(batchRequest);
 
 			m_state = STATE_STARTED;
@@ -260,7 +344,7 @@ void BatchExecutor::onStateChanged (CommLinkState state, const char* message)
 				XE_CHECK(m_commLink->getState() == COMMLINKSTATE_READY);
 
 				TestSet batchRequest;
-				computeBatchRequest(batchRequest, m_casesToExecute, m_root, m_config.maxCasesPerSession);
+				computeBatchRequest(batchRequest, m_casesToExecute, m_isolatedCases, m_root, m_config.maxCasesPerSession);
 				launchTestSet(batchRequest);
 			}
 			else
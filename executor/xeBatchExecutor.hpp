@@ -28,7 +28,9 @@
 #include "xeCommLink.hpp"
 #include "xeTestLogParser.hpp"
 #include "xeCallQueue.hpp"
+#include "xeCaseHistory.hpp"
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -51,9 +53,12 @@ struct TargetConfiguration
 class BatchExecutorLogHandler : public TestLogHandler
 {
 public:
-							BatchExecutorLogHandler		(BatchResult* batchResult);
+							BatchExecutorLogHandler		(BatchResult* batchResult, const CaseHistory* history);
 							~BatchExecutorLogHandler	(void);
 
+	//! Set cases to be executed, used for predicting remaining time if history has durations.
+	void					setPendingCases				(const TestNode* root, const TestSet& pendingCases);
+
 	void					setSessionInfo				(const SessionInfo& sessionInfo);
 
 	TestCaseResultPtr		startTestCaseResult			(const char* casePath);
@@ -61,13 +66,17 @@ public:
 	void					testCaseResultComplete		(const TestCaseResultPtr& resultData);
 
 private:
-	BatchResult*			m_batchResult;
+	BatchResult*						m_batchResult;
+	const CaseHistory*					m_history;
+
+	std::map<std::string, deInt64>		m_pendingDurations;
+	deInt64								m_remainingDuration;
 };
 
 class BatchExecutor
 {
 public:
-							BatchExecutor		(const TargetConfiguration& config, CommLink* commLink, const TestNode* root, const TestSet& testSet, BatchResult* batchResult, InfoLog* infoLog);
+							BatchExecutor		(const TargetConfiguration& config, CommLink* commLink, const TestNode* root, const TestSet& testSet, const CaseHistory* history, BatchResult* batchResult, InfoLog* infoLog);
 							~BatchExecutor		(void);
 
 	void					run					(void);
@@ -109,6 +118,7 @@ private:
 
 	const TestNode*			m_root;
 	const TestSet&			m_testSet;
+	const CaseHistory*		m_history;
 
 	BatchExecutorLogHandler	m_logHandler;
 	BatchResult*			m_batchResult;
@@ -116,6 +126,7 @@ private:
 
 	State					m_state;
 	TestSet					m_casesToExecute;
+	TestSet					m_isolatedCases;		//!< Crash-prone cases, each executed in its own test process.
 
 	TestLogParser			m_testLogParser;
 
@@ -0,0 +1,198 @@
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Test Executor
+ * ------------------------------------------
+ *
+ * Copyright 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Persistent per-case duration and crash history.
+ *//*--------------------------------------------------------------------*/
+
+#include "xeCaseHistory.hpp"
+#include "xeTestResultParser.hpp"
+#include "deStringUtil.hpp"
+
+#include <fstream>
+#include <sstream>
+
+using std::string;
+using std::map;
+
+namespace xe
+{
+
+static const char* const s_header = "#caseHistory 1";
+
+CaseHistory::CaseHistory (void)
+	: m_durationSum		(0)
+	, m_numDurations	(0)
+{
+}
+
+CaseHistory::~CaseHistory (void)
+{
+}
+
+void CaseHistory::read (const char* filename)
+{
+	std::ifstream	in		(filename, std::ifstream::in);
+	string			line;
+	int				lineNdx	= 0;
+
+	if (!in.good())
+		throw Error(string("Failed to open '") + filename + "'");
+
+	while (std::getline(in, line))
+	{
+		lineNdx += 1;
+
+		if (!line.empty() && line[line.size()-1] == '\r')
+			line.erase(line.size()-1);
+
+		if (lineNdx == 1)
+		{
+			if (line != s_header)
+				throw Error(string("'") + filename + "' is not a case history file");
+			continue;
+		}
+
+		if (line.empty())
+			continue;
+
+		std::istringstream	str			(line);
+		string				casePath;
+		deInt64				duration	= -1;
+		int					numRuns		= 0;
+		deUint32			crashMask	= 0;
+
+		str >> casePath >> duration >> numRuns >> std::hex >> crashMask;
+
+		if (str.fail() || numRuns < 0 || duration < -1)
+			throw Error(string(filename) + ":" + de::toString(lineNdx) + ": invalid case history entry");
+
+		Entry& entry = m_entries[casePath];
+
+		updateDuration(entry, duration);
+		entry.numRuns	= numRuns;
+		entry.crashMask	= crashMask;
+	}
+}
+
+void CaseHistory::write (const char* filename) const
+{
+	std::ofstream out (filename, std::ofstream::out|std::ofstream::trunc);
+
+	if (!out.good())
+		throw Error(string("Failed to open '") + filename + "'");
+
+	out << s_header << "\n";
+
+	for (map<string, Entry>::const_iterator iter = m_entries.begin(); iter != m_entries.end(); ++iter)
+		out << iter->first << " " << iter->second.duration << " " << iter->second.numRuns << " 0x" << std::hex << iter->second.crashMask << std::dec << "\n";
+
+	out.close();
+
+	if (out.fail())
+		throw Error(string("Failed to write '") + filename + "'");
+}
+
+void CaseHistory::addResult (const TestCaseResultData& result)
+{
+	const TestStatusCode statusCode = result.getStatusCode();
+
+	if (statusCode == TESTSTATUSCODE_PENDING || statusCode == TESTSTATUSCODE_RUNNING)
+		return;
+
+	const bool	crashed	= statusCode == TESTSTATUSCODE_CRASH || statusCode == TESTSTATUSCODE_TIMEOUT;
+	Entry&		entry	= m_entries[result.getTestCasePath()];
+
+	entry.numRuns	+= 1;
+	entry.crashMask	 = (entry.crashMask << 1) | (crashed ? 1u : 0u);
+
+	// \note Crashed and timed out cases are recorded without duration, their partial timing would skew the average.
+	if (!crashed && result.getDataSize() > 0)
+	{
+		TestResultParser	parser;
+		TestCaseResult		parsed;
+		deInt64				duration	= -1;
+
+		try
+		{
+			parseTestCaseResultFromData(&parser, &parsed, result);
+			duration = getTestCaseDuration(parsed);
+		}
+		catch (const ParseError&)
+		{
+			// Ignore, no usable timing.
+		}
+
+		if (duration >= 0)
+			updateDuration(entry, entry.duration >= 0 ? (entry.duration + duration) / 2 : duration);
+	}
+}
+
+void CaseHistory::setDuration (const char* casePath, deInt64 duration)
+{
+	DE_ASSERT(duration >= 0);
+	updateDuration(m_entries[casePath], duration);
+}
+
+void CaseHistory::updateDuration (Entry& entry, deInt64 duration)
+{
+	if (entry.duration >= 0)
+	{
+		m_durationSum	-= entry.duration;
+		m_numDurations	-= 1;
+	}
+
+	entry.duration = duration;
+
+	if (entry.duration >= 0)
+	{
+		m_durationSum	+= entry.duration;
+		m_numDurations	+= 1;
+	}
+}
+
+const CaseHistory::Entry* CaseHistory::findEntry (const char* casePath) const
+{
+	const map<string, Entry>::const_iterator pos = m_entries.find(casePath);
+	return pos != m_entries.end() ? &pos->second : DE_NULL;
+}
+
+deInt64 CaseHistory::getDuration (const char* casePath) const
+{
+	const Entry* entry = findEntry(casePath);
+	return entry ? entry->duration : -1;
+}
+
+deInt64 CaseHistory::getExpectedDuration (const char* casePath) const
+{
+	const deInt64 duration = getDuration(casePath);
+
+	if (duration >= 0)
+		return duration;
+	else
+		return m_numDurations > 0 ? m_durationSum / m_numDurations : 0;
+}
+
+bool CaseHistory::isCrashProne (const char* casePath) const
+{
+	const Entry* entry = findEntry(casePath);
+	return entry && (entry->crashMask & ((1u << CRASH_HISTORY_RUNS) - 1u)) != 0;
+}
+
+} // xe
@@ -0,0 +1,101 @@
+#ifndef _XECASEHISTORY_HPP
+#define _XECASEHISTORY_HPP
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Test Executor
+ * ------------------------------------------
+ *
+ * Copyright 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Persistent per-case duration and crash history.
+ *//*--------------------------------------------------------------------*/
+
+#include "xeDefs.hpp"
+#include "xeBatchResult.hpp"
+
+#include <map>
+#include <string>
+
+namespace xe
+{
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Case duration and crash history over several runs
+ *
+ * History is used for scheduling: durations balance shards and predict
+ * remaining time, and cases that crashed or timed out recently are run
+ * in separate test process launches.
+ *
+ * History is stored as a text file with one line per case:
+ *
+ *  <case path> <average duration in us or -1> <number of runs> <crash mask>
+ *
+ * where bit N of crash mask is set if case crashed or timed out N runs
+ * ago.
+ *//*--------------------------------------------------------------------*/
+class CaseHistory
+{
+public:
+	enum
+	{
+		CRASH_HISTORY_RUNS	= 5		//!< Case is considered crash-prone if it crashed or timed out within this many last runs.
+	};
+
+	struct Entry
+	{
+		Entry (void) : duration(-1), numRuns(0), crashMask(0) {}
+
+		deInt64				duration;	//!< Average duration in microseconds, -1 if unknown.
+		int					numRuns;
+		deUint32			crashMask;
+	};
+
+							CaseHistory				(void);
+							~CaseHistory			(void);
+
+	void					read					(const char* filename);
+	void					write					(const char* filename) const;
+
+	//! Record result of one execution. Only completed, crashed or timed out results are recorded.
+	void					addResult				(const TestCaseResultData& result);
+
+	//! Set duration without recording a run, used for importing durations from test logs.
+	void					setDuration				(const char* casePath, deInt64 duration);
+
+	bool					empty					(void) const { return m_entries.empty();	}
+	bool					hasDurations			(void) const { return m_numDurations > 0;	}
+
+	const Entry*			findEntry				(const char* casePath) const;
+
+	//! Duration of case in microseconds, or -1 if not known.
+	deInt64					getDuration				(const char* casePath) const;
+
+	//! Duration of case, or average duration of known cases if not known.
+	deInt64					getExpectedDuration		(const char* casePath) const;
+
+	bool					isCrashProne			(const char* casePath) const;
+
+private:
+	void					updateDuration			(Entry& entry, deInt64 duration);
+
+	std::map<std::string, Entry>	m_entries;
+	deInt64							m_durationSum;
+	int								m_numDurations;
+};
+
+} // xe
+
+#endif // _XECASEHISTORY_HPP
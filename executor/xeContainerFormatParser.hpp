@@ -63,6 +63,10 @@ public:
 
 	ContainerElement			getElement					(void) const { return m_element; }
 
+	//! Position of current element in fed data, and its size in bytes (including line end).
+	deUint64					getElementOffset			(void) const { return m_elementOffset;	}
+	int							getElementSize				(void) const { return m_elementLen;		}
+
 	// SESSION_INFO
 	const char*					getSessionInfoAttribute		(void) const;
 	const char*					getSessionInfoValue			(void) const;
@@ -104,6 +108,7 @@ private:
 
 	ContainerElement			m_element;
 	int							m_elementLen;
+	deUint64					m_elementOffset;
 	State						m_state;
 	std::string					m_attribute;
 	std::string					m_value;
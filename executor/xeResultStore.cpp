@@ -0,0 +1,664 @@
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Test Executor
+ * ------------------------------------------
+ *
+ * Copyright 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Indexed binary test result store.
+ *//*--------------------------------------------------------------------*/
+
+#include "xeResultStore.hpp"
+#include "xeTestLogParser.hpp"
+#include "xeTestResultParser.hpp"
+#include "deMemory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#if (DE_OS == DE_OS_WIN32)
+#	define VC_EXTRALEAN
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#elif (DE_OS == DE_OS_UNIX) || (DE_OS == DE_OS_OSX) || (DE_OS == DE_OS_ANDROID) || (DE_OS == DE_OS_IOS) || (DE_OS == DE_OS_QNX)
+#	define XE_RESULTSTORE_USE_MMAP 1
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+using std::string;
+using std::vector;
+using std::map;
+
+namespace xe
+{
+
+namespace
+{
+
+static const char s_magic[] = { 'X', 'E', 'R', 'S', 'T', 'O', 'R', 'E' };
+
+enum
+{
+	MAGIC_SIZE					= DE_LENGTH_OF_ARRAY(s_magic),
+	NUM_SESSION_INFO_STRINGS	= 7,
+
+	// Header field offsets.
+	HEADER_VERSION				= 8,
+	HEADER_NUM_CASES			= 12,
+	HEADER_CASE_TABLE_OFFSET	= 16,
+	HEADER_PATH_INDEX_OFFSET	= 24,
+	HEADER_STRING_TABLE_OFFSET	= 32,
+	HEADER_STRING_TABLE_SIZE	= 40,
+	HEADER_DATA_OFFSET			= 48,
+	HEADER_DATA_SIZE			= 56,
+	HEADER_SESSION_INFO			= 64,	//!< NUM_SESSION_INFO_STRINGS string offsets.
+	HEADER_SIZE					= 96,
+
+	// Case entry field offsets.
+	CASE_PATH					= 0,
+	CASE_TYPE					= 4,
+	CASE_STATUS_CODE			= 8,
+	CASE_STATUS_DETAILS			= 12,
+	CASE_LOG_STATUS_CODE		= 16,	//!< Status code as recorded in test log container, TESTSTATUSCODE_LAST for completed cases.
+	CASE_LOG_STATUS_DETAILS		= 20,
+	CASE_DURATION				= 24,
+	CASE_DATA_OFFSET			= 32,
+	CASE_DATA_SIZE				= 40,
+	CASE_ENTRY_SIZE				= 48
+};
+
+inline void writeU32 (deUint8* dst, deUint32 value)
+{
+	for (int ndx = 0; ndx < 4; ndx++)
+		dst[ndx] = (deUint8)(value >> (ndx*8));
+}
+
+inline void writeU64 (deUint8* dst, deUint64 value)
+{
+	for (int ndx = 0; ndx < 8; ndx++)
+		dst[ndx] = (deUint8)(value >> (ndx*8));
+}
+
+inline deUint32 readU32 (const deUint8* src)
+{
+	deUint32 value = 0;
+	for (int ndx = 0; ndx < 4; ndx++)
+		value |= (deUint32)src[ndx] << (ndx*8);
+	return value;
+}
+
+inline deUint64 readU64 (const deUint8* src)
+{
+	deUint64 value = 0;
+	for (int ndx = 0; ndx < 8; ndx++)
+		value |= (deUint64)src[ndx] << (ndx*8);
+	return value;
+}
+
+class StringTable
+{
+public:
+	StringTable (void)
+	{
+		// Offset 0 is always empty string.
+		m_data.push_back(0);
+		m_offsets[""] = 0;
+	}
+
+	deUint32 add (const string& str)
+	{
+		const map<string, deUint32>::const_iterator pos = m_offsets.find(str);
+
+		if (pos != m_offsets.end())
+			return pos->second;
+
+		const deUint32 offset = (deUint32)m_data.size();
+		XE_CHECK_MSG((deUint64)offset + str.length() + 1 <= 0xffffffffu, "Result store string table is too large");
+
+		m_data.insert(m_data.end(), str.begin(), str.end());
+		m_data.push_back(0);
+		m_offsets[str] = offset;
+
+		return offset;
+	}
+
+	const vector<deUint8>& getData (void) const { return m_data; }
+
+private:
+	vector<deUint8>				m_data;
+	map<string, deUint32>		m_offsets;
+};
+
+struct CasePathLess
+{
+	CasePathLess (const vector<string>& paths) : m_paths(paths) {}
+
+	bool operator() (deUint32 a, deUint32 b) const
+	{
+		return m_paths[a] < m_paths[b];
+	}
+
+	const vector<string>& m_paths;
+};
+
+//! Resolve final status and duration of case the same way tools do when parsing test log.
+void resolveCaseHeader (TestResultParser& parser, const TestCaseResultData& data, TestCaseResultHeader& header, deInt64& duration)
+{
+	TestCaseResult result;
+
+	try
+	{
+		parseTestCaseResultFromData(&parser, &result, data);
+	}
+	catch (const ParseError&)
+	{
+		result.statusCode		= TESTSTATUSCODE_INTERNAL_ERROR;
+		result.statusDetails	= "Test case result parsing failed";
+	}
+
+	duration	= getTestCaseDuration(result);
+	header		= result;
+}
+
+} // anonymous
+
+// Writer
+
+void writeResultStore (const BatchResult& batchResult, const char* filename)
+{
+	const int			numCases		= batchResult.getNumTestCaseResults();
+	const SessionInfo&	sessionInfo		= batchResult.getSessionInfo();
+	StringTable			strings;
+	vector<string>		paths			(numCases);
+	vector<deUint8>		caseTable		(numCases*CASE_ENTRY_SIZE);
+	vector<deUint8>		pathIndex		(numCases*4);
+	deUint8				header			[HEADER_SIZE];
+	TestResultParser	parser;
+
+	deMemset(&header[0], 0, sizeof(header));
+
+	// Session info.
+	{
+		const string* const infoStrings[] =
+		{
+			&sessionInfo.releaseName,
+			&sessionInfo.releaseId,
+			&sessionInfo.targetName,
+			&sessionInfo.candyTargetName,
+			&sessionInfo.configName,
+			&sessionInfo.resultName,
+			&sessionInfo.timestamp
+		};
+		DE_STATIC_ASSERT(DE_LENGTH_OF_ARRAY(infoStrings) == NUM_SESSION_INFO_STRINGS);
+
+		for (int ndx = 0; ndx < NUM_SESSION_INFO_STRINGS; ndx++)
+			writeU32(&header[HEADER_SESSION_INFO + ndx*4], strings.add(*infoStrings[ndx]));
+	}
+
+	// Case table. Data offsets are relative to data section until final layout is known.
+	deUint64 dataSize = 0;
+
+	for (int caseNdx = 0; caseNdx < numCases; caseNdx++)
+	{
+		const ConstTestCaseResultPtr	data	= batchResult.getTestCaseResult(caseNdx);
+		deUint8* const					entry	= &caseTable[caseNdx*CASE_ENTRY_SIZE];
+		TestCaseResultHeader			caseHeader;
+		deInt64							duration;
+
+		resolveCaseHeader(parser, *data, caseHeader, duration);
+
+		paths[caseNdx] = data->getTestCasePath();
+
+		writeU32(entry + CASE_PATH,					strings.add(paths[caseNdx]));
+		writeU32(entry + CASE_TYPE,					(deUint32)caseHeader.caseType);
+		writeU32(entry + CASE_STATUS_CODE,			(deUint32)caseHeader.statusCode);
+		writeU32(entry + CASE_STATUS_DETAILS,		strings.add(caseHeader.statusDetails));
+		writeU32(entry + CASE_LOG_STATUS_CODE,		(deUint32)data->getStatusCode());
+		writeU32(entry + CASE_LOG_STATUS_DETAILS,	strings.add(data->getStatusDetails()));
+		writeU64(entry + CASE_DURATION,				(deUint64)duration);
+		writeU64(entry + CASE_DATA_OFFSET,			dataSize);
+		writeU32(entry + CASE_DATA_SIZE,			(deUint32)data->getDataSize());
+
+		dataSize += (deUint64)data->getDataSize();
+	}
+
+	// Path index.
+	{
+		vector<deUint32> order (numCases);
+
+		for (int ndx = 0; ndx < numCases; ndx++)
+			order[ndx] = (deUint32)ndx;
+
+		std::sort(order.begin(), order.end(), CasePathLess(paths));
+
+		for (int ndx = 0; ndx < numCases; ndx++)
+			writeU32(&pathIndex[ndx*4], order[ndx]);
+	}
+
+	// Final layout.
+	const vector<deUint8>&	stringTable			= strings.getData();
+	const deUint64			caseTableOffset		= HEADER_SIZE;
+	const deUint64			pathIndexOffset		= caseTableOffset + caseTable.size();
+	const deUint64			stringTableOffset	= pathIndexOffset + pathIndex.size();
+	const deUint64			dataOffset			= stringTableOffset + stringTable.size();
+
+	for (int caseNdx = 0; caseNdx < numCases; caseNdx++)
+	{
+		deUint8* const entry = &caseTable[caseNdx*CASE_ENTRY_SIZE];
+		writeU64(entry + CASE_DATA_OFFSET, dataOffset + readU64(entry + CASE_DATA_OFFSET));
+	}
+
+	deMemcpy(&header[0], &s_magic[0], MAGIC_SIZE);
+	writeU32(&header[HEADER_VERSION],				RESULTSTORE_VERSION);
+	writeU32(&header[HEADER_NUM_CASES],				(deUint32)numCases);
+	writeU64(&header[HEADER_CASE_TABLE_OFFSET],		caseTableOffset);
+	writeU64(&header[HEADER_PATH_INDEX_OFFSET],		pathIndexOffset);
+	writeU64(&header[HEADER_STRING_TABLE_OFFSET],	stringTableOffset);
+	writeU64(&header[HEADER_STRING_TABLE_SIZE],		(deUint64)stringTable.size());
+	writeU64(&header[HEADER_DATA_OFFSET],			dataOffset);
+	writeU64(&header[HEADER_DATA_SIZE],				dataSize);
+
+	// Write file.
+	std::ofstream out (filename, std::ofstream::binary|std::ofstream::trunc);
+
+	XE_CHECK_MSG(out.good(), (string("Failed to open '") + filename + "'").c_str());
+
+	out.write((const char*)&header[0], sizeof(header));
+
+	if (numCases > 0)
+	{
+		out.write((const char*)&caseTable[0], (std::streamsize)caseTable.size());
+		out.write((const char*)&pathIndex[0], (std::streamsize)pathIndex.size());
+	}
+
+	out.write((const char*)&stringTable[0], (std::streamsize)stringTable.size());
+
+	for (int caseNdx = 0; caseNdx < numCases; caseNdx++)
+	{
+		const ConstTestCaseResultPtr data = batchResult.getTestCaseResult(caseNdx);
+
+		if (data->getDataSize() > 0)
+			out.write((const char*)data->getData(), data->getDataSize());
+	}
+
+	out.close();
+	XE_CHECK_MSG(!out.fail(), (string("Failed to write '") + filename + "'").c_str());
+}
+
+bool isResultStoreFile (const char* filename)
+{
+	std::ifstream	in		(filename, std::ifstream::binary|std::ifstream::in);
+	char			magic	[MAGIC_SIZE];
+
+	if (!in.good())
+		return false;
+
+	in.read(&magic[0], MAGIC_SIZE);
+
+	return in.gcount() == MAGIC_SIZE && deMemCmp(&magic[0], &s_magic[0], MAGIC_SIZE) == 0;
+}
+
+// ResultStore::MappedFile
+
+class ResultStore::MappedFile
+{
+public:
+	MappedFile (const char* filename);
+	~MappedFile (void);
+
+	const deUint8*	getData		(void) const { return m_data;	}
+	deUint64		getSize		(void) const { return m_size;	}
+
+private:
+	MappedFile				(const MappedFile&);
+	MappedFile& operator=	(const MappedFile&);
+
+	const deUint8*			m_data;
+	deUint64				m_size;
+
+#if (DE_OS == DE_OS_WIN32)
+	HANDLE					m_file;
+	HANDLE					m_mapping;
+#elif defined(XE_RESULTSTORE_USE_MMAP)
+	// Nothing else needed.
+#else
+	vector<deUint8>			m_buffer;
+#endif
+};
+
+#if (DE_OS == DE_OS_WIN32)
+
+ResultStore::MappedFile::MappedFile (const char* filename)
+	: m_data	(DE_NULL)
+	, m_size	(0)
+	, m_file	(INVALID_HANDLE_VALUE)
+	, m_mapping	(DE_NULL)
+{
+	LARGE_INTEGER size;
+
+	m_file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, DE_NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, DE_NULL);
+
+	if (m_file == INVALID_HANDLE_VALUE)
+		throw Error(string("Failed to open '") + filename + "'");
+
+	if (!GetFileSizeEx(m_file, &size) || size.QuadPart < HEADER_SIZE)
+	{
+		CloseHandle(m_file);
+		throw Error(string("'") + filename + "' is not a result store");
+	}
+
+	m_size		= (deUint64)size.QuadPart;
+	m_mapping	= CreateFileMappingA(m_file, DE_NULL, PAGE_READONLY, 0, 0, DE_NULL);
+	m_data		= m_mapping ? (const deUint8*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : DE_NULL;
+
+	if (!m_data)
+	{
+		if (m_mapping)
+			CloseHandle(m_mapping);
+		CloseHandle(m_file);
+		throw Error(string("Failed to map '") + filename + "'");
+	}
+}
+
+ResultStore::MappedFile::~MappedFile (void)
+{
+	UnmapViewOfFile(m_data);
+	CloseHandle(m_mapping);
+	CloseHandle(m_file);
+}
+
+#elif defined(XE_RESULTSTORE_USE_MMAP)
+
+ResultStore::MappedFile::MappedFile (const char* filename)
+	: m_data	(DE_NULL)
+	, m_size	(0)
+{
+	const int	fd		= open(filename, O_RDONLY);
+	struct stat	st;
+
+	if (fd < 0)
+		throw Error(string("Failed to open '") + filename + "'");
+
+	if (fstat(fd, &st) != 0 || st.st_size < HEADER_SIZE)
+	{
+		close(fd);
+		throw Error(string("'") + filename + "' is not a result store");
+	}
+
+	void* const ptr = mmap(DE_NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+	// \note Mapping stays valid after closing the descriptor.
+	close(fd);
+
+	if (ptr == MAP_FAILED)
+		throw Error(string("Failed to map '") + filename + "'");
+
+	m_data	= (const deUint8*)ptr;
+	m_size	= (deUint64)st.st_size;
+}
+
+ResultStore::MappedFile::~MappedFile (void)
+{
+	munmap(const_cast<deUint8*>(m_data), (size_t)m_size);
+}
+
+#else
+
+ResultStore::MappedFile::MappedFile (const char* filename)
+	: m_data	(DE_NULL)
+	, m_size	(0)
+{
+	// No mapping support, read whole file instead.
+	std::ifstream in (filename, std::ifstream::binary|std::ifstream::in);
+
+	if (!in.good())
+		throw Error(string("Failed to open '") + filename + "'");
+
+	in.seekg(0, std::ios_base::end);
+	m_buffer.resize((size_t)in.tellg());
+	in.seekg(0, std::ios_base::beg);
+
+	if (m_buffer.size() < HEADER_SIZE)
+		throw Error(string("'") + filename + "' is not a result store");
+
+	in.read((char*)&m_buffer[0], (std::streamsize)m_buffer.size());
+	XE_CHECK_MSG(in.gcount() == (std::streamsize)m_buffer.size(), (string("Failed to read '") + filename + "'").c_str());
+
+	m_data	= &m_buffer[0];
+	m_size	= (deUint64)m_buffer.size();
+}
+
+ResultStore::MappedFile::~MappedFile (void)
+{
+}
+
+#endif
+
+// ResultStore
+
+ResultStore::ResultStore (const char* filename)
+	: m_file			(new MappedFile(filename))
+	, m_data			(m_file->getData())
+	, m_size			(m_file->getSize())
+	, m_numCases		(0)
+	, m_caseTable		(DE_NULL)
+	, m_pathIndex		(DE_NULL)
+	, m_stringTable		(DE_NULL)
+	, m_stringTableSize	(0)
+{
+	try
+	{
+		if (deMemCmp(m_data, &s_magic[0], MAGIC_SIZE) != 0)
+			throw Error(string("'") + filename + "' is not a result store");
+
+		if (readU32(m_data + HEADER_VERSION) != RESULTSTORE_VERSION)
+			throw Error(string("'") + filename + "' has unsupported result store version");
+
+		validate();
+
+		{
+			string* const infoStrings[] =
+			{
+				&m_sessionInfo.releaseName,
+				&m_sessionInfo.releaseId,
+				&m_sessionInfo.targetName,
+				&m_sessionInfo.candyTargetName,
+				&m_sessionInfo.configName,
+				&m_sessionInfo.resultName,
+				&m_sessionInfo.timestamp
+			};
+			DE_STATIC_ASSERT(DE_LENGTH_OF_ARRAY(infoStrings) == NUM_SESSION_INFO_STRINGS);
+
+			for (int ndx = 0; ndx < NUM_SESSION_INFO_STRINGS; ndx++)
+				*infoStrings[ndx] = getString(readU32(m_data + HEADER_SESSION_INFO + ndx*4));
+		}
+	}
+	catch (...)
+	{
+		delete m_file;
+		throw;
+	}
+}
+
+ResultStore::~ResultStore (void)
+{
+	delete m_file;
+}
+
+void ResultStore::validate (void)
+{
+	const deUint64	numCases			= readU32(m_data + HEADER_NUM_CASES);
+	const deUint64	caseTableOffset		= readU64(m_data + HEADER_CASE_TABLE_OFFSET);
+	const deUint64	pathIndexOffset		= readU64(m_data + HEADER_PATH_INDEX_OFFSET);
+	const deUint64	stringTableOffset	= readU64(m_data + HEADER_STRING_TABLE_OFFSET);
+	const deUint64	stringTableSize		= readU64(m_data + HEADER_STRING_TABLE_SIZE);
+	const deUint64	dataOffset			= readU64(m_data + HEADER_DATA_OFFSET);
+	const deUint64	dataSize			= readU64(m_data + HEADER_DATA_SIZE);
+
+	// \note Sections are checked against file size one by one to avoid overflows.
+	XE_CHECK_MSG(numCases <= 0x7fffffffu, "Corrupt result store header");
+	XE_CHECK_MSG(caseTableOffset >= HEADER_SIZE && caseTableOffset <= m_size && numCases*CASE_ENTRY_SIZE <= m_size - caseTableOffset, "Corrupt result store case table");
+	XE_CHECK_MSG(pathIndexOffset >= HEADER_SIZE && pathIndexOffset <= m_size && numCases*4 <= m_size - pathIndexOffset, "Corrupt result store path index");
+	XE_CHECK_MSG(stringTableOffset >= HEADER_SIZE && stringTableOffset <= m_size && stringTableSize > 0 && stringTableSize <= m_size - stringTableOffset, "Corrupt result store string table");
+	XE_CHECK_MSG(dataOffset <= m_size && dataSize <= m_size - dataOffset, "Corrupt result store data");
+
+	m_numCases			= (int)numCases;
+	m_caseTable			= m_data + caseTableOffset;
+	m_pathIndex			= m_data + pathIndexOffset;
+	m_stringTable		= (const char*)(m_data + stringTableOffset);
+	m_stringTableSize	= stringTableSize;
+
+	// Last string must be terminated, getString() relies on that.
+	XE_CHECK_MSG(m_stringTable[m_stringTableSize-1] == 0, "Corrupt result store string table");
+
+	for (int ndx = 0; ndx < NUM_SESSION_INFO_STRINGS; ndx++)
+		XE_CHECK_MSG(readU32(m_data + HEADER_SESSION_INFO + ndx*4) < m_stringTableSize, "Corrupt result store session info");
+
+	for (int caseNdx = 0; caseNdx < m_numCases; caseNdx++)
+	{
+		const deUint8* const	entry			= getCaseEntry(caseNdx);
+		const deUint64			caseDataOffset	= readU64(entry + CASE_DATA_OFFSET);
+		const deUint64			caseDataSize	= readU32(entry + CASE_DATA_SIZE);
+
+		XE_CHECK_MSG(readU32(entry + CASE_PATH) < m_stringTableSize &&
+					 readU32(entry + CASE_STATUS_DETAILS) < m_stringTableSize &&
+					 readU32(entry + CASE_LOG_STATUS_DETAILS) < m_stringTableSize, "Corrupt result store case entry");
+		XE_CHECK_MSG(readU32(entry + CASE_TYPE) <= TESTCASETYPE_LAST &&
+					 readU32(entry + CASE_STATUS_CODE) <= TESTSTATUSCODE_LAST &&
+					 readU32(entry + CASE_LOG_STATUS_CODE) <= TESTSTATUSCODE_LAST, "Corrupt result store case entry");
+		XE_CHECK_MSG(caseDataOffset >= dataOffset && caseDataOffset - dataOffset <= dataSize && caseDataSize <= dataSize - (caseDataOffset - dataOffset), "Corrupt result store case entry");
+		XE_CHECK_MSG(readU32(m_pathIndex + caseNdx*4) < (deUint32)m_numCases, "Corrupt result store path index");
+	}
+}
+
+const deUint8* ResultStore::getCaseEntry (int ndx) const
+{
+	DE_ASSERT(de::inBounds(ndx, 0, m_numCases));
+	return m_caseTable + (size_t)ndx*CASE_ENTRY_SIZE;
+}
+
+const char* ResultStore::getString (deUint32 offset) const
+{
+	DE_ASSERT(offset < m_stringTableSize);
+	return m_stringTable + offset;
+}
+
+int ResultStore::findCase (const char* casePath) const
+{
+	int first	= 0;
+	int last	= m_numCases;
+
+	while (first < last)
+	{
+		const int	mid		= first + (last - first) / 2;
+		const int	caseNdx	= (int)readU32(m_pathIndex + mid*4);
+		const int	cmp		= strcmp(getCasePath(caseNdx), casePath);
+
+		if (cmp == 0)
+			return caseNdx;
+		else if (cmp < 0)
+			first = mid+1;
+		else
+			last = mid;
+	}
+
+	return -1;
+}
+
+const char* ResultStore::getCasePath (int ndx) const
+{
+	return getString(readU32(getCaseEntry(ndx) + CASE_PATH));
+}
+
+TestCaseType ResultStore::getCaseType (int ndx) const
+{
+	return (TestCaseType)readU32(getCaseEntry(ndx) + CASE_TYPE);
+}
+
+TestStatusCode ResultStore::getStatusCode (int ndx) const
+{
+	return (TestStatusCode)readU32(getCaseEntry(ndx) + CASE_STATUS_CODE);
+}
+
+const char* ResultStore::getStatusDetails (int ndx) const
+{
+	return getString(readU32(getCaseEntry(ndx) + CASE_STATUS_DETAILS));
+}
+
+deInt64 ResultStore::getDuration (int ndx) const
+{
+	return (deInt64)readU64(getCaseEntry(ndx) + CASE_DURATION);
+}
+
+bool ResultStore::isComplete (int ndx) const
+{
+	return readU32(getCaseEntry(ndx) + CASE_LOG_STATUS_CODE) != TESTSTATUSCODE_RUNNING;
+}
+
+const deUint8* ResultStore::getCaseData (int ndx) const
+{
+	return m_data + readU64(getCaseEntry(ndx) + CASE_DATA_OFFSET);
+}
+
+int ResultStore::getCaseDataSize (int ndx) const
+{
+	return (int)readU32(getCaseEntry(ndx) + CASE_DATA_SIZE);
+}
+
+void ResultStore::readCaseData (int ndx, TestCaseResultData& dst) const
+{
+	const deUint8* const entry = getCaseEntry(ndx);
+
+	dst.setTestResult((TestStatusCode)readU32(entry + CASE_LOG_STATUS_CODE), getString(readU32(entry + CASE_LOG_STATUS_DETAILS)));
+	dst.setDataSize(getCaseDataSize(ndx));
+
+	if (dst.getDataSize() > 0)
+		deMemcpy(dst.getData(), getCaseData(ndx), dst.getDataSize());
+}
+
+TestCaseResultPtr ResultStore::getTestCaseResultData (int ndx) const
+{
+	TestCaseResultPtr data (new TestCaseResultData(getCasePath(ndx)));
+	readCaseData(ndx, *data);
+	return data;
+}
+
+void ResultStore::replay (TestLogHandler& handler) const
+{
+	handler.setSessionInfo(m_sessionInfo);
+
+	for (int caseNdx = 0; caseNdx < m_numCases; caseNdx++)
+	{
+		const TestCaseResultPtr data = handler.startTestCaseResult(getCasePath(caseNdx));
+
+		readCaseData(caseNdx, *data);
+
+		handler.testCaseResultUpdated(data);
+
+		if (isComplete(caseNdx))
+			handler.testCaseResultComplete(data);
+	}
+}
+
+} // xe
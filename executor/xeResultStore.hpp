@@ -0,0 +1,113 @@
+#ifndef _XERESULTSTORE_HPP
+#define _XERESULTSTORE_HPP
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Test Executor
+ * ------------------------------------------
+ *
+ * Copyright 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Indexed binary test result store.
+ *
+ * Result store is a random-access alternative to the .qpa test log. It
+ * contains a header table with case path, status and duration of each
+ * case, a sorted case path index and raw case log data. Status queries
+ * only touch the header table and don't require parsing the case logs.
+ *
+ * File layout (all integers are little-endian):
+ *
+ *  Header          Magic, version, section offsets, session info
+ *  Case table      One fixed-size entry per case, in execution order
+ *  Path index      Case table indices sorted by case path
+ *  String table    Null-terminated strings referenced by offset
+ *  Case data       Case log data as found between #beginTestCaseResult
+ *                  and #endTestCaseResult in the .qpa log
+ *//*--------------------------------------------------------------------*/
+
+#include "xeDefs.hpp"
+#include "xeTestCase.hpp"
+#include "xeBatchResult.hpp"
+
+namespace xe
+{
+
+class TestLogHandler;
+
+enum
+{
+	RESULTSTORE_VERSION = 1
+};
+
+//! Write batch result to result store file.
+void	writeResultStore		(const BatchResult& batchResult, const char* filename);
+
+//! Check if file is a result store (as opposed to a test log).
+bool	isResultStoreFile		(const char* filename);
+
+class ResultStore
+{
+public:
+							ResultStore				(const char* filename);
+							~ResultStore			(void);
+
+	const SessionInfo&		getSessionInfo			(void) const { return m_sessionInfo;	}
+	int						getNumCases				(void) const { return m_numCases;		}
+
+	//! Find case by path in O(log n), returns -1 if not found.
+	int						findCase				(const char* casePath) const;
+
+	const char*				getCasePath				(int ndx) const;
+	TestCaseType			getCaseType				(int ndx) const;
+	TestStatusCode			getStatusCode			(int ndx) const;
+	const char*				getStatusDetails		(int ndx) const;
+	deInt64					getDuration				(int ndx) const;	//!< TestDuration value in microseconds, or -1 if not available.
+	bool					isComplete				(int ndx) const;	//!< False if case log was cut off before #endTestCaseResult or #terminateTestCaseResult.
+
+	const deUint8*			getCaseData				(int ndx) const;
+	int						getCaseDataSize			(int ndx) const;
+
+	//! Create TestCaseResultData matching what TestLogParser would produce from the original log.
+	TestCaseResultPtr		getTestCaseResultData	(int ndx) const;
+
+	//! Feed all cases to handler as if they were read from test log. Incomplete cases are started but never completed.
+	void					replay					(TestLogHandler& handler) const;
+
+private:
+							ResultStore				(const ResultStore& other);
+	ResultStore&			operator=				(const ResultStore& other);
+
+	const deUint8*			getCaseEntry			(int ndx) const;
+	const char*				getString				(deUint32 offset) const;
+	void					readCaseData			(int ndx, TestCaseResultData& dst) const;
+	void					validate				(void);
+
+	class MappedFile;
+
+	MappedFile*				m_file;
+	const deUint8*			m_data;
+	deUint64				m_size;
+
+	int						m_numCases;
+	const deUint8*			m_caseTable;
+	const deUint8*			m_pathIndex;
+	const char*				m_stringTable;
+	deUint64				m_stringTableSize;
+	SessionInfo				m_sessionInfo;
+};
+
+} // xe
+
+#endif // _XERESULTSTORE_HPP
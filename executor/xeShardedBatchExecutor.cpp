@@ -0,0 +1,335 @@
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Test Executor
+ * ------------------------------------------
+ *
+ * Copyright 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Test batch executor running test set shards on several targets.
+ *//*--------------------------------------------------------------------*/
+
+#include "xeShardedBatchExecutor.hpp"
+#include "xeTestResultParser.hpp"
+#include "deThread.hpp"
+#include "deMemory.h"
+
+#include <algorithm>
+
+namespace xe
+{
+
+using std::string;
+using std::vector;
+
+namespace
+{
+
+struct WeightedCase
+{
+	WeightedCase (const TestCase* testCase_, deInt64 duration_, int order_)
+		: testCase	(testCase_)
+		, duration	(duration_)
+		, order		(order_)
+	{
+	}
+
+	const TestCase*	testCase;
+	deInt64			duration;
+	int				order;		//!< Position in hierarchy, used to keep the split deterministic.
+};
+
+struct LongestFirst
+{
+	bool operator() (const WeightedCase& a, const WeightedCase& b) const
+	{
+		return a.duration != b.duration ? a.duration > b.duration : a.order < b.order;
+	}
+};
+
+bool isPending (const BatchResult* batchResult, const string& casePath)
+{
+	if (!batchResult || !batchResult->hasTestCaseResult(casePath.c_str()))
+		return true;
+
+	const TestStatusCode statusCode = batchResult->getTestCaseResult(casePath.c_str())->getStatusCode();
+
+	return statusCode == TESTSTATUSCODE_PENDING || statusCode == TESTSTATUSCODE_RUNNING;
+}
+
+void copyTestCaseResult (TestCaseResultData& dst, const TestCaseResultData& src)
+{
+	dst.setTestResult(src.getStatusCode(), src.getStatusDetails());
+	dst.setDataSize(src.getDataSize());
+
+	if (src.getDataSize() > 0)
+		deMemcpy(dst.getData(), src.getData(), (size_t)src.getDataSize());
+}
+
+class ShardThread : public de::Thread
+{
+public:
+	ShardThread (BatchExecutor& executor)
+		: m_executor	(executor)
+		, m_failed		(false)
+	{
+	}
+
+	void run (void)
+	{
+		try
+		{
+			m_executor.run();
+		}
+		catch (const std::exception& e)
+		{
+			m_failed	= true;
+			m_error		= e.what();
+		}
+	}
+
+	bool			isFailed	(void) const { return m_failed;	}
+	const string&	getError	(void) const { return m_error;	}
+
+private:
+	BatchExecutor&	m_executor;
+	bool			m_failed;
+	string			m_error;
+};
+
+} // anonymous
+
+void readCaseDurations (CaseDurationMap& dst, const BatchResult& batchResult)
+{
+	TestResultParser parser;
+
+	for (int resultNdx = 0; resultNdx < batchResult.getNumTestCaseResults(); resultNdx++)
+	{
+		const ConstTestCaseResultPtr	data	= batchResult.getTestCaseResult(resultNdx);
+		TestCaseResult					result;
+
+		if (data->getDataSize() == 0)
+			continue;
+
+		try
+		{
+			parseTestCaseResultFromData(&parser, &result, *data);
+		}
+		catch (const ParseError&)
+		{
+			continue; // Truncated or corrupted results don't carry usable timing.
+		}
+
+		const deInt64 duration = getTestCaseDuration(result);
+
+		if (duration >= 0)
+			dst[data->getTestCasePath()] = duration;
+	}
+}
+
+void splitTestSet (vector<TestSet>& shards, const TestNode* root, const TestSet& testSet, const BatchResult* batchResult, const CaseHistory* history, int numShards)
+{
+	vector<WeightedCase>	cases;
+	deInt64					knownTotal	= 0;
+	int						numKnown	= 0;
+
+	XE_CHECK(numShards >= 1);
+
+	for (ConstTestNodeIterator iter = ConstTestNodeIterator::begin(root); iter != ConstTestNodeIterator::end(root); ++iter)
+	{
+		const TestNode* node = *iter;
+
+		if (node->getNodeType() == TESTNODETYPE_TEST_CASE && testSet.hasNode(node))
+		{
+			const TestCase*	testCase	= static_cast<const TestCase*>(node);
+			const string	fullPath	= testCase->getFullPath();
+
+			if (!isPending(batchResult, fullPath))
+				continue;
+
+			const deInt64 duration = history ? history->getDuration(fullPath.c_str()) : -1;
+
+			if (duration >= 0)
+			{
+				knownTotal	+= duration;
+				numKnown	+= 1;
+			}
+
+			cases.push_back(WeightedCase(testCase, duration, (int)cases.size()));
+		}
+	}
+
+	// Cases without history get the average duration so they still spread out evenly.
+	{
+		const deInt64 defaultDuration = numKnown > 0 ? std::max<deInt64>(knownTotal / numKnown, 1) : 1;
+
+		for (vector<WeightedCase>::iterator caseIter = cases.begin(); caseIter != cases.end(); ++caseIter)
+		{
+			if (caseIter->duration < 0)
+				caseIter->duration = defaultDuration;
+		}
+	}
+
+	std::sort(cases.begin(), cases.end(), LongestFirst());
+
+	shards.clear();
+	shards.resize(numShards);
+
+	{
+		vector<deInt64> load (numShards, 0);
+
+		for (vector<WeightedCase>::const_iterator caseIter = cases.begin(); caseIter != cases.end(); ++caseIter)
+		{
+			const int shardNdx = (int)(std::min_element(load.begin(), load.end()) - load.begin());
+
+			shards[shardNdx].addCase(caseIter->testCase);
+			load[shardNdx] += caseIter->duration;
+		}
+	}
+}
+
+ShardedBatchExecutor::Shard::Shard (const TargetConfiguration& config, CommLink* commLink, const TestNode* root, const TestSet& testSet_, const CaseHistory* history, BatchResult* batchResult_, InfoLog* infoLog_)
+	: testSet	(testSet_)
+	, executor	(config, commLink, root, testSet, history, batchResult_ ? batchResult_ : &ownBatchResult, infoLog_ ? infoLog_ : &ownInfoLog)
+{
+}
+
+ShardedBatchExecutor::ShardedBatchExecutor (const TargetConfiguration& config, const vector<CommLink*>& commLinks, const TestNode* root, const TestSet& testSet, const CaseHistory* history, BatchResult* batchResult, InfoLog* infoLog)
+	: m_root		(root)
+	, m_batchResult	(batchResult)
+	, m_infoLog		(infoLog)
+{
+	XE_CHECK(!commLinks.empty());
+
+	if (commLinks.size() == 1)
+	{
+		// Single target writes directly to destination.
+		m_shards.push_back(de::SharedPtr<Shard>(new Shard(config, commLinks[0], root, testSet, history, batchResult, infoLog)));
+	}
+	else
+	{
+		vector<TestSet> shardSets;
+
+		splitTestSet(shardSets, root, testSet, batchResult, history, (int)commLinks.size());
+
+		for (size_t shardNdx = 0; shardNdx < commLinks.size(); shardNdx++)
+			m_shards.push_back(de::SharedPtr<Shard>(new Shard(config, commLinks[shardNdx], root, shardSets[shardNdx], history, DE_NULL, DE_NULL)));
+	}
+}
+
+ShardedBatchExecutor::~ShardedBatchExecutor (void)
+{
+}
+
+void ShardedBatchExecutor::run (void)
+{
+	if (m_shards.size() == 1)
+	{
+		m_shards[0]->executor.run();
+		return;
+	}
+
+	vector<de::SharedPtr<ShardThread> >	threads;
+	string								error;
+
+	for (size_t shardNdx = 0; shardNdx < m_shards.size(); shardNdx++)
+	{
+		// \note Empty shards (fewer cases than targets) would fail launchTestSet() on a set without root.
+		if (m_shards[shardNdx]->testSet.empty())
+			continue;
+
+		threads.push_back(de::SharedPtr<ShardThread>(new ShardThread(m_shards[shardNdx]->executor)));
+		threads.back()->start();
+	}
+
+	for (size_t threadNdx = 0; threadNdx < threads.size(); threadNdx++)
+	{
+		threads[threadNdx]->join();
+
+		if (threads[threadNdx]->isFailed() && error.empty())
+			error = threads[threadNdx]->getError();
+	}
+
+	// \note Results are merged even on failure so that partial logs can be written out.
+	mergeResults();
+
+	if (!error.empty())
+		throw Error(error);
+}
+
+void ShardedBatchExecutor::cancel (void)
+{
+	for (size_t shardNdx = 0; shardNdx < m_shards.size(); shardNdx++)
+		m_shards[shardNdx]->executor.cancel();
+}
+
+void ShardedBatchExecutor::mergeResults (void)
+{
+	// Session info is identical across targets running the same binary; take the first one reported.
+	for (size_t shardNdx = 0; shardNdx < m_shards.size(); shardNdx++)
+	{
+		const SessionInfo& sessionInfo = m_shards[shardNdx]->ownBatchResult.getSessionInfo();
+
+		if (!sessionInfo.releaseName.empty() || !sessionInfo.targetName.empty())
+		{
+			m_batchResult->getSessionInfo() = sessionInfo;
+			break;
+		}
+	}
+
+	// Merge results in hierarchy order to keep the output log independent of the shard count.
+	for (ConstTestNodeIterator iter = ConstTestNodeIterator::begin(m_root); iter != ConstTestNodeIterator::end(m_root); ++iter)
+	{
+		const TestNode* node = *iter;
+
+		if (node->getNodeType() != TESTNODETYPE_TEST_CASE)
+			continue;
+
+		for (size_t shardNdx = 0; shardNdx < m_shards.size(); shardNdx++)
+		{
+			const Shard& shard = *m_shards[shardNdx];
+
+			if (shard.testSet.hasNode(node))
+			{
+				const string fullPath = node->getFullPath();
+
+				if (shard.ownBatchResult.hasTestCaseResult(fullPath.c_str()))
+				{
+					const ConstTestCaseResultPtr	src	= shard.ownBatchResult.getTestCaseResult(fullPath.c_str());
+					const TestCaseResultPtr			dst	= m_batchResult->hasTestCaseResult(fullPath.c_str())
+														? m_batchResult->getTestCaseResult(fullPath.c_str())
+														: m_batchResult->createTestCaseResult(fullPath.c_str());
+
+					copyTestCaseResult(*dst, *src);
+				}
+
+				break;
+			}
+		}
+	}
+
+	if (m_infoLog)
+	{
+		for (size_t shardNdx = 0; shardNdx < m_shards.size(); shardNdx++)
+		{
+			const InfoLog& shardLog = m_shards[shardNdx]->ownInfoLog;
+
+			if (shardLog.getSize() > 0)
+				m_infoLog->append(shardLog.getBytes(), shardLog.getSize());
+		}
+	}
+}
+
+} // xe
@@ -0,0 +1,101 @@
+#ifndef _XESHARDEDBATCHEXECUTOR_HPP
+#define _XESHARDEDBATCHEXECUTOR_HPP
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Test Executor
+ * ------------------------------------------
+ *
+ * Copyright 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Test batch executor running test set shards on several targets.
+ *//*--------------------------------------------------------------------*/
+
+#include "xeDefs.hpp"
+#include "xeBatchExecutor.hpp"
+#include "xeCaseHistory.hpp"
+#include "deSharedPtr.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace xe
+{
+
+//! Historical case durations in microseconds, keyed by full case path.
+typedef std::map<std::string, deInt64> CaseDurationMap;
+
+//! Collect durations of executed cases in batchResult into dst.
+void	readCaseDurations	(CaseDurationMap& dst, const BatchResult& batchResult);
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Split not yet executed cases of testSet into numShards sets
+ *
+ * Cases are assigned longest-first to the shard with the smallest total
+ * expected duration. Cases without a historical duration are assumed to
+ * take the average duration of known cases. History can be null, in
+ * which case all cases are assumed to take equally long.
+ *//*--------------------------------------------------------------------*/
+void	splitTestSet		(std::vector<TestSet>& shards, const TestNode* root, const TestSet& testSet, const BatchResult* batchResult, const CaseHistory* history, int numShards);
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Batch executor distributing a test set over several CommLinks
+ *
+ * Each CommLink runs its own BatchExecutor on a separate thread. Results
+ * are collected into per-shard batch results and merged into batchResult
+ * in test hierarchy order once all shards have finished. With a single
+ * CommLink this is equivalent to BatchExecutor. Optional case history is
+ * used for balancing shards and is passed on to BatchExecutors.
+ *//*--------------------------------------------------------------------*/
+class ShardedBatchExecutor
+{
+public:
+							ShardedBatchExecutor	(const TargetConfiguration& config, const std::vector<CommLink*>& commLinks, const TestNode* root, const TestSet& testSet, const CaseHistory* history, BatchResult* batchResult, InfoLog* infoLog);
+							~ShardedBatchExecutor	(void);
+
+	void					run						(void);
+	void					cancel					(void); //!< Cancel current run(), can be called from any thread.
+
+private:
+							ShardedBatchExecutor	(const ShardedBatchExecutor& other);
+	ShardedBatchExecutor&	operator=				(const ShardedBatchExecutor& other);
+
+	struct Shard
+	{
+								Shard		(const TargetConfiguration& config, CommLink* commLink, const TestNode* root, const TestSet& testSet_, const CaseHistory* history, BatchResult* batchResult_, InfoLog* infoLog_);
+
+		TestSet					testSet;
+		BatchResult				ownBatchResult;
+		InfoLog					ownInfoLog;
+		BatchExecutor			executor;
+
+	private:
+								Shard		(const Shard& other);
+		Shard&					operator=	(const Shard& other);
+	};
+
+	void					mergeResults			(void);
+
+	const TestNode*			m_root;
+	BatchResult*			m_batchResult;
+	InfoLog*				m_infoLog;
+
+	std::vector<de::SharedPtr<Shard> >	m_shards;
+};
+
+} // xe
+
+#endif // _XESHARDEDBATCHEXECUTOR_HPP
@@ -24,6 +24,7 @@
 #include "xeTcpIpLink.hpp"
 #include "xsProtocol.hpp"
 #include "deClock.h"
+#include "deMemory.h"
 #include "deInt32.h"
 
 namespace xe
@@ -32,7 +33,9 @@ namespace xe
 enum
 {
 	SEND_BUFFER_BLOCK_SIZE		= 1024,
-	SEND_BUFFER_NUM_BLOCKS		= 64
+	SEND_BUFFER_NUM_BLOCKS		= 64,
+
+	RECV_BUFFER_SIZE			= 64*1024	//!< Initial receive buffer size, grows to fit largest message.
 };
 
 // Utilities for writing messages out.
@@ -44,6 +47,18 @@ static void writeMessageHeader (de::BlockBuffer<deUint8>& dst, xs::MessageType t
 	dst.write(xs::MESSAGE_HEADER_SIZE, &hdr[0]);
 }
 
+static void writeHello (de::BlockBuffer<deUint8>& dst, int version)
+{
+	xs::HelloMessage		msg;
+	std::vector<deUint8>	buf;
+
+	msg.version = version;
+	msg.write(buf);
+
+	dst.write((int)buf.size(), &buf[0]);
+	dst.flush();
+}
+
 static void writeKeepalive (de::BlockBuffer<deUint8>& dst)
 {
 	writeMessageHeader(dst, xs::MESSAGETYPE_KEEPALIVE, xs::MESSAGE_HEADER_SIZE);
@@ -263,7 +278,8 @@ void TcpIpSendThread::stop (void)
 TcpIpRecvThread::TcpIpRecvThread (de::Socket& socket, TcpIpLinkState& state)
 	: m_socket		(socket)
 	, m_state		(state)
-	, m_curMsgPos	(0)
+	, m_recvBuf		(RECV_BUFFER_SIZE)
+	, m_recvBufSize	(0)
 	, m_isRunning	(false)
 {
 }
@@ -277,8 +293,8 @@ void TcpIpRecvThread::start (void)
 	DE_ASSERT(!m_isRunning);
 
 	// Reset state.
-	m_curMsgPos = 0;
-	m_isRunning = true;
+	m_recvBufSize	= 0;
+	m_isRunning		= true;
 
 	de::Thread::start();
 }
@@ -289,35 +305,44 @@ void TcpIpRecvThread::run (void)
 	{
 		for (;;)
 		{
-			bool				hasHeader		= m_curMsgPos >= xs::MESSAGE_HEADER_SIZE;
-			bool				hasPayload		= false;
-			size_t				messageSize		= 0;
-			xs::MessageType		messageType		= (xs::MessageType)0;
+			size_t	readPos		= 0;
+			size_t	curMsgSize	= xs::MESSAGE_HEADER_SIZE;
 
-			if (hasHeader)
+			// Handle all complete messages in buffer.
+			while (m_recvBufSize - readPos >= xs::MESSAGE_HEADER_SIZE)
 			{
-				xs::Message::parseHeader(&m_curMsgBuf[0], xs::MESSAGE_HEADER_SIZE, messageType, messageSize);
-				hasPayload = m_curMsgPos >= messageSize;
+				xs::MessageType		messageType		= (xs::MessageType)0;
+				size_t				messageSize		= 0;
+
+				xs::Message::parseHeader(&m_recvBuf[readPos], xs::MESSAGE_HEADER_SIZE, messageType, messageSize);
+				XE_CHECK_MSG(messageSize >= (size_t)xs::MESSAGE_HEADER_SIZE, "Invalid message size");
+
+				if (m_recvBufSize - readPos < messageSize)
+				{
+					curMsgSize = messageSize;
+					break;
+				}
+
+				handleMessage(messageType, messageSize > xs::MESSAGE_HEADER_SIZE ? &m_recvBuf[readPos + xs::MESSAGE_HEADER_SIZE] : DE_NULL, messageSize-xs::MESSAGE_HEADER_SIZE);
+				readPos += messageSize;
 			}
 
-			if (hasPayload)
+			// Move partial message to the beginning and make sure it fits in buffer.
+			if (readPos > 0)
 			{
-				// Process message.
-				handleMessage(messageType, m_curMsgPos > xs::MESSAGE_HEADER_SIZE ? &m_curMsgBuf[xs::MESSAGE_HEADER_SIZE] : DE_NULL, messageSize-xs::MESSAGE_HEADER_SIZE);
-				m_curMsgPos = 0;
+				if (readPos < m_recvBufSize)
+					deMemmove(&m_recvBuf[0], &m_recvBuf[readPos], m_recvBufSize - readPos);
+				m_recvBufSize -= readPos;
 			}
-			else
-			{
-				// Try to receive missing bytes.
-				size_t				curSize			= hasHeader ? messageSize : (size_t)xs::MESSAGE_HEADER_SIZE;
-				size_t				bytesToRecv		= curSize-m_curMsgPos;
-				size_t				numRecv			= 0;
-				deSocketResult		result			= DE_SOCKETRESULT_LAST;
 
-				if (m_curMsgBuf.size() < curSize)
-					m_curMsgBuf.resize(curSize);
+			if (m_recvBuf.size() < curMsgSize)
+				m_recvBuf.resize(curMsgSize);
 
-				result = m_socket.receive(&m_curMsgBuf[m_curMsgPos], bytesToRecv, &numRecv);
+			// Receive as many bytes as there is room for.
+			{
+				size_t				bytesToRecv		= m_recvBuf.size() - m_recvBufSize;
+				size_t				numRecv			= 0;
+				deSocketResult		result			= m_socket.receive(&m_recvBuf[m_recvBufSize], bytesToRecv, &numRecv);
 
 				if (result == DE_SOCKETRESULT_CONNECTION_CLOSED)
 					XE_FAIL("Connection closed");
@@ -335,8 +360,8 @@ void TcpIpRecvThread::run (void)
 				{
 					DE_ASSERT(result == DE_SOCKETRESULT_SUCCESS);
 					DE_ASSERT(numRecv <= bytesToRecv);
-					m_curMsgPos += numRecv;
-					// Continue receiving bytes / handle message in next iter.
+					m_recvBufSize += numRecv;
+					// Handle received messages in next iter.
 				}
 			}
 		}
@@ -367,6 +392,13 @@ void TcpIpRecvThread::handleMessage (xs::MessageType messageType, const deUint8*
 			m_state.onKeepaliveReceived();
 			break;
 
+		case xs::MESSAGETYPE_HELLO:
+		{
+			xs::HelloMessage msg(data, dataSize);
+			XE_CHECK_MSG(msg.version >= xs::PROTOCOL_VERSION_COMPRESSED_LOG && msg.version <= xs::PROTOCOL_VERSION, "Unexpected protocol version in HELLO reply");
+			break;
+		}
+
 		case xs::MESSAGETYPE_PROCESS_STARTED:
 			XE_CHECK_MSG(m_state.getState() == COMMLINKSTATE_TEST_PROCESS_LAUNCHING, "Unexpected PROCESS_STARTED message");
 			m_state.setState(COMMLINKSTATE_TEST_PROCESS_RUNNING);
@@ -404,6 +436,12 @@ void TcpIpRecvThread::handleMessage (xs::MessageType messageType, const deUint8*
 				m_state.onInfoLogData(&data[0], dataSize);
 			break;
 
+		case xs::MESSAGETYPE_PROCESS_LOG_DATA_COMPRESSED:
+			XE_CHECK_MSG(m_state.getState() == COMMLINKSTATE_TEST_PROCESS_RUNNING, "Unexpected PROCESS_LOG_DATA_COMPRESSED message");
+			xs::ProcessLogDataCompressedMessage::read(m_logDataBuf, m_decompressor, data, dataSize);
+			m_state.onTestLogData(&m_logDataBuf[0], m_logDataBuf.size());
+			break;
+
 		default:
 			XE_FAIL("Unknown message");
 	}
@@ -416,6 +454,7 @@ TcpIpLink::TcpIpLink (void)
 	, m_sendThread		(m_socket, m_state)
 	, m_recvThread		(m_socket, m_state)
 	, m_keepaliveTimer	(DE_NULL)
+	, m_compressLog		(false)
 {
 	m_keepaliveTimer = deTimer_create(keepaliveTimerCallback, this);
 	XE_CHECK(m_keepaliveTimer);
@@ -455,6 +494,12 @@ void TcpIpLink::closeConnection (void)
 		m_socket.close();
 }
 
+void TcpIpLink::setLogCompression (bool enabled)
+{
+	XE_CHECK(m_socket.getState() == DE_SOCKETSTATE_CLOSED);
+	m_compressLog = enabled;
+}
+
 void TcpIpLink::connect (const de::SocketAddress& address)
 {
 	XE_CHECK(m_socket.getState() == DE_SOCKETSTATE_CLOSED);
@@ -474,6 +519,10 @@ void TcpIpLink::connect (const de::SocketAddress& address)
 		m_sendThread.start();
 		m_recvThread.start();
 
+		// \note Older ExecServers reject HELLO with newer version, so it is only sent if compression was requested.
+		if (m_compressLog)
+			writeHello(m_sendThread.getBuffer(), xs::PROTOCOL_VERSION);
+
 		XE_CHECK(deTimer_scheduleInterval(m_keepaliveTimer, xs::KEEPALIVE_SEND_INTERVAL));
 	}
 	catch (const std::exception& e)
@@ -29,6 +29,7 @@
 #include "deRingBuffer.hpp"
 #include "deBlockBuffer.hpp"
 #include "xsProtocol.hpp"
+#include "xsCompression.hpp"
 #include "deThread.hpp"
 #include "deTimer.h"
 
@@ -109,8 +110,11 @@ private:
 	de::Socket&					m_socket;
 	TcpIpLinkState&				m_state;
 
-	std::vector<deUint8>		m_curMsgBuf;
-	size_t						m_curMsgPos;
+	std::vector<deUint8>		m_recvBuf;				//!< Received bytes, may contain several messages.
+	size_t						m_recvBufSize;
+
+	xs::Decompressor			m_decompressor;
+	std::vector<deUint8>		m_logDataBuf;			//!< Decompressed log data.
 
 	bool						m_isRunning;
 };
@@ -122,6 +126,7 @@ public:
 								~TcpIpLink				(void);
 
 	// TcpIpLink -specific API
+	void						setLogCompression		(bool enabled);		//!< Request compressed log data from ExecServer. Must be called before connect().
 	void						connect					(const de::SocketAddress& address);
 	void						disconnect				(void);
 
@@ -148,6 +153,7 @@ private:
 	TcpIpRecvThread				m_recvThread;
 
 	deTimer*					m_keepaliveTimer;
+	bool						m_compressLog;
 };
 
 } // xe
@@ -84,4 +84,23 @@ std::ostream& operator<< (std::ostream& str, const NumericValue& value)
 }
 
 } // ri
+
+deInt64 getTestCaseDuration (const TestCaseResult& result)
+{
+	for (int itemNdx = 0; itemNdx < result.resultItems.getNumItems(); itemNdx++)
+	{
+		const ri::Item& item = result.resultItems.getItem(itemNdx);
+
+		if (item.getType() == ri::TYPE_NUMBER)
+		{
+			const ri::Number& number = static_cast<const ri::Number&>(item);
+
+			if (number.name == "TestDuration" && number.value.getType() == ri::NumericValue::TYPE_INT64)
+				return number.value.getInt64();
+		}
+	}
+
+	return -1;
+}
+
 } // xe
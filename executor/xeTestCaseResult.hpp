@@ -127,6 +127,9 @@ public:
 	ri::List			resultItems;			//!< Test log items.
 };
 
+//! Get value of TestDuration item in microseconds, or -1 if result doesn't have one.
+deInt64 getTestCaseDuration (const TestCaseResult& result);
+
 // Result items.
 namespace ri
 {
@@ -31,6 +31,26 @@ using std::map;
 namespace xe
 {
 
+void setSessionInfoAttribute (SessionInfo& info, const char* attribute, const char* value)
+{
+	if (deStringEqual(attribute, "releaseName"))
+		info.releaseName = value;
+	else if (deStringEqual(attribute, "releaseId"))
+		info.releaseId = value;
+	else if (deStringEqual(attribute, "targetName"))
+		info.targetName = value;
+	else if (deStringEqual(attribute, "candyTargetName"))
+		info.candyTargetName = value;
+	else if (deStringEqual(attribute, "configName"))
+		info.configName = value;
+	else if (deStringEqual(attribute, "resultName"))
+		info.resultName = value;
+	else if (deStringEqual(attribute, "timestamp"))
+		info.timestamp = value;
+
+	// \todo [2012-06-09 pyry] What to do with unknown/duplicate attributes? Currently just ignored.
+}
+
 TestLogParser::TestLogParser (TestLogHandler* handler)
 	: m_handler		(handler)
 	, m_inSession	(false)
@@ -86,25 +106,7 @@ void TestLogParser::parse (const deUint8* bytes, size_t numBytes)
 				if (m_inSession)
 					throw Error("Unexpected #sessionInfo");
 
-				const char*		attribute	= m_containerParser.getSessionInfoAttribute();
-				const char*		value		= m_containerParser.getSessionInfoValue();
-
-				if (deStringEqual(attribute, "releaseName"))
-					m_sessionInfo.releaseName = value;
-				else if (deStringEqual(attribute, "releaseId"))
-					m_sessionInfo.releaseId = value;
-				else if (deStringEqual(attribute, "targetName"))
-					m_sessionInfo.targetName = value;
-				else if (deStringEqual(attribute, "candyTargetName"))
-					m_sessionInfo.candyTargetName = value;
-				else if (deStringEqual(attribute, "configName"))
-					m_sessionInfo.configName = value;
-				else if (deStringEqual(attribute, "resultName"))
-					m_sessionInfo.resultName = value;
-				else if (deStringEqual(attribute, "timestamp"))
-					m_sessionInfo.timestamp = value;
-
-				// \todo [2012-06-09 pyry] What to do with unknown/duplicate attributes? Currently just ignored.
+				setSessionInfoAttribute(m_sessionInfo, m_containerParser.getSessionInfoAttribute(), m_containerParser.getSessionInfoValue());
 				break;
 			}
 
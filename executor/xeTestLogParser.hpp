@@ -36,6 +36,9 @@
 namespace xe
 {
 
+//! Set SessionInfo field matching #sessionInfo attribute. Unknown attributes are ignored.
+void setSessionInfoAttribute (SessionInfo& info, const char* attribute, const char* value);
+
 class TestLogHandler
 {
 public:
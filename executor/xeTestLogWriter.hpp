@@ -37,6 +37,7 @@ namespace xml
 class Writer;
 }
 
+void	writeSessionInfo		(const SessionInfo& info, std::ostream& stream);
 void	writeTestLog			(const BatchResult& batchResult, std::ostream& stream);
 void	writeBatchResultToFile	(const BatchResult& batchResult, const char* filename);
 
@@ -22,7 +22,7 @@
  *//*--------------------------------------------------------------------*/
 
 #include "xeXMLParser.hpp"
-#include "deInt32.h"
+#include "deMemory.h"
 
 namespace xe
 {
@@ -49,17 +49,48 @@ static inline bool isWhitespaceChar (int ch)
 	return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
 }
 
-static int getNextBufferSize (int curSize, int minNewSize)
+static inline bool hasZeroByte (deUint64 word)
 {
-	return de::max(curSize*2, 1<<deLog2Ceil32(minNewSize));
+	const deUint64 lowBits	= 0x0101010101010101ull;
+	const deUint64 highBits	= 0x8080808080808080ull;
+
+	return ((word - lowBits) & ~word & highBits) != 0;
+}
+
+//! Find first byte equal to a, b or c in [begin, end), or end if there is none.
+static const deUint8* findFirstOf (const deUint8* begin, const deUint8* end, deUint8 a, deUint8 b, deUint8 c)
+{
+	const deUint64	lowBits		= 0x0101010101010101ull;
+	const deUint64	patternA	= lowBits * a;
+	const deUint64	patternB	= lowBits * b;
+	const deUint64	patternC	= lowBits * c;
+	const deUint8*	cur			= begin;
+
+	// Skip 8 bytes at a time until a word contains one of the bytes.
+	while (end - cur >= (int)sizeof(deUint64))
+	{
+		deUint64 word;
+		deMemcpy(&word, cur, sizeof(word));
+
+		if (hasZeroByte(word ^ patternA) || hasZeroByte(word ^ patternB) || hasZeroByte(word ^ patternC))
+			break;
+
+		cur += sizeof(deUint64);
+	}
+
+	while (cur != end && *cur != a && *cur != b && *cur != c)
+		cur++;
+
+	return cur;
 }
 
 Tokenizer::Tokenizer (void)
 	: m_curToken	(TOKEN_INCOMPLETE)
 	, m_curTokenLen	(0)
 	, m_state		(STATE_DATA)
-	, m_buf			(TOKENIZER_INITIAL_BUFFER_SIZE)
+	, m_bufStart	(0)
 {
+	m_buf.reserve(TOKENIZER_INITIAL_BUFFER_SIZE);
 }
 
 Tokenizer::~Tokenizer (void)
@@ -71,6 +102,7 @@ void Tokenizer::clear (void)
 	m_curToken		= TOKEN_INCOMPLETE;
 	m_curTokenLen	= 0;
 	m_state			= STATE_DATA;
+	m_bufStart		= 0;
 	m_buf.clear();
 }
 
@@ -81,14 +113,15 @@ void Tokenizer::error (const std::string& what)
 
 void Tokenizer::feed (const deUint8* bytes, int numBytes)
 {
-	// Grow buffer if necessary.
-	if (m_buf.getNumFree() < numBytes)
+	// Drop consumed bytes once there are at least as many of them as unconsumed ones. This keeps
+	// the buffer contiguous while moving each byte only an amortized constant number of times.
+	if (m_bufStart > 0 && m_bufStart >= (int)m_buf.size() - m_bufStart)
 	{
-		m_buf.resize(getNextBufferSize(m_buf.getSize(), m_buf.getNumElements()+numBytes));
+		m_buf.erase(m_buf.begin(), m_buf.begin() + m_bufStart);
+		m_bufStart = 0;
 	}
 
-	// Append to front.
-	m_buf.pushFront(bytes, numBytes);
+	m_buf.insert(m_buf.end(), bytes, bytes + numBytes);
 
 	// If we haven't parsed complete token, re-try after data feed.
 	if (m_curToken == TOKEN_INCOMPLETE)
@@ -97,14 +130,28 @@ void Tokenizer::feed (const deUint8* bytes, int numBytes)
 
 int Tokenizer::getChar (int offset) const
 {
-	DE_ASSERT(de::inRange(offset, 0, m_buf.getNumElements()));
+	const int numElements = (int)m_buf.size() - m_bufStart;
+
+	DE_ASSERT(de::inRange(offset, 0, numElements));
 
-	if (offset < m_buf.getNumElements())
-		return m_buf.peekBack(offset);
+	if (offset < numElements)
+		return m_buf[m_bufStart + offset];
 	else
 		return END_OF_BUFFER;
 }
 
+//! Find offset of first byte equal to a, b or c starting from offset, or end of buffer.
+int Tokenizer::scanUntil (int offset, deUint8 a, deUint8 b, deUint8 c) const
+{
+	if (m_buf.empty())
+		return offset;
+
+	const deUint8* const	begin	= &m_buf[0] + m_bufStart;
+	const deUint8* const	end		= &m_buf[0] + m_buf.size();
+
+	return (int)(findFirstOf(begin + offset, end, a, b, c) - begin);
+}
+
 void Tokenizer::advance (void)
 {
 	if (m_curToken != TOKEN_INCOMPLETE)
@@ -121,7 +168,7 @@ void Tokenizer::advance (void)
 			m_state = STATE_DATA;
 
 		// Advance buffer by length of last token.
-		m_buf.popBack(m_curTokenLen);
+		m_bufStart += m_curTokenLen;
 
 		// Reset state.
 		m_curToken		= TOKEN_INCOMPLETE;
@@ -143,6 +190,9 @@ void Tokenizer::advance (void)
 		if (m_state == STATE_DATA)
 		{
 			// Advance until we hit end of buffer or tag start and treat that as data token.
+			m_curTokenLen	= scanUntil(m_curTokenLen, (deUint8)'<', (deUint8)'&', (deUint8)END_OF_STRING);
+			curChar			= getChar(m_curTokenLen);
+
 			if (curChar == END_OF_STRING || curChar == (int)END_OF_BUFFER || curChar == '<' || curChar == '&')
 			{
 				if (curChar == '<')
@@ -156,7 +206,14 @@ void Tokenizer::advance (void)
 					m_curToken = TOKEN_DATA;
 					return;
 				}
-				else if (curChar == END_OF_STRING || curChar == (int)END_OF_BUFFER)
+				else if (curChar == END_OF_STRING)
+				{
+					// End of string was fed separately from the preceding token.
+					m_curToken		= TOKEN_END_OF_STRING;
+					m_curTokenLen	= 1;
+					return;
+				}
+				else if (curChar == (int)END_OF_BUFFER)
 				{
 					// Just return incomplete token, no data parsed.
 					return;
@@ -175,7 +232,7 @@ void Tokenizer::advance (void)
 			{
 				while (isWhitespaceChar(curChar))
 				{
-					m_buf.popBack();
+					m_bufStart += 1;
 					curChar = getChar(0);
 				}
 			}
@@ -226,6 +283,14 @@ void Tokenizer::advance (void)
 			else if (m_state == STATE_VALUE)
 			{
 				// \todo [2012-06-07 pyry] Escapes.
+				m_curTokenLen	= scanUntil(m_curTokenLen, (deUint8)'\'', (deUint8)'"', (deUint8)END_OF_STRING);
+				curChar			= getChar(m_curTokenLen);
+
+				if (curChar == END_OF_STRING)
+					error("Unexpected end of string");
+				else if (curChar == (int)END_OF_BUFFER)
+					return;
+
 				if (curChar == '\'' || curChar == '"')
 				{
 					// \todo [2012-10-17 pyry] Should we actually do the check against getChar(0)?
@@ -338,14 +403,13 @@ void Tokenizer::advance (void)
 void Tokenizer::getString (std::string& dst) const
 {
 	DE_ASSERT(m_curToken == TOKEN_STRING);
-	dst.resize(m_curTokenLen-2);
-	for (int ndx = 0; ndx < m_curTokenLen-2; ndx++)
-		dst[ndx] = m_buf.peekBack(ndx+1);
+	dst.assign((const char*)getTokenPtr() + 1, (size_t)(m_curTokenLen-2));
 }
 
 Parser::Parser (void)
-	: m_element		(ELEMENT_INCOMPLETE)
-	, m_state		(STATE_DATA)
+	: m_element			(ELEMENT_INCOMPLETE)
+	, m_numAttributes	(0)
+	, m_state			(STATE_DATA)
 {
 }
 
@@ -358,11 +422,11 @@ void Parser::clear (void)
 	m_tokenizer.clear();
 	m_elementName.clear();
 	m_attributes.clear();
-	m_attribName.clear();
 	m_entityValue.clear();
 
-	m_element	= ELEMENT_INCOMPLETE;
-	m_state		= STATE_DATA;
+	m_element		= ELEMENT_INCOMPLETE;
+	m_numAttributes	= 0;
+	m_state			= STATE_DATA;
 }
 
 void Parser::error (const std::string& what)
@@ -381,7 +445,7 @@ void Parser::feed (const deUint8* bytes, int numBytes)
 void Parser::advance (void)
 {
 	if (m_element == ELEMENT_START)
-		m_attributes.clear();
+		m_numAttributes = 0;
 
 	// \note No token is advanced when element end is reported.
 	if (m_state == STATE_YIELD_EMPTY_ELEMENT_END)
@@ -487,7 +551,11 @@ void Parser::advance (void)
 			case STATE_ATTRIBUTE_LIST:
 				if (curToken == TOKEN_IDENTIFIER)
 				{
-					m_tokenizer.getTokenStr(m_attribName);
+					// Attribute is stored to the next free slot and committed once its value is parsed.
+					if (m_numAttributes == (int)m_attributes.size())
+						m_attributes.push_back(Attribute());
+
+					m_tokenizer.getTokenStr(m_attributes[m_numAttributes].name);
 					m_state = STATE_EXPECTING_ATTRIBUTE_EQ;
 				}
 				else if (curToken == TOKEN_EMPTY_ELEMENT_END)
@@ -515,11 +583,12 @@ void Parser::advance (void)
 			case STATE_EXPECTING_ATTRIBUTE_VALUE:
 				if (curToken != TOKEN_STRING)
 					error("Expected value");
-				if (hasAttribute(m_attribName.c_str()))
+				if (hasAttribute(m_attributes[m_numAttributes].name.c_str()))
 					error("Duplicate attribute");
 
-				m_tokenizer.getString(m_attributes[m_attribName]);
-				m_state = STATE_ATTRIBUTE_LIST;
+				m_tokenizer.getString(m_attributes[m_numAttributes].value);
+				m_numAttributes	+= 1;
+				m_state			 = STATE_ATTRIBUTE_LIST;
 				break;
 
 			default:
@@ -530,6 +599,17 @@ void Parser::advance (void)
 	}
 }
 
+const Parser::Attribute* Parser::findAttribute (const char* name) const
+{
+	for (int ndx = 0; ndx < m_numAttributes; ndx++)
+	{
+		if (m_attributes[ndx].name == name)
+			return &m_attributes[ndx];
+	}
+
+	return DE_NULL;
+}
+
 static char getEntityValue (const std::string& entity)
 {
 	static const struct
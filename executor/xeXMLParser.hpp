@@ -30,10 +30,9 @@
  *//*--------------------------------------------------------------------*/
 
 #include "xeDefs.hpp"
-#include "deRingBuffer.hpp"
 
 #include <string>
-#include <map>
+#include <vector>
 
 namespace xe
 {
@@ -93,7 +92,8 @@ public:
 
 	Token				getToken			(void) const		{ return m_curToken;	}
 	int					getTokenLen			(void) const		{ return m_curTokenLen;	}
-	deUint8				getTokenByte		(int offset) const	{ DE_ASSERT(m_curToken != TOKEN_INCOMPLETE && m_curToken != TOKEN_END_OF_STRING); return m_buf.peekBack(offset); }
+	deUint8				getTokenByte		(int offset) const	{ DE_ASSERT(m_curToken != TOKEN_INCOMPLETE && m_curToken != TOKEN_END_OF_STRING); return m_buf[m_bufStart+offset]; }
+	const deUint8*		getTokenPtr			(void) const		{ DE_ASSERT(m_curToken != TOKEN_INCOMPLETE && m_curToken != TOKEN_END_OF_STRING); return &m_buf[m_bufStart]; }
 	void				getTokenStr			(std::string& dst) const;
 	void				appendTokenStr		(std::string& dst) const;
 
@@ -104,6 +104,7 @@ private:
 	Tokenizer&			operator=			(const Tokenizer& other);
 
 	int					getChar				(int offset) const;
+	int					scanUntil			(int offset, deUint8 a, deUint8 b, deUint8 c) const;
 
 	void				error				(const std::string& what);
 
@@ -130,15 +131,13 @@ private:
 
 	State						m_state;			//!< Tokenization state.
 
-	de::RingBuffer<deUint8>		m_buf;
+	std::vector<deUint8>		m_buf;				//!< Unconsumed input is contiguous in m_buf[m_bufStart..].
+	int							m_bufStart;			//!< Offset of current token in m_buf.
 };
 
 class Parser
 {
 public:
-	typedef std::map<std::string, std::string>		AttributeMap;
-	typedef AttributeMap::const_iterator			AttributeIter;
-
 						Parser				(void);
 						~Parser				(void);
 
@@ -153,9 +152,11 @@ public:
 	const char*			getElementName		(void) const						{ return m_elementName.c_str();							}
 
 	// For ELEMENT_START.
-	bool				hasAttribute		(const char* name) const			{ return m_attributes.find(name) != m_attributes.end();	}
-	const char*			getAttribute		(const char* name) const			{ return m_attributes.find(name)->second.c_str();		}
-	const AttributeMap&	attributes			(void) const						{ return m_attributes;									}
+	bool				hasAttribute		(const char* name) const			{ return findAttribute(name) != DE_NULL;				}
+	const char*			getAttribute		(const char* name) const			{ DE_ASSERT(hasAttribute(name)); return findAttribute(name)->value.c_str();	}
+	int					getNumAttributes	(void) const						{ return m_numAttributes;								}
+	const char*			getAttributeName	(int ndx) const						{ DE_ASSERT(de::inBounds(ndx, 0, m_numAttributes)); return m_attributes[ndx].name.c_str();	}
+	const char*			getAttributeValue	(int ndx) const						{ DE_ASSERT(de::inBounds(ndx, 0, m_numAttributes)); return m_attributes[ndx].value.c_str();	}
 
 	// For ELEMENT_DATA.
 	int					getDataSize			(void) const;
@@ -167,6 +168,13 @@ private:
 						Parser				(const Parser& other);
 	Parser&				operator=			(const Parser& other);
 
+	struct Attribute
+	{
+		std::string		name;
+		std::string		value;
+	};
+
+	const Attribute*	findAttribute		(const char* name) const;
 	void				parseEntityValue	(void);
 
 	void				error				(const std::string& what);
@@ -191,10 +199,10 @@ private:
 
 	Element				m_element;
 	std::string			m_elementName;
-	AttributeMap		m_attributes;
+	std::vector<Attribute>	m_attributes;		//!< Attributes of current element. Entries past m_numAttributes are kept to reuse their storage.
+	int					m_numAttributes;
 
 	State				m_state;
-	std::string			m_attribName;
 	std::string			m_entityValue;		//!< Data override, such as entity value.
 };
 
@@ -203,20 +211,13 @@ private:
 inline void Tokenizer::getTokenStr (std::string& dst) const
 {
 	DE_ASSERT(m_curToken != TOKEN_INCOMPLETE && m_curToken != TOKEN_END_OF_STRING);
-	dst.resize(m_curTokenLen);
-	for (int ndx = 0; ndx < m_curTokenLen; ndx++)
-		dst[ndx] = m_buf.peekBack(ndx);
+	dst.assign((const char*)getTokenPtr(), (size_t)m_curTokenLen);
 }
 
 inline void Tokenizer::appendTokenStr (std::string& dst) const
 {
 	DE_ASSERT(m_curToken != TOKEN_INCOMPLETE && m_curToken != TOKEN_END_OF_STRING);
-
-	size_t oldLen = dst.size();
-	dst.resize(oldLen+m_curTokenLen);
-
-	for (int ndx = 0; ndx < m_curTokenLen; ndx++)
-		dst[oldLen+ndx] = m_buf.peekBack(ndx);
+	dst.append((const char*)getTokenPtr(), (size_t)m_curTokenLen);
 }
 
 inline int Parser::getDataSize (void) const
@@ -29,6 +29,8 @@
 #include "deInt32.h"
 
 #include <sstream>
+#include <set>
+#include <algorithm>
 
 namespace vk
 {
@@ -210,6 +212,358 @@ MovePtr<Allocation> SimpleAllocator::allocate (const VkMemoryRequirements& memRe
 	return MovePtr<Allocation>(new SimpleAllocation(mem, hostPtr));
 }
 
+// SubAllocator
+
+class SubAllocator::MemoryBlock
+{
+public:
+									MemoryBlock			(const DeviceInterface& vk, VkDevice device, const VkMemoryAllocateInfo& allocInfo, bool hostVisible, VkDeviceSize minAllocationSize, int numOrders);
+
+	bool							allocate			(int order, VkDeviceSize* offset);
+	void							free				(VkDeviceSize offset, int order);
+
+	bool							isEmpty				(void) const { return m_numAllocations == 0;		}
+	deUint32						getMemoryTypeIndex	(void) const { return m_memoryTypeNdx;				}
+	VkDeviceMemory					getMemory			(void) const { return *m_memory;					}
+	void*							getHostPtr			(VkDeviceSize offset) const;
+	VkDeviceSize					getLargestFreeRange	(void) const;
+
+private:
+	typedef std::set<VkDeviceSize>	FreeList;
+
+	VkDeviceSize					getRangeSize		(int order) const { return m_minAllocationSize << order;	}
+
+	const Unique<VkDeviceMemory>	m_memory;
+	const UniquePtr<HostPtr>		m_hostPtr;
+	const deUint32					m_memoryTypeNdx;
+	const VkDeviceSize				m_minAllocationSize;
+
+	std::vector<FreeList>			m_freeLists;		//!< Offsets of free ranges for each order.
+	deUint32						m_numAllocations;
+};
+
+SubAllocator::MemoryBlock::MemoryBlock (const DeviceInterface& vk, VkDevice device, const VkMemoryAllocateInfo& allocInfo, bool hostVisible, VkDeviceSize minAllocationSize, int numOrders)
+	: m_memory				(allocateMemory(vk, device, &allocInfo))
+	, m_hostPtr				(hostVisible ? new HostPtr(vk, device, *m_memory, 0u, allocInfo.allocationSize, 0u) : DE_NULL)
+	, m_memoryTypeNdx		(allocInfo.memoryTypeIndex)
+	, m_minAllocationSize	(minAllocationSize)
+	, m_freeLists			(numOrders)
+	, m_numAllocations		(0u)
+{
+	DE_ASSERT(getRangeSize(numOrders-1) == allocInfo.allocationSize);
+	m_freeLists.back().insert(0u);
+}
+
+bool SubAllocator::MemoryBlock::allocate (int order, VkDeviceSize* offset)
+{
+	int srcOrder = order;
+
+	while (srcOrder < (int)m_freeLists.size() && m_freeLists[srcOrder].empty())
+		srcOrder += 1;
+
+	if (srcOrder == (int)m_freeLists.size())
+		return false;
+
+	*offset = *m_freeLists[srcOrder].begin();
+	m_freeLists[srcOrder].erase(m_freeLists[srcOrder].begin());
+
+	// Split range until it has requested size, upper halves become free.
+	while (srcOrder > order)
+	{
+		srcOrder -= 1;
+		m_freeLists[srcOrder].insert(*offset + getRangeSize(srcOrder));
+	}
+
+	m_numAllocations += 1;
+	return true;
+}
+
+void SubAllocator::MemoryBlock::free (VkDeviceSize offset, int order)
+{
+	DE_ASSERT(m_numAllocations > 0);
+
+	// Merge with free buddies.
+	while (order+1 < (int)m_freeLists.size())
+	{
+		const VkDeviceSize			buddyOffset	= offset ^ getRangeSize(order);
+		const FreeList::iterator	buddy		= m_freeLists[order].find(buddyOffset);
+
+		if (buddy == m_freeLists[order].end())
+			break;
+
+		m_freeLists[order].erase(buddy);
+		offset	 = de::min(offset, buddyOffset);
+		order	+= 1;
+	}
+
+	m_freeLists[order].insert(offset);
+	m_numAllocations -= 1;
+}
+
+void* SubAllocator::MemoryBlock::getHostPtr (VkDeviceSize offset) const
+{
+	return m_hostPtr ? (deUint8*)m_hostPtr->get() + offset : DE_NULL;
+}
+
+VkDeviceSize SubAllocator::MemoryBlock::getLargestFreeRange (void) const
+{
+	for (int order = (int)m_freeLists.size()-1; order >= 0; order--)
+	{
+		if (!m_freeLists[order].empty())
+			return getRangeSize(order);
+	}
+
+	return 0u;
+}
+
+class SubAllocation : public Allocation
+{
+public:
+								SubAllocation	(SubAllocator& allocator, SubAllocator::MemoryBlock* block, VkDeviceSize offset, int order, VkDeviceSize requestedSize);
+	virtual						~SubAllocation	(void);
+
+private:
+	SubAllocator&				m_allocator;
+	SubAllocator::MemoryBlock*	m_block;
+	const int					m_order;
+	const VkDeviceSize			m_requestedSize;
+};
+
+SubAllocation::SubAllocation (SubAllocator& allocator, SubAllocator::MemoryBlock* block, VkDeviceSize offset, int order, VkDeviceSize requestedSize)
+	: Allocation		(block->getMemory(), offset, block->getHostPtr(offset))
+	, m_allocator		(allocator)
+	, m_block			(block)
+	, m_order			(order)
+	, m_requestedSize	(requestedSize)
+{
+}
+
+SubAllocation::~SubAllocation (void)
+{
+	m_allocator.free(m_block, getOffset(), m_order, m_requestedSize);
+}
+
+class DedicatedAllocation : public Allocation
+{
+public:
+									DedicatedAllocation		(SubAllocator& allocator, Move<VkDeviceMemory> mem, MovePtr<HostPtr> hostPtr);
+	virtual							~DedicatedAllocation	(void);
+
+private:
+	SubAllocator&					m_allocator;
+	const Unique<VkDeviceMemory>	m_memHolder;
+	const UniquePtr<HostPtr>		m_hostPtr;
+};
+
+DedicatedAllocation::DedicatedAllocation (SubAllocator& allocator, Move<VkDeviceMemory> mem, MovePtr<HostPtr> hostPtr)
+	: Allocation	(*mem, (VkDeviceSize)0, hostPtr ? hostPtr->get() : DE_NULL)
+	, m_allocator	(allocator)
+	, m_memHolder	(mem)
+	, m_hostPtr		(hostPtr)
+{
+}
+
+DedicatedAllocation::~DedicatedAllocation (void)
+{
+	m_allocator.freeDedicated();
+}
+
+SubAllocator::Statistics::Statistics (void)
+	: numBlocks					(0u)
+	, numSubAllocations			(0u)
+	, numDedicatedAllocations	(0u)
+	, blockBytes				(0u)
+	, requestedBytes			(0u)
+	, reservedBytes				(0u)
+	, largestFreeRange			(0u)
+{
+}
+
+float SubAllocator::Statistics::getExternalFragmentation (void) const
+{
+	const VkDeviceSize freeBytes = blockBytes - reservedBytes;
+
+	return freeBytes > 0 ? 1.0f - (float)largestFreeRange / (float)freeBytes : 0.0f;
+}
+
+float SubAllocator::Statistics::getInternalFragmentation (void) const
+{
+	return reservedBytes > 0 ? 1.0f - (float)requestedBytes / (float)reservedBytes : 0.0f;
+}
+
+static int getNumBuddyOrders (VkDeviceSize blockSize, VkDeviceSize minAllocationSize)
+{
+	int numOrders = 1;
+
+	TCU_CHECK_INTERNAL(deIsPowerOfTwo64(blockSize) && deIsPowerOfTwo64(minAllocationSize) && minAllocationSize <= blockSize);
+
+	while ((minAllocationSize << (numOrders-1)) < blockSize)
+		numOrders += 1;
+
+	return numOrders;
+}
+
+SubAllocator::SubAllocator (const DeviceInterface&					vk,
+							VkDevice								device,
+							const VkPhysicalDeviceMemoryProperties&	deviceMemProps,
+							VkDeviceSize							blockSize,
+							VkDeviceSize							minAllocationSize)
+	: m_vk					(vk)
+	, m_device				(device)
+	, m_memProps			(deviceMemProps)
+	, m_blockSize			(blockSize)
+	, m_minAllocationSize	(minAllocationSize)
+	, m_numOrders			(getNumBuddyOrders(blockSize, minAllocationSize))
+	, m_blocks				(deviceMemProps.memoryTypeCount)
+{
+}
+
+SubAllocator::~SubAllocator (void)
+{
+	// \note Only cached empty blocks should remain.
+	DE_ASSERT(m_liveStats.numSubAllocations == 0 && m_liveStats.numDedicatedAllocations == 0);
+
+	for (size_t typeNdx = 0; typeNdx < m_blocks.size(); typeNdx++)
+	{
+		for (size_t blockNdx = 0; blockNdx < m_blocks[typeNdx].size(); blockNdx++)
+			delete m_blocks[typeNdx][blockNdx];
+	}
+}
+
+MovePtr<Allocation> SubAllocator::allocate (const VkMemoryAllocateInfo& allocInfo, VkDeviceSize alignment)
+{
+	const bool			hostVisible	= isHostVisibleMemory(m_memProps, allocInfo.memoryTypeIndex);
+	const VkDeviceSize	minSize		= de::max(de::max(allocInfo.allocationSize, alignment), m_minAllocationSize);
+	int					order		= 0;
+
+	DE_ASSERT(alignment == 0 || deIsPowerOfTwo64(alignment));
+
+	if (minSize > m_blockSize)
+	{
+		Move<VkDeviceMemory>	mem		= allocateMemory(m_vk, m_device, &allocInfo);
+		MovePtr<HostPtr>		hostPtr;
+
+		if (hostVisible)
+			hostPtr = MovePtr<HostPtr>(new HostPtr(m_vk, m_device, *mem, 0u, allocInfo.allocationSize, 0u));
+
+		{
+			MovePtr<Allocation>		allocation	(new DedicatedAllocation(*this, mem, hostPtr));
+			const de::ScopedLock	lock		(m_lock);
+
+			m_liveStats.numDedicatedAllocations += 1;
+			return allocation;
+		}
+	}
+
+	while ((m_minAllocationSize << order) < minSize)
+		order += 1;
+
+	{
+		const de::ScopedLock		lock	(m_lock);
+		std::vector<MemoryBlock*>&	blocks	= m_blocks[allocInfo.memoryTypeIndex];
+		MemoryBlock*				block	= DE_NULL;
+		VkDeviceSize				offset	= 0;
+
+		for (size_t blockNdx = 0; blockNdx < blocks.size() && !block; blockNdx++)
+		{
+			if (blocks[blockNdx]->allocate(order, &offset))
+				block = blocks[blockNdx];
+		}
+
+		if (!block)
+		{
+			const VkMemoryAllocateInfo	blockAllocInfo	=
+			{
+				VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,	//	VkStructureType			sType;
+				DE_NULL,								//	const void*				pNext;
+				m_blockSize,							//	VkDeviceSize			allocationSize;
+				allocInfo.memoryTypeIndex,				//	deUint32				memoryTypeIndex;
+			};
+
+			blocks.reserve(blocks.size()+1);
+			blocks.push_back(new MemoryBlock(m_vk, m_device, blockAllocInfo, hostVisible, m_minAllocationSize, m_numOrders));
+			block = blocks.back();
+
+			if (!block->allocate(order, &offset))
+				DE_FATAL("Allocation from empty block failed");
+		}
+
+		m_liveStats.numSubAllocations	+= 1;
+		m_liveStats.requestedBytes		+= allocInfo.allocationSize;
+		m_liveStats.reservedBytes		+= m_minAllocationSize << order;
+
+		return MovePtr<Allocation>(new SubAllocation(*this, block, offset, order, allocInfo.allocationSize));
+	}
+}
+
+MovePtr<Allocation> SubAllocator::allocate (const VkMemoryRequirements& memReqs, MemoryRequirement requirement)
+{
+	const deUint32				memoryTypeNdx	= selectMatchingMemoryType(m_memProps, memReqs.memoryTypeBits, requirement);
+	const VkMemoryAllocateInfo	allocInfo		=
+	{
+		VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,	//	VkStructureType			sType;
+		DE_NULL,								//	const void*				pNext;
+		memReqs.size,							//	VkDeviceSize			allocationSize;
+		memoryTypeNdx,							//	deUint32				memoryTypeIndex;
+	};
+
+	return allocate(allocInfo, memReqs.alignment);
+}
+
+void SubAllocator::free (MemoryBlock* block, VkDeviceSize offset, int order, VkDeviceSize requestedSize)
+{
+	const de::ScopedLock	lock	(m_lock);
+
+	block->free(offset, order);
+
+	DE_ASSERT(m_liveStats.numSubAllocations > 0);
+	m_liveStats.numSubAllocations	-= 1;
+	m_liveStats.requestedBytes		-= requestedSize;
+	m_liveStats.reservedBytes		-= m_minAllocationSize << order;
+
+	// Keep at most one empty block per memory type around for reuse.
+	if (block->isEmpty())
+	{
+		std::vector<MemoryBlock*>&	blocks		= m_blocks[block->getMemoryTypeIndex()];
+		int							numEmpty	= 0;
+
+		for (size_t blockNdx = 0; blockNdx < blocks.size(); blockNdx++)
+			numEmpty += blocks[blockNdx]->isEmpty() ? 1 : 0;
+
+		if (numEmpty > 1)
+		{
+			blocks.erase(std::find(blocks.begin(), blocks.end(), block));
+			delete block;
+		}
+	}
+}
+
+void SubAllocator::freeDedicated (void)
+{
+	const de::ScopedLock	lock	(m_lock);
+
+	DE_ASSERT(m_liveStats.numDedicatedAllocations > 0);
+	m_liveStats.numDedicatedAllocations -= 1;
+}
+
+SubAllocator::Statistics SubAllocator::getStatistics (void) const
+{
+	const de::ScopedLock	lock	(m_lock);
+	Statistics				stats	= m_liveStats;
+
+	for (size_t typeNdx = 0; typeNdx < m_blocks.size(); typeNdx++)
+	{
+		for (size_t blockNdx = 0; blockNdx < m_blocks[typeNdx].size(); blockNdx++)
+		{
+			stats.numBlocks			+= 1;
+			stats.blockBytes		+= m_blockSize;
+			stats.largestFreeRange	 = de::max(stats.largestFreeRange, m_blocks[typeNdx][blockNdx]->getLargestFreeRange());
+		}
+	}
+
+	return stats;
+}
+
 void flushMappedMemoryRange (const DeviceInterface& vkd, VkDevice device, VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize size)
 {
 	const VkMappedMemoryRange	range	=
@@ -25,6 +25,9 @@
 
 #include "vkDefs.hpp"
 #include "deUniquePtr.hpp"
+#include "deMutex.hpp"
+
+#include <vector>
 
 namespace vk
 {
@@ -133,6 +136,85 @@ private:
 	const VkPhysicalDeviceMemoryProperties	m_memProps;
 };
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Allocator that sub-allocates from large VkDeviceMemory blocks
+ *
+ * Memory is allocated in blocks of blockSize bytes for each memory type,
+ * and blocks are split into power-of-two sized ranges using a buddy
+ * allocator. Ranges are aligned to their size, so any alignment up to
+ * blockSize is satisfied. Larger requests get their own VkDeviceMemory.
+ *
+ * All ranges are at least minAllocationSize bytes. If linear and optimal
+ * tiling resources are placed in memory from the same allocator, it must
+ * be at least bufferImageGranularity, and if non-coherent memory is
+ * flushed, at least nonCoherentAtomSize.
+ *
+ * Host-visible blocks are kept persistently mapped. Allocator must
+ * outlive all allocations made from it.
+ *//*--------------------------------------------------------------------*/
+class SubAllocator : public Allocator
+{
+public:
+	enum
+	{
+		DEFAULT_BLOCK_SIZE			= 32*1024*1024,
+		DEFAULT_MIN_ALLOCATION_SIZE	= 256
+	};
+
+	struct Statistics
+	{
+		deUint32		numBlocks;					//!< VkDeviceMemory blocks used for sub-allocation.
+		deUint32		numSubAllocations;			//!< Live allocations in blocks.
+		deUint32		numDedicatedAllocations;	//!< Live allocations too large for blocks.
+		VkDeviceSize	blockBytes;					//!< Total size of blocks.
+		VkDeviceSize	requestedBytes;				//!< Requested size of live sub-allocations.
+		VkDeviceSize	reservedBytes;				//!< Block space used by live sub-allocations.
+		VkDeviceSize	largestFreeRange;			//!< Largest free range in a single block.
+
+						Statistics					(void);
+
+		//! Fraction of free block space that is not part of the largest free range.
+		float			getExternalFragmentation	(void) const;
+
+		//! Fraction of reserved block space lost to rounding up request sizes.
+		float			getInternalFragmentation	(void) const;
+	};
+
+											SubAllocator		(const DeviceInterface&						vk,
+																 VkDevice									device,
+																 const VkPhysicalDeviceMemoryProperties&	deviceMemProps,
+																 VkDeviceSize								blockSize			= DEFAULT_BLOCK_SIZE,
+																 VkDeviceSize								minAllocationSize	= DEFAULT_MIN_ALLOCATION_SIZE);
+											~SubAllocator		(void);
+
+	de::MovePtr<Allocation>					allocate			(const VkMemoryAllocateInfo& allocInfo, VkDeviceSize alignment);
+	de::MovePtr<Allocation>					allocate			(const VkMemoryRequirements& memRequirements, MemoryRequirement requirement);
+
+	Statistics								getStatistics		(void) const;
+
+private:
+	class MemoryBlock;
+	friend class SubAllocation;
+	friend class DedicatedAllocation;
+
+											SubAllocator		(const SubAllocator&); // not allowed
+	SubAllocator&							operator=			(const SubAllocator&); // not allowed
+
+	void									free				(MemoryBlock* block, VkDeviceSize offset, int order, VkDeviceSize requestedSize);
+	void									freeDedicated		(void);
+
+	const DeviceInterface&					m_vk;
+	const VkDevice							m_device;
+	const VkPhysicalDeviceMemoryProperties	m_memProps;
+	const VkDeviceSize						m_blockSize;
+	const VkDeviceSize						m_minAllocationSize;
+	const int								m_numOrders;
+
+	mutable de::Mutex						m_lock;				//!< Protects state below.
+	std::vector<std::vector<MemoryBlock*> >	m_blocks;			//!< Blocks for each memory type.
+	Statistics								m_liveStats;		//!< Allocation counters, block counts are computed on query.
+};
+
 void	flushMappedMemoryRange		(const DeviceInterface& vkd, VkDevice device, VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize size);
 void	invalidateMappedMemoryRange	(const DeviceInterface& vkd, VkDevice device, VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize size);
 
@@ -0,0 +1,215 @@
+/*-------------------------------------------------------------------------
+ * Vulkan CTS Framework
+ * --------------------
+ *
+ * Copyright (c) 2015 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Persistent program binary cache.
+ *//*--------------------------------------------------------------------*/
+
+#include "vkProgramBinaryCache.hpp"
+#include "deFilePath.hpp"
+#include "deStringUtil.hpp"
+#include "deClock.h"
+#include "deFile.h"
+#include "deMemory.h"
+#include "qpInfo.h"
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <cstdio>
+
+namespace vk
+{
+
+using std::string;
+using std::vector;
+
+namespace
+{
+
+enum
+{
+	SPIRV_MAGIC_NUMBER		= 0x07230203,
+	SPIRV_HEADER_WORDS		= 5
+};
+
+bool isValidSpirVBinary (const vector<deUint8>& bytes)
+{
+	deUint32 magic = 0;
+
+	if (bytes.size() < SPIRV_HEADER_WORDS*sizeof(deUint32) || (bytes.size() % sizeof(deUint32)) != 0)
+		return false;
+
+	deMemcpy(&magic, &bytes[0], sizeof(magic));
+
+	return magic == (deUint32)SPIRV_MAGIC_NUMBER;
+}
+
+// Common prefix for all keys. Binaries built by different dEQP releases
+// (and thus possibly different compilers) never share cache entries.
+void beginKey (de::Sha1Stream& stream, const char* sourceType)
+{
+	stream << string(qpGetReleaseName()) << string(sourceType);
+}
+
+} // anonymous
+
+ProgramBinaryCache::ProgramBinaryCache (const std::string& dirName)
+	: m_dirName		(dirName)
+	, m_numHits		(0)
+	, m_numMisses	(0)
+	, m_numStores	(0)
+{
+	if (!de::FilePath(m_dirName).exists())
+		de::createDirectoryAndParents(m_dirName.c_str());
+}
+
+std::string ProgramBinaryCache::getPath (const de::Sha1& key) const
+{
+	return de::FilePath::join(m_dirName, key.toString() + ".spv").getPath();
+}
+
+ProgramBinary* ProgramBinaryCache::load (const de::Sha1& key)
+{
+	std::ifstream in (getPath(key).c_str(), std::ios_base::binary);
+
+	if (in.is_open())
+	{
+		const vector<deUint8> bytes ((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+		if (isValidSpirVBinary(bytes))
+		{
+			m_numHits += 1;
+			return new ProgramBinary(PROGRAM_FORMAT_SPIRV, bytes.size(), &bytes[0]);
+		}
+	}
+
+	m_numMisses += 1;
+	return DE_NULL;
+}
+
+bool ProgramBinaryCache::store (const de::Sha1& key, const ProgramBinary& binary)
+{
+	const string	dstPath		= getPath(key);
+	const string	tmpPath		= dstPath + "." + de::toString(deGetMicroseconds()) + "-" + de::toString(m_numStores++) + ".tmp";
+
+	DE_ASSERT(binary.getFormat() == PROGRAM_FORMAT_SPIRV);
+
+	{
+		std::ofstream out (tmpPath.c_str(), std::ios_base::binary);
+
+		if (!out.is_open())
+			return false;
+
+		out.write((const char*)binary.getBinary(), (std::streamsize)binary.getSize());
+
+		if (!out.good())
+		{
+			out.close();
+			deDeleteFile(tmpPath.c_str());
+			return false;
+		}
+	}
+
+	// \note Rename fails on some platforms if another process already stored
+	//       the same entry. Contents are identical, so that is not an error.
+	if (std::rename(tmpPath.c_str(), dstPath.c_str()) != 0)
+		deDeleteFile(tmpPath.c_str());
+
+	return true;
+}
+
+de::Sha1 getProgramCacheKey (const glu::ProgramSources& program, ProgramFormat binaryFormat)
+{
+	de::Sha1Stream stream;
+
+	beginKey(stream, "glsl");
+	stream << (deUint32)binaryFormat;
+
+	// \note Only shader sources affect the Vulkan compilation result.
+	for (int shaderType = 0; shaderType < glu::SHADERTYPE_LAST; shaderType++)
+		stream << program.sources[shaderType];
+
+	return stream.finalize();
+}
+
+de::Sha1 getProgramCacheKey (const SpirVAsmSource& program)
+{
+	de::Sha1Stream stream;
+
+	beginKey(stream, "spirv-asm");
+	stream << program.source;
+
+	return stream.finalize();
+}
+
+void programBinaryCacheSelfTest (void)
+{
+	// \note Entries are written into current directory and removed afterwards.
+	ProgramBinaryCache		cache		(".");
+	glu::ProgramSources		vtxProgram;
+	glu::ProgramSources		fragProgram;
+	const SpirVAsmSource	asmProgram	("OpCapability Shader\n");
+	const deUint32			words[]		= { (deUint32)SPIRV_MAGIC_NUMBER, 0x00010000u, 0u, 1u, 0u };
+	const ProgramBinary		binary		(PROGRAM_FORMAT_SPIRV, sizeof(words), (const deUint8*)&words[0]);
+
+	vtxProgram << glu::VertexSource("void main (void) {}");
+	fragProgram << glu::FragmentSource("void main (void) {}");
+
+	const de::Sha1			vtxKey		= getProgramCacheKey(vtxProgram, PROGRAM_FORMAT_SPIRV);
+	const de::Sha1			fragKey		= getProgramCacheKey(fragProgram, PROGRAM_FORMAT_SPIRV);
+	const de::Sha1			asmKey		= getProgramCacheKey(asmProgram);
+
+	// Same source in different stages must not share entries.
+	DE_TEST_ASSERT(vtxKey != fragKey);
+	DE_TEST_ASSERT(vtxKey != asmKey);
+	DE_TEST_ASSERT(vtxKey == getProgramCacheKey(vtxProgram, PROGRAM_FORMAT_SPIRV));
+
+	deDeleteFile(cache.getPath(vtxKey).c_str());
+	deDeleteFile(cache.getPath(fragKey).c_str());
+
+	DE_TEST_ASSERT(!de::MovePtr<ProgramBinary>(cache.load(vtxKey)));
+	DE_TEST_ASSERT(cache.store(vtxKey, binary));
+
+	{
+		const de::MovePtr<ProgramBinary> loaded (cache.load(vtxKey));
+
+		DE_TEST_ASSERT(loaded);
+		DE_TEST_ASSERT(loaded->getSize() == binary.getSize());
+		DE_TEST_ASSERT(deMemCmp(loaded->getBinary(), binary.getBinary(), binary.getSize()) == 0);
+	}
+
+	DE_TEST_ASSERT(!de::MovePtr<ProgramBinary>(cache.load(fragKey)));
+
+	// Malformed entry is a miss.
+	{
+		std::ofstream out (cache.getPath(fragKey).c_str(), std::ios_base::binary);
+		out << "not a SPIR-V binary";
+	}
+
+	DE_TEST_ASSERT(!de::MovePtr<ProgramBinary>(cache.load(fragKey)));
+
+	DE_TEST_ASSERT(cache.getNumHits() == 1);
+	DE_TEST_ASSERT(cache.getNumMisses() == 3);
+
+	deDeleteFile(cache.getPath(vtxKey).c_str());
+	deDeleteFile(cache.getPath(fragKey).c_str());
+}
+
+} // vk
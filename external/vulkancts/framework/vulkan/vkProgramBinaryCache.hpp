@@ -0,0 +1,77 @@
+#ifndef _VKPROGRAMBINARYCACHE_HPP
+#define _VKPROGRAMBINARYCACHE_HPP
+/*-------------------------------------------------------------------------
+ * Vulkan CTS Framework
+ * --------------------
+ *
+ * Copyright (c) 2015 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Persistent program binary cache.
+ *//*--------------------------------------------------------------------*/
+
+#include "vkDefs.hpp"
+#include "vkPrograms.hpp"
+#include "deSha1.hpp"
+
+#include <string>
+
+namespace vk
+{
+
+/*--------------------------------------------------------------------*//*!
+ * \brief On-disk cache of compiled program binaries
+ *
+ * Binaries are stored as <dir>/<key>.spv where key is a SHA1 hash of
+ * everything that affects compilation result. Cache directory may be
+ * shared by several concurrently running processes: entries are written
+ * into temporary files and then renamed into place, and unreadable or
+ * malformed entries are treated as misses.
+ *
+ * \note Only successfully built programs should be stored.
+ *//*--------------------------------------------------------------------*/
+class ProgramBinaryCache
+{
+public:
+	explicit				ProgramBinaryCache	(const std::string& dirName);
+
+	//! Load binary or return DE_NULL on miss.
+	ProgramBinary*			load				(const de::Sha1& key);
+
+	//! Store binary, returns false if cache entry couldn't be written.
+	bool					store				(const de::Sha1& key, const ProgramBinary& binary);
+
+	int						getNumHits			(void) const { return m_numHits;	}
+	int						getNumMisses		(void) const { return m_numMisses;	}
+
+	//! Get path of cache entry file.
+	std::string				getPath				(const de::Sha1& key) const;
+
+private:
+	const std::string		m_dirName;
+	int						m_numHits;
+	int						m_numMisses;
+	int						m_numStores;
+};
+
+de::Sha1	getProgramCacheKey	(const glu::ProgramSources& program, ProgramFormat binaryFormat);
+de::Sha1	getProgramCacheKey	(const SpirVAsmSource& program);
+
+void		programBinaryCacheSelfTest	(void);
+
+} // vk
+
+#endif // _VKPROGRAMBINARYCACHE_HPP
@@ -38,6 +38,7 @@
 #include "tcuStringTemplate.hpp"
 #include "tcuTexture.hpp"
 #include "tcuTestLog.hpp"
+#include "tcuCommandLine.hpp"
 #include "tcuVector.hpp"
 #include "tcuVectorUtil.hpp"
 
@@ -1825,7 +1826,7 @@ public:
 	void init (void)
 	{
 		ShaderCaseFactory				caseFactory	(m_testCtx);
-		const vector<tcu::TestNode*>	children	= glu::sl::parseFile(m_testCtx.getArchive(), m_filename, &caseFactory);
+		const vector<tcu::TestNode*>	children	= glu::sl::parseFile(m_testCtx.getArchive(), m_filename, &caseFactory, m_testCtx.getCommandLine().getShaderLibraryCacheDir());
 
 		for (size_t ndx = 0; ndx < children.size(); ndx++)
 		{
@@ -31,6 +31,7 @@
 #include "vkPlatform.hpp"
 #include "vkPrograms.hpp"
 #include "vkBinaryRegistry.hpp"
+#include "vkProgramBinaryCache.hpp"
 #include "vkGlslToSpirV.hpp"
 #include "vkDebugReportUtil.hpp"
 #include "vkQueryUtil.hpp"
@@ -93,10 +94,21 @@ vk::ProgramBinary* compileProgram (const vk::SpirVAsmSource& source, vk::SpirVPr
 	return vk::assembleProgram(source, buildInfo);
 }
 
+de::Sha1 getCacheKey (const glu::ProgramSources& source)
+{
+	return vk::getProgramCacheKey(source, vk::PROGRAM_FORMAT_SPIRV);
+}
+
+de::Sha1 getCacheKey (const vk::SpirVAsmSource& source)
+{
+	return vk::getProgramCacheKey(source);
+}
+
 template <typename InfoType, typename IteratorType>
 vk::ProgramBinary* buildProgram (const std::string&					casePath,
 								 IteratorType						iter,
 								 const vk::BinaryRegistryReader&	prebuiltBinRegistry,
+								 vk::ProgramBinaryCache*			binaryCache,
 								 tcu::TestLog&						log,
 								 vk::BinaryCollection*				progCollection)
 {
@@ -105,25 +117,39 @@ vk::ProgramBinary* buildProgram (const std::string&					casePath,
 	de::MovePtr<vk::ProgramBinary>	binProg;
 	InfoType						buildInfo;
 
-	try
+	if (binaryCache)
 	{
-		binProg	= de::MovePtr<vk::ProgramBinary>(compileProgram(iter.getProgram(), &buildInfo));
-		log << buildInfo;
+		binProg = de::MovePtr<vk::ProgramBinary>(binaryCache->load(getCacheKey(iter.getProgram())));
+
+		if (binProg)
+			log << iter.getProgram() << tcu::TestLog::Message << "Loaded binary from program cache" << tcu::TestLog::EndMessage;
 	}
-	catch (const tcu::NotSupportedError& err)
+
+	if (!binProg)
 	{
-		// Try to load from cache
-		log << err << tcu::TestLog::Message << "Building from source not supported, loading stored binary instead" << tcu::TestLog::EndMessage;
+		try
+		{
+			binProg	= de::MovePtr<vk::ProgramBinary>(compileProgram(iter.getProgram(), &buildInfo));
+			log << buildInfo;
+
+			if (binaryCache && !binaryCache->store(getCacheKey(iter.getProgram()), *binProg))
+				log << tcu::TestLog::Message << "WARNING: Failed to store binary in program cache" << tcu::TestLog::EndMessage;
+		}
+		catch (const tcu::NotSupportedError& err)
+		{
+			// Try to load from cache
+			log << err << tcu::TestLog::Message << "Building from source not supported, loading stored binary instead" << tcu::TestLog::EndMessage;
 
-		binProg = de::MovePtr<vk::ProgramBinary>(prebuiltBinRegistry.loadProgram(progId));
+			binProg = de::MovePtr<vk::ProgramBinary>(prebuiltBinRegistry.loadProgram(progId));
 
-		log << iter.getProgram();
-	}
-	catch (const tcu::Exception&)
-	{
-		// Build failed for other reason
-		log << buildInfo;
-		throw;
+			log << iter.getProgram();
+		}
+		catch (const tcu::Exception&)
+		{
+			// Build failed for other reason
+			log << buildInfo;
+			throw;
+		}
 	}
 
 	TCU_CHECK_INTERNAL(binProg);
@@ -176,6 +202,7 @@ public:
 private:
 	vk::BinaryCollection						m_progCollection;
 	vk::BinaryRegistryReader					m_prebuiltBinRegistry;
+	const UniquePtr<vk::ProgramBinaryCache>		m_binaryCache;		//!< Persistent program cache, or null if not enabled.
 
 	const UniquePtr<vk::Library>				m_library;
 	Context										m_context;
@@ -190,8 +217,17 @@ static MovePtr<vk::Library> createLibrary (tcu::TestContext& testCtx)
 	return MovePtr<vk::Library>(testCtx.getPlatform().getVulkanPlatform().createLibrary());
 }
 
+static MovePtr<vk::ProgramBinaryCache> createProgramBinaryCache (const tcu::CommandLine& cmdLine)
+{
+	if (cmdLine.getVKProgramCacheDir())
+		return MovePtr<vk::ProgramBinaryCache>(new vk::ProgramBinaryCache(cmdLine.getVKProgramCacheDir()));
+	else
+		return MovePtr<vk::ProgramBinaryCache>();
+}
+
 TestCaseExecutor::TestCaseExecutor (tcu::TestContext& testCtx)
 	: m_prebuiltBinRegistry	(testCtx.getArchive(), "vulkan/prebuilt")
+	, m_binaryCache			(createProgramBinaryCache(testCtx.getCommandLine()))
 	, m_library				(createLibrary(testCtx))
 	, m_context				(testCtx, m_library->getPlatformInterface(), m_progCollection)
 	, m_debugReportRecorder	(testCtx.getCommandLine().isValidationEnabled()
@@ -206,6 +242,9 @@ TestCaseExecutor::TestCaseExecutor (tcu::TestContext& testCtx)
 TestCaseExecutor::~TestCaseExecutor (void)
 {
 	delete m_instance;
+
+	if (m_binaryCache)
+		tcu::print("Program cache: %d hits, %d misses\n", m_binaryCache->getNumHits(), m_binaryCache->getNumMisses());
 }
 
 void TestCaseExecutor::init (tcu::TestCase* testCase, const std::string& casePath)
@@ -219,12 +258,15 @@ void TestCaseExecutor::init (tcu::TestCase* testCase, const std::string& casePat
 	if (!vktCase)
 		TCU_THROW(InternalError, "Test node not an instance of vkt::TestCase");
 
+	const int				numCacheHits	= m_binaryCache ? m_binaryCache->getNumHits() : 0;
+	const int				numCacheMisses	= m_binaryCache ? m_binaryCache->getNumMisses() : 0;
+
 	m_progCollection.clear();
 	vktCase->initPrograms(sourceProgs);
 
 	for (vk::GlslSourceCollection::Iterator progIter = sourceProgs.glslSources.begin(); progIter != sourceProgs.glslSources.end(); ++progIter)
 	{
-		vk::ProgramBinary* binProg = buildProgram<glu::ShaderProgramInfo, vk::GlslSourceCollection::Iterator>(casePath, progIter, m_prebuiltBinRegistry, log, &m_progCollection);
+		vk::ProgramBinary* binProg = buildProgram<glu::ShaderProgramInfo, vk::GlslSourceCollection::Iterator>(casePath, progIter, m_prebuiltBinRegistry, m_binaryCache.get(), log, &m_progCollection);
 
 		try
 		{
@@ -242,9 +284,13 @@ void TestCaseExecutor::init (tcu::TestCase* testCase, const std::string& casePat
 
 	for (vk::SpirVAsmCollection::Iterator asmIterator = sourceProgs.spirvAsmSources.begin(); asmIterator != sourceProgs.spirvAsmSources.end(); ++asmIterator)
 	{
-		buildProgram<vk::SpirVProgramInfo, vk::SpirVAsmCollection::Iterator>(casePath, asmIterator, m_prebuiltBinRegistry, log, &m_progCollection);
+		buildProgram<vk::SpirVProgramInfo, vk::SpirVAsmCollection::Iterator>(casePath, asmIterator, m_prebuiltBinRegistry, m_binaryCache.get(), log, &m_progCollection);
 	}
 
+	if (m_binaryCache && (m_binaryCache->getNumHits() != numCacheHits || m_binaryCache->getNumMisses() != numCacheMisses))
+		log << TestLog::Message << "Program cache: " << (m_binaryCache->getNumHits() - numCacheHits) << " hits, "
+								<< (m_binaryCache->getNumMisses() - numCacheMisses) << " misses" << TestLog::EndMessage;
+
 	DE_ASSERT(!m_instance);
 	m_instance = vktCase->createInstance(m_context);
 }
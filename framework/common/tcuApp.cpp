@@ -26,6 +26,7 @@
 #include "tcuTestContext.hpp"
 #include "tcuTestSessionExecutor.hpp"
 #include "tcuTestHierarchyUtil.hpp"
+#include "tcuTestHierarchyIndex.hpp"
 #include "tcuCommandLine.hpp"
 #include "tcuTestLog.hpp"
 
@@ -33,26 +34,44 @@
 #include "qpDebugOut.h"
 
 #include "deMath.h"
+#include "deMemory.h"
+#include "deStringUtil.hpp"
 
 #include <iostream>
+#include <cstdio>
+
+#if (DE_OS == DE_OS_UNIX)
+#	include <new>
+#	include <errno.h>
+#	include <unistd.h>
+#	include <sys/mman.h>
+#	include <sys/wait.h>
+#	if defined(__linux__)
+#		include <signal.h>
+#		include <sys/prctl.h>
+#	endif
+#endif
 
 namespace tcu
 {
 
 using std::string;
 
+enum
+{
+	WATCHDOG_TOTAL_TIME_LIMIT_SECS		= 300,
+	WATCHDOG_INTERVAL_TIME_LIMIT_SECS	= 30
+};
+
 /*--------------------------------------------------------------------*//*!
  *  Writes all packages found stdout without any
  *  separations. Recommended to be used with a single package
  *  only. It's possible to use test selectors for limiting the export
  *  to one package in a multipackage binary.
  *//*--------------------------------------------------------------------*/
-static void writeCaselistsToStdout (TestPackageRoot& root, TestContext& testCtx)
+template<typename Iterator>
+static void writeCaselistsToStdout (Iterator& iter)
 {
-	DefaultHierarchyInflater			inflater		(testCtx);
-	de::MovePtr<const CaseListFilter>	caseListFilter	(testCtx.getCommandLine().createCaseListFilter(testCtx.getArchive()));
-	TestHierarchyIterator				iter			(root, inflater, *caseListFilter);
-
 	while (iter.getState() != TestHierarchyIterator::STATE_FINISHED)
 	{
 		iter.next();
@@ -70,6 +89,105 @@ static void writeCaselistsToStdout (TestPackageRoot& root, TestContext& testCtx)
 	}
 }
 
+static void writeCaselistsToStdout (TestPackageRoot& root, TestContext& testCtx)
+{
+	DefaultHierarchyInflater			inflater		(testCtx);
+	de::MovePtr<const CaseListFilter>	caseListFilter	(testCtx.getCommandLine().createCaseListFilter(testCtx.getArchive()));
+	TestHierarchyIterator				iter			(root, inflater, *caseListFilter);
+
+	writeCaselistsToStdout(iter);
+}
+
+static void writeCaselistsToStdout (const TestHierarchyIndex& index, TestContext& testCtx)
+{
+	de::MovePtr<const CaseListFilter>	caseListFilter	(testCtx.getCommandLine().createCaseListFilter(testCtx.getArchive(), &index));
+	IndexedHierarchyIterator			iter			(index, *caseListFilter);
+
+	writeCaselistsToStdout(iter);
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Load test hierarchy index, or build and save it if missing
+ *
+ * Failure to save the index is not fatal, as the built index can still be
+ * used for this run.
+ *//*--------------------------------------------------------------------*/
+static de::MovePtr<TestHierarchyIndex> loadOrBuildHierarchyIndex (TestPackageRoot& root, TestContext& testCtx, const char* filename)
+{
+	de::MovePtr<TestHierarchyIndex> index = TestHierarchyIndex::load(filename, root);
+
+	if (index)
+		print("Using test hierarchy index '%s'. Delete it if test data files have changed.\n", filename);
+	else
+	{
+		print("Building test hierarchy index '%s'..\n", filename);
+
+		index = TestHierarchyIndex::build(root, testCtx);
+
+		try
+		{
+			index->save(filename);
+		}
+		catch (const Exception& e)
+		{
+			print("WARNING: Failed to save test hierarchy index: %s\n", e.getMessage());
+		}
+	}
+
+	return index;
+}
+
+static void printTestRunTotals (const TestRunStatus& result)
+{
+	print("\nTest run totals:\n");
+	print("  Passed:        %d/%d (%.1f%%)\n", result.numPassed,		result.numExecuted, (result.numExecuted > 0 ? (100.0f * (float)result.numPassed			/ (float)result.numExecuted) : 0.0f));
+	print("  Failed:        %d/%d (%.1f%%)\n", result.numFailed,		result.numExecuted, (result.numExecuted > 0 ? (100.0f * (float)result.numFailed			/ (float)result.numExecuted) : 0.0f));
+	print("  Not supported: %d/%d (%.1f%%)\n", result.numNotSupported,	result.numExecuted, (result.numExecuted > 0 ? (100.0f * (float)result.numNotSupported	/ (float)result.numExecuted) : 0.0f));
+	print("  Warnings:      %d/%d (%.1f%%)\n", result.numWarnings,		result.numExecuted, (result.numExecuted > 0 ? (100.0f * (float)result.numWarnings		/ (float)result.numExecuted) : 0.0f));
+	if (!result.isComplete)
+		print("Test run was ABORTED!\n");
+}
+
+#if (DE_OS == DE_OS_UNIX)
+
+static TestSessionProgress* createSharedProgress (void)
+{
+	void* const ptr = mmap(DE_NULL, sizeof(TestSessionProgress), PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
+
+	if (ptr == MAP_FAILED)
+		throw InternalError("Failed to allocate memory shared with test processes");
+
+	return new (ptr) TestSessionProgress();
+}
+
+static void destroySharedProgress (TestSessionProgress* progress)
+{
+	progress->~TestSessionProgress();
+	munmap(progress, sizeof(TestSessionProgress));
+}
+
+#else
+
+static TestSessionProgress* createSharedProgress (void)
+{
+	throw Exception("--deqp-fork-server is not supported on this platform");
+}
+
+static void destroySharedProgress (TestSessionProgress* progress)
+{
+	DE_UNREF(progress);
+	DE_ASSERT(false);
+}
+
+#endif // DE_OS_UNIX
+
+static void setPendingCaseTerminated (TestSessionProgress* progress)
+{
+	// \note THIS IS CALLED BY SIGNAL HANDLER! CALLING MALLOC/FREE IS NOT ALLOWED!
+	if (progress && progress->pendingCaseState == TestSessionProgress::PENDINGCASE_LOGGED)
+		progress->pendingCaseState = TestSessionProgress::PENDINGCASE_TERMINATED;
+}
+
 /*--------------------------------------------------------------------*//*!
  * \brief Construct test application
  *
@@ -85,7 +203,11 @@ App::App (Platform& platform, Archive& archive, TestLog& log, const CommandLine&
 	, m_crashed			(false)
 	, m_testCtx			(DE_NULL)
 	, m_testRoot		(DE_NULL)
+	, m_hierarchyIndex	(DE_NULL)
 	, m_testExecutor	(DE_NULL)
+	, m_forkProgress		(DE_NULL)
+	, m_forkCaseListFilter	(DE_NULL)
+	, m_isForkChild			(false)
 {
 	print("dEQP Core %s (0x%08x) starting..\n", qpGetReleaseName(), qpGetReleaseId());
 	print("  target implementation = '%s'\n", qpGetTargetName());
@@ -95,11 +217,12 @@ App::App (Platform& platform, Archive& archive, TestLog& log, const CommandLine&
 
 	try
 	{
-		const RunMode	runMode	= cmdLine.getRunMode();
+		const RunMode	runMode			= cmdLine.getRunMode();
+		const bool		useForkServer	= runMode == RUNMODE_EXECUTE && cmdLine.isForkServerEnabled();
 
-		// Initialize watchdog
-		if (cmdLine.isWatchDogEnabled())
-			TCU_CHECK_INTERNAL(m_watchDog = qpWatchDog_create(onWatchdogTimeout, this, 300, 30));
+		// Initialize watchdog. With fork server each child process has its own watchdog.
+		if (cmdLine.isWatchDogEnabled() && !useForkServer)
+			TCU_CHECK_INTERNAL(m_watchDog = qpWatchDog_create(onWatchdogTimeout, this, WATCHDOG_TOTAL_TIME_LIMIT_SECS, WATCHDOG_INTERVAL_TIME_LIMIT_SECS));
 
 		// Initialize crash handler.
 		if (cmdLine.isCrashHandlingEnabled())
@@ -111,9 +234,29 @@ App::App (Platform& platform, Archive& archive, TestLog& log, const CommandLine&
 		// Create root from registry
 		m_testRoot = new TestPackageRoot(*m_testCtx, TestPackageRegistry::getSingleton());
 
-		// \note No executor is created if runmode is not EXECUTE
-		if (runMode == RUNMODE_EXECUTE)
-			m_testExecutor = new TestSessionExecutor(*m_testRoot, *m_testCtx);
+		if (cmdLine.getHierarchyIndexFile())
+			m_hierarchyIndex = loadOrBuildHierarchyIndex(*m_testRoot, *m_testCtx, cmdLine.getHierarchyIndexFile()).release();
+
+		// \note No executor is created if runmode is not EXECUTE, or until child process is forked with fork server
+		if (useForkServer)
+		{
+			m_forkProgress			= createSharedProgress();
+			m_forkCaseListFilter	= cmdLine.createCaseListFilter(m_testCtx->getArchive(), m_hierarchyIndex).release();
+		}
+		else if (runMode == RUNMODE_EXECUTE)
+			m_testExecutor = new TestSessionExecutor(*m_testRoot, *m_testCtx, m_hierarchyIndex);
+		else if (m_hierarchyIndex)
+		{
+			// Case lists can be written directly from the index
+			if (runMode == RUNMODE_DUMP_STDOUT_CASELIST)
+				writeCaselistsToStdout(*m_hierarchyIndex, *m_testCtx);
+			else if (runMode == RUNMODE_DUMP_XML_CASELIST)
+				writeXmlCaselistsToFiles(*m_hierarchyIndex, *m_testCtx, cmdLine);
+			else if (runMode == RUNMODE_DUMP_TEXT_CASELIST)
+				writeTxtCaselistsToFiles(*m_hierarchyIndex, *m_testCtx, cmdLine);
+			else
+				DE_ASSERT(false);
+		}
 		else if (runMode == RUNMODE_DUMP_STDOUT_CASELIST)
 			writeCaselistsToStdout(*m_testRoot, *m_testCtx);
 		else if (runMode == RUNMODE_DUMP_XML_CASELIST)
@@ -138,9 +281,14 @@ App::~App (void)
 void App::cleanup (void)
 {
 	delete m_testExecutor;
+	delete m_forkCaseListFilter;
+	delete m_hierarchyIndex;
 	delete m_testRoot;
 	delete m_testCtx;
 
+	if (m_forkProgress)
+		destroySharedProgress(m_forkProgress);
+
 	if (m_crashHandler)
 		qpCrashHandler_destroy(m_crashHandler);
 
@@ -155,6 +303,9 @@ void App::cleanup (void)
  *//*--------------------------------------------------------------------*/
 bool App::iterate (void)
 {
+	if (m_forkProgress && !m_isForkChild)
+		return iterateForkServer();
+
 	if (!m_testExecutor)
 	{
 		DE_ASSERT(m_testCtx->getCommandLine().getRunMode() != RUNMODE_EXECUTE);
@@ -185,20 +336,13 @@ bool App::iterate (void)
 		else
 			print("\nDONE!\n");
 
+		// Parent process reports statistics.
+		if (m_isForkChild)
+			exitForkChild();
+
 		const RunMode runMode = m_testCtx->getCommandLine().getRunMode();
 		if (runMode == RUNMODE_EXECUTE)
-		{
-			const TestRunStatus& result = m_testExecutor->getStatus();
-
-			// Report statistics.
-			print("\nTest run totals:\n");
-			print("  Passed:        %d/%d (%.1f%%)\n", result.numPassed,		result.numExecuted, (result.numExecuted > 0 ? (100.0f * (float)result.numPassed			/ (float)result.numExecuted) : 0.0f));
-			print("  Failed:        %d/%d (%.1f%%)\n", result.numFailed,		result.numExecuted, (result.numExecuted > 0 ? (100.0f * (float)result.numFailed			/ (float)result.numExecuted) : 0.0f));
-			print("  Not supported: %d/%d (%.1f%%)\n", result.numNotSupported,	result.numExecuted, (result.numExecuted > 0 ? (100.0f * (float)result.numNotSupported	/ (float)result.numExecuted) : 0.0f));
-			print("  Warnings:      %d/%d (%.1f%%)\n", result.numWarnings,		result.numExecuted, (result.numExecuted > 0 ? (100.0f * (float)result.numWarnings		/ (float)result.numExecuted) : 0.0f));
-			if (!result.isComplete)
-				print("Test run was ABORTED!\n");
-		}
+			printTestRunTotals(m_testExecutor->getStatus());
 	}
 
 	return platformOk && testExecOk;
@@ -206,9 +350,140 @@ bool App::iterate (void)
 
 const TestRunStatus& App::getResult (void) const
 {
-	return m_testExecutor->getStatus();
+	return m_forkProgress ? m_forkProgress->status : m_testExecutor->getStatus();
 }
 
+#if (DE_OS == DE_OS_UNIX)
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Fork child process for executing cases and wait for it to exit
+ * \return true if a new child should be forked, false if session is
+ *         complete or was aborted.
+ *
+ * Child process returns immediately and continues in iterate() as a
+ * regular test process. On Linux child is killed if parent dies.
+ *//*--------------------------------------------------------------------*/
+bool App::iterateForkServer (void)
+{
+	TestSessionProgress&	progress	= *m_forkProgress;
+	const pid_t				parentPid	= getpid();
+	int						status		= 0;
+	pid_t					pid;
+
+	// Don't let child inherit unwritten output.
+	fflush(DE_NULL);
+
+	pid = fork();
+
+	if (pid < 0)
+		throw InternalError("Failed to fork test process");
+
+	if (pid == 0)
+	{
+		// Child must not outlive parent, e.g. when parent is killed by execserver on timeout.
+#if defined(__linux__)
+		prctl(PR_SET_PDEATHSIG, SIGKILL);
+#endif
+
+		// Parent may have died before death signal was requested.
+		if (getppid() != parentPid)
+			_exit(1);
+
+		initForkChild();
+		return true;
+	}
+
+	while (waitpid(pid, &status, 0) < 0)
+	{
+		if (errno != EINTR)
+			throw InternalError("Failed to wait for test process");
+	}
+
+	if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+	{
+		printTestRunTotals(progress.status);
+		return false;
+	}
+
+	{
+		const string reason = WIFSIGNALED(status) ? "killed by signal " + de::toString(WTERMSIG(status))
+												  : "exited with code " + de::toString(WEXITSTATUS(status));
+
+		if (progress.pendingCaseState == TestSessionProgress::PENDINGCASE_NONE)
+		{
+			// Nothing to skip, new child would most likely fail the same way.
+			print("\nTest process %s outside test case, aborting\n", reason.c_str());
+			printTestRunTotals(progress.status);
+			return false;
+		}
+
+		if (progress.pendingCaseState == TestSessionProgress::PENDINGCASE_NOT_LOGGED)
+			print("\nTest case '%s'..\n", progress.pendingCasePath);
+
+		// \note Result of partially logged case is replaced by the new #beginTestCaseResult.
+		if (progress.pendingCaseState != TestSessionProgress::PENDINGCASE_TERMINATED)
+		{
+			TestLog& log = m_testCtx->getLog();
+
+			log.startCase(progress.pendingCasePath, progress.pendingCaseType);
+			log.terminateCase(progress.terminateResult);
+		}
+
+		print("  %s (Test process %s)\n", qpGetTestResultName(progress.terminateResult), reason.c_str());
+	}
+
+	// Resume after interrupted case.
+	progress.status.numExecuted		+= 1;
+	progress.status.numFailed		+= 1;
+	progress.pendingCaseState		 = TestSessionProgress::PENDINGCASE_NONE;
+	progress.terminateResult		 = QP_TEST_RESULT_CRASH;
+
+	deMemcpy(&progress.lastCasePath[0], &progress.pendingCasePath[0], sizeof(progress.lastCasePath));
+	progress.pendingCasePath[0] = 0;
+
+	return true;
+}
+
+void App::initForkChild (void)
+{
+	m_isForkChild = true;
+
+	if (m_testCtx->getCommandLine().isWatchDogEnabled())
+	{
+		TCU_CHECK_INTERNAL(m_watchDog = qpWatchDog_create(onWatchdogTimeout, this, WATCHDOG_TOTAL_TIME_LIMIT_SECS, WATCHDOG_INTERVAL_TIME_LIMIT_SECS));
+		m_testCtx->setWatchDog(m_watchDog);
+	}
+
+	m_testExecutor = new TestSessionExecutor(*m_testRoot, *m_testCtx, *m_forkCaseListFilter, *m_forkProgress);
+}
+
+void App::exitForkChild (void)
+{
+	// \note Log session is closed by parent, so nothing is destroyed here.
+	fflush(DE_NULL);
+	_exit(0);
+}
+
+#else
+
+bool App::iterateForkServer (void)
+{
+	DE_ASSERT(false);
+	return false;
+}
+
+void App::initForkChild (void)
+{
+	DE_ASSERT(false);
+}
+
+void App::exitForkChild (void)
+{
+	DE_ASSERT(false);
+}
+
+#endif // DE_OS_UNIX
+
 void App::onWatchdogTimeout (qpWatchDog* watchDog, void* userPtr)
 {
 	DE_UNREF(watchDog);
@@ -228,7 +503,16 @@ void App::onWatchdogTimeout (void)
 
 	m_crashed = true;
 
-	m_testCtx->getLog().terminateCase(QP_TEST_RESULT_TIMEOUT);
+	if (m_forkProgress)
+		m_forkProgress->terminateResult = QP_TEST_RESULT_TIMEOUT;
+
+	// \note Concurrently executed cases are not written to log until all of them are finished.
+	if (m_testExecutor && m_testExecutor->isInTestCase())
+	{
+		m_testCtx->getLog().terminateCase(QP_TEST_RESULT_TIMEOUT);
+		setPendingCaseTerminated(m_forkProgress);
+	}
+
 	die("Watchdog timer timeout");
 }
 
@@ -261,6 +545,7 @@ void App::onCrash (void)
 	{
 		qpCrashHandler_writeCrashInfo(m_crashHandler, writeCrashToLog, &m_testCtx->getLog());
 		m_testCtx->getLog().terminateCase(QP_TEST_RESULT_CRASH);
+		setPendingCaseTerminated(m_forkProgress);
 	}
 	else
 		qpCrashHandler_writeCrashInfo(m_crashHandler, writeCrashToConsole, DE_NULL);
@@ -41,7 +41,10 @@ class TestSessionExecutor;
 class CommandLine;
 class TestLog;
 class TestPackageRoot;
+class TestHierarchyIndex;
 class TestRunStatus;
+class CaseListFilter;
+struct TestSessionProgress;
 
 /*--------------------------------------------------------------------*//*!
  * \brief Test application
@@ -57,6 +60,15 @@ class TestRunStatus;
  * App is responsible of setting up crash handler (qpCrashHandler) and
  * watchdog (qpWatchDog).
  *
+ * With --deqp-fork-server=enable (DE_OS_UNIX only) the process initializes
+ * everything up to the test hierarchy and then forks a child process to
+ * execute test cases. If the child crashes or is killed, the parent
+ * records the result of the interrupted case and forks a new child that
+ * resumes after it. This avoids relaunching the whole binary after each
+ * crash. Test packages are initialized in the child since rendering
+ * contexts can't be shared over fork(). Only on Linux is the child killed
+ * if the parent dies; elsewhere it runs until its current session ends.
+ *
  * See tcuMain.cpp for an example on how to implement application stub.
  *//*--------------------------------------------------------------------*/
 class App
@@ -71,6 +83,10 @@ public:
 protected:
 	void					cleanup				(void);
 
+	bool					iterateForkServer	(void);
+	void					initForkChild		(void);
+	void					exitForkChild		(void);
+
 	void					onWatchdogTimeout	(void);
 	void					onCrash				(void);
 
@@ -85,7 +101,12 @@ protected:
 
 	TestContext*			m_testCtx;
 	TestPackageRoot*		m_testRoot;
+	TestHierarchyIndex*		m_hierarchyIndex;
 	TestSessionExecutor*	m_testExecutor;
+
+	TestSessionProgress*	m_forkProgress;		//!< Progress shared with forked child, or null if fork server is not used.
+	CaseListFilter*			m_forkCaseListFilter;	//!< Created once in parent, case list may be read from stdin.
+	bool					m_isForkChild;
 };
 
 } // tcu
@@ -25,6 +25,10 @@
 #include "tcuTexture.hpp"
 #include "tcuTextureUtil.hpp"
 #include "tcuRGBA.hpp"
+#include "tcuParallelRows.hpp"
+
+#include <vector>
+#include <algorithm>
 
 namespace tcu
 {
@@ -188,35 +192,70 @@ bool comparePixelRGBA8 (const ConstPixelBufferAccess& reference, const ConstPixe
 	return false;
 }
 
-bool bilinearCompareRGBA8 (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const PixelBufferAccess& errorMask, const RGBA threshold)
+class BilinearCompareRGBA8Task : public RowBandTask
 {
-	DE_ASSERT(reference.getFormat() == TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8) &&
-			  result.getFormat()	== TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8));
-
-	// Clear error mask first to green (faster this way).
-	clear(errorMask, Vec4(0.0f, 1.0f, 0.0f, 1.0f));
-
-	bool allOk = true;
+public:
+	BilinearCompareRGBA8Task (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const PixelBufferAccess& errorMask, const RGBA threshold, int numBands)
+		: m_reference	(reference)
+		, m_result		(result)
+		, m_errorMask	(errorMask)
+		, m_threshold	(threshold)
+		, m_bandOk		(numBands, (deUint8)1)
+	{
+	}
 
-	for (int y = 0; y < reference.getHeight(); y++)
+	void processRows (int bandNdx, int rowBegin, int rowEnd)
 	{
-		for (int x = 0; x < reference.getWidth(); x++)
+		bool allOk = true;
+
+		for (int y = rowBegin; y < rowEnd; y++)
 		{
-			if (!comparePixelRGBA8(reference, result, threshold, x, y) &&
-				!comparePixelRGBA8(result, reference, threshold, x, y))
+			for (int x = 0; x < m_reference.getWidth(); x++)
 			{
-				allOk = false;
-				errorMask.setPixel(Vec4(1.0f, 0.0f, 0.0f, 1.0f), x, y);
+				if (!comparePixelRGBA8(m_reference, m_result, m_threshold, x, y) &&
+					!comparePixelRGBA8(m_result, m_reference, m_threshold, x, y))
+				{
+					allOk = false;
+					m_errorMask.setPixel(Vec4(1.0f, 0.0f, 0.0f, 1.0f), x, y);
+				}
 			}
 		}
+
+		m_bandOk[bandNdx] = (deUint8)(allOk ? 1 : 0);
 	}
 
-	return allOk;
+	bool isOk (void) const
+	{
+		return std::find(m_bandOk.begin(), m_bandOk.end(), (deUint8)0u) == m_bandOk.end();
+	}
+
+private:
+	const ConstPixelBufferAccess	m_reference;
+	const ConstPixelBufferAccess	m_result;
+	const PixelBufferAccess			m_errorMask;
+	const RGBA						m_threshold;
+	std::vector<deUint8>			m_bandOk;		//!< \note Not vector<bool> since bands are written concurrently.
+};
+
+bool bilinearCompareRGBA8 (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const PixelBufferAccess& errorMask, const RGBA threshold, int maxThreads)
+{
+	DE_ASSERT(reference.getFormat() == TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8) &&
+			  result.getFormat()	== TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8));
+
+	// Clear error mask first to green (faster this way).
+	clear(errorMask, Vec4(0.0f, 1.0f, 0.0f, 1.0f));
+
+	const int					numBands	= getNumRowBands(reference.getHeight(), reference.getWidth(), maxThreads);
+	BilinearCompareRGBA8Task	task		(reference, result, errorMask, threshold, numBands);
+
+	executeRowBands(task, reference.getHeight(), numBands);
+
+	return task.isOk();
 }
 
 } // anonymous
 
-bool bilinearCompare (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const PixelBufferAccess& errorMask, const RGBA threshold)
+bool bilinearCompare (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const PixelBufferAccess& errorMask, const RGBA threshold, int maxThreads)
 {
 	DE_ASSERT(reference.getWidth()	== result.getWidth()	&&
 			  reference.getHeight()	== result.getHeight()	&&
@@ -227,7 +266,7 @@ bool bilinearCompare (const ConstPixelBufferAccess& reference, const ConstPixelB
 			  reference.getDepth()	== errorMask.getDepth());
 
 	if (reference.getFormat() == TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8))
-		return bilinearCompareRGBA8(reference, result, errorMask, threshold);
+		return bilinearCompareRGBA8(reference, result, errorMask, threshold, maxThreads);
 	else
 		throw InternalError("Unsupported format for bilinear comparison");
 }
@@ -32,7 +32,7 @@ class ConstPixelBufferAccess;
 class PixelBufferAccess;
 class RGBA;
 
-bool bilinearCompare (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const PixelBufferAccess& errorMask, const RGBA threshold);
+bool bilinearCompare (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const PixelBufferAccess& errorMask, const RGBA threshold, int maxThreads = 1);
 
 } // tcu
 
@@ -25,9 +25,11 @@
 #include "tcuPlatform.hpp"
 #include "tcuTestCase.hpp"
 #include "tcuResource.hpp"
+#include "tcuTestHierarchyIndex.hpp"
 #include "deFilePath.hpp"
 #include "deStringUtil.hpp"
 #include "deString.h"
+#include "deMemory.h"
 #include "deInt32.h"
 #include "deCommandLine.h"
 #include "qpTestLog.h"
@@ -38,6 +40,8 @@
 #include <sstream>
 #include <fstream>
 #include <iostream>
+#include <algorithm>
+#include <map>
 
 using std::string;
 using std::vector;
@@ -86,8 +90,17 @@ DE_DECLARE_COMMAND_LINE_OPT(LogImages,					bool);
 DE_DECLARE_COMMAND_LINE_OPT(LogShaderSources,			bool);
 DE_DECLARE_COMMAND_LINE_OPT(TestOOM,					bool);
 DE_DECLARE_COMMAND_LINE_OPT(VKDeviceID,					int);
+DE_DECLARE_COMMAND_LINE_OPT(VKProgramCacheDir,			std::string);
 DE_DECLARE_COMMAND_LINE_OPT(LogFlush,					bool);
+DE_DECLARE_COMMAND_LINE_OPT(LogAsyncImages,				bool);
 DE_DECLARE_COMMAND_LINE_OPT(Validation,					bool);
+DE_DECLARE_COMMAND_LINE_OPT(RefRendererThreads,			int);
+DE_DECLARE_COMMAND_LINE_OPT(ImageCompareThreads,			int);
+DE_DECLARE_COMMAND_LINE_OPT(CaseThreads,				int);
+DE_DECLARE_COMMAND_LINE_OPT(HierarchyIndex,				std::string);
+DE_DECLARE_COMMAND_LINE_OPT(ShaderLibraryCacheDir,		std::string);
+DE_DECLARE_COMMAND_LINE_OPT(PrecisionEvalThreads,		int);
+DE_DECLARE_COMMAND_LINE_OPT(ForkServer,					bool);
 
 static void parseIntList (const char* src, std::vector<int>* dst)
 {
@@ -171,11 +184,20 @@ void registerOptions (de::cmdline::Parser& parser)
 		<< Option<EGLWindowType>		(DE_NULL,	"deqp-egl-window-type",			"EGL native window type")
 		<< Option<EGLPixmapType>		(DE_NULL,	"deqp-egl-pixmap-type",			"EGL native pixmap type")
 		<< Option<VKDeviceID>			(DE_NULL,	"deqp-vk-device-id",			"Vulkan device ID (IDs start from 1)",									"1")
+		<< Option<VKProgramCacheDir>	(DE_NULL,	"deqp-vk-program-cache-dir",	"Directory for caching compiled Vulkan programs across runs")
 		<< Option<LogImages>			(DE_NULL,	"deqp-log-images",				"Enable or disable logging of result images",		s_enableNames,		"enable")
 		<< Option<LogShaderSources>		(DE_NULL,	"deqp-log-shader-sources",		"Enable or disable logging of shader sources",		s_enableNames,		"enable")
 		<< Option<TestOOM>				(DE_NULL,	"deqp-test-oom",				"Run tests that exhaust memory on purpose",			s_enableNames,		TEST_OOM_DEFAULT)
 		<< Option<LogFlush>				(DE_NULL,	"deqp-log-flush",				"Enable or disable log file fflush",				s_enableNames,		"enable")
-		<< Option<Validation>			(DE_NULL,	"deqp-validation",				"Enable or disable test case validation",			s_enableNames,		"disable");
+		<< Option<LogAsyncImages>		(DE_NULL,	"deqp-log-async-images",		"Enable or disable image compression on background threads",	s_enableNames,	"disable")
+		<< Option<Validation>			(DE_NULL,	"deqp-validation",				"Enable or disable test case validation",			s_enableNames,		"disable")
+		<< Option<RefRendererThreads>	(DE_NULL,	"deqp-ref-renderer-threads",	"Number of tile rasterization threads in reference renderer (0 = number of cores)",	"1")
+		<< Option<ImageCompareThreads>	(DE_NULL,	"deqp-image-compare-threads",	"Number of threads used by image comparison (0 = number of cores)",				"1")
+		<< Option<CaseThreads>			(DE_NULL,	"deqp-case-threads",			"Number of threads running context-free test cases concurrently (0 = number of cores)",	"1")
+		<< Option<HierarchyIndex>		(DE_NULL,	"deqp-hierarchy-index",			"Test hierarchy index file, created if missing or out of date")
+		<< Option<ShaderLibraryCacheDir>	(DE_NULL,	"deqp-shader-library-cache-dir",	"Directory for caching parsed shader library (.test) files")
+		<< Option<PrecisionEvalThreads>	(DE_NULL,	"deqp-precision-eval-threads",	"Number of threads computing reference intervals in builtin precision tests (0 = number of cores)",	"1")
+		<< Option<ForkServer>			(DE_NULL,	"deqp-fork-server",				"Execute cases in forked child processes and resume in a new child after a crash (Unix only)",	s_enableNames,	"disable");
 }
 
 void registerLegacyOptions (de::cmdline::Parser& parser)
@@ -250,7 +272,7 @@ void DebugOutStreambuf::flushLine (void)
 class CaseTreeNode
 {
 public:
-										CaseTreeNode		(const std::string& name) : m_name(name) {}
+										CaseTreeNode		(const std::string& name) : m_name(name), m_nameHash(getNameHash(name.c_str(), name.size())) {}
 										~CaseTreeNode		(void);
 
 	const std::string&					getName				(void) const { return m_name;				}
@@ -259,20 +281,30 @@ public:
 	bool								hasChild			(const std::string& name) const;
 	const CaseTreeNode*					getChild			(const std::string& name) const;
 	CaseTreeNode*						getChild			(const std::string& name);
+	const CaseTreeNode*					getChild			(const char* name, size_t nameLen) const;
 
-	void								addChild			(CaseTreeNode* child) { m_children.push_back(child); }
+	void								addChild			(CaseTreeNode* child);
 
 private:
 										CaseTreeNode		(const CaseTreeNode&);
 	CaseTreeNode&						operator=			(const CaseTreeNode&);
 
-	enum { NOT_FOUND = -1 };
+	enum
+	{
+		NOT_FOUND			= -1,
+		MAX_LINEAR_SEARCH	= 8		//!< Children are hashed only when there are more than this many.
+	};
+
+	static deUint32						getNameHash			(const char* name, size_t nameLen) { return deMemoryHash(name, nameLen); }
 
-	// \todo [2014-10-30 pyry] Speed up with hash / sorting
-	int									findChildNdx		(const std::string& name) const;
+	bool								isNamed				(const char* name, size_t nameLen, deUint32 nameHash) const;
+	int									findChildNdx		(const char* name, size_t nameLen) const;
+	void								insertToTable		(int childNdx);
 
 	std::string							m_name;
+	deUint32							m_nameHash;
 	std::vector<CaseTreeNode*>			m_children;
+	std::vector<int>					m_childTable;		//!< Open-addressed hash of indices to m_children, empty for small nodes.
 };
 
 CaseTreeNode::~CaseTreeNode (void)
@@ -281,30 +313,92 @@ CaseTreeNode::~CaseTreeNode (void)
 		delete *i;
 }
 
-int CaseTreeNode::findChildNdx (const std::string& name) const
+inline bool CaseTreeNode::isNamed (const char* name, size_t nameLen, deUint32 nameHash) const
+{
+	return m_nameHash == nameHash && m_name.size() == nameLen && deMemCmp(m_name.c_str(), name, nameLen) == 0;
+}
+
+int CaseTreeNode::findChildNdx (const char* name, size_t nameLen) const
 {
-	for (int ndx = 0; ndx < (int)m_children.size(); ++ndx)
+	const deUint32 nameHash = getNameHash(name, nameLen);
+
+	if (m_childTable.empty())
+	{
+		for (int ndx = 0; ndx < (int)m_children.size(); ++ndx)
+		{
+			if (m_children[ndx]->isNamed(name, nameLen, nameHash))
+				return ndx;
+		}
+	}
+	else
 	{
-		if (m_children[ndx]->getName() == name)
-			return ndx;
+		const size_t mask = m_childTable.size()-1;
+
+		for (size_t slot = nameHash & mask; m_childTable[slot] != NOT_FOUND; slot = (slot+1) & mask)
+		{
+			if (m_children[m_childTable[slot]]->isNamed(name, nameLen, nameHash))
+				return m_childTable[slot];
+		}
 	}
+
 	return NOT_FOUND;
 }
 
+void CaseTreeNode::insertToTable (int childNdx)
+{
+	const size_t	mask	= m_childTable.size()-1;
+	size_t			slot	= m_children[childNdx]->m_nameHash & mask;
+
+	while (m_childTable[slot] != NOT_FOUND)
+		slot = (slot+1) & mask;
+
+	m_childTable[slot] = childNdx;
+}
+
+void CaseTreeNode::addChild (CaseTreeNode* child)
+{
+	const size_t numChildren = m_children.size()+1;
+
+	// Keep hash table at most half full. Allocations are done before modifying the node so
+	// that caller still owns child if this throws.
+	if (numChildren > MAX_LINEAR_SEARCH && numChildren*2 > m_childTable.size())
+	{
+		std::vector<int> newTable (de::max<size_t>(m_childTable.size()*2, 4*MAX_LINEAR_SEARCH), (int)NOT_FOUND);
+
+		m_children.push_back(child);
+		m_childTable.swap(newTable);
+
+		for (int ndx = 0; ndx < (int)m_children.size(); ++ndx)
+			insertToTable(ndx);
+	}
+	else
+	{
+		m_children.push_back(child);
+
+		if (!m_childTable.empty())
+			insertToTable((int)m_children.size()-1);
+	}
+}
+
 inline bool CaseTreeNode::hasChild (const std::string& name) const
 {
-	return findChildNdx(name) != NOT_FOUND;
+	return findChildNdx(name.c_str(), name.size()) != NOT_FOUND;
 }
 
 inline const CaseTreeNode* CaseTreeNode::getChild (const std::string& name) const
 {
-	const int ndx = findChildNdx(name);
+	return getChild(name.c_str(), name.size());
+}
+
+inline const CaseTreeNode* CaseTreeNode::getChild (const char* name, size_t nameLen) const
+{
+	const int ndx = findChildNdx(name, nameLen);
 	return ndx == NOT_FOUND ? DE_NULL : m_children[ndx];
 }
 
 inline CaseTreeNode* CaseTreeNode::getChild (const std::string& name)
 {
-	const int ndx = findChildNdx(name);
+	const int ndx = findChildNdx(name.c_str(), name.size());
 	return ndx == NOT_FOUND ? DE_NULL : m_children[ndx];
 }
 
@@ -323,7 +417,7 @@ static const CaseTreeNode* findNode (const CaseTreeNode* root, const char* path)
 
 	for (;;)
 	{
-		curNode = curNode->getChild(std::string(curPath, curPath+curLen));
+		curNode = curNode->getChild(curPath, (size_t)curLen);
 
 		if (!curNode)
 			break;
@@ -535,9 +629,58 @@ public:
 	bool					matches		(const string& caseName, bool allowPrefix=false) const;
 
 private:
+#if defined(TCU_HIERARCHICAL_CASEPATHS)
 	const vector<string>	m_casePatterns;
+#else
+	// Patterns are compiled into a single NFA shaped as a trie: literal characters of patterns sharing
+	// a prefix share states, and each '*' is a state that loops on any character. The NFA is converted
+	// to a DFA lazily while matching, so once the visited part of the DFA has been built, matching costs
+	// one table lookup per character.
+	struct NfaState
+	{
+								NfaState		(bool isWildcard_) : isWildcard(isWildcard_), wildcardState(NO_STATE), isFinal(false) {}
+
+		bool					isWildcard;		//!< Consumes any character and stays in this state.
+		vector<char>			labels;			//!< Characters of outgoing literal transitions.
+		vector<int>				targets;		//!< Target states of outgoing literal transitions.
+		int						wildcardState;	//!< '*' state following this state, entered without consuming input.
+		bool					isFinal;		//!< A pattern ends in this state.
+	};
+
+	struct DfaState
+	{
+		vector<int>				nfaStates;		//!< Sorted set of active NFA states.
+		bool					isFinal;
+	};
+
+	enum
+	{
+		NO_STATE			= -1,
+		DEAD_STATE			= -1,	//!< DFA state with no active NFA states.
+		UNKNOWN_STATE		= -2,	//!< DFA transition not built yet.
+		NUM_SYMBOLS			= 256,
+		MAX_DFA_STATES		= 4096	//!< DFA is rebuilt from scratch if it grows past this.
+	};
+
+	int						addNfaState		(bool isWildcard);
+	void					addPattern		(const string& pattern);
+	void					addClosure		(vector<int>& nfaStates, int nfaStateNdx) const;
+
+	void					resetDfa		(void) const;
+	int						getDfaState		(vector<int>& nfaStates) const;
+	int						getTransition	(int dfaStateNdx, deUint8 symbol) const;
+
+	vector<NfaState>					m_nfaStates;
+
+	// \note DFA is built by matches() and thus matches() is not thread-safe.
+	mutable vector<DfaState>			m_dfaStates;		//!< State 0 is the start state.
+	mutable vector<int>					m_dfaTransitions;	//!< NUM_SYMBOLS entries per DFA state.
+	mutable std::map<vector<int>, int>	m_dfaIndex;			//!< Set of NFA states to DFA state.
+#endif
 };
 
+#if defined(TCU_HIERARCHICAL_CASEPATHS)
+
 CasePaths::CasePaths (const string& pathList)
 	: m_casePatterns(de::splitString(pathList, ','))
 {
@@ -578,7 +721,6 @@ static bool matchWildcards(string::const_iterator	patternStart,
 	return false;
 }
 
-#if defined(TCU_HIERARCHICAL_CASEPATHS)
 // Match a list of pattern components to a list of path components. A pattern
 // component may contain *-wildcards. A pattern component "**" matches zero or
 // more whole path components.
@@ -612,30 +754,194 @@ static bool patternMatches(vector<string>::const_iterator	patternStart,
 
 	return false;
 }
-#endif
-
 bool CasePaths::matches (const string& caseName, bool allowPrefix) const
 {
 	const vector<string> components = de::splitString(caseName, '.');
 
 	for (size_t ndx = 0; ndx < m_casePatterns.size(); ++ndx)
 	{
-#if defined(TCU_HIERARCHICAL_CASEPATHS)
 		const vector<string> patternComponents = de::splitString(m_casePatterns[ndx], '.');
 
 		if (patternMatches(patternComponents.begin(), patternComponents.end(),
 						   components.begin(), components.end(), allowPrefix))
 			return true;
-#else
-		if (matchWildcards(m_casePatterns[ndx].begin(), m_casePatterns[ndx].end(),
-						   caseName.begin(), caseName.end(), allowPrefix))
-			return true;
-#endif
 	}
 
 	return false;
 }
 
+#else // !TCU_HIERARCHICAL_CASEPATHS
+
+CasePaths::CasePaths (const string& pathList)
+{
+	const vector<string> patterns = de::splitString(pathList, ',');
+
+	addNfaState(false);
+
+	for (vector<string>::const_iterator pattern = patterns.begin(); pattern != patterns.end(); ++pattern)
+		addPattern(*pattern);
+
+	resetDfa();
+}
+
+int CasePaths::addNfaState (bool isWildcard)
+{
+	m_nfaStates.push_back(NfaState(isWildcard));
+	return (int)m_nfaStates.size()-1;
+}
+
+void CasePaths::addPattern (const string& pattern)
+{
+	int curState = 0;
+
+	for (string::const_iterator chr = pattern.begin(); chr != pattern.end(); ++chr)
+	{
+		int nextState = NO_STATE;
+
+		if (*chr == '*')
+		{
+			nextState = m_nfaStates[curState].wildcardState;
+
+			if (nextState == NO_STATE)
+			{
+				nextState = addNfaState(true);
+				m_nfaStates[curState].wildcardState = nextState;
+			}
+		}
+		else
+		{
+			const vector<char>&					labels	= m_nfaStates[curState].labels;
+			const vector<char>::const_iterator	pos		= std::find(labels.begin(), labels.end(), *chr);
+
+			if (pos != labels.end())
+				nextState = m_nfaStates[curState].targets[pos - labels.begin()];
+			else
+			{
+				nextState = addNfaState(false);
+				m_nfaStates[curState].labels.push_back(*chr);
+				m_nfaStates[curState].targets.push_back(nextState);
+			}
+		}
+
+		curState = nextState;
+	}
+
+	m_nfaStates[curState].isFinal = true;
+}
+
+void CasePaths::addClosure (vector<int>& nfaStates, int nfaStateNdx) const
+{
+	// A wildcard may match an empty string, so its state is entered together with its predecessor.
+	for (; nfaStateNdx != NO_STATE; nfaStateNdx = m_nfaStates[nfaStateNdx].wildcardState)
+		nfaStates.push_back(nfaStateNdx);
+}
+
+void CasePaths::resetDfa (void) const
+{
+	vector<int> startStates;
+
+	m_dfaStates.clear();
+	m_dfaTransitions.clear();
+	m_dfaIndex.clear();
+
+	addClosure(startStates, 0);
+	getDfaState(startStates);
+
+	DE_ASSERT(m_dfaStates.size() == 1);
+}
+
+int CasePaths::getDfaState (vector<int>& nfaStates) const
+{
+	std::sort(nfaStates.begin(), nfaStates.end());
+	nfaStates.erase(std::unique(nfaStates.begin(), nfaStates.end()), nfaStates.end());
+
+	if (nfaStates.empty())
+		return DEAD_STATE;
+
+	{
+		const std::map<vector<int>, int>::const_iterator pos = m_dfaIndex.find(nfaStates);
+
+		if (pos != m_dfaIndex.end())
+			return pos->second;
+	}
+
+	{
+		const int	dfaStateNdx	= (int)m_dfaStates.size();
+		DfaState	dfaState;
+
+		dfaState.nfaStates	= nfaStates;
+		dfaState.isFinal	= false;
+
+		for (vector<int>::const_iterator nfaStateNdx = nfaStates.begin(); nfaStateNdx != nfaStates.end(); ++nfaStateNdx)
+			dfaState.isFinal = dfaState.isFinal || m_nfaStates[*nfaStateNdx].isFinal;
+
+		m_dfaStates.push_back(dfaState);
+		m_dfaTransitions.resize(m_dfaStates.size() * NUM_SYMBOLS, (int)UNKNOWN_STATE);
+		m_dfaIndex[nfaStates] = dfaStateNdx;
+
+		return dfaStateNdx;
+	}
+}
+
+int CasePaths::getTransition (int dfaStateNdx, deUint8 symbol) const
+{
+	const int transitionNdx = dfaStateNdx * NUM_SYMBOLS + symbol;
+
+	if (m_dfaTransitions[transitionNdx] != UNKNOWN_STATE)
+		return m_dfaTransitions[transitionNdx];
+
+	{
+		const vector<int>&	curStates	= m_dfaStates[dfaStateNdx].nfaStates;
+		vector<int>			nextStates;
+
+		for (vector<int>::const_iterator nfaStateNdx = curStates.begin(); nfaStateNdx != curStates.end(); ++nfaStateNdx)
+		{
+			const NfaState& state = m_nfaStates[*nfaStateNdx];
+
+			if (state.isWildcard)
+				addClosure(nextStates, *nfaStateNdx);
+
+			for (size_t labelNdx = 0; labelNdx < state.labels.size(); ++labelNdx)
+			{
+				if ((deUint8)state.labels[labelNdx] == symbol)
+					addClosure(nextStates, state.targets[labelNdx]);
+			}
+		}
+
+		if ((int)m_dfaStates.size() >= MAX_DFA_STATES)
+		{
+			// Pathological pattern sets could otherwise grow the DFA without bound.
+			resetDfa();
+			return getDfaState(nextStates);
+		}
+		else
+		{
+			const int nextDfaStateNdx = getDfaState(nextStates);
+
+			m_dfaTransitions[transitionNdx] = nextDfaStateNdx;
+			return nextDfaStateNdx;
+		}
+	}
+}
+
+bool CasePaths::matches (const string& caseName, bool allowPrefix) const
+{
+	int curState = 0;
+
+	for (string::const_iterator chr = caseName.begin(); chr != caseName.end(); ++chr)
+	{
+		curState = getTransition(curState, (deUint8)*chr);
+
+		if (curState == DEAD_STATE)
+			return false;
+	}
+
+	// Every NFA state can reach a final state, so any live state means caseName is a prefix of some match.
+	return allowPrefix || m_dfaStates[curState].isFinal;
+}
+
+#endif // TCU_HIERARCHICAL_CASEPATHS
+
 /*--------------------------------------------------------------------*//*!
  * \brief Construct command line
  * \note CommandLine is not fully initialized until parse() has been called.
@@ -729,6 +1035,10 @@ bool CommandLine::parse (int argc, const char* const* argv)
 	if (!m_cmdLine.getOption<opt::LogFlush>())
 		m_logFlags |= QP_TEST_LOG_NO_FLUSH;
 
+	// \note Image encoder threads of the log would not exist in forked child processes.
+	if (m_cmdLine.getOption<opt::LogAsyncImages>() && !m_cmdLine.getOption<opt::ForkServer>())
+		m_logFlags |= QP_TEST_LOG_ASYNC_IMAGES;
+
 	if ((m_cmdLine.hasOption<opt::CasePath>()?1:0) +
 		(m_cmdLine.hasOption<opt::CaseList>()?1:0) +
 		(m_cmdLine.hasOption<opt::CaseListFile>()?1:0) +
@@ -788,6 +1098,11 @@ const std::vector<int>&	CommandLine::getCLDeviceIds				(void) const	{ return m_c
 int						CommandLine::getVKDeviceId				(void) const	{ return m_cmdLine.getOption<opt::VKDeviceID>();					}
 bool					CommandLine::isValidationEnabled		(void) const	{ return m_cmdLine.getOption<opt::Validation>();					}
 bool					CommandLine::isOutOfMemoryTestEnabled	(void) const	{ return m_cmdLine.getOption<opt::TestOOM>();						}
+int						CommandLine::getRefRendererNumThreads	(void) const	{ return m_cmdLine.getOption<opt::RefRendererThreads>();			}
+int						CommandLine::getImageCompareNumThreads	(void) const	{ return m_cmdLine.getOption<opt::ImageCompareThreads>();			}
+int						CommandLine::getCaseNumThreads			(void) const	{ return m_cmdLine.getOption<opt::CaseThreads>();					}
+int						CommandLine::getPrecisionEvalNumThreads	(void) const	{ return m_cmdLine.getOption<opt::PrecisionEvalThreads>();			}
+bool					CommandLine::isForkServerEnabled		(void) const	{ return m_cmdLine.getOption<opt::ForkServer>();					}
 
 const char* CommandLine::getGLContextType (void) const
 {
@@ -820,6 +1135,30 @@ const char* CommandLine::getCLBuildOptions (void) const
 		return DE_NULL;
 }
 
+const char* CommandLine::getVKProgramCacheDir (void) const
+{
+	if (m_cmdLine.hasOption<opt::VKProgramCacheDir>())
+		return m_cmdLine.getOption<opt::VKProgramCacheDir>().c_str();
+	else
+		return DE_NULL;
+}
+
+const char* CommandLine::getHierarchyIndexFile (void) const
+{
+	if (m_cmdLine.hasOption<opt::HierarchyIndex>())
+		return m_cmdLine.getOption<opt::HierarchyIndex>().c_str();
+	else
+		return DE_NULL;
+}
+
+const char* CommandLine::getShaderLibraryCacheDir (void) const
+{
+	if (m_cmdLine.hasOption<opt::ShaderLibraryCacheDir>())
+		return m_cmdLine.getOption<opt::ShaderLibraryCacheDir>().c_str();
+	else
+		return DE_NULL;
+}
+
 const char* CommandLine::getEGLDisplayType (void) const
 {
 	if (m_cmdLine.hasOption<opt::EGLDisplayType>())
@@ -856,13 +1195,16 @@ static bool checkTestCaseName (const CaseTreeNode* root, const char* casePath)
 	return node && !node->hasChildren();
 }
 
-de::MovePtr<CaseListFilter> CommandLine::createCaseListFilter (const tcu::Archive& archive) const
+de::MovePtr<CaseListFilter> CommandLine::createCaseListFilter (const tcu::Archive& archive, const TestHierarchyIndex* hierarchyIndex) const
 {
-	return de::MovePtr<CaseListFilter>(new CaseListFilter(m_cmdLine, archive));
+	return de::MovePtr<CaseListFilter>(new CaseListFilter(m_cmdLine, archive, hierarchyIndex));
 }
 
 bool CaseListFilter::checkTestGroupName (const char* groupName) const
 {
+	if (!m_emptyGroups.empty() && m_emptyGroups.find(groupName) != m_emptyGroups.end())
+		return false;
+
 	if (m_casePaths)
 		return m_casePaths->matches(groupName, true);
 	else if (m_caseTree)
@@ -886,7 +1228,7 @@ CaseListFilter::CaseListFilter (void)
 {
 }
 
-CaseListFilter::CaseListFilter (const de::cmdline::CommandLine& cmdLine, const tcu::Archive& archive)
+CaseListFilter::CaseListFilter (const de::cmdline::CommandLine& cmdLine, const tcu::Archive& archive, const TestHierarchyIndex* hierarchyIndex)
 	: m_caseTree(DE_NULL)
 {
 	if (cmdLine.hasOption<opt::CaseList>())
@@ -929,6 +1271,19 @@ CaseListFilter::CaseListFilter (const de::cmdline::CommandLine& cmdLine, const t
 	}
 	else if (cmdLine.hasOption<opt::CasePath>())
 		m_casePaths = de::MovePtr<const CasePaths>(new CasePaths(cmdLine.getOption<opt::CasePath>()));
+
+	if (hierarchyIndex && (m_caseTree || m_casePaths))
+	{
+		try
+		{
+			findEmptyGroups(*hierarchyIndex);
+		}
+		catch (...)
+		{
+			delete m_caseTree;
+			throw;
+		}
+	}
 }
 
 CaseListFilter::~CaseListFilter (void)
@@ -936,4 +1291,44 @@ CaseListFilter::~CaseListFilter (void)
 	delete m_caseTree;
 }
 
+void CaseListFilter::findEmptyGroups (const TestHierarchyIndex& hierarchyIndex)
+{
+	const TestHierarchyIndex::Node& root = hierarchyIndex.getNode(0);
+
+	// Packages are checked individually as the root itself is never filtered.
+	for (int pkgNdx = 1; pkgNdx < root.subtreeEnd; pkgNdx = hierarchyIndex.getNode(pkgNdx).subtreeEnd)
+	{
+		const std::string pkgName = hierarchyIndex.getNode(pkgNdx).name;
+
+		if (!findEmptyGroups(hierarchyIndex, pkgNdx, pkgName))
+			m_emptyGroups.insert(pkgName);
+	}
+}
+
+bool CaseListFilter::findEmptyGroups (const TestHierarchyIndex& hierarchyIndex, int nodeNdx, const std::string& nodePath)
+{
+	const TestHierarchyIndex::Node&	node			= hierarchyIndex.getNode(nodeNdx);
+	std::vector<std::string>		emptyChildren;
+	bool							anyMatching		= false;
+
+	if (isTestNodeTypeExecutable(node.nodeType))
+		return checkTestCaseName(nodePath.c_str());
+
+	for (int childNdx = nodeNdx+1; childNdx < node.subtreeEnd; childNdx = hierarchyIndex.getNode(childNdx).subtreeEnd)
+	{
+		const std::string childPath = nodePath + "." + hierarchyIndex.getNode(childNdx).name;
+
+		if (findEmptyGroups(hierarchyIndex, childNdx, childPath))
+			anyMatching = true;
+		else if (!isTestNodeTypeExecutable(hierarchyIndex.getNode(childNdx).nodeType))
+			emptyChildren.push_back(childPath);
+	}
+
+	// Only the outermost empty group is recorded, iterator never descends below it.
+	if (anyMatching)
+		m_emptyGroups.insert(emptyChildren.begin(), emptyChildren.end());
+
+	return anyMatching;
+}
+
 } // tcu
@@ -30,6 +30,7 @@
 #include <string>
 #include <vector>
 #include <istream>
+#include <set>
 
 namespace tcu
 {
@@ -90,11 +91,12 @@ enum ScreenRotation
 class CaseTreeNode;
 class CasePaths;
 class Archive;
+class TestHierarchyIndex;
 
 class CaseListFilter
 {
 public:
-									CaseListFilter				(const de::cmdline::CommandLine& cmdLine, const tcu::Archive& archive);
+									CaseListFilter				(const de::cmdline::CommandLine& cmdLine, const tcu::Archive& archive, const TestHierarchyIndex* hierarchyIndex = DE_NULL);
 									CaseListFilter				(void);
 									~CaseListFilter				(void);
 
@@ -108,8 +110,12 @@ private:
 	CaseListFilter												(const CaseListFilter&);	// not allowed!
 	CaseListFilter&					operator=					(const CaseListFilter&);	// not allowed!
 
+	void							findEmptyGroups				(const TestHierarchyIndex& hierarchyIndex);
+	bool							findEmptyGroups				(const TestHierarchyIndex& hierarchyIndex, int nodeNdx, const std::string& nodePath);
+
 	CaseTreeNode*					m_caseTree;
 	de::MovePtr<const CasePaths>	m_casePaths;
+	std::set<std::string>			m_emptyGroups;		//!< Indexed groups without any matching cases, outermost only.
 };
 
 /*--------------------------------------------------------------------*//*!
@@ -202,15 +208,40 @@ public:
 	//! Get Vulkan device ID (--deqp-vk-device-id)
 	int								getVKDeviceId				(void) const;
 
+	//! Get directory for Vulkan program binary cache (--deqp-vk-program-cache-dir)
+	const char*						getVKProgramCacheDir		(void) const;
+
 	//! Enable development-time test case validation checks
 	bool							isValidationEnabled			(void) const;
 
 	//! Should we run tests that exhaust memory (--deqp-test-oom)
 	bool							isOutOfMemoryTestEnabled	(void) const;
 
+	//! Get number of reference renderer rasterization threads (--deqp-ref-renderer-threads)
+	int								getRefRendererNumThreads	(void) const;
+
+	//! Get number of image comparison threads (--deqp-image-compare-threads)
+	int								getImageCompareNumThreads	(void) const;
+
+	//! Get number of threads running context-free test cases (--deqp-case-threads)
+	int								getCaseNumThreads			(void) const;
+
+	//! Get test hierarchy index file (--deqp-hierarchy-index)
+	const char*						getHierarchyIndexFile		(void) const;
+
+	//! Get directory for parsed shader library file cache (--deqp-shader-library-cache-dir)
+	const char*						getShaderLibraryCacheDir	(void) const;
+
+	//! Get number of threads computing builtin precision test reference intervals (--deqp-precision-eval-threads)
+	int								getPrecisionEvalNumThreads	(void) const;
+
+	//! Get fork server enable status (--deqp-fork-server)
+	bool							isForkServerEnabled			(void) const;
+
 	/*--------------------------------------------------------------------*//*!
 	 * \brief Creates case list filter
 	 * \param archive Resources
+	 * \param hierarchyIndex Optional index used for rejecting groups without matching cases
 	 *
 	 * Creates case list filter based on one of the following parameters:
 	 *
@@ -222,7 +253,7 @@ public:
 	 *
 	 * Throws std::invalid_argument if parsing fails.
 	 *//*--------------------------------------------------------------------*/
-	de::MovePtr<CaseListFilter>		createCaseListFilter		(const tcu::Archive& archive) const;
+	de::MovePtr<CaseListFilter>		createCaseListFilter		(const tcu::Archive& archive, const TestHierarchyIndex* hierarchyIndex = DE_NULL) const;
 
 protected:
 	const de::cmdline::CommandLine&	getCommandLine				(void) const;
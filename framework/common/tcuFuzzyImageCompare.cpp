@@ -26,6 +26,7 @@
 #include "tcuTextureUtil.hpp"
 #include "deMath.h"
 #include "deRandom.hpp"
+#include "tcuParallelRows.hpp"
 
 #include <vector>
 
@@ -158,55 +159,120 @@ inline deUint32 bilinearSample (const ConstPixelBufferAccess& src, float u, floa
 	return dst;
 }
 
+namespace
+{
+
 template<int DstChannels, int SrcChannels>
-static void separableConvolve (const PixelBufferAccess& dst, const ConstPixelBufferAccess& src, int shiftX, int shiftY, const std::vector<float>& kernelX, const std::vector<float>& kernelY)
+class HorizontalConvolveTask : public RowBandTask
 {
-	DE_ASSERT(dst.getWidth() == src.getWidth() && dst.getHeight() == src.getHeight());
+public:
+	HorizontalConvolveTask (const PixelBufferAccess& dst, const ConstPixelBufferAccess& src, int shift, const std::vector<float>& kernel)
+		: m_dst		(dst)
+		, m_src		(src)
+		, m_shift	(shift)
+		, m_kernel	(kernel)
+	{
+	}
 
-	TextureLevel		tmp			(dst.getFormat(), dst.getHeight(), dst.getWidth());
-	PixelBufferAccess	tmpAccess	= tmp.getAccess();
+	// \note Destination is written in column-wise order
+	void processRows (int bandNdx, int rowBegin, int rowEnd)
+	{
+		const int kw = (int)m_kernel.size();
 
-	int kw = (int)kernelX.size();
-	int kh = (int)kernelY.size();
+		DE_UNREF(bandNdx);
 
-	// Horizontal pass
-	// \note Temporary surface is written in column-wise order
-	for (int j = 0; j < src.getHeight(); j++)
-	{
-		for (int i = 0; i < src.getWidth(); i++)
+		for (int j = rowBegin; j < rowEnd; j++)
 		{
-			Vec4 sum(0);
-
-			for (int kx = 0; kx < kw; kx++)
+			for (int i = 0; i < m_src.getWidth(); i++)
 			{
-				float		f = kernelX[kw-kx-1];
-				deUint32	p = readUnorm8<SrcChannels>(src, de::clamp(i+kx-shiftX, 0, src.getWidth()-1), j);
+				Vec4 sum(0);
 
-				sum += toFloatVec(p)*f;
-			}
+				for (int kx = 0; kx < kw; kx++)
+				{
+					float		f = m_kernel[kw-kx-1];
+					deUint32	p = readUnorm8<SrcChannels>(m_src, de::clamp(i+kx-m_shift, 0, m_src.getWidth()-1), j);
 
-			writeUnorm8<DstChannels>(tmpAccess, j, i, toColor(sum));
+					sum += toFloatVec(p)*f;
+				}
+
+				writeUnorm8<DstChannels>(m_dst, j, i, toColor(sum));
+			}
 		}
 	}
 
-	// Vertical pass
-	for (int j = 0; j < src.getHeight(); j++)
+private:
+	const PixelBufferAccess			m_dst;
+	const ConstPixelBufferAccess	m_src;
+	const int						m_shift;
+	const std::vector<float>&		m_kernel;
+};
+
+template<int DstChannels>
+class VerticalConvolveTask : public RowBandTask
+{
+public:
+	VerticalConvolveTask (const PixelBufferAccess& dst, const ConstPixelBufferAccess& tmp, int shift, const std::vector<float>& kernel)
+		: m_dst		(dst)
+		, m_tmp		(tmp)
+		, m_shift	(shift)
+		, m_kernel	(kernel)
 	{
-		for (int i = 0; i < src.getWidth(); i++)
-		{
-			Vec4 sum(0.0f);
+	}
+
+	void processRows (int bandNdx, int rowBegin, int rowEnd)
+	{
+		const int kh = (int)m_kernel.size();
+
+		DE_UNREF(bandNdx);
 
-			for (int ky = 0; ky < kh; ky++)
+		for (int j = rowBegin; j < rowEnd; j++)
+		{
+			for (int i = 0; i < m_dst.getWidth(); i++)
 			{
-				float		f = kernelY[kh-ky-1];
-				deUint32	p = readUnorm8<DstChannels>(tmpAccess, de::clamp(j+ky-shiftY, 0, tmp.getWidth()-1), i);
+				Vec4 sum(0.0f);
 
-				sum += toFloatVec(p)*f;
-			}
+				for (int ky = 0; ky < kh; ky++)
+				{
+					float		f = m_kernel[kh-ky-1];
+					deUint32	p = readUnorm8<DstChannels>(m_tmp, de::clamp(j+ky-m_shift, 0, m_tmp.getWidth()-1), i);
+
+					sum += toFloatVec(p)*f;
+				}
 
-			writeUnorm8<DstChannels>(dst, i, j, toColor(sum));
+				writeUnorm8<DstChannels>(m_dst, i, j, toColor(sum));
+			}
 		}
 	}
+
+private:
+	const PixelBufferAccess			m_dst;
+	const ConstPixelBufferAccess	m_tmp;
+	const int						m_shift;
+	const std::vector<float>&		m_kernel;
+};
+
+} // anonymous
+
+template<int DstChannels, int SrcChannels>
+static void separableConvolve (const PixelBufferAccess& dst, const ConstPixelBufferAccess& src, int shiftX, int shiftY, const std::vector<float>& kernelX, const std::vector<float>& kernelY, int maxThreads)
+{
+	DE_ASSERT(dst.getWidth() == src.getWidth() && dst.getHeight() == src.getHeight());
+
+	TextureLevel		tmp			(dst.getFormat(), dst.getHeight(), dst.getWidth());
+	PixelBufferAccess	tmpAccess	= tmp.getAccess();
+	const int			numBands	= getNumRowBands(src.getHeight(), src.getWidth(), maxThreads);
+
+	// Horizontal pass
+	{
+		HorizontalConvolveTask<DstChannels, SrcChannels> task (tmpAccess, src, shiftX, kernelX);
+		executeRowBands(task, src.getHeight(), numBands);
+	}
+
+	// Vertical pass
+	{
+		VerticalConvolveTask<DstChannels> task (dst, tmpAccess, shiftY, kernelY);
+		executeRowBands(task, src.getHeight(), numBands);
+	}
 }
 
 template<int NumChannels>
@@ -293,16 +359,16 @@ float fuzzyCompare (const FuzzyCompareParams& params, const ConstPixelBufferAcce
 
 	switch (ref.getFormat().order)
 	{
-		case TextureFormat::RGBA:	separableConvolve<4, 4>(refFiltered, ref, shift, shift, kernel, kernel);	break;
-		case TextureFormat::RGB:	separableConvolve<4, 3>(refFiltered, ref, shift, shift, kernel, kernel);	break;
+		case TextureFormat::RGBA:	separableConvolve<4, 4>(refFiltered, ref, shift, shift, kernel, kernel, params.numThreads);	break;
+		case TextureFormat::RGB:	separableConvolve<4, 3>(refFiltered, ref, shift, shift, kernel, kernel, params.numThreads);	break;
 		default:
 			DE_ASSERT(DE_FALSE);
 	}
 
 	switch (cmp.getFormat().order)
 	{
-		case TextureFormat::RGBA:	separableConvolve<4, 4>(cmpFiltered, cmp, shift, shift, kernel, kernel);	break;
-		case TextureFormat::RGB:	separableConvolve<4, 3>(cmpFiltered, cmp, shift, shift, kernel, kernel);	break;
+		case TextureFormat::RGBA:	separableConvolve<4, 4>(cmpFiltered, cmp, shift, shift, kernel, kernel, params.numThreads);	break;
+		case TextureFormat::RGB:	separableConvolve<4, 3>(cmpFiltered, cmp, shift, shift, kernel, kernel, params.numThreads);	break;
 		default:
 			DE_ASSERT(DE_FALSE);
 	}
@@ -33,12 +33,14 @@ class PixelBufferAccess;
 
 struct FuzzyCompareParams
 {
-	FuzzyCompareParams (int maxSampleSkip_ = 8)
-		: maxSampleSkip(maxSampleSkip_)
+	FuzzyCompareParams (int maxSampleSkip_ = 8, int numThreads_ = 1)
+		: maxSampleSkip	(maxSampleSkip_)
+		, numThreads	(numThreads_)
 	{
 	}
 
 	int		maxSampleSkip;
+	int		numThreads;		//!< Maximum number of threads used for filtering.
 };
 
 float fuzzyCompare (const FuzzyCompareParams& params, const ConstPixelBufferAccess& ref, const ConstPixelBufferAccess& cmp, const PixelBufferAccess& errorMask);
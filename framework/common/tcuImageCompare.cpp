@@ -32,8 +32,20 @@
 #include "tcuTexture.hpp"
 #include "tcuTextureUtil.hpp"
 #include "tcuFloat.hpp"
+#include "tcuParallelRows.hpp"
+#include "deRandom.hpp"
+#include "deThread.h"
 
 #include <string.h>
+#include <vector>
+
+#if (DE_CPU == DE_CPU_X86_64) || ((DE_CPU == DE_CPU_X86) && defined(__SSE2__))
+#	define TCU_IMAGE_COMPARE_SSE2 1
+#	include <emmintrin.h>
+#elif ((DE_CPU == DE_CPU_ARM) || (DE_CPU == DE_CPU_ARM_64)) && defined(__ARM_NEON)
+#	define TCU_IMAGE_COMPARE_NEON 1
+#	include <arm_neon.h>
+#endif
 
 namespace tcu
 {
@@ -88,14 +100,432 @@ void computeScaleAndBias (const ConstPixelBufferAccess& reference, const ConstPi
 	}
 }
 
-static int findNumPositionDeviationFailingPixels (const PixelBufferAccess& errorMask, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, bool acceptOutOfBoundsAsAnyValue)
+inline void writeErrorMaskPixelRGB8 (deUint8* dst, bool isOk)
+{
+	dst[0] = isOk ? 0x00 : 0xff;
+	dst[1] = isOk ? 0xff : 0x00;
+	dst[2] = 0x00;
+}
+
+inline bool isErrorMaskRGB8 (const PixelBufferAccess& errorMask)
+{
+	return errorMask.getFormat() == TextureFormat(TextureFormat::RGB, TextureFormat::UNORM_INT8) && errorMask.getPixelPitch() == 3;
+}
+
+inline bool isPackedRGBA8 (const ConstPixelBufferAccess& access)
+{
+	return access.getFormat() == TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8) && access.getPixelPitch() == 4;
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Compare row of RGBA8 pixels against per-channel threshold
+ *
+ * Equivalent to intThresholdCompare() per-pixel logic for RGBA8 data.
+ * Threshold values must be clamped to 255.
+ *//*--------------------------------------------------------------------*/
+void compareRowRGBA8 (deUint8* errorMask, const deUint8* reference, const deUint8* result, int numPixels, const deUint8 (&threshold)[4], deUint8 (&maxDiff)[4])
+{
+	int x = 0;
+
+#if defined(TCU_IMAGE_COMPARE_SSE2)
+	{
+		const __m128i	thr		= _mm_set1_epi32((int)(threshold[0] | (threshold[1] << 8) | (threshold[2] << 16) | ((deUint32)threshold[3] << 24)));
+		__m128i			maxD	= _mm_setzero_si128();
+		deUint8			maxBytes[16];
+
+		for (; x + 4 <= numPixels; x += 4)
+		{
+			const __m128i	a		= _mm_loadu_si128((const __m128i*)(reference + x*4));
+			const __m128i	b		= _mm_loadu_si128((const __m128i*)(result + x*4));
+			const __m128i	diff	= _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+			const int		okBits	= _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(diff, thr), thr));
+
+			maxD = _mm_max_epu8(maxD, diff);
+
+			for (int i = 0; i < 4; i++)
+				writeErrorMaskPixelRGB8(errorMask + (x+i)*3, ((okBits >> (i*4)) & 0xf) == 0xf);
+		}
+
+		_mm_storeu_si128((__m128i*)maxBytes, maxD);
+
+		for (int i = 0; i < 16; i++)
+			maxDiff[i%4] = de::max(maxDiff[i%4], maxBytes[i]);
+	}
+#elif defined(TCU_IMAGE_COMPARE_NEON)
+	{
+		const deUint8	thrBytes[16]	= { threshold[0], threshold[1], threshold[2], threshold[3], threshold[0], threshold[1], threshold[2], threshold[3],
+											threshold[0], threshold[1], threshold[2], threshold[3], threshold[0], threshold[1], threshold[2], threshold[3] };
+		const uint8x16_t thr			= vld1q_u8(thrBytes);
+		uint8x16_t		maxD			= vdupq_n_u8(0);
+		deUint8			okBytes[16];
+		deUint8			maxBytes[16];
+
+		for (; x + 4 <= numPixels; x += 4)
+		{
+			const uint8x16_t	diff	= vabdq_u8(vld1q_u8(reference + x*4), vld1q_u8(result + x*4));
+
+			maxD = vmaxq_u8(maxD, diff);
+			vst1q_u8(okBytes, vcleq_u8(diff, thr));
+
+			for (int i = 0; i < 4; i++)
+				writeErrorMaskPixelRGB8(errorMask + (x+i)*3, (okBytes[i*4+0] & okBytes[i*4+1] & okBytes[i*4+2] & okBytes[i*4+3]) != 0);
+		}
+
+		vst1q_u8(maxBytes, maxD);
+
+		for (int i = 0; i < 16; i++)
+			maxDiff[i%4] = de::max(maxDiff[i%4], maxBytes[i]);
+	}
+#endif
+
+	for (; x < numPixels; x++)
+	{
+		bool isOk = true;
+
+		for (int c = 0; c < 4; c++)
+		{
+			const deUint8 diff = (deUint8)de::abs((int)reference[x*4+c] - (int)result[x*4+c]);
+
+			maxDiff[c]	= de::max(maxDiff[c], diff);
+			isOk		= isOk && diff <= threshold[c];
+		}
+
+		writeErrorMaskPixelRGB8(errorMask + x*3, isOk);
+	}
+}
+
+//! Image row (y, z) for linear row index, rows of all slices are enumerated in order.
+inline IVec2 getRowCoords (int height, int rowNdx)
+{
+	return IVec2(rowNdx % height, rowNdx / height);
+}
+
+class FloatThresholdCompareTask : public RowBandTask
+{
+public:
+	FloatThresholdCompareTask (const PixelBufferAccess& errorMask, const ConstPixelBufferAccess* reference, const Vec4& referenceColor, const ConstPixelBufferAccess& result, const Vec4& threshold, int numBands)
+		: m_errorMask		(errorMask)
+		, m_reference		(reference)
+		, m_referenceColor	(referenceColor)
+		, m_result			(result)
+		, m_threshold		(threshold)
+		, m_bandMaxDiff		(numBands, Vec4(0.0f))
+		, m_bandHasNaN		(numBands, BVec4(false))
+	{
+	}
+
+	void processRows (int bandNdx, int rowBegin, int rowEnd)
+	{
+		const int			width	= m_result.getWidth();
+		const int			height	= m_result.getHeight();
+		std::vector<Vec4>	refRow	(m_reference ? width : 0);
+		std::vector<Vec4>	cmpRow	(width);
+		Vec4				maxDiff	(0.0f);
+		BVec4				hasNaN	(false);
+
+		if (width == 0)
+			return;
+
+		for (int rowNdx = rowBegin; rowNdx < rowEnd; rowNdx++)
+		{
+			const IVec2		yz		= getRowCoords(height, rowNdx);
+			deUint8* const	maskRow	= (deUint8*)m_errorMask.getPixelPtr(0, yz.x(), yz.y());
+
+			if (m_reference)
+				m_reference->getPixels(&refRow[0], width, 0, yz.x(), yz.y());
+			m_result.getPixels(&cmpRow[0], width, 0, yz.x(), yz.y());
+
+			for (int x = 0; x < width; x++)
+			{
+				const Vec4	refPix		= m_reference ? refRow[x] : m_referenceColor;
+				const Vec4	diff		= abs(refPix - cmpRow[x]);
+				const bool	isOk		= boolAll(lessThanEqual(diff, m_threshold));
+
+				maxDiff = max(maxDiff, diff);
+				hasNaN	= logicalOr(hasNaN, notEqual(diff, diff));
+
+				writeErrorMaskPixelRGB8(maskRow + x*3, isOk);
+			}
+		}
+
+		m_bandMaxDiff[bandNdx]	= maxDiff;
+		m_bandHasNaN[bandNdx]	= hasNaN;
+	}
+
+	Vec4 getMaxDiff (void) const
+	{
+		// \note max() is not associative if NaNs are involved, but sequential max() over a
+		//		 range containing NaN does not depend on the preceding value.
+		Vec4 maxDiff (0.0f);
+
+		for (size_t bandNdx = 0; bandNdx < m_bandMaxDiff.size(); bandNdx++)
+		{
+			for (int c = 0; c < 4; c++)
+				maxDiff[c] = m_bandHasNaN[bandNdx][c] ? m_bandMaxDiff[bandNdx][c] : de::max(maxDiff[c], m_bandMaxDiff[bandNdx][c]);
+		}
+
+		return maxDiff;
+	}
+
+private:
+	const PixelBufferAccess			m_errorMask;
+	const ConstPixelBufferAccess*	m_reference;
+	const Vec4						m_referenceColor;
+	const ConstPixelBufferAccess	m_result;
+	const Vec4						m_threshold;
+	std::vector<Vec4>				m_bandMaxDiff;
+	std::vector<BVec4>				m_bandHasNaN;
+};
+
+class IntThresholdCompareTask : public RowBandTask
+{
+public:
+	IntThresholdCompareTask (const PixelBufferAccess& errorMask, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, int numBands)
+		: m_errorMask	(errorMask)
+		, m_reference	(reference)
+		, m_result		(result)
+		, m_threshold	(threshold)
+		, m_bandMaxDiff	(numBands, UVec4(0u))
+	{
+	}
+
+	void processRows (int bandNdx, int rowBegin, int rowEnd)
+	{
+		if (m_reference.getWidth() == 0)
+			return;
+
+		if (isPackedRGBA8(m_reference) && isPackedRGBA8(m_result))
+			processRowsRGBA8(bandNdx, rowBegin, rowEnd);
+		else
+			processRowsGeneric(bandNdx, rowBegin, rowEnd);
+	}
+
+	UVec4 getMaxDiff (void) const
+	{
+		UVec4 maxDiff (0u);
+
+		for (size_t bandNdx = 0; bandNdx < m_bandMaxDiff.size(); bandNdx++)
+			maxDiff = max(maxDiff, m_bandMaxDiff[bandNdx]);
+
+		return maxDiff;
+	}
+
+private:
+	void processRowsRGBA8 (int bandNdx, int rowBegin, int rowEnd)
+	{
+		const int	width		= m_reference.getWidth();
+		const int	height		= m_reference.getHeight();
+		deUint8		threshold[4];
+		deUint8		maxDiff[4]	= { 0, 0, 0, 0 };
+
+		for (int c = 0; c < 4; c++)
+			threshold[c] = (deUint8)de::min(m_threshold[c], 255u);
+
+		for (int rowNdx = rowBegin; rowNdx < rowEnd; rowNdx++)
+		{
+			const IVec2 yz = getRowCoords(height, rowNdx);
+
+			compareRowRGBA8((deUint8*)m_errorMask.getPixelPtr(0, yz.x(), yz.y()),
+							(const deUint8*)m_reference.getPixelPtr(0, yz.x(), yz.y()),
+							(const deUint8*)m_result.getPixelPtr(0, yz.x(), yz.y()),
+							width, threshold, maxDiff);
+		}
+
+		m_bandMaxDiff[bandNdx] = UVec4(maxDiff[0], maxDiff[1], maxDiff[2], maxDiff[3]);
+	}
+
+	void processRowsGeneric (int bandNdx, int rowBegin, int rowEnd)
+	{
+		const int			width	= m_reference.getWidth();
+		const int			height	= m_reference.getHeight();
+		std::vector<IVec4>	refRow	(width);
+		std::vector<IVec4>	cmpRow	(width);
+		UVec4				maxDiff	(0u);
+
+		for (int rowNdx = rowBegin; rowNdx < rowEnd; rowNdx++)
+		{
+			const IVec2		yz		= getRowCoords(height, rowNdx);
+			deUint8* const	maskRow	= (deUint8*)m_errorMask.getPixelPtr(0, yz.x(), yz.y());
+
+			m_reference.getPixelsInt(&refRow[0], width, 0, yz.x(), yz.y());
+			m_result.getPixelsInt(&cmpRow[0], width, 0, yz.x(), yz.y());
+
+			for (int x = 0; x < width; x++)
+			{
+				const UVec4	diff	= abs(refRow[x] - cmpRow[x]).cast<deUint32>();
+				const bool	isOk	= boolAll(lessThanEqual(diff, m_threshold));
+
+				maxDiff = max(maxDiff, diff);
+
+				writeErrorMaskPixelRGB8(maskRow + x*3, isOk);
+			}
+		}
+
+		m_bandMaxDiff[bandNdx] = maxDiff;
+	}
+
+	const PixelBufferAccess			m_errorMask;
+	const ConstPixelBufferAccess	m_reference;
+	const ConstPixelBufferAccess	m_result;
+	const UVec4						m_threshold;
+	std::vector<UVec4>				m_bandMaxDiff;
+};
+
+Vec4 computeFloatThresholdErrorMask (const PixelBufferAccess& errorMask, const ConstPixelBufferAccess* reference, const Vec4& referenceColor, const ConstPixelBufferAccess& result, const Vec4& threshold, int maxThreads)
+{
+	DE_ASSERT(isErrorMaskRGB8(errorMask));
+
+	const int					numRows		= result.getHeight()*result.getDepth();
+	const int					numBands	= getNumRowBands(numRows, result.getWidth(), maxThreads);
+	FloatThresholdCompareTask	task		(errorMask, reference, referenceColor, result, threshold, numBands);
+
+	executeRowBands(task, numRows, numBands);
+
+	return task.getMaxDiff();
+}
+
+UVec4 computeIntThresholdErrorMask (const PixelBufferAccess& errorMask, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, int maxThreads)
+{
+	DE_ASSERT(isErrorMaskRGB8(errorMask));
+
+	const int				numRows		= reference.getHeight()*reference.getDepth();
+	const int				numBands	= getNumRowBands(numRows, reference.getWidth(), maxThreads);
+	IntThresholdCompareTask	task		(errorMask, reference, result, threshold, numBands);
+
+	executeRowBands(task, numRows, numBands);
+
+	return task.getMaxDiff();
+}
+
+bool isPositionDeviationPixelOk (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, int x, int y, int z, const IVec4& refPix, const IVec4& cmpPix)
+{
+	const int	width	= reference.getWidth();
+	const int	height	= reference.getHeight();
+	const int	depth	= reference.getDepth();
+
+	// Find matching pixels for both result and reference pixel
+
+	{
+		bool pixelFoundForReference = false;
+
+		// Find deviated result pixel for reference
+
+		for (int sz = de::max(0, z - maxPositionDeviation.z()); sz <= de::min(depth  - 1, z + maxPositionDeviation.z()) && !pixelFoundForReference; ++sz)
+		for (int sy = de::max(0, y - maxPositionDeviation.y()); sy <= de::min(height - 1, y + maxPositionDeviation.y()) && !pixelFoundForReference; ++sy)
+		for (int sx = de::max(0, x - maxPositionDeviation.x()); sx <= de::min(width  - 1, x + maxPositionDeviation.x()) && !pixelFoundForReference; ++sx)
+		{
+			const IVec4	deviatedCmpPix	= result.getPixelInt(sx, sy, sz);
+			const UVec4	diff			= abs(refPix - deviatedCmpPix).cast<deUint32>();
+			const bool	isOk			= boolAll(lessThanEqual(diff, threshold));
+
+			pixelFoundForReference		= isOk;
+		}
+
+		if (!pixelFoundForReference)
+			return false;
+	}
+	{
+		bool pixelFoundForResult = false;
+
+		// Find deviated reference pixel for result
+
+		for (int sz = de::max(0, z - maxPositionDeviation.z()); sz <= de::min(depth  - 1, z + maxPositionDeviation.z()) && !pixelFoundForResult; ++sz)
+		for (int sy = de::max(0, y - maxPositionDeviation.y()); sy <= de::min(height - 1, y + maxPositionDeviation.y()) && !pixelFoundForResult; ++sy)
+		for (int sx = de::max(0, x - maxPositionDeviation.x()); sx <= de::min(width  - 1, x + maxPositionDeviation.x()) && !pixelFoundForResult; ++sx)
+		{
+			const IVec4	deviatedRefPix	= reference.getPixelInt(sx, sy, sz);
+			const UVec4	diff			= abs(cmpPix - deviatedRefPix).cast<deUint32>();
+			const bool	isOk			= boolAll(lessThanEqual(diff, threshold));
+
+			pixelFoundForResult			= isOk;
+		}
+
+		if (!pixelFoundForResult)
+			return false;
+	}
+
+	return true;
+}
+
+class PositionDeviationCompareTask : public RowBandTask
+{
+public:
+	PositionDeviationCompareTask (const PixelBufferAccess& errorMask, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, const IVec3& begin, const IVec3& end, int numBands)
+		: m_errorMask				(errorMask)
+		, m_reference				(reference)
+		, m_result					(result)
+		, m_threshold				(threshold)
+		, m_maxPositionDeviation	(maxPositionDeviation)
+		, m_begin					(begin)
+		, m_end						(end)
+		, m_bandNumFailingPixels	(numBands, 0)
+	{
+	}
+
+	void processRows (int bandNdx, int rowBegin, int rowEnd)
+	{
+		const tcu::IVec4	errorColor			(255, 0, 0, 255);
+		const int			numColumns			= m_end.x() - m_begin.x();
+		const int			numRowsPerSlice		= m_end.y() - m_begin.y();
+		std::vector<IVec4>	refRow				(numColumns);
+		std::vector<IVec4>	cmpRow				(numColumns);
+		int					numFailingPixels	= 0;
+
+		for (int rowNdx = rowBegin; rowNdx < rowEnd; rowNdx++)
+		{
+			const int	y	= m_begin.y() + rowNdx % numRowsPerSlice;
+			const int	z	= m_begin.z() + rowNdx / numRowsPerSlice;
+
+			m_reference.getPixelsInt(&refRow[0], numColumns, m_begin.x(), y, z);
+			m_result.getPixelsInt(&cmpRow[0], numColumns, m_begin.x(), y, z);
+
+			for (int colNdx = 0; colNdx < numColumns; colNdx++)
+			{
+				const int	x		= m_begin.x() + colNdx;
+				const UVec4	diff	= abs(refRow[colNdx] - cmpRow[colNdx]).cast<deUint32>();
+
+				// Exact match
+				if (boolAll(lessThanEqual(diff, m_threshold)))
+					continue;
+
+				if (!isPositionDeviationPixelOk(m_reference, m_result, m_threshold, m_maxPositionDeviation, x, y, z, refRow[colNdx], cmpRow[colNdx]))
+				{
+					m_errorMask.setPixel(errorColor, x, y, z);
+					++numFailingPixels;
+				}
+			}
+		}
+
+		m_bandNumFailingPixels[bandNdx] = numFailingPixels;
+	}
+
+	int getNumFailingPixels (void) const
+	{
+		int numFailingPixels = 0;
+
+		for (size_t bandNdx = 0; bandNdx < m_bandNumFailingPixels.size(); bandNdx++)
+			numFailingPixels += m_bandNumFailingPixels[bandNdx];
+
+		return numFailingPixels;
+	}
+
+private:
+	const PixelBufferAccess			m_errorMask;
+	const ConstPixelBufferAccess	m_reference;
+	const ConstPixelBufferAccess	m_result;
+	const UVec4						m_threshold;
+	const IVec3						m_maxPositionDeviation;
+	const IVec3						m_begin;
+	const IVec3						m_end;
+	std::vector<int>				m_bandNumFailingPixels;
+};
+
+int findNumPositionDeviationFailingPixels (const PixelBufferAccess& errorMask, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, bool acceptOutOfBoundsAsAnyValue, int maxThreads)
 {
 	const tcu::IVec4	okColor				(0, 255, 0, 255);
-	const tcu::IVec4	errorColor			(255, 0, 0, 255);
 	const int			width				= reference.getWidth();
 	const int			height				= reference.getHeight();
 	const int			depth				= reference.getDepth();
-	int					numFailingPixels	= 0;
 
 	// Accept pixels "sampling" over the image bounds pixels since "taps" could be anything
 	const int			beginX				= (acceptOutOfBoundsAsAnyValue) ? (maxPositionDeviation.x()) : (0);
@@ -110,77 +540,18 @@ static int findNumPositionDeviationFailingPixels (const PixelBufferAccess& error
 
 	tcu::clear(errorMask, okColor);
 
-	for (int z = beginZ; z < endZ; z++)
-	{
-		for (int y = beginY; y < endY; y++)
-		{
-			for (int x = beginX; x < endX; x++)
-			{
-				const IVec4	refPix = reference.getPixelInt(x, y, z);
-				const IVec4	cmpPix = result.getPixelInt(x, y, z);
-
-				// Exact match
-				{
-					const UVec4	diff = abs(refPix - cmpPix).cast<deUint32>();
-					const bool	isOk = boolAll(lessThanEqual(diff, threshold));
+	if (beginX >= endX || beginY >= endY || beginZ >= endZ)
+		return 0;
 
-					if (isOk)
-						continue;
-				}
+	{
+		const int						numRows		= (endY - beginY)*(endZ - beginZ);
+		const int						numBands	= getNumRowBands(numRows, endX - beginX, maxThreads);
+		PositionDeviationCompareTask	task		(errorMask, reference, result, threshold, maxPositionDeviation, IVec3(beginX, beginY, beginZ), IVec3(endX, endY, endZ), numBands);
 
-				// Find matching pixels for both result and reference pixel
+		executeRowBands(task, numRows, numBands);
 
-				{
-					bool pixelFoundForReference = false;
-
-					// Find deviated result pixel for reference
-
-					for (int sz = de::max(0, z - maxPositionDeviation.z()); sz <= de::min(depth  - 1, z + maxPositionDeviation.z()) && !pixelFoundForReference; ++sz)
-					for (int sy = de::max(0, y - maxPositionDeviation.y()); sy <= de::min(height - 1, y + maxPositionDeviation.y()) && !pixelFoundForReference; ++sy)
-					for (int sx = de::max(0, x - maxPositionDeviation.x()); sx <= de::min(width  - 1, x + maxPositionDeviation.x()) && !pixelFoundForReference; ++sx)
-					{
-						const IVec4	deviatedCmpPix	= result.getPixelInt(sx, sy, sz);
-						const UVec4	diff			= abs(refPix - deviatedCmpPix).cast<deUint32>();
-						const bool	isOk			= boolAll(lessThanEqual(diff, threshold));
-
-						pixelFoundForReference		= isOk;
-					}
-
-					if (!pixelFoundForReference)
-					{
-						errorMask.setPixel(errorColor, x, y, z);
-						++numFailingPixels;
-						continue;
-					}
-				}
-				{
-					bool pixelFoundForResult = false;
-
-					// Find deviated reference pixel for result
-
-					for (int sz = de::max(0, z - maxPositionDeviation.z()); sz <= de::min(depth  - 1, z + maxPositionDeviation.z()) && !pixelFoundForResult; ++sz)
-					for (int sy = de::max(0, y - maxPositionDeviation.y()); sy <= de::min(height - 1, y + maxPositionDeviation.y()) && !pixelFoundForResult; ++sy)
-					for (int sx = de::max(0, x - maxPositionDeviation.x()); sx <= de::min(width  - 1, x + maxPositionDeviation.x()) && !pixelFoundForResult; ++sx)
-					{
-						const IVec4	deviatedRefPix	= reference.getPixelInt(sx, sy, sz);
-						const UVec4	diff			= abs(cmpPix - deviatedRefPix).cast<deUint32>();
-						const bool	isOk			= boolAll(lessThanEqual(diff, threshold));
-
-						pixelFoundForResult			= isOk;
-					}
-
-					if (!pixelFoundForResult)
-					{
-						errorMask.setPixel(errorColor, x, y, z);
-						++numFailingPixels;
-						continue;
-					}
-				}
-			}
-		}
+		return task.getNumFailingPixels();
 	}
-
-	return numFailingPixels;
 }
 
 } // anonymous
@@ -216,7 +587,7 @@ static int findNumPositionDeviationFailingPixels (const PixelBufferAccess& error
  *//*--------------------------------------------------------------------*/
 bool fuzzyCompare (TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, float threshold, CompareLogMode logMode)
 {
-	FuzzyCompareParams	params;		// Use defaults.
+	FuzzyCompareParams	params			(8, getImageCompareNumThreads());
 	TextureLevel		errorMask		(TextureFormat(TextureFormat::RGB, TextureFormat::UNORM_INT8), reference.getWidth(), reference.getHeight());
 	float				difference		= fuzzyCompare(params, reference, result, errorMask.getAccess());
 	bool				isOk			= difference <= threshold;
@@ -578,30 +949,12 @@ bool floatThresholdCompare (TestLog& log, const char* imageSetName, const char*
 	int					depth				= reference.getDepth();
 	TextureLevel		errorMaskStorage	(TextureFormat(TextureFormat::RGB, TextureFormat::UNORM_INT8), width, height, depth);
 	PixelBufferAccess	errorMask			= errorMaskStorage.getAccess();
-	Vec4				maxDiff				(0.0f, 0.0f, 0.0f, 0.0f);
 	Vec4				pixelBias			(0.0f, 0.0f, 0.0f, 0.0f);
 	Vec4				pixelScale			(1.0f, 1.0f, 1.0f, 1.0f);
 
 	TCU_CHECK_INTERNAL(result.getWidth() == width && result.getHeight() == height && result.getDepth() == depth);
 
-	for (int z = 0; z < depth; z++)
-	{
-		for (int y = 0; y < height; y++)
-		{
-			for (int x = 0; x < width; x++)
-			{
-				Vec4	refPix		= reference.getPixel(x, y, z);
-				Vec4	cmpPix		= result.getPixel(x, y, z);
-
-				Vec4	diff		= abs(refPix - cmpPix);
-				bool	isOk		= boolAll(lessThanEqual(diff, threshold));
-
-				maxDiff = max(maxDiff, diff);
-
-				errorMask.setPixel(isOk ? Vec4(0.0f, 1.0f, 0.0f, 1.0f) : Vec4(1.0f, 0.0f, 0.0f, 1.0f), x, y, z);
-			}
-		}
-	}
+	const Vec4			maxDiff				= computeFloatThresholdErrorMask(errorMask, &reference, Vec4(0.0f), result, threshold, getImageCompareNumThreads());
 
 	bool compareOk = boolAll(lessThanEqual(maxDiff, threshold));
 
@@ -666,26 +1019,10 @@ bool floatThresholdCompare (TestLog& log, const char* imageSetName, const char*
 
 	TextureLevel		errorMaskStorage	(TextureFormat(TextureFormat::RGB, TextureFormat::UNORM_INT8), width, height, depth);
 	PixelBufferAccess	errorMask			= errorMaskStorage.getAccess();
-	Vec4				maxDiff				(0.0f, 0.0f, 0.0f, 0.0f);
 	Vec4				pixelBias			(0.0f, 0.0f, 0.0f, 0.0f);
 	Vec4				pixelScale			(1.0f, 1.0f, 1.0f, 1.0f);
 
-	for (int z = 0; z < depth; z++)
-	{
-		for (int y = 0; y < height; y++)
-		{
-			for (int x = 0; x < width; x++)
-			{
-				const Vec4	cmpPix		= result.getPixel(x, y, z);
-				const Vec4	diff		= abs(reference - cmpPix);
-				const bool	isOk		= boolAll(lessThanEqual(diff, threshold));
-
-				maxDiff = max(maxDiff, diff);
-
-				errorMask.setPixel(isOk ? Vec4(0.0f, 1.0f, 0.0f, 1.0f) : Vec4(1.0f, 0.0f, 0.0f, 1.0f), x, y, z);
-			}
-		}
-	}
+	const Vec4			maxDiff				= computeFloatThresholdErrorMask(errorMask, DE_NULL, reference, result, threshold, getImageCompareNumThreads());
 
 	bool compareOk = boolAll(lessThanEqual(maxDiff, threshold));
 
@@ -747,30 +1084,12 @@ bool intThresholdCompare (TestLog& log, const char* imageSetName, const char* im
 	int					depth				= reference.getDepth();
 	TextureLevel		errorMaskStorage	(TextureFormat(TextureFormat::RGB, TextureFormat::UNORM_INT8), width, height, depth);
 	PixelBufferAccess	errorMask			= errorMaskStorage.getAccess();
-	UVec4				maxDiff				(0, 0, 0, 0);
 	Vec4				pixelBias			(0.0f, 0.0f, 0.0f, 0.0f);
 	Vec4				pixelScale			(1.0f, 1.0f, 1.0f, 1.0f);
 
 	TCU_CHECK_INTERNAL(result.getWidth() == width && result.getHeight() == height && result.getDepth() == depth);
 
-	for (int z = 0; z < depth; z++)
-	{
-		for (int y = 0; y < height; y++)
-		{
-			for (int x = 0; x < width; x++)
-			{
-				IVec4	refPix		= reference.getPixelInt(x, y, z);
-				IVec4	cmpPix		= result.getPixelInt(x, y, z);
-
-				UVec4	diff		= abs(refPix - cmpPix).cast<deUint32>();
-				bool	isOk		= boolAll(lessThanEqual(diff, threshold));
-
-				maxDiff = max(maxDiff, diff);
-
-				errorMask.setPixel(isOk ? IVec4(0, 0xff, 0, 0xff) : IVec4(0xff, 0, 0, 0xff), x, y, z);
-			}
-		}
-	}
+	const UVec4			maxDiff				= computeIntThresholdErrorMask(errorMask, reference, result, threshold, getImageCompareNumThreads());
 
 	bool compareOk = boolAll(lessThanEqual(maxDiff, threshold));
 
@@ -842,7 +1161,7 @@ bool intThresholdPositionDeviationCompare (TestLog& log, const char* imageSetNam
 	const int			depth				= reference.getDepth();
 	TextureLevel		errorMaskStorage	(TextureFormat(TextureFormat::RGB, TextureFormat::UNORM_INT8), width, height, depth);
 	PixelBufferAccess	errorMask			= errorMaskStorage.getAccess();
-	const int			numFailingPixels	= findNumPositionDeviationFailingPixels(errorMask, reference, result, threshold, maxPositionDeviation, acceptOutOfBoundsAsAnyValue);
+	const int			numFailingPixels	= findNumPositionDeviationFailingPixels(errorMask, reference, result, threshold, maxPositionDeviation, acceptOutOfBoundsAsAnyValue, getImageCompareNumThreads());
 	const bool			compareOk			= numFailingPixels == 0;
 	Vec4				pixelBias			(0.0f, 0.0f, 0.0f, 0.0f);
 	Vec4				pixelScale			(1.0f, 1.0f, 1.0f, 1.0f);
@@ -921,7 +1240,7 @@ bool intThresholdPositionDeviationErrorThresholdCompare (TestLog& log, const cha
 	const int			depth				= reference.getDepth();
 	TextureLevel		errorMaskStorage	(TextureFormat(TextureFormat::RGB, TextureFormat::UNORM_INT8), width, height, depth);
 	PixelBufferAccess	errorMask			= errorMaskStorage.getAccess();
-	const int			numFailingPixels	= findNumPositionDeviationFailingPixels(errorMask, reference, result, threshold, maxPositionDeviation, acceptOutOfBoundsAsAnyValue);
+	const int			numFailingPixels	= findNumPositionDeviationFailingPixels(errorMask, reference, result, threshold, maxPositionDeviation, acceptOutOfBoundsAsAnyValue, getImageCompareNumThreads());
 	const bool			compareOk			= numFailingPixels <= maxAllowedFailingPixels;
 	Vec4				pixelBias			(0.0f, 0.0f, 0.0f, 0.0f);
 	Vec4				pixelScale			(1.0f, 1.0f, 1.0f, 1.0f);
@@ -1007,7 +1326,7 @@ bool pixelThresholdCompare (TestLog& log, const char* imageSetName, const char*
 bool bilinearCompare (TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const RGBA threshold, CompareLogMode logMode)
 {
 	TextureLevel		errorMask		(TextureFormat(TextureFormat::RGB, TextureFormat::UNORM_INT8), reference.getWidth(), reference.getHeight());
-	bool				isOk			= bilinearCompare(reference, result, errorMask, threshold);
+	bool				isOk			= bilinearCompare(reference, result, errorMask, threshold, getImageCompareNumThreads());
 	Vec4				pixelBias		(0.0f, 0.0f, 0.0f, 0.0f);
 	Vec4				pixelScale		(1.0f, 1.0f, 1.0f, 1.0f);
 
@@ -1038,4 +1357,251 @@ bool bilinearCompare (TestLog& log, const char* imageSetName, const char* imageS
 	return isOk;
 }
 
+static volatile deInt32 s_imageCompareNumThreads = 1;
+
+int getImageCompareNumThreads (void)
+{
+	return s_imageCompareNumThreads;
+}
+
+void setImageCompareNumThreads (int numThreads)
+{
+	DE_ASSERT(numThreads >= 0);
+	s_imageCompareNumThreads = (numThreads == 0) ? (int)deGetNumAvailableLogicalCores() : numThreads;
+}
+
+namespace
+{
+
+void fillRandomBytes (const PixelBufferAccess& dst, de::Random& rnd)
+{
+	for (int z = 0; z < dst.getDepth(); z++)
+	for (int y = 0; y < dst.getHeight(); y++)
+	{
+		deUint8* const row = (deUint8*)dst.getPixelPtr(0, y, z);
+
+		for (int ndx = 0; ndx < dst.getWidth()*dst.getPixelPitch(); ndx++)
+			row[ndx] = rnd.getUint8();
+	}
+}
+
+//! Copy src to dst and add small random differences to random bytes.
+void perturbBytes (const PixelBufferAccess& dst, const ConstPixelBufferAccess& src, de::Random& rnd)
+{
+	copy(dst, src);
+
+	for (int z = 0; z < dst.getDepth(); z++)
+	for (int y = 0; y < dst.getHeight(); y++)
+	{
+		deUint8* const row = (deUint8*)dst.getPixelPtr(0, y, z);
+
+		for (int ndx = 0; ndx < dst.getWidth()*dst.getPixelPitch(); ndx++)
+		{
+			if (rnd.getInt(0, 7) == 0)
+				row[ndx] = (deUint8)(row[ndx] + rnd.getInt(-4, 4));
+		}
+	}
+}
+
+void fillRandomFloat (const PixelBufferAccess& dst, const ConstPixelBufferAccess* src, de::Random& rnd)
+{
+	for (int z = 0; z < dst.getDepth(); z++)
+	for (int y = 0; y < dst.getHeight(); y++)
+	for (int x = 0; x < dst.getWidth(); x++)
+	{
+		Vec4 color = src ? src->getPixel(x, y, z) : Vec4(rnd.getFloat(), rnd.getFloat(), rnd.getFloat(), rnd.getFloat());
+
+		if (src && rnd.getInt(0, 7) == 0)
+			color[rnd.getInt(0, 3)] += rnd.getFloat(-0.01f, 0.01f);
+
+		if (src && rnd.getInt(0, 4999) == 0)
+			color[rnd.getInt(0, 3)] = tcu::Float32::nan().asFloat();
+
+		dst.setPixel(color, x, y, z);
+	}
+}
+
+bool isErrorMaskEqual (const ConstPixelBufferAccess& a, const ConstPixelBufferAccess& b)
+{
+	for (int z = 0; z < a.getDepth(); z++)
+	for (int y = 0; y < a.getHeight(); y++)
+	for (int x = 0; x < a.getWidth(); x++)
+	{
+		if (a.getPixelInt(x, y, z) != b.getPixelInt(x, y, z))
+			return false;
+	}
+
+	return true;
+}
+
+bool isMaxDiffEqual (const Vec4& a, const Vec4& b)
+{
+	for (int c = 0; c < 4; c++)
+	{
+		if (a[c] != b[c] && !(deIsNaN(a[c]) && deIsNaN(b[c])))
+			return false;
+	}
+
+	return true;
+}
+
+void selfTestIntThresholdCompare (de::Random& rnd, const TextureFormat& format, const IVec3& size, const UVec4& threshold)
+{
+	const TextureFormat	maskFormat		(TextureFormat::RGB, TextureFormat::UNORM_INT8);
+	TextureLevel		reference		(format, size.x(), size.y(), size.z());
+	TextureLevel		result			(format, size.x(), size.y(), size.z());
+	TextureLevel		expectedMask	(maskFormat, size.x(), size.y(), size.z());
+	UVec4				expectedMaxDiff	(0u);
+
+	fillRandomBytes(reference, rnd);
+	perturbBytes(result, reference, rnd);
+
+	for (int z = 0; z < size.z(); z++)
+	for (int y = 0; y < size.y(); y++)
+	for (int x = 0; x < size.x(); x++)
+	{
+		const UVec4	diff	= abs(reference.getAccess().getPixelInt(x, y, z) - result.getAccess().getPixelInt(x, y, z)).cast<deUint32>();
+		const bool	isOk	= boolAll(lessThanEqual(diff, threshold));
+
+		expectedMaxDiff = max(expectedMaxDiff, diff);
+		expectedMask.getAccess().setPixel(isOk ? IVec4(0, 0xff, 0, 0xff) : IVec4(0xff, 0, 0, 0xff), x, y, z);
+	}
+
+	for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+	{
+		TextureLevel	mask	(maskFormat, size.x(), size.y(), size.z());
+		const UVec4		maxDiff	= computeIntThresholdErrorMask(mask, reference, result, threshold, numThreads);
+
+		TCU_CHECK(maxDiff == expectedMaxDiff);
+		TCU_CHECK(isErrorMaskEqual(mask, expectedMask));
+	}
+}
+
+void selfTestFloatThresholdCompare (de::Random& rnd, const TextureFormat& format, const IVec3& size, const Vec4& threshold, bool constantReference)
+{
+	const TextureFormat	maskFormat		(TextureFormat::RGB, TextureFormat::UNORM_INT8);
+	TextureLevel		reference		(format, size.x(), size.y(), size.z());
+	TextureLevel		result			(format, size.x(), size.y(), size.z());
+	TextureLevel		expectedMask	(maskFormat, size.x(), size.y(), size.z());
+	const Vec4			referenceColor	(0.25f, 0.5f, 0.75f, 1.0f);
+	Vec4				expectedMaxDiff	(0.0f);
+
+	const ConstPixelBufferAccess	referenceAccess	= reference.getAccess();
+
+	if (constantReference)
+		clear(reference, referenceColor);
+	else
+		fillRandomFloat(reference, DE_NULL, rnd);
+
+	fillRandomFloat(result, &referenceAccess, rnd);
+
+	for (int z = 0; z < size.z(); z++)
+	for (int y = 0; y < size.y(); y++)
+	for (int x = 0; x < size.x(); x++)
+	{
+		const Vec4	diff	= abs(reference.getAccess().getPixel(x, y, z) - result.getAccess().getPixel(x, y, z));
+		const bool	isOk	= boolAll(lessThanEqual(diff, threshold));
+
+		expectedMaxDiff = max(expectedMaxDiff, diff);
+		expectedMask.getAccess().setPixel(isOk ? Vec4(0.0f, 1.0f, 0.0f, 1.0f) : Vec4(1.0f, 0.0f, 0.0f, 1.0f), x, y, z);
+	}
+
+	for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+	{
+		TextureLevel					mask			(maskFormat, size.x(), size.y(), size.z());
+		const Vec4						maxDiff			= computeFloatThresholdErrorMask(mask, constantReference ? DE_NULL : &referenceAccess, referenceColor, result, threshold, numThreads);
+
+		TCU_CHECK(isMaxDiffEqual(maxDiff, expectedMaxDiff));
+		TCU_CHECK(isErrorMaskEqual(mask, expectedMask));
+	}
+}
+
+void selfTestPositionDeviationCompare (de::Random& rnd, const IVec3& size, const IVec3& maxPositionDeviation, bool acceptOutOfBoundsAsAnyValue)
+{
+	const TextureFormat	maskFormat		(TextureFormat::RGB, TextureFormat::UNORM_INT8);
+	const TextureFormat	format			(TextureFormat::RGBA, TextureFormat::UNORM_INT8);
+	const UVec4			threshold		(2u);
+	TextureLevel		reference		(format, size.x(), size.y(), size.z());
+	TextureLevel		result			(format, size.x(), size.y(), size.z());
+	TextureLevel		expectedMask	(maskFormat, size.x(), size.y(), size.z());
+	TextureLevel		mask			(maskFormat, size.x(), size.y(), size.z());
+
+	fillRandomBytes(reference, rnd);
+	perturbBytes(result, reference, rnd);
+
+	{
+		const int expectedNumFailing = findNumPositionDeviationFailingPixels(expectedMask, reference, result, threshold, maxPositionDeviation, acceptOutOfBoundsAsAnyValue, 1);
+
+		TCU_CHECK(expectedNumFailing > 0);
+		TCU_CHECK(findNumPositionDeviationFailingPixels(mask, reference, result, threshold, maxPositionDeviation, acceptOutOfBoundsAsAnyValue, 4) == expectedNumFailing);
+		TCU_CHECK(isErrorMaskEqual(mask, expectedMask));
+	}
+}
+
+void selfTestBilinearCompare (de::Random& rnd, const IVec2& size)
+{
+	const TextureFormat	maskFormat		(TextureFormat::RGB, TextureFormat::UNORM_INT8);
+	const TextureFormat	format			(TextureFormat::RGBA, TextureFormat::UNORM_INT8);
+	TextureLevel		reference		(format, size.x(), size.y());
+	TextureLevel		result			(format, size.x(), size.y());
+	TextureLevel		expectedMask	(maskFormat, size.x(), size.y());
+	TextureLevel		mask			(maskFormat, size.x(), size.y());
+
+	fillRandomBytes(reference, rnd);
+	perturbBytes(result, reference, rnd);
+
+	{
+		const bool expectedOk = bilinearCompare(reference, result, expectedMask, RGBA(3, 3, 3, 3), 1);
+
+		TCU_CHECK(bilinearCompare(reference, result, mask, RGBA(3, 3, 3, 3), 4) == expectedOk);
+		TCU_CHECK(isErrorMaskEqual(mask, expectedMask));
+	}
+}
+
+void selfTestFuzzyCompare (de::Random& rnd, const TextureFormat& format, const IVec2& size)
+{
+	const TextureFormat	maskFormat		(TextureFormat::RGB, TextureFormat::UNORM_INT8);
+	TextureLevel		reference		(format, size.x(), size.y());
+	TextureLevel		result			(format, size.x(), size.y());
+	TextureLevel		expectedMask	(maskFormat, size.x(), size.y());
+	TextureLevel		mask			(maskFormat, size.x(), size.y());
+
+	fillRandomBytes(reference, rnd);
+	perturbBytes(result, reference, rnd);
+
+	for (int maxSampleSkip = 0; maxSampleSkip <= 8; maxSampleSkip += 8)
+	{
+		const float expectedDiff = fuzzyCompare(FuzzyCompareParams(maxSampleSkip, 1), reference, result, expectedMask);
+
+		TCU_CHECK(fuzzyCompare(FuzzyCompareParams(maxSampleSkip, 4), reference, result, mask) == expectedDiff);
+		TCU_CHECK(isErrorMaskEqual(mask, expectedMask));
+	}
+}
+
+} // anonymous
+
+void ImageCompare_selfTest (void)
+{
+	de::Random rnd (0x3ce5a81);
+
+	// \note Sizes are chosen large enough to be split into multiple bands.
+	selfTestIntThresholdCompare(rnd, TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8),		IVec3(303, 229, 1),	UVec4(2u, 3u, 0u, 300u));
+	selfTestIntThresholdCompare(rnd, TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8),		IVec3(61, 47, 23),	UVec4(1u));
+	selfTestIntThresholdCompare(rnd, TextureFormat(TextureFormat::RGB, TextureFormat::UNORM_INT8),		IVec3(303, 229, 1),	UVec4(2u));
+	selfTestIntThresholdCompare(rnd, TextureFormat(TextureFormat::RGBA, TextureFormat::UNSIGNED_INT16),	IVec3(257, 270, 1),	UVec4(3u));
+
+	selfTestFloatThresholdCompare(rnd, TextureFormat(TextureFormat::RGBA, TextureFormat::FLOAT),		IVec3(303, 229, 1),	Vec4(0.005f), false);
+	selfTestFloatThresholdCompare(rnd, TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8),	IVec3(61, 47, 23),	Vec4(0.01f), false);
+	selfTestFloatThresholdCompare(rnd, TextureFormat(TextureFormat::RGBA, TextureFormat::FLOAT),		IVec3(303, 229, 1),	Vec4(0.005f), true);
+
+	selfTestPositionDeviationCompare(rnd, IVec3(303, 229, 1),	IVec3(1, 1, 0), false);
+	selfTestPositionDeviationCompare(rnd, IVec3(303, 229, 1),	IVec3(1, 1, 0), true);
+	selfTestPositionDeviationCompare(rnd, IVec3(61, 47, 23),	IVec3(1, 1, 1), true);
+
+	selfTestBilinearCompare(rnd, IVec2(303, 229));
+
+	selfTestFuzzyCompare(rnd, TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8),	IVec2(303, 229));
+	selfTestFuzzyCompare(rnd, TextureFormat(TextureFormat::RGB, TextureFormat::UNORM_INT8),		IVec2(303, 229));
+}
+
 } // tcu
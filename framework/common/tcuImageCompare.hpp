@@ -58,6 +58,14 @@ bool	intThresholdPositionDeviationErrorThresholdCompare	(TestLog& log, const cha
 int		measurePixelDiffAccuracy							(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, int bestScoreDiff, int worstScoreDiff, CompareLogMode logMode);
 bool	bilinearCompare										(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const RGBA threshold, CompareLogMode logMode);
 
+//! Get number of threads used by image comparison functions.
+int		getImageCompareNumThreads							(void);
+
+//! Set number of threads used by image comparison functions. Value 0 selects number of available cores.
+void	setImageCompareNumThreads							(int numThreads);
+
+void	ImageCompare_selfTest								(void);
+
 } // tcu
 
 #endif // _TCUIMAGECOMPARE_HPP
@@ -0,0 +1,309 @@
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Tester Core
+ * ----------------------------------------
+ *
+ * Copyright 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Row-banded parallel execution of image processing loops.
+ *//*--------------------------------------------------------------------*/
+
+#include "tcuParallelRows.hpp"
+#include "deThread.hpp"
+#include "deSharedPtr.hpp"
+
+#include <vector>
+#include <string>
+#include <new>
+#include <stdexcept>
+
+namespace tcu
+{
+
+namespace
+{
+
+enum
+{
+	MIN_PIXELS_PER_BAND	= 16*1024	//!< Smaller bands don't amortize thread startup.
+};
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Exception caught from a band
+ *
+ * Exceptions can't be carried across threads as such, so type, message
+ * and test result are stored and the exception is rebuilt with the same
+ * type when rethrown. That keeps the reported failure independent of
+ * which band, and thus which thread, failed.
+ *//*--------------------------------------------------------------------*/
+class BandError
+{
+public:
+	enum Type
+	{
+		TYPE_NONE = 0,
+		TYPE_TEST_ERROR,
+		TYPE_INTERNAL_ERROR,
+		TYPE_RESOURCE_ERROR,
+		TYPE_NOT_SUPPORTED_ERROR,
+		TYPE_TEST_EXCEPTION,
+		TYPE_EXCEPTION,
+		TYPE_BAD_ALLOC,
+		TYPE_STD_EXCEPTION,
+
+		TYPE_LAST
+	};
+
+	BandError (void)
+		: m_type	(TYPE_NONE)
+		, m_result	(QP_TEST_RESULT_LAST)
+	{
+	}
+
+	void processRows (RowBandTask& task, int bandNdx, int rowBegin, int rowEnd)
+	{
+		try
+		{
+			task.processRows(bandNdx, rowBegin, rowEnd);
+		}
+		catch (const NotSupportedError& e)	{ set(TYPE_NOT_SUPPORTED_ERROR,	e);	}
+		catch (const ResourceError& e)		{ set(TYPE_RESOURCE_ERROR,		e);	}
+		catch (const InternalError& e)		{ set(TYPE_INTERNAL_ERROR,		e);	}
+		catch (const TestError& e)			{ set(TYPE_TEST_ERROR,			e);	}
+		catch (const TestException& e)		{ set(TYPE_TEST_EXCEPTION,		e);	}
+		catch (const Exception& e)			{ set(TYPE_EXCEPTION,			e);	}
+		catch (const std::bad_alloc& e)		{ set(TYPE_BAD_ALLOC,			e);	}
+		catch (const std::exception& e)		{ set(TYPE_STD_EXCEPTION,		e);	}
+	}
+
+	bool isFailed (void) const { return m_type != TYPE_NONE; }
+
+	void rethrow (void) const
+	{
+		switch (m_type)
+		{
+			case TYPE_NONE:					return;
+			case TYPE_TEST_ERROR:			throw TestError(m_message);
+			case TYPE_INTERNAL_ERROR:		throw InternalError(m_message);
+			case TYPE_RESOURCE_ERROR:		throw ResourceError(m_message);
+			case TYPE_NOT_SUPPORTED_ERROR:	throw NotSupportedError(m_message);
+			case TYPE_TEST_EXCEPTION:		throw TestException(m_message, m_result);
+			case TYPE_EXCEPTION:			throw Exception(m_message);
+			case TYPE_BAD_ALLOC:			throw std::bad_alloc();
+			case TYPE_STD_EXCEPTION:		throw std::runtime_error(m_message);
+			default:
+				DE_ASSERT(false);
+		}
+	}
+
+private:
+	void set (Type type, const std::exception& e)
+	{
+		const TestException* const testException = dynamic_cast<const TestException*>(&e);
+
+		m_type		= type;
+		m_message	= e.what();
+		m_result	= testException ? testException->getTestResult() : QP_TEST_RESULT_LAST;
+	}
+
+	Type			m_type;
+	std::string		m_message;
+	qpTestResult	m_result;
+};
+
+class RowBandThread : public de::Thread
+{
+public:
+	RowBandThread (RowBandTask& task, int bandNdx, int rowBegin, int rowEnd)
+		: m_task		(task)
+		, m_bandNdx		(bandNdx)
+		, m_rowBegin	(rowBegin)
+		, m_rowEnd		(rowEnd)
+	{
+	}
+
+	void run (void)
+	{
+		m_error.processRows(m_task, m_bandNdx, m_rowBegin, m_rowEnd);
+	}
+
+	const BandError&	getError	(void) const { return m_error; }
+
+private:
+	RowBandTask&		m_task;
+	const int			m_bandNdx;
+	const int			m_rowBegin;
+	const int			m_rowEnd;
+	BandError			m_error;
+};
+
+} // anonymous
+
+int getNumRowBands (int numRows, int rowLength, int maxThreads)
+{
+	const deInt64	numPixels	= (deInt64)numRows * (deInt64)rowLength;
+	const deInt64	maxBands	= de::max<deInt64>(numPixels / MIN_PIXELS_PER_BAND, 1);
+
+	return (int)de::min<deInt64>(de::min<deInt64>(maxBands, (deInt64)de::max(maxThreads, 1)), (deInt64)de::max(numRows, 1));
+}
+
+int getRowBandBegin (int numRows, int numBands, int bandNdx)
+{
+	DE_ASSERT(de::inRange(bandNdx, 0, numBands));
+	return (int)((deInt64)numRows * bandNdx / numBands);
+}
+
+void executeRowBands (RowBandTask& task, int numRows, int numBands)
+{
+	typedef de::SharedPtr<RowBandThread> ThreadSp;
+
+	DE_ASSERT(numBands >= 1);
+
+	if (numBands == 1)
+	{
+		task.processRows(0, 0, numRows);
+		return;
+	}
+
+	std::vector<ThreadSp>	threads;
+	BandError				firstBandError;
+
+	try
+	{
+		for (int bandNdx = 1; bandNdx < numBands; bandNdx++)
+		{
+			threads.push_back(ThreadSp(new RowBandThread(task, bandNdx, getRowBandBegin(numRows, numBands, bandNdx), getRowBandBegin(numRows, numBands, bandNdx+1))));
+			threads.back()->start();
+		}
+	}
+	catch (...)
+	{
+		// \note Already started threads reference task, so they must be joined before failure is propagated.
+		for (size_t threadNdx = 0; threadNdx < threads.size(); threadNdx++)
+		{
+			if (threads[threadNdx]->isStarted())
+				threads[threadNdx]->join();
+		}
+
+		throw;
+	}
+
+	// \note Threads reference task, so they must be joined even if band 0 fails.
+	firstBandError.processRows(task, 0, 0, getRowBandBegin(numRows, numBands, 1));
+
+	for (size_t threadNdx = 0; threadNdx < threads.size(); threadNdx++)
+		threads[threadNdx]->join();
+
+	// Report failure of first failed band in band order.
+	firstBandError.rethrow();
+
+	for (size_t threadNdx = 0; threadNdx < threads.size(); threadNdx++)
+		threads[threadNdx]->getError().rethrow();
+}
+
+namespace
+{
+
+class ThrowingRowBandTask : public RowBandTask
+{
+public:
+	ThrowingRowBandTask (int failRow, BandError::Type type)
+		: m_failRow	(failRow)
+		, m_type	(type)
+	{
+	}
+
+	void processRows (int bandNdx, int rowBegin, int rowEnd)
+	{
+		DE_UNREF(bandNdx);
+
+		if (!de::inBounds(m_failRow, rowBegin, rowEnd))
+			return;
+
+		switch (m_type)
+		{
+			case BandError::TYPE_TEST_ERROR:			throw TestError("Row failed");
+			case BandError::TYPE_INTERNAL_ERROR:		throw InternalError("Row failed");
+			case BandError::TYPE_RESOURCE_ERROR:		throw ResourceError("Row failed");
+			case BandError::TYPE_NOT_SUPPORTED_ERROR:	throw NotSupportedError("Row failed");
+			case BandError::TYPE_TEST_EXCEPTION:		throw TestException("Row failed", QP_TEST_RESULT_COMPATIBILITY_WARNING);
+			case BandError::TYPE_BAD_ALLOC:				throw std::bad_alloc();
+			default:
+				DE_ASSERT(false);
+		}
+	}
+
+private:
+	const int				m_failRow;
+	const BandError::Type	m_type;
+};
+
+template<typename ExceptionType>
+bool throwsType (ThrowingRowBandTask task, int numRows, int numBands)
+{
+	try
+	{
+		executeRowBands(task, numRows, numBands);
+	}
+	catch (const ExceptionType&)
+	{
+		return true;
+	}
+	catch (...)
+	{
+		return false;
+	}
+
+	return false;
+}
+
+void selfTestExceptionType (int numRows, int numBands, int failRow)
+{
+	TCU_CHECK(throwsType<TestError>			(ThrowingRowBandTask(failRow, BandError::TYPE_TEST_ERROR),			numRows, numBands));
+	TCU_CHECK(throwsType<ResourceError>		(ThrowingRowBandTask(failRow, BandError::TYPE_RESOURCE_ERROR),		numRows, numBands));
+	TCU_CHECK(throwsType<NotSupportedError>	(ThrowingRowBandTask(failRow, BandError::TYPE_NOT_SUPPORTED_ERROR),	numRows, numBands));
+	TCU_CHECK(throwsType<std::bad_alloc>	(ThrowingRowBandTask(failRow, BandError::TYPE_BAD_ALLOC),			numRows, numBands));
+	TCU_CHECK(!throwsType<ResourceError>	(ThrowingRowBandTask(failRow, BandError::TYPE_INTERNAL_ERROR),		numRows, numBands));
+	TCU_CHECK(throwsType<InternalError>		(ThrowingRowBandTask(failRow, BandError::TYPE_INTERNAL_ERROR),		numRows, numBands));
+
+	try
+	{
+		ThrowingRowBandTask task (failRow, BandError::TYPE_TEST_EXCEPTION);
+		executeRowBands(task, numRows, numBands);
+		TCU_FAIL("Expected exception");
+	}
+	catch (const TestException& e)
+	{
+		TCU_CHECK(e.getTestResult() == QP_TEST_RESULT_COMPATIBILITY_WARNING);
+	}
+}
+
+} // anonymous
+
+void ParallelRows_selfTest (void)
+{
+	const int numRows = 64;
+
+	for (int numBands = 1; numBands <= 4; numBands++)
+	{
+		// Fail in first, middle and last band.
+		selfTestExceptionType(numRows, numBands, 0);
+		selfTestExceptionType(numRows, numBands, numRows/2);
+		selfTestExceptionType(numRows, numBands, numRows-1);
+	}
+}
+
+} // tcu
@@ -0,0 +1,59 @@
+#ifndef _TCUPARALLELROWS_HPP
+#define _TCUPARALLELROWS_HPP
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Tester Core
+ * ----------------------------------------
+ *
+ * Copyright 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Row-banded parallel execution of image processing loops.
+ *//*--------------------------------------------------------------------*/
+
+#include "tcuDefs.hpp"
+
+namespace tcu
+{
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Task processing a contiguous range of image rows
+ *
+ * processRows() is called once per band, possibly from several threads
+ * concurrently. Bands cover [0, numRows) in order, so results accumulated
+ * per bandNdx can be combined deterministically after execution.
+ *//*--------------------------------------------------------------------*/
+class RowBandTask
+{
+public:
+	virtual			~RowBandTask	(void) {}
+	virtual void	processRows		(int bandNdx, int rowBegin, int rowEnd) = 0;
+};
+
+//! Get number of bands worth using for numRows rows of rowLength pixels with at most maxThreads threads.
+int		getNumRowBands		(int numRows, int rowLength, int maxThreads);
+
+//! Get first row of band bandNdx when numRows rows are split into numBands bands.
+int		getRowBandBegin		(int numRows, int numBands, int bandNdx);
+
+//! Execute task over numRows rows split into numBands bands. Each band runs on its own thread; band 0 runs on the calling thread.
+//! If bands throw, exception of the first failed band is rethrown with its type preserved.
+void	executeRowBands		(RowBandTask& task, int numRows, int numBands);
+
+void	ParallelRows_selfTest	(void);
+
+} // tcu
+
+#endif // _TCUPARALLELROWS_HPP
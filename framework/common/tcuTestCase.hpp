@@ -174,6 +174,9 @@ public:
 					TestCase			(TestContext& testCtx, const char* name, const char* description);
 					TestCase			(TestContext& testCtx, TestNodeType nodeType, const char* name, const char* description);
 	virtual			~TestCase			(void);
+
+	//! Does case avoid all shared state (rendering contexts, package resources)? Context-free cases may be run concurrently.
+	virtual bool	isContextFree		(void) const { return false; }
 };
 
 class TestStatus
@@ -25,6 +25,8 @@
 
 #include "tcuTestLog.hpp"
 
+#include "deAtomic.h"
+
 namespace tcu
 {
 
@@ -34,28 +36,35 @@ TestContext::TestContext (
 	TestLog&			log,
 	const CommandLine&	cmdLine,
 	qpWatchDog*			watchDog)
-	: m_platform		(platform)
-	, m_rootArchive		(rootArchive)
-	, m_log				(log)
-	, m_cmdLine			(cmdLine)
-	, m_watchDog		(watchDog)
-	, m_curArchive		(DE_NULL)
-	, m_testResult		(QP_TEST_RESULT_LAST)
-	, m_terminateAfter	(false)
+	: m_platform			(platform)
+	, m_rootArchive			(rootArchive)
+	, m_log					(log)
+	, m_cmdLine				(cmdLine)
+	, m_watchDog			(watchDog)
+	, m_curArchive			(DE_NULL)
+	, m_testResult			(QP_TEST_RESULT_LAST)
+	, m_terminateAfter		(false)
+	, m_numWatchdogTouches	(0)
 {
 	setCurrentArchive(m_rootArchive);
 }
 
 void TestContext::touchWatchdog (void)
 {
-	if (m_watchDog)
-		qpWatchDog_touch(m_watchDog);
+	TestContext& ctx = getThreadContext();
+
+	deAtomicIncrementUint32(&ctx.m_numWatchdogTouches);
+
+	if (ctx.m_watchDog)
+		qpWatchDog_touch(ctx.m_watchDog);
 }
 
 void TestContext::setTestResult (qpTestResult testResult, const char* description)
 {
-	m_testResult		= testResult;
-	m_testResultDesc	= description;
+	TestContext& ctx = getThreadContext();
+
+	ctx.m_testResult		= testResult;
+	ctx.m_testResultDesc	= description;
 }
 
 } // tcu
@@ -26,6 +26,7 @@
 #include "tcuDefs.hpp"
 #include "qpWatchDog.h"
 #include "qpTestLog.h"
+#include "deThreadLocal.hpp"
 
 #include <string>
 
@@ -44,6 +45,12 @@ class TestLog;
  * This includes test log and resource archive.
  *
  * Test case can write to test log and must set test result to test context.
+ *
+ * Test framework may redirect log and result of calls made from a given
+ * thread to another context with setThreadContext(). This allows running
+ * several test cases concurrently. Watchdog touches are redirected as well;
+ * the framework polls them with getNumWatchdogTouches() so that worker
+ * threads never access the watchdog directly.
  *//*--------------------------------------------------------------------*/
 class TestContext
 {
@@ -52,7 +59,7 @@ public:
 							~TestContext		(void) {}
 
 	// API for test cases
-	TestLog&				getLog				(void)			{ return m_log;			}
+	TestLog&				getLog				(void)			{ return getThreadContext().m_log;	}
 	Archive&				getArchive			(void)			{ return *m_curArchive;	} //!< \note Do not access in TestNode constructors.
 	Platform&				getPlatform			(void)			{ return m_platform;	}
 	void					setTestResult		(qpTestResult result, const char* description);
@@ -60,20 +67,27 @@ public:
 	const CommandLine&		getCommandLine		(void) const	{ return m_cmdLine;		}
 
 	// API for test framework
-	qpTestResult			getTestResult		(void) const	{ return m_testResult;				}
-	const char*				getTestResultDesc	(void) const	{ return m_testResultDesc.c_str();	}
+	qpTestResult			getTestResult		(void) const	{ return getThreadContext().m_testResult;				}
+	const char*				getTestResultDesc	(void) const	{ return getThreadContext().m_testResultDesc.c_str();	}
 	qpWatchDog*				getWatchDog			(void)			{ return m_watchDog;				}
+	void					setWatchDog			(qpWatchDog* watchDog)	{ m_watchDog = watchDog;	}
+	deUint32				getNumWatchdogTouches	(void) const	{ return m_numWatchdogTouches;	} //!< Number of touchWatchdog() calls redirected to this context. Safe to call from any thread.
 
 	Archive&				getRootArchive		(void) const		{ return m_rootArchive;		}
 	void					setCurrentArchive	(Archive& archive)	{ m_curArchive = &archive;	}
 
-	void					setTerminateAfter	(bool terminate)	{ m_terminateAfter = terminate;	}
-	bool					getTerminateAfter	(void) const		{ return m_terminateAfter;		}
+	void					setTerminateAfter	(bool terminate)	{ getThreadContext().m_terminateAfter = terminate;	}
+	bool					getTerminateAfter	(void) const		{ return getThreadContext().m_terminateAfter;		}
+
+	void					setThreadContext	(TestContext* context)	{ m_threadContext.set(context);	} //!< Redirect log, result and watchdog touches of calls from current thread to context, or back to this context with DE_NULL.
 
 protected:
 							TestContext			(const TestContext&);
 	TestContext&			operator=			(const TestContext&);
 
+	TestContext&			getThreadContext	(void)			{ TestContext* const ctx = static_cast<TestContext*>(m_threadContext.get()); return ctx ? *ctx : *this;	}
+	const TestContext&		getThreadContext	(void) const	{ TestContext* const ctx = static_cast<TestContext*>(m_threadContext.get()); return ctx ? *ctx : *this;	}
+
 	Platform&				m_platform;			//!< Platform port implementation.
 	Archive&				m_rootArchive;		//!< Root archive.
 	TestLog&				m_log;				//!< Test log.
@@ -84,6 +98,9 @@ protected:
 	qpTestResult			m_testResult;		//!< Latest test result.
 	std::string				m_testResultDesc;	//!< Latest test result description.
 	bool					m_terminateAfter;	//!< Should tester terminate after execution of the current test
+	volatile deUint32		m_numWatchdogTouches;	//!< Number of touchWatchdog() calls, updated atomically.
+
+	de::ThreadLocal			m_threadContext;	//!< Per-thread redirection target, see setThreadContext().
 };
 
 } // tcu
@@ -0,0 +1,493 @@
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Tester Core
+ * ----------------------------------------
+ *
+ * Copyright 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Precomputed test hierarchy index.
+ *//*--------------------------------------------------------------------*/
+
+#include "tcuTestHierarchyIndex.hpp"
+#include "tcuCommandLine.hpp"
+
+#include "qpInfo.h"
+#include "deClock.h"
+#include "deFile.h"
+#include "deStringUtil.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+#if (DE_OS == DE_OS_UNIX) || (DE_OS == DE_OS_ANDROID)
+#	include <sys/stat.h>
+#endif
+
+namespace tcu
+{
+
+using std::string;
+using std::vector;
+
+namespace
+{
+
+enum
+{
+	INDEX_MAGIC		= 0x58444968,	//!< "hIDX"
+	INDEX_VERSION	= 2
+};
+
+void writeU32 (vector<deUint8>& dst, deUint32 value)
+{
+	dst.push_back((deUint8)(value & 0xffu));
+	dst.push_back((deUint8)((value >> 8) & 0xffu));
+	dst.push_back((deUint8)((value >> 16) & 0xffu));
+	dst.push_back((deUint8)((value >> 24) & 0xffu));
+}
+
+void writeString (vector<deUint8>& dst, const string& str)
+{
+	writeU32(dst, (deUint32)str.size());
+	dst.insert(dst.end(), str.begin(), str.end());
+}
+
+class IndexReader
+{
+public:
+	IndexReader (const vector<deUint8>& data)
+		: m_data	(data)
+		, m_pos		(0)
+		, m_ok		(true)
+	{
+	}
+
+	deUint8 readU8 (void)
+	{
+		if (!require(1))
+			return 0;
+
+		return m_data[m_pos++];
+	}
+
+	deUint32 readU32 (void)
+	{
+		if (!require(4))
+			return 0;
+
+		const deUint32 value = (deUint32)m_data[m_pos]
+							 | ((deUint32)m_data[m_pos+1] << 8)
+							 | ((deUint32)m_data[m_pos+2] << 16)
+							 | ((deUint32)m_data[m_pos+3] << 24);
+		m_pos += 4;
+		return value;
+	}
+
+	void readString (string& dst)
+	{
+		const deUint32 length = readU32();
+
+		if (!require(length))
+			return;
+
+		dst.assign((const char*)&m_data[0] + m_pos, (size_t)length);
+		m_pos += length;
+	}
+
+	bool isOk		(void) const { return m_ok;								}
+	bool isAtEnd	(void) const { return m_ok && m_pos == m_data.size();	}
+
+private:
+	bool require (size_t numBytes)
+	{
+		if (m_ok && m_data.size() - m_pos < numBytes)
+			m_ok = false;
+
+		return m_ok;
+	}
+
+	const vector<deUint8>&	m_data;
+	size_t					m_pos;
+	bool					m_ok;
+};
+
+//! Identify the running executable by its size and modification time, or return empty string if not possible.
+string getExecutableStamp (void)
+{
+#if (DE_OS == DE_OS_UNIX) || (DE_OS == DE_OS_ANDROID)
+	struct stat st;
+
+	if (stat("/proc/self/exe", &st) == 0)
+		return de::toString((deInt64)st.st_size) + ":" + de::toString((deInt64)st.st_mtime);
+#endif
+
+	return string();
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Get fingerprint of the registered test hierarchy
+ *
+ * Fingerprint consists of package names and executable stamp, which can be
+ * computed without initializing any packages. Cases added to or removed
+ * from the executable change the stamp when it is rebuilt.
+ *//*--------------------------------------------------------------------*/
+string getHierarchyFingerprint (TestPackageRoot& root)
+{
+	vector<TestNode*>	packages;
+	string				fingerprint;
+
+	root.getChildren(packages);
+
+	for (vector<TestNode*>::const_iterator package = packages.begin(); package != packages.end(); ++package)
+		fingerprint += string((*package)->getName()) + ",";
+
+	return fingerprint + getExecutableStamp();
+}
+
+bool isValidHierarchy (const vector<TestHierarchyIndex::Node>& nodes)
+{
+	const int	numNodes	= (int)nodes.size();
+	vector<int>	openEnds;
+
+	if (numNodes == 0 || nodes[0].nodeType != NODETYPE_ROOT || nodes[0].subtreeEnd != numNodes)
+		return false;
+
+	openEnds.push_back(numNodes);
+
+	for (int nodeNdx = 1; nodeNdx < numNodes; nodeNdx++)
+	{
+		const TestHierarchyIndex::Node& node = nodes[nodeNdx];
+
+		while (openEnds.back() == nodeNdx)
+			openEnds.pop_back();
+
+		if (node.nodeType == NODETYPE_ROOT || (node.nodeType == NODETYPE_PACKAGE) != (openEnds.size() == 1))
+			return false;
+
+		if (node.subtreeEnd <= nodeNdx || node.subtreeEnd > openEnds.back())
+			return false;
+
+		if (isTestNodeTypeExecutable(node.nodeType) && node.subtreeEnd != nodeNdx+1)
+			return false;
+
+		openEnds.push_back(node.subtreeEnd);
+	}
+
+	return true;
+}
+
+} // anonymous
+
+// TestHierarchyIndex
+
+TestHierarchyIndex::TestHierarchyIndex (void)
+{
+}
+
+TestHierarchyIndex::~TestHierarchyIndex (void)
+{
+}
+
+de::MovePtr<TestHierarchyIndex> TestHierarchyIndex::build (TestPackageRoot& root, TestContext& testCtx)
+{
+	DefaultHierarchyInflater		inflater	(testCtx);
+	const CaseListFilter			allCases;
+	TestHierarchyIterator			iter		(root, inflater, allCases);
+	de::MovePtr<TestHierarchyIndex>	index		(new TestHierarchyIndex());
+	vector<int>						openNodes;
+
+	index->m_fingerprint = getHierarchyFingerprint(root);
+	index->m_nodes.push_back(Node());
+	openNodes.push_back(0);
+
+	while (iter.getState() != TestHierarchyIterator::STATE_FINISHED)
+	{
+		if (iter.getState() == TestHierarchyIterator::STATE_ENTER_NODE)
+		{
+			const TestNode* const	testNode	= iter.getNode();
+			Node					node;
+
+			node.name			= testNode->getName();
+			node.description	= testNode->getDescription();
+			node.nodeType		= testNode->getNodeType();
+
+			openNodes.push_back((int)index->m_nodes.size());
+			index->m_nodes.push_back(node);
+		}
+		else
+		{
+			index->m_nodes[openNodes.back()].subtreeEnd = (int)index->m_nodes.size();
+			openNodes.pop_back();
+		}
+
+		iter.next();
+	}
+
+	DE_ASSERT(openNodes.size() == 1);
+	index->m_nodes[0].subtreeEnd = (int)index->m_nodes.size();
+
+	return index;
+}
+
+void TestHierarchyIndex::save (const char* filename) const
+{
+	vector<deUint8> data;
+
+	writeU32(data, INDEX_MAGIC);
+	writeU32(data, INDEX_VERSION);
+	writeU32(data, qpGetReleaseId());
+	writeString(data, qpGetReleaseName());
+	writeString(data, m_fingerprint);
+	writeU32(data, (deUint32)m_nodes.size());
+
+	for (vector<Node>::const_iterator node = m_nodes.begin(); node != m_nodes.end(); ++node)
+	{
+		data.push_back((deUint8)node->nodeType);
+		writeU32(data, (deUint32)node->subtreeEnd);
+		writeString(data, node->name);
+		writeString(data, node->description);
+	}
+
+	// \note Index is written to a temporary file and renamed in place, so an interrupted
+	//		 or concurrent run never leaves a truncated index behind.
+	const string tmpPath = string(filename) + "." + de::toString(deGetMicroseconds()) + ".tmp";
+
+	{
+		std::ofstream out(tmpPath.c_str(), std::ios_base::binary);
+
+		if (!out.is_open() || !out.good())
+			throw Exception(string("Failed to open ") + tmpPath);
+
+		out.write((const char*)&data[0], (std::streamsize)data.size());
+
+		if (!out.good())
+		{
+			out.close();
+			deDeleteFile(tmpPath.c_str());
+			throw Exception(string("Failed to write ") + tmpPath);
+		}
+	}
+
+	// \note Rename fails on some platforms if the destination exists.
+	if (std::rename(tmpPath.c_str(), filename) != 0)
+	{
+		deDeleteFile(filename);
+
+		if (std::rename(tmpPath.c_str(), filename) != 0)
+		{
+			deDeleteFile(tmpPath.c_str());
+			throw Exception(string("Failed to write ") + filename);
+		}
+	}
+}
+
+de::MovePtr<TestHierarchyIndex> TestHierarchyIndex::load (const char* filename, TestPackageRoot& root)
+{
+	vector<deUint8> data;
+
+	{
+		std::ifstream in(filename, std::ios_base::binary);
+
+		if (!in.is_open() || !in.good())
+			return de::MovePtr<TestHierarchyIndex>();
+
+		in.seekg(0, std::ios_base::end);
+		data.resize((size_t)in.tellg());
+		in.seekg(0, std::ios_base::beg);
+
+		if (!data.empty())
+			in.read((char*)&data[0], (std::streamsize)data.size());
+
+		if (!in.good())
+			return de::MovePtr<TestHierarchyIndex>();
+	}
+
+	{
+		IndexReader						reader		(data);
+		de::MovePtr<TestHierarchyIndex>	index		(new TestHierarchyIndex());
+		string							releaseName;
+
+		if (reader.readU32() != INDEX_MAGIC || reader.readU32() != INDEX_VERSION || reader.readU32() != qpGetReleaseId())
+			return de::MovePtr<TestHierarchyIndex>();
+
+		reader.readString(releaseName);
+		reader.readString(index->m_fingerprint);
+
+		// \note Development builds share the same release id and name, so fingerprint is what detects stale indices.
+		if (!reader.isOk() || releaseName != qpGetReleaseName() || index->m_fingerprint != getHierarchyFingerprint(root))
+			return de::MovePtr<TestHierarchyIndex>();
+
+		{
+			const deUint32 numNodes = reader.readU32();
+
+			// Each node takes at least 13 bytes, don't trust the count beyond that.
+			if (!reader.isOk() || (deUint64)numNodes * 13u > (deUint64)data.size())
+				return de::MovePtr<TestHierarchyIndex>();
+
+			index->m_nodes.resize((size_t)numNodes);
+		}
+
+		for (vector<Node>::iterator node = index->m_nodes.begin(); node != index->m_nodes.end() && reader.isOk(); ++node)
+		{
+			const deUint8	nodeType	= reader.readU8();
+			const deUint32	subtreeEnd	= reader.readU32();
+
+			if (nodeType > NODETYPE_ACCURACY || subtreeEnd > index->m_nodes.size())
+				return de::MovePtr<TestHierarchyIndex>();
+
+			node->nodeType		= (TestNodeType)nodeType;
+			node->subtreeEnd	= (int)subtreeEnd;
+			reader.readString(node->name);
+			reader.readString(node->description);
+		}
+
+		if (!reader.isAtEnd() || !isValidHierarchy(index->m_nodes))
+			return de::MovePtr<TestHierarchyIndex>();
+
+		return index;
+	}
+}
+
+// IndexedHierarchyIterator
+
+IndexedHierarchyIterator::IndexedHierarchyIterator (const TestHierarchyIndex& index, const CaseListFilter& caseListFilter)
+	: m_index			(index)
+	, m_caseListFilter	(caseListFilter)
+{
+	// Root is never reported
+	m_sessionStack.push_back(NodeIter(0, NodeIter::STATE_ENTER));
+	next();
+}
+
+IndexedHierarchyIterator::~IndexedHierarchyIterator (void)
+{
+}
+
+TestHierarchyIterator::State IndexedHierarchyIterator::getState (void) const
+{
+	if (!m_sessionStack.empty())
+	{
+		const NodeIter& iter = m_sessionStack.back();
+
+		DE_ASSERT(iter.state == NodeIter::STATE_ENTER ||
+				  iter.state == NodeIter::STATE_LEAVE);
+
+		return iter.state == NodeIter::STATE_ENTER ? TestHierarchyIterator::STATE_ENTER_NODE : TestHierarchyIterator::STATE_LEAVE_NODE;
+	}
+	else
+		return TestHierarchyIterator::STATE_FINISHED;
+}
+
+const TestHierarchyIndex::Node* IndexedHierarchyIterator::getNode (void) const
+{
+	DE_ASSERT(getState() != TestHierarchyIterator::STATE_FINISHED);
+	return &m_index.getNode(m_sessionStack.back().nodeNdx);
+}
+
+const std::string& IndexedHierarchyIterator::getNodePath (void) const
+{
+	DE_ASSERT(getState() != TestHierarchyIterator::STATE_FINISHED);
+	return m_nodePath;
+}
+
+std::string IndexedHierarchyIterator::buildNodePath (void) const
+{
+	string nodePath;
+	for (size_t ndx = 1; ndx < m_sessionStack.size(); ndx++)
+	{
+		if (ndx > 1) // ignore root package
+			nodePath += ".";
+		nodePath += m_index.getNode(m_sessionStack[ndx].nodeNdx).name;
+	}
+	return nodePath;
+}
+
+void IndexedHierarchyIterator::next (void)
+{
+	while (!m_sessionStack.empty())
+	{
+		NodeIter&						iter	= m_sessionStack.back();
+		const TestHierarchyIndex::Node&	node	= m_index.getNode(iter.nodeNdx);
+		const bool						isLeaf	= isTestNodeTypeExecutable(node.nodeType);
+
+		switch (iter.state)
+		{
+			case NodeIter::STATE_INIT:
+			{
+				const std::string nodePath = buildNodePath();
+
+				// Return to parent if name doesn't match filter.
+				if (!(isLeaf ? m_caseListFilter.checkTestCaseName(nodePath.c_str()) : m_caseListFilter.checkTestGroupName(nodePath.c_str())))
+				{
+					m_sessionStack.pop_back();
+					break;
+				}
+
+				m_nodePath = nodePath;
+				iter.state = NodeIter::STATE_ENTER;
+				return; // Yield enter event
+			}
+
+			case NodeIter::STATE_ENTER:
+			{
+				if (isLeaf)
+				{
+					iter.state = NodeIter::STATE_LEAVE;
+					return; // Yield leave event
+				}
+
+				iter.state			= NodeIter::STATE_TRAVERSE_CHILDREN;
+				iter.nextChildNdx	= iter.nodeNdx + 1;
+				break;
+			}
+
+			case NodeIter::STATE_TRAVERSE_CHILDREN:
+			{
+				if (iter.nextChildNdx < node.subtreeEnd)
+				{
+					const int childNdx = iter.nextChildNdx;
+
+					// \note iter is invalidated by push_back()
+					iter.nextChildNdx = m_index.getNode(childNdx).subtreeEnd;
+					m_sessionStack.push_back(NodeIter(childNdx, NodeIter::STATE_INIT));
+				}
+				else
+				{
+					iter.state = NodeIter::STATE_LEAVE;
+					if (node.nodeType != NODETYPE_ROOT)
+						return; // Yield leave event
+				}
+
+				break;
+			}
+
+			case NodeIter::STATE_LEAVE:
+			{
+				m_sessionStack.pop_back();
+				m_nodePath = buildNodePath();
+				break;
+			}
+
+			default:
+				DE_ASSERT(false);
+				return;
+		}
+	}
+
+	DE_ASSERT(m_sessionStack.empty() && getState() == TestHierarchyIterator::STATE_FINISHED);
+}
+
+} // tcu
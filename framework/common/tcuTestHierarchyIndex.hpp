@@ -0,0 +1,158 @@
+#ifndef _TCUTESTHIERARCHYINDEX_HPP
+#define _TCUTESTHIERARCHYINDEX_HPP
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Tester Core
+ * ----------------------------------------
+ *
+ * Copyright 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Precomputed test hierarchy index.
+ *//*--------------------------------------------------------------------*/
+
+#include "tcuDefs.hpp"
+#include "tcuTestCase.hpp"
+#include "tcuTestHierarchyIterator.hpp"
+#include "deUniquePtr.hpp"
+
+#include <string>
+#include <vector>
+
+namespace tcu
+{
+
+class CaseListFilter;
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Flattened copy of the full test hierarchy
+ *
+ * Index stores names, descriptions and types of all test nodes in depth-
+ * first order. Node 0 is the root and children of each group follow it
+ * directly, ending at subtreeEnd. The index can be saved to a file and
+ * loaded on later runs to answer hierarchy queries without constructing
+ * test case objects.
+ *
+ * Saved index is tagged with the release id and name of the binary, the
+ * names of registered test packages and the size and modification time of
+ * the executable (where available). Index is rejected on load if any of
+ * them differ. Index must be regenerated by hand if the test hierarchy
+ * changes without a change in the executable, e.g. when test data files
+ * defining cases are edited.
+ *//*--------------------------------------------------------------------*/
+class TestHierarchyIndex
+{
+public:
+	struct Node
+	{
+		std::string			name;
+		std::string			description;
+		TestNodeType		nodeType;
+		int					subtreeEnd;		//!< Index of the first node after this node's subtree.
+
+		Node (void)
+			: nodeType		(NODETYPE_ROOT)
+			, subtreeEnd	(0)
+		{
+		}
+
+		const char*			getName			(void) const { return name.c_str();			}
+		const char*			getDescription	(void) const { return description.c_str();	}
+		TestNodeType		getNodeType		(void) const { return nodeType;				}
+	};
+
+											~TestHierarchyIndex	(void);
+
+	int										getNumNodes			(void) const { return (int)m_nodes.size();	}
+	const Node&								getNode				(int ndx) const { return m_nodes[ndx];		}
+
+	//! Write index to file, throws tcu::Exception on failure.
+	void									save				(const char* filename) const;
+
+	//! Inflate the full hierarchy under root and record it.
+	static de::MovePtr<TestHierarchyIndex>	build				(TestPackageRoot& root, TestContext& testCtx);
+
+	//! Load index of root from file. Returns empty pointer if file is missing, corrupt or built for another hierarchy.
+	static de::MovePtr<TestHierarchyIndex>	load				(const char* filename, TestPackageRoot& root);
+
+private:
+											TestHierarchyIndex	(void);
+											TestHierarchyIndex	(const TestHierarchyIndex&);	// not allowed!
+	TestHierarchyIndex&						operator=			(const TestHierarchyIndex&);	// not allowed!
+
+	std::string								m_fingerprint;
+	std::vector<Node>						m_nodes;
+};
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Test hierarchy iterator over a precomputed index
+ *
+ * Reports the same sequence of events as TestHierarchyIterator with the
+ * same filter, but walks a TestHierarchyIndex instead of the actual test
+ * hierarchy and thus never initializes test packages or groups.
+ *//*--------------------------------------------------------------------*/
+class IndexedHierarchyIterator
+{
+public:
+									IndexedHierarchyIterator	(const TestHierarchyIndex& index, const CaseListFilter& caseListFilter);
+									~IndexedHierarchyIterator	(void);
+
+	TestHierarchyIterator::State	getState					(void) const;
+
+	const TestHierarchyIndex::Node*	getNode						(void) const;
+	const std::string&				getNodePath					(void) const;
+
+	void							next						(void);
+
+private:
+	struct NodeIter
+	{
+		enum State
+		{
+			STATE_INIT = 0,
+			STATE_ENTER,
+			STATE_TRAVERSE_CHILDREN,
+			STATE_LEAVE,
+
+			STATE_LAST
+		};
+
+		NodeIter (int nodeNdx_, State state_)
+			: nodeNdx		(nodeNdx_)
+			, nextChildNdx	(-1)
+			, state			(state_)
+		{
+		}
+
+		int							nodeNdx;
+		int							nextChildNdx;
+		State						state;
+	};
+
+									IndexedHierarchyIterator	(const IndexedHierarchyIterator&);	// not allowed!
+	IndexedHierarchyIterator&		operator=					(const IndexedHierarchyIterator&);	// not allowed!
+
+	std::string						buildNodePath				(void) const;
+
+	const TestHierarchyIndex&		m_index;
+	const CaseListFilter&			m_caseListFilter;
+
+	std::vector<NodeIter>			m_sessionStack;
+	std::string						m_nodePath;
+};
+
+} // tcu
+
+#endif // _TCUTESTHIERARCHYINDEX_HPP
@@ -87,9 +87,11 @@ void DefaultHierarchyInflater::leaveGroupNode (TestCaseGroup* testGroup)
 
 TestHierarchyIterator::TestHierarchyIterator (TestPackageRoot&			rootNode,
 											  TestHierarchyInflater&	inflater,
-											  const CaseListFilter&		caseListFilter)
-	: m_inflater		(inflater)
-	, m_caseListFilter	(caseListFilter)
+											  const CaseListFilter&		caseListFilter,
+											  const char*				resumeAfterCasePath)
+	: m_inflater			(inflater)
+	, m_caseListFilter		(caseListFilter)
+	, m_resumeAfterCasePath	(resumeAfterCasePath ? resumeAfterCasePath : "")
 {
 	// Init traverse state and "seek" to first reportable node.
 	NodeIter iter(&rootNode);
@@ -144,6 +146,28 @@ const std::string& TestHierarchyIterator::getNodePath (void) const
 	return m_nodePath;
 }
 
+bool TestHierarchyIterator::isBeforeResumePoint (const std::string& nodePath, bool isLeaf)
+{
+	if (m_resumeAfterCasePath.empty())
+		return false;
+
+	// \note Traversal is depth-first, so any node reached before the resume case that is not its parent comes before it.
+	if (isLeaf && nodePath == m_resumeAfterCasePath)
+	{
+		m_resumeAfterCasePath.clear();
+		return true;
+	}
+
+	{
+		const bool isParentOfResumeCase = !isLeaf &&
+										  m_resumeAfterCasePath.size() > nodePath.size() &&
+										  m_resumeAfterCasePath.compare(0, nodePath.size(), nodePath) == 0 &&
+										  m_resumeAfterCasePath[nodePath.size()] == '.';
+
+		return !isParentOfResumeCase;
+	}
+}
+
 std::string TestHierarchyIterator::buildNodePath (const vector<NodeIter>& nodeStack)
 {
 	string nodePath;
@@ -171,8 +195,9 @@ void TestHierarchyIterator::next (void)
 			{
 				const std::string nodePath = buildNodePath(m_sessionStack);
 
-				// Return to parent if name doesn't match filter.
-				if (!(isLeaf ? m_caseListFilter.checkTestCaseName(nodePath.c_str()) : m_caseListFilter.checkTestGroupName(nodePath.c_str())))
+				// Return to parent if name doesn't match filter or node was already passed in resumed session.
+				if (!(isLeaf ? m_caseListFilter.checkTestCaseName(nodePath.c_str()) : m_caseListFilter.checkTestGroupName(nodePath.c_str())) ||
+					isBeforeResumePoint(nodePath, isLeaf))
 				{
 					m_sessionStack.pop_back();
 					break;
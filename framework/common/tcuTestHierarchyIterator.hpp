@@ -97,6 +97,10 @@ protected:
  * Root node is never reported, but instead iteration will start on first
  * matching test package node, if there is any.
  *
+ * If resumeAfterCasePath is given, iteration resumes after that case.
+ * Nodes before it in hierarchy order are skipped without being reported
+ * or inflated; only its parent groups are entered.
+ *
  * Test hierarchy is created on demand with help of TestHierarchyInflater.
  * Upon entering a group node, after STATE_ENTER_NODE has been signaled,
  * inflater is called to construct the list of child nodes for that group.
@@ -107,7 +111,7 @@ protected:
 class TestHierarchyIterator
 {
 public:
-							TestHierarchyIterator	(TestPackageRoot& rootNode, TestHierarchyInflater& inflater, const CaseListFilter& caseListFilter);
+							TestHierarchyIterator	(TestPackageRoot& rootNode, TestHierarchyInflater& inflater, const CaseListFilter& caseListFilter, const char* resumeAfterCasePath = DE_NULL);
 							~TestHierarchyIterator	(void);
 
 	enum State
@@ -187,10 +191,13 @@ private:
 	bool					matchFolderName			(const std::string& folderName) const;
 	bool					matchCaseName			(const std::string& caseName) const;
 
+	bool					isBeforeResumePoint		(const std::string& nodePath, bool isLeaf);
+
 	static std::string		buildNodePath			(const std::vector<NodeIter>& nodeStack);
 
 	TestHierarchyInflater&	m_inflater;
 	const CaseListFilter&	m_caseListFilter;
+	std::string				m_resumeAfterCasePath;	//!< Empty when not resuming or once the case has been passed.
 
 	// Current session state.
 	std::vector<NodeIter>	m_sessionStack;
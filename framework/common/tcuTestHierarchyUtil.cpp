@@ -59,17 +59,17 @@ static std::string makePackageFilename (const std::string& pattern, const std::s
 	return StringTemplate(pattern).specialize(args);
 }
 
-static void writeXmlCaselist (TestHierarchyIterator& iter, qpXmlWriter* writer)
+template<typename Iterator>
+static void writeXmlCaselist (Iterator& iter, qpXmlWriter* writer)
 {
 	DE_ASSERT(iter.getState() == TestHierarchyIterator::STATE_ENTER_NODE &&
 			  iter.getNode()->getNodeType() == NODETYPE_PACKAGE);
 
 	{
-		const TestNode* node		= iter.getNode();
 		qpXmlAttribute	attribs[2];
 		int				numAttribs	= 0;
-		attribs[numAttribs++] = qpSetStringAttrib("PackageName", node->getName());
-		attribs[numAttribs++] = qpSetStringAttrib("Description", node->getDescription());
+		attribs[numAttribs++] = qpSetStringAttrib("PackageName", iter.getNode()->getName());
+		attribs[numAttribs++] = qpSetStringAttrib("Description", iter.getNode()->getDescription());
 		DE_ASSERT(numAttribs <= DE_LENGTH_OF_ARRAY(attribs));
 
 		if (!qpXmlWriter_startDocument(writer) ||
@@ -81,8 +81,7 @@ static void writeXmlCaselist (TestHierarchyIterator& iter, qpXmlWriter* writer)
 
 	while (iter.getNode()->getNodeType() != NODETYPE_PACKAGE)
 	{
-		const TestNode* const	node		= iter.getNode();
-		const TestNodeType		nodeType	= node->getNodeType();
+		const TestNodeType		nodeType	= iter.getNode()->getNodeType();
 		const bool				isEnter		= iter.getState() == TestHierarchyIterator::STATE_ENTER_NODE;
 
 		DE_ASSERT(iter.getState() == TestHierarchyIterator::STATE_ENTER_NODE ||
@@ -90,8 +89,8 @@ static void writeXmlCaselist (TestHierarchyIterator& iter, qpXmlWriter* writer)
 		{
 			if (isEnter)
 			{
-				const string	caseName	= node->getName();
-				const string	description	= node->getDescription();
+				const string	caseName	= iter.getNode()->getName();
+				const string	description	= iter.getNode()->getDescription();
 				qpXmlAttribute	attribs[3];
 				int				numAttribs = 0;
 
@@ -119,25 +118,16 @@ static void writeXmlCaselist (TestHierarchyIterator& iter, qpXmlWriter* writer)
 		throw Exception("Failed to terminate XML document");
 }
 
-/*--------------------------------------------------------------------*//*!
- * \brief Export the test list of each package into a separate XML file.
- *//*--------------------------------------------------------------------*/
-void writeXmlCaselistsToFiles (TestPackageRoot& root, TestContext& testCtx, const CommandLine& cmdLine)
+template<typename Iterator>
+static void writeXmlCaselists (Iterator& iter, const char* filenamePattern)
 {
-	DefaultHierarchyInflater			inflater		(testCtx);
-	de::MovePtr<const CaseListFilter>	caseListFilter	(testCtx.getCommandLine().createCaseListFilter(testCtx.getArchive()));
-
-	TestHierarchyIterator				iter			(root, inflater, *caseListFilter);
-	const char* const					filenamePattern = cmdLine.getCaseListExportFile();
-
 	while (iter.getState() != TestHierarchyIterator::STATE_FINISHED)
 	{
-		const TestNode* node		= iter.getNode();
-		const char*		pkgName		= node->getName();
+		const char*		pkgName		= iter.getNode()->getName();
 		const string	filename	= makePackageFilename(filenamePattern, pkgName, "xml");
 
 		DE_ASSERT(iter.getState() == TestHierarchyIterator::STATE_ENTER_NODE &&
-				  node->getNodeType() == NODETYPE_PACKAGE);
+				  iter.getNode()->getNodeType() == NODETYPE_PACKAGE);
 
 		FILE*			file	= DE_NULL;
 		qpXmlWriter*	writer	= DE_NULL;
@@ -177,25 +167,16 @@ void writeXmlCaselistsToFiles (TestPackageRoot& root, TestContext& testCtx, cons
 	}
 }
 
-/*--------------------------------------------------------------------*//*!
- * \brief Export the test list of each package into a separate ascii file.
- *//*--------------------------------------------------------------------*/
-void writeTxtCaselistsToFiles (TestPackageRoot& root, TestContext& testCtx, const CommandLine& cmdLine)
+template<typename Iterator>
+static void writeTxtCaselists (Iterator& iter, const char* filenamePattern)
 {
-	DefaultHierarchyInflater			inflater		(testCtx);
-	de::MovePtr<const CaseListFilter>	caseListFilter	(testCtx.getCommandLine().createCaseListFilter(testCtx.getArchive()));
-
-	TestHierarchyIterator				iter			(root, inflater, *caseListFilter);
-	const char* const					filenamePattern = cmdLine.getCaseListExportFile();
-
 	while (iter.getState() != TestHierarchyIterator::STATE_FINISHED)
 	{
-		const TestNode* node		= iter.getNode();
-		const char*		pkgName		= node->getName();
+		const char*		pkgName		= iter.getNode()->getName();
 		const string	filename	= makePackageFilename(filenamePattern, pkgName, "txt");
 
 		DE_ASSERT(iter.getState() == TestHierarchyIterator::STATE_ENTER_NODE &&
-				  node->getNodeType() == NODETYPE_PACKAGE);
+				  iter.getNode()->getNodeType() == NODETYPE_PACKAGE);
 
 		std::ofstream out(filename.c_str(), std::ios_base::binary);
 		if (!out.is_open() || !out.good())
@@ -218,4 +199,44 @@ void writeTxtCaselistsToFiles (TestPackageRoot& root, TestContext& testCtx, cons
 	}
 }
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Export the test list of each package into a separate XML file.
+ *//*--------------------------------------------------------------------*/
+void writeXmlCaselistsToFiles (TestPackageRoot& root, TestContext& testCtx, const CommandLine& cmdLine)
+{
+	DefaultHierarchyInflater			inflater		(testCtx);
+	de::MovePtr<const CaseListFilter>	caseListFilter	(testCtx.getCommandLine().createCaseListFilter(testCtx.getArchive()));
+	TestHierarchyIterator				iter			(root, inflater, *caseListFilter);
+
+	writeXmlCaselists(iter, cmdLine.getCaseListExportFile());
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Export the test list of each package into a separate ascii file.
+ *//*--------------------------------------------------------------------*/
+void writeTxtCaselistsToFiles (TestPackageRoot& root, TestContext& testCtx, const CommandLine& cmdLine)
+{
+	DefaultHierarchyInflater			inflater		(testCtx);
+	de::MovePtr<const CaseListFilter>	caseListFilter	(testCtx.getCommandLine().createCaseListFilter(testCtx.getArchive()));
+	TestHierarchyIterator				iter			(root, inflater, *caseListFilter);
+
+	writeTxtCaselists(iter, cmdLine.getCaseListExportFile());
+}
+
+void writeXmlCaselistsToFiles (const TestHierarchyIndex& index, TestContext& testCtx, const CommandLine& cmdLine)
+{
+	de::MovePtr<const CaseListFilter>	caseListFilter	(testCtx.getCommandLine().createCaseListFilter(testCtx.getArchive(), &index));
+	IndexedHierarchyIterator			iter			(index, *caseListFilter);
+
+	writeXmlCaselists(iter, cmdLine.getCaseListExportFile());
+}
+
+void writeTxtCaselistsToFiles (const TestHierarchyIndex& index, TestContext& testCtx, const CommandLine& cmdLine)
+{
+	de::MovePtr<const CaseListFilter>	caseListFilter	(testCtx.getCommandLine().createCaseListFilter(testCtx.getArchive(), &index));
+	IndexedHierarchyIterator			iter			(index, *caseListFilter);
+
+	writeTxtCaselists(iter, cmdLine.getCaseListExportFile());
+}
+
 } // tcu
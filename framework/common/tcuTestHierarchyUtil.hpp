@@ -25,6 +25,7 @@
 
 #include "tcuDefs.hpp"
 #include "tcuTestHierarchyIterator.hpp"
+#include "tcuTestHierarchyIndex.hpp"
 
 namespace tcu
 {
@@ -33,6 +34,10 @@ namespace tcu
 void writeXmlCaselistsToFiles (TestPackageRoot& root, TestContext& testCtx, const CommandLine& cmdLine);
 void writeTxtCaselistsToFiles (TestPackageRoot& root, TestContext& testCtx, const CommandLine& cmdLine);
 
+// Variants reading the hierarchy from an index, no test nodes are initialized.
+void writeXmlCaselistsToFiles (const TestHierarchyIndex& index, TestContext& testCtx, const CommandLine& cmdLine);
+void writeTxtCaselistsToFiles (const TestHierarchyIndex& index, TestContext& testCtx, const CommandLine& cmdLine);
+
 } // tcu
 
 #endif // _TCUTESTHIERARCHYUTIL_HPP
@@ -187,6 +187,13 @@ TestLog::TestLog (const char* fileName, deUint32 flags)
 		throw ResourceError(std::string("Failed to open test log file '") + fileName + "'");
 }
 
+TestLog::TestLog (const BufferToken&, deUint32 flags)
+	: m_log(qpTestLog_createBufferLog(flags))
+{
+	if (!m_log)
+		throw ResourceError("Failed to create test log buffer");
+}
+
 TestLog::~TestLog (void)
 {
 	qpTestLog_destroy(m_log);
@@ -271,15 +278,33 @@ void TestLog::writeImage (const char* name, const char* description, const Const
 
 		longDesc << description << " (p' = p * " << pixelScale << " + " << pixelBias << ")";
 
-		for (int y = 0; y < logImage.getHeight(); y++)
+		if (width > 0 && logImageSize == IVec2(width, height) && !tcu::isSRGB(format))
 		{
-			for (int x = 0; x < logImage.getWidth(); x++)
+			// No scaling required, convert full rows.
+			std::vector<Vec4> row (width);
+
+			for (int y = 0; y < height; y++)
 			{
-				float	yf	= ((float)y + 0.5f) / (float)logImage.getHeight();
-				float	xf	= ((float)x + 0.5f) / (float)logImage.getWidth();
-				Vec4	s	= access.sample2D(sampler, sampler.minFilter, xf, yf, 0)*pixelScale + pixelBias;
+				access.getPixels(&row[0], width, 0, y);
+
+				for (int x = 0; x < width; x++)
+					row[x] = row[x]*pixelScale + pixelBias;
 
-				logImageAccess.setPixel(s, x, y);
+				logImageAccess.setPixels(&row[0], width, 0, y);
+			}
+		}
+		else
+		{
+			for (int y = 0; y < logImage.getHeight(); y++)
+			{
+				for (int x = 0; x < logImage.getWidth(); x++)
+				{
+					float	yf	= ((float)y + 0.5f) / (float)logImage.getHeight();
+					float	xf	= ((float)x + 0.5f) / (float)logImage.getWidth();
+					Vec4	s	= access.sample2D(sampler, sampler.minFilter, xf, yf, 0)*pixelScale + pixelBias;
+
+					logImageAccess.setPixel(s, x, y);
+				}
 			}
 		}
 
@@ -513,6 +538,20 @@ void TestLog::endSampleList (void)
 		throw LogWriteFailedError();
 }
 
+void TestLog::readBuffer (std::vector<deUint8>& dst)
+{
+	dst.resize(qpTestLog_getBufferSize(m_log));
+
+	if (qpTestLog_readBuffer(m_log, dst.empty() ? DE_NULL : &dst[0], dst.size()) == DE_FALSE)
+		throw LogWriteFailedError();
+}
+
+void TestLog::writeBufferData (const std::vector<deUint8>& data)
+{
+	if (qpTestLog_writeBufferData(m_log, data.empty() ? DE_NULL : &data[0], data.size()) == DE_FALSE)
+		throw LogWriteFailedError();
+}
+
 const TestLog::BeginMessageToken		TestLog::Message			= TestLog::BeginMessageToken();
 const TestLog::EndMessageToken			TestLog::EndMessage			= TestLog::EndMessageToken();
 const TestLog::EndImageSetToken			TestLog::EndImageSet		= TestLog::EndImageSetToken();
@@ -523,5 +562,6 @@ const TestLog::EndSampleInfoToken		TestLog::EndSampleInfo		= TestLog::EndSampleI
 const TestLog::BeginSampleToken			TestLog::Sample				= TestLog::BeginSampleToken();
 const TestLog::EndSampleToken			TestLog::EndSample			= TestLog::EndSampleToken();
 const TestLog::EndSampleListToken		TestLog::EndSampleList		= TestLog::EndSampleListToken();
+const TestLog::BufferToken				TestLog::Buffer				= TestLog::BufferToken();
 
 } // tcu
@@ -28,6 +28,7 @@
 #include "tcuTexture.hpp"
 
 #include <sstream>
+#include <vector>
 
 namespace tcu
 {
@@ -88,6 +89,7 @@ public:
 	static const class BeginSampleToken {}			Sample;
 	static const class EndSampleToken {}			EndSample;
 	static const class EndSampleListToken {}		EndSampleList;
+	static const class BufferToken {}				Buffer;
 
 	// Typedefs.
 	typedef LogImageSet				ImageSet;
@@ -103,6 +105,7 @@ public:
 	typedef LogNumber<deInt64>		Integer;
 
 	explicit			TestLog					(const char* fileName, deUint32 flags = 0);
+						TestLog					(const BufferToken&, deUint32 flags = 0);	//!< Log buffering output until read with readBuffer().
 						~TestLog				(void);
 
 	MessageBuilder		operator<<				(const BeginMessageToken&);
@@ -171,6 +174,10 @@ public:
 	void				endSample				(void);
 	void				endSampleList			(void);
 
+	// Buffer logs
+	void				readBuffer				(std::vector<deUint8>& dst);				//!< Move complete case results out of a buffer log.
+	void				writeBufferData			(const std::vector<deUint8>& data);		//!< Write case results read from a buffer log. No case may be open.
+
 private:
 						TestLog					(const TestLog& other); // Not allowed!
 	TestLog&			operator=				(const TestLog& other); // Not allowed!
@@ -26,12 +26,22 @@
 #include "tcuTestLog.hpp"
 
 #include "deClock.h"
+#include "deMemory.h"
+#include "deAtomic.h"
+#include "deThread.hpp"
+#include "deSharedPtr.hpp"
 
 namespace tcu
 {
 
 using std::vector;
 
+enum
+{
+	MAX_QUEUED_CASES		= 256,	//!< Queued cases are executed when this many have been collected.
+	WORKER_POLL_INTERVAL_MS	= 10	//!< Interval for polling progress of case worker threads.
+};
+
 static qpTestCaseType nodeTypeToTestCaseType (TestNodeType nodeType)
 {
 	switch (nodeType)
@@ -46,15 +56,228 @@ static qpTestCaseType nodeTypeToTestCaseType (TestNodeType nodeType)
 	}
 }
 
-TestSessionExecutor::TestSessionExecutor (TestPackageRoot& root, TestContext& testCtx)
+static void updateRunStatus (TestRunStatus& status, qpTestResult testResult)
+{
+	status.numExecuted += 1;
+	switch (testResult)
+	{
+		case QP_TEST_RESULT_PASS:					status.numPassed		+= 1;	break;
+		case QP_TEST_RESULT_NOT_SUPPORTED:			status.numNotSupported	+= 1;	break;
+		case QP_TEST_RESULT_QUALITY_WARNING:		status.numWarnings		+= 1;	break;
+		case QP_TEST_RESULT_COMPATIBILITY_WARNING:	status.numWarnings		+= 1;	break;
+		default:									status.numFailed		+= 1;	break;
+	}
+}
+
+static int getNumCaseThreads (const CommandLine& cmdLine)
+{
+	const int numThreads = cmdLine.getCaseNumThreads();
+
+	if (numThreads < 0)
+		throw Exception("Invalid --deqp-case-threads value");
+
+	return numThreads == 0 ? deGetNumAvailableLogicalCores() : numThreads;
+}
+
+namespace
+{
+
+//! Runs context-free case with testCtx redirected to a worker context. Mirrors enter/iterate/leave in TestSessionExecutor.
+//! \note Watchdog touches are counted in the worker context and forwarded to the watchdog by the main thread.
+void runContextFreeCase (TestContext& testCtx, TestCase* testCase)
+{
+	TestLog& log = testCtx.getLog();
+
+	try
+	{
+		testCase->init();
+
+		for (;;)
+		{
+			testCtx.touchWatchdog();
+
+			if (testCase->iterate() == TestNode::STOP)
+				break;
+		}
+	}
+	catch (const std::bad_alloc&)
+	{
+		testCtx.setTestResult(QP_TEST_RESULT_RESOURCE_ERROR, "Failed to allocate memory during test execution");
+		testCtx.setTerminateAfter(true);
+	}
+	catch (const tcu::TestException& e)
+	{
+		DE_ASSERT(e.getTestResult() != QP_TEST_RESULT_LAST);
+		log << e;
+		testCtx.setTestResult(e.getTestResult(), e.getMessage());
+		testCtx.setTerminateAfter(e.isFatal());
+	}
+	catch (const tcu::Exception& e)
+	{
+		log << e;
+		testCtx.setTestResult(QP_TEST_RESULT_FAIL, e.getMessage());
+	}
+
+	try
+	{
+		testCase->deinit();
+	}
+	catch (const tcu::Exception& e)
+	{
+		log << e << TestLog::Message << "Error in test case deinit, test program will terminate." << TestLog::EndMessage;
+		testCtx.setTerminateAfter(true);
+	}
+}
+
+template<typename QueuedCase>
+class CaseWorker : public de::Thread
+{
+public:
+	CaseWorker (TestContext& testCtx, vector<QueuedCase>& cases, volatile deInt32& nextCaseNdx)
+		: m_testCtx		(testCtx)
+		, m_cases		(cases)
+		, m_nextCaseNdx	(nextCaseNdx)
+		// \note Image compression is already parallel at case level.
+		, m_log			(TestLog::Buffer, testCtx.getCommandLine().getLogFlags() & ~(deUint32)QP_TEST_LOG_ASYNC_IMAGES)
+		, m_workerCtx	(testCtx.getPlatform(), testCtx.getRootArchive(), m_log, testCtx.getCommandLine(), DE_NULL)
+		, m_curCaseNdx	(-1)
+		, m_finished	(0)
+		, m_failed		(false)
+	{
+	}
+
+	void run (void)
+	{
+		try
+		{
+			m_testCtx.setThreadContext(&m_workerCtx);
+
+			try
+			{
+				for (;;)
+				{
+					const int caseNdx = deAtomicIncrement32(&m_nextCaseNdx) - 1;
+
+					if (caseNdx >= (int)m_cases.size())
+						break;
+
+					m_curCaseNdx = caseNdx;
+					runCase(m_cases[caseNdx]);
+				}
+			}
+			catch (...)
+			{
+				m_testCtx.setThreadContext(DE_NULL);
+				throw;
+			}
+
+			m_testCtx.setThreadContext(DE_NULL);
+		}
+		catch (const std::exception& e)
+		{
+			m_failed	= true;
+			m_error		= e.what();
+		}
+
+		deMemoryReadWriteFence();
+		m_finished = 1;
+	}
+
+	// \note Progress queries are safe to call from other threads while worker is running.
+	bool					isFinished				(void) const { return m_finished != 0;						}
+	int						getCurCaseNdx			(void) const { return m_curCaseNdx;							} //!< -1 until the first case is started.
+	deUint32				getNumWatchdogTouches	(void) const { return m_workerCtx.getNumWatchdogTouches();	}
+
+	bool					isFailed				(void) const { return m_failed;	}
+	const std::string&		getError				(void) const { return m_error;	}
+
+private:
+	void runCase (QueuedCase& queuedCase)
+	{
+		const deUint64 startTime = deGetMicroseconds();
+
+		m_testCtx.setTestResult(QP_TEST_RESULT_LAST, "");
+		m_testCtx.setTerminateAfter(false);
+		m_log.startCase(queuedCase.casePath.c_str(), nodeTypeToTestCaseType(queuedCase.testCase->getNodeType()));
+
+		runContextFreeCase(m_testCtx, queuedCase.testCase);
+
+		m_log << TestLog::Integer("TestDuration", "Test case duration in microseconds", "us", QP_KEY_TAG_TIME, (deInt64)(deGetMicroseconds()-startTime));
+
+		DE_ASSERT(m_testCtx.getTestResult() != QP_TEST_RESULT_LAST);
+
+		queuedCase.result			= m_testCtx.getTestResult();
+		queuedCase.resultDesc		= m_testCtx.getTestResultDesc();
+		queuedCase.terminateAfter	= m_testCtx.getTerminateAfter();
+
+		m_log.endCase(queuedCase.result, queuedCase.resultDesc.c_str());
+		m_log.readBuffer(queuedCase.logData);
+	}
+
+	TestContext&			m_testCtx;
+	vector<QueuedCase>&		m_cases;
+	volatile deInt32&		m_nextCaseNdx;
+	TestLog					m_log;
+	TestContext				m_workerCtx;
+	volatile deInt32		m_curCaseNdx;
+	volatile deInt32		m_finished;
+	bool					m_failed;
+	std::string				m_error;
+};
+
+//! Watchdog view of a worker's progress, maintained by the main thread.
+struct WorkerProgress
+{
+	int			caseNdx;
+	deUint32	numTouches;
+	deUint64	caseStartTime;
+	deUint64	lastTouchTime;
+
+	WorkerProgress (deUint64 startTime)
+		: caseNdx		(-1)
+		, numTouches	(0)
+		, caseStartTime	(startTime)
+		, lastTouchTime	(startTime)
+	{
+	}
+};
+
+} // anonymous
+
+TestSessionExecutor::QueuedCase::QueuedCase (TestCase* testCase_, const std::string& casePath_)
+	: testCase			(testCase_)
+	, casePath			(casePath_)
+	, result			(QP_TEST_RESULT_LAST)
+	, terminateAfter	(false)
+{
+}
+
+TestSessionExecutor::TestSessionExecutor (TestPackageRoot& root, TestContext& testCtx, const TestHierarchyIndex* hierarchyIndex)
 	: m_testCtx			(testCtx)
 	, m_inflater		(testCtx)
-	, m_caseListFilter	(testCtx.getCommandLine().createCaseListFilter(testCtx.getArchive()))
+	, m_caseListFilter	(testCtx.getCommandLine().createCaseListFilter(testCtx.getArchive(), hierarchyIndex))
 	, m_iterator		(root, m_inflater, *m_caseListFilter)
+	, m_progress		(m_ownProgress)
 	, m_state			(STATE_TRAVERSE_HIERARCHY)
 	, m_abortSession	(false)
 	, m_isInTestCase	(false)
 	, m_testStartTime	(0)
+	, m_numCaseThreads	(getNumCaseThreads(testCtx.getCommandLine()))
+	, m_isCaseQueued	(false)
+{
+}
+
+TestSessionExecutor::TestSessionExecutor (TestPackageRoot& root, TestContext& testCtx, const CaseListFilter& caseListFilter, TestSessionProgress& progress)
+	: m_testCtx			(testCtx)
+	, m_inflater		(testCtx)
+	, m_iterator		(root, m_inflater, caseListFilter, progress.lastCasePath)
+	, m_progress		(progress)
+	, m_state			(STATE_TRAVERSE_HIERARCHY)
+	, m_abortSession	(false)
+	, m_isInTestCase	(false)
+	, m_testStartTime	(0)
+	, m_numCaseThreads	(getNumCaseThreads(testCtx.getCommandLine()))
+	, m_isCaseQueued	(false)
 {
 }
 
@@ -78,6 +301,20 @@ bool TestSessionExecutor::iterate (void)
 					TestNode* const		curNode		= m_iterator.getNode();
 					const TestNodeType	nodeType	= curNode->getNodeType();
 					const bool			isEnter		= hierIterState == TestHierarchyIterator::STATE_ENTER_NODE;
+					const bool			isCase		= isTestNodeTypeExecutable(nodeType);
+
+					// Queued cases must be executed before any other case, and before their group is left and destroyed.
+					if (!m_queuedCases.empty())
+					{
+						const bool continueQueue = isCase ? (isEnter ? isQueueableCase(static_cast<TestCase*>(curNode)) : m_isCaseQueued)
+														  : isEnter;
+
+						if (!continueQueue)
+						{
+							runQueuedCases();
+							return !m_abortSession;
+						}
+					}
 
 					switch (nodeType)
 					{
@@ -100,10 +337,20 @@ bool TestSessionExecutor::iterate (void)
 
 							if (isEnter)
 							{
-								if (enterTestCase(testCase, m_iterator.getNodePath()))
+								if (isQueueableCase(testCase))
+								{
+									if (m_queuedCases.empty())
+										setPendingCase(m_iterator.getNodePath(), testCase, TestSessionProgress::PENDINGCASE_NOT_LOGGED);
+
+									m_queuedCases.push_back(QueuedCase(testCase, m_iterator.getNodePath()));
+									m_isCaseQueued = true;
+								}
+								else if (enterTestCase(testCase, m_iterator.getNodePath()))
 									m_state = STATE_EXECUTE_TEST_CASE;
 								// else remain in TRAVERSING_HIERARCHY => node will be exited from in the next iteration
 							}
+							else if (m_isCaseQueued)
+								m_isCaseQueued = false;
 							else
 								leaveTestCase(testCase);
 
@@ -121,7 +368,8 @@ bool TestSessionExecutor::iterate (void)
 				else
 				{
 					DE_ASSERT(hierIterState == TestHierarchyIterator::STATE_FINISHED);
-					m_status.isComplete = true;
+					DE_ASSERT(m_queuedCases.empty());
+					m_progress.status.isComplete = true;
 					return false;
 				}
 			}
@@ -172,7 +420,10 @@ bool TestSessionExecutor::enterTestCase (TestCase* testCase, const std::string&
 
 	m_testCtx.setTestResult(QP_TEST_RESULT_LAST, "");
 	m_testCtx.setTerminateAfter(false);
+
+	setPendingCase(casePath, testCase, TestSessionProgress::PENDINGCASE_NOT_LOGGED);
 	log.startCase(casePath.c_str(), caseType);
+	m_progress.pendingCaseState = TestSessionProgress::PENDINGCASE_LOGGED;
 
 	m_isInTestCase	= true;
 	m_testStartTime	= deGetMicroseconds();
@@ -241,15 +492,7 @@ void TestSessionExecutor::leaveTestCase (TestCase* testCase)
 		// Update statistics.
 		print("  %s (%s)\n", qpGetTestResultName(testResult), testResultDesc);
 
-		m_status.numExecuted += 1;
-		switch (testResult)
-		{
-			case QP_TEST_RESULT_PASS:					m_status.numPassed			+= 1;	break;
-			case QP_TEST_RESULT_NOT_SUPPORTED:			m_status.numNotSupported	+= 1;	break;
-			case QP_TEST_RESULT_QUALITY_WARNING:		m_status.numWarnings		+= 1;	break;
-			case QP_TEST_RESULT_COMPATIBILITY_WARNING:	m_status.numWarnings		+= 1;	break;
-			default:									m_status.numFailed			+= 1;	break;
-		}
+		setCaseDone(testResult);
 
 		// terminateAfter, Resource error or any error in deinit means that execution should end
 		if (terminateAfter || testResult == QP_TEST_RESULT_RESOURCE_ERROR)
@@ -291,4 +534,140 @@ TestCase::IterateResult TestSessionExecutor::iterateTestCase (TestCase* testCase
 	return iterateResult;
 }
 
+void TestSessionExecutor::setPendingCase (const std::string& casePath, TestCase* testCase, TestSessionProgress::PendingCaseState state)
+{
+	// \note Progress may live in memory shared with another process, so path is copied into a fixed-size buffer.
+	const size_t pathLen = de::min(casePath.size(), (size_t)TestSessionProgress::MAX_CASE_PATH_LENGTH-1);
+
+	deMemcpy(&m_progress.pendingCasePath[0], casePath.c_str(), pathLen);
+	m_progress.pendingCasePath[pathLen]	= 0;
+	m_progress.pendingCaseType			= nodeTypeToTestCaseType(testCase->getNodeType());
+	m_progress.pendingCaseState			= state;
+}
+
+void TestSessionExecutor::setCaseDone (qpTestResult result)
+{
+	updateRunStatus(m_progress.status, result);
+
+	deMemcpy(&m_progress.lastCasePath[0], &m_progress.pendingCasePath[0], sizeof(m_progress.lastCasePath));
+	m_progress.pendingCaseState		= TestSessionProgress::PENDINGCASE_NONE;
+	m_progress.pendingCasePath[0]	= 0;
+}
+
+bool TestSessionExecutor::isQueueableCase (TestCase* testCase) const
+{
+	// \note Progress given by caller is used for recovering from crashes, which must be attributed to the right case.
+	if (&m_progress != &m_ownProgress)
+		return false;
+
+	return m_numCaseThreads > 1 && (int)m_queuedCases.size() < MAX_QUEUED_CASES && testCase->isContextFree();
+}
+
+void TestSessionExecutor::runQueuedCases (void)
+{
+	typedef CaseWorker<QueuedCase>	Worker;
+	typedef de::SharedPtr<Worker>	WorkerSp;
+
+	const int				numThreads	= de::min(m_numCaseThreads, (int)m_queuedCases.size());
+	qpWatchDog* const		watchDog	= m_testCtx.getWatchDog();
+	volatile deInt32		nextCaseNdx	= 0;
+	vector<WorkerSp>		workers;
+	vector<WorkerProgress>	progress	(numThreads, WorkerProgress(deGetMicroseconds()));
+	std::string				error;
+
+	DE_ASSERT(!m_queuedCases.empty() && !m_isCaseQueued);
+
+	for (int threadNdx = 0; threadNdx < numThreads; threadNdx++)
+	{
+		workers.push_back(WorkerSp(new Worker(m_testCtx, m_queuedCases, nextCaseNdx)));
+		workers.back()->start();
+	}
+
+	// Time limits apply to each case separately, so watchdog follows the oldest running case instead of the whole batch.
+	for (;;)
+	{
+		const deUint64	curTime			= deGetMicroseconds();
+		deUint64		resetTime		= curTime;
+		deUint64		lastTouchTime	= curTime;
+		bool			allFinished		= true;
+
+		for (size_t threadNdx = 0; threadNdx < workers.size(); threadNdx++)
+		{
+			const Worker&		worker		= *workers[threadNdx];
+			WorkerProgress&		workerProg	= progress[threadNdx];
+
+			if (worker.isFinished())
+				continue;
+
+			{
+				const int		caseNdx		= worker.getCurCaseNdx();
+				const deUint32	numTouches	= worker.getNumWatchdogTouches();
+
+				if (caseNdx != workerProg.caseNdx)
+				{
+					workerProg.caseNdx			= caseNdx;
+					workerProg.caseStartTime	= curTime;
+					workerProg.lastTouchTime	= curTime;
+				}
+				else if (numTouches != workerProg.numTouches)
+					workerProg.lastTouchTime	= curTime;
+
+				workerProg.numTouches = numTouches;
+			}
+
+			resetTime		= de::min(resetTime, workerProg.caseStartTime);
+			lastTouchTime	= de::min(lastTouchTime, workerProg.lastTouchTime);
+			allFinished		= false;
+		}
+
+		if (allFinished)
+			break;
+
+		if (watchDog)
+			qpWatchDog_setTimes(watchDog, resetTime, lastTouchTime);
+
+		deSleep(WORKER_POLL_INTERVAL_MS);
+	}
+
+	for (size_t threadNdx = 0; threadNdx < workers.size(); threadNdx++)
+	{
+		workers[threadNdx]->join();
+
+		if (workers[threadNdx]->isFailed() && error.empty())
+			error = workers[threadNdx]->getError();
+	}
+
+	if (!error.empty())
+	{
+		m_queuedCases.clear();
+		throw InternalError(error);
+	}
+
+	// Write results in hierarchy order.
+	for (vector<QueuedCase>::const_iterator caseIter = m_queuedCases.begin(); caseIter != m_queuedCases.end(); ++caseIter)
+	{
+		print("\nTest case '%s'..\n", caseIter->casePath.c_str());
+
+		m_testCtx.getLog().writeBufferData(caseIter->logData);
+
+		print("  %s (%s)\n", qpGetTestResultName(caseIter->result), caseIter->resultDesc.c_str());
+		setCaseDone(caseIter->result);
+
+		// \note Remaining cases have already been executed, but serial execution would not have reached them.
+		if (caseIter->terminateAfter || caseIter->result == QP_TEST_RESULT_RESOURCE_ERROR)
+		{
+			m_abortSession = true;
+			break;
+		}
+
+		if (caseIter+1 != m_queuedCases.end())
+			setPendingCase((caseIter+1)->casePath, (caseIter+1)->testCase, TestSessionProgress::PENDINGCASE_NOT_LOGGED);
+	}
+
+	m_queuedCases.clear();
+
+	if (m_testCtx.getWatchDog())
+		qpWatchDog_reset(m_testCtx.getWatchDog());
+}
+
 } // tcu
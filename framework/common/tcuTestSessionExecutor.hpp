@@ -30,9 +30,14 @@
 #include "tcuTestHierarchyIterator.hpp"
 #include "deUniquePtr.hpp"
 
+#include <string>
+#include <vector>
+
 namespace tcu
 {
 
+class TestHierarchyIndex;
+
 //! Test run summary.
 class TestRunStatus
 {
@@ -57,16 +62,80 @@ public:
 	bool	isComplete;			//!< Is run complete.
 };
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Test session progress
+ *
+ * Progress is updated by TestSessionExecutor as cases are started and
+ * their results are written to the log. It is plain data so that it can
+ * be placed in memory shared with another process: the fork server in
+ * App uses it to find out where a crashed test process was and to resume
+ * execution after that case in a new process.
+ *//*--------------------------------------------------------------------*/
+struct TestSessionProgress
+{
+	enum
+	{
+		MAX_CASE_PATH_LENGTH	= 1024
+	};
+
+	enum PendingCaseState
+	{
+		PENDINGCASE_NONE = 0,		//!< No case is being executed.
+		PENDINGCASE_NOT_LOGGED,		//!< Case is being executed but nothing has been written to log yet.
+		PENDINGCASE_LOGGED,			//!< #beginTestCaseResult has been written.
+		PENDINGCASE_TERMINATED,		//!< #terminateTestCaseResult has been written by crash handler or watchdog.
+
+		PENDINGCASE_LAST
+	};
+
+	TestSessionProgress (void)
+		: pendingCaseState	(PENDINGCASE_NONE)
+		, pendingCaseType	(QP_TEST_CASE_TYPE_LAST)
+		, terminateResult	(QP_TEST_RESULT_CRASH)
+	{
+		lastCasePath[0]		= 0;
+		pendingCasePath[0]	= 0;
+	}
+
+	TestRunStatus		status;
+	char				lastCasePath[MAX_CASE_PATH_LENGTH];	//!< Last case whose result is in the log, empty if none. Executor resumes after it.
+	PendingCaseState	pendingCaseState;	//!< State of the first case whose result is not yet in the log.
+	qpTestCaseType		pendingCaseType;
+	char				pendingCasePath[MAX_CASE_PATH_LENGTH];
+	qpTestResult		terminateResult;	//!< Result to record for pending case if process dies.
+};
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Test session executor
+ *
+ * Executes test cases in hierarchy order. With --deqp-case-threads > 1
+ * consecutive cases that declare themselves context-free (see
+ * TestCase::isContextFree()) are queued and run concurrently on worker
+ * threads, bypassing the package TestCaseExecutor. Each worker logs into
+ * a buffer log and results are written into the main log in hierarchy
+ * order once the queue is executed.
+ *
+ * If a hierarchy index is given, groups without any cases matching the
+ * case list filter are skipped without being initialized.
+ *
+ * Executor can also be given a case list filter and progress owned by
+ * the caller. Progress is kept up to date and execution resumes after
+ * progress.lastCasePath: nodes before it in hierarchy order are skipped
+ * without being initialized. Cases are never queued in that case, so
+ * that the pending case in progress is always the one being executed if
+ * the process dies.
+ *//*--------------------------------------------------------------------*/
 class TestSessionExecutor
 {
 public:
-									TestSessionExecutor	(TestPackageRoot& root, TestContext& testCtx);
+									TestSessionExecutor	(TestPackageRoot& root, TestContext& testCtx, const TestHierarchyIndex* hierarchyIndex = DE_NULL);
+									TestSessionExecutor	(TestPackageRoot& root, TestContext& testCtx, const CaseListFilter& caseListFilter, TestSessionProgress& progress);
 									~TestSessionExecutor(void);
 
 	bool							iterate				(void);
 
 	bool							isInTestCase		(void) const { return m_isInTestCase;	}
-	const TestRunStatus&			getStatus			(void) const { return m_status;			}
+	const TestRunStatus&			getStatus			(void) const { return m_progress.status;	}
 
 private:
 	void							enterTestPackage	(TestPackage* testPackage);
@@ -76,6 +145,24 @@ private:
 	TestCase::IterateResult			iterateTestCase		(TestCase* testCase);
 	void							leaveTestCase		(TestCase* testCase);
 
+	void							setPendingCase		(const std::string& casePath, TestCase* testCase, TestSessionProgress::PendingCaseState state);
+	void							setCaseDone			(qpTestResult result);
+
+	bool							isQueueableCase		(TestCase* testCase) const;
+	void							runQueuedCases		(void);
+
+	struct QueuedCase
+	{
+								QueuedCase		(TestCase* testCase_, const std::string& casePath_);
+
+		TestCase*				testCase;
+		std::string				casePath;
+		qpTestResult			result;
+		std::string				resultDesc;
+		bool					terminateAfter;
+		std::vector<deUint8>	logData;		//!< Complete case result from worker buffer log.
+	};
+
 	enum State
 	{
 		STATE_TRAVERSE_HIERARCHY = 0,
@@ -87,15 +174,20 @@ private:
 	TestContext&					m_testCtx;
 
 	DefaultHierarchyInflater		m_inflater;
-	de::MovePtr<CaseListFilter>		m_caseListFilter;
+	de::MovePtr<CaseListFilter>		m_caseListFilter;	//!< Own filter, null if given by caller.
 	TestHierarchyIterator			m_iterator;
 
 	de::MovePtr<TestCaseExecutor>	m_caseExecutor;
-	TestRunStatus					m_status;
+	TestSessionProgress				m_ownProgress;
+	TestSessionProgress&			m_progress;			//!< Either m_ownProgress or progress given by caller.
 	State							m_state;
 	bool							m_abortSession;
 	bool							m_isInTestCase;
 	deUint64						m_testStartTime;
+
+	const int						m_numCaseThreads;
+	std::vector<QueuedCase>			m_queuedCases;
+	bool							m_isCaseQueued;		//!< Was case at current hierarchy position queued for concurrent execution?
 };
 
 } // tcu
@@ -27,6 +27,7 @@
 #include "tcuVectorUtil.hpp"
 #include "tcuTextureUtil.hpp"
 #include "deMath.h"
+#include "deRandom.hpp"
 
 namespace tcu
 {
@@ -243,6 +244,81 @@ static bool isInColorBounds (const LookupPrecision&		prec,
 	return boolAll(logicalOr(logicalAnd(greaterThanEqual(result, minVal), lessThanEqual(result, maxVal)), logicalNot(prec.colorMask)));
 }
 
+// Reference sample comparison
+
+static inline Vec4 sampleReference (const Texture1DView& texture, const Sampler& sampler, const float coord, float lod)
+{
+	return texture.sample(sampler, coord, lod);
+}
+
+static inline Vec4 sampleReference (const Texture2DView& texture, const Sampler& sampler, const Vec2& coord, float lod)
+{
+	return texture.sample(sampler, coord.x(), coord.y(), lod);
+}
+
+static inline Vec4 sampleReference (const TextureCubeView& texture, const Sampler& sampler, const Vec3& coord, float lod)
+{
+	return texture.sample(sampler, coord.x(), coord.y(), coord.z(), lod);
+}
+
+static inline Vec4 sampleReference (const Texture1DArrayView& texture, const Sampler& sampler, const Vec2& coord, float lod)
+{
+	return texture.sample(sampler, coord.x(), coord.y(), lod);
+}
+
+static inline Vec4 sampleReference (const Texture2DArrayView& texture, const Sampler& sampler, const Vec3& coord, float lod)
+{
+	return texture.sample(sampler, coord.x(), coord.y(), coord.z(), lod);
+}
+
+static inline Vec4 sampleReference (const Texture3DView& texture, const Sampler& sampler, const Vec3& coord, float lod)
+{
+	return texture.sample(sampler, coord.x(), coord.y(), coord.z(), lod);
+}
+
+static inline Vec4 sampleReference (const TextureCubeArrayView& texture, const Sampler& sampler, const Vec4& coord, float lod)
+{
+	return texture.sample(sampler, coord.x(), coord.y(), coord.z(), coord.w(), lod);
+}
+
+//! Check whether filters used within lod bounds select texels without interpolating between them.
+static bool isNearestTexelLookup (const Sampler& sampler, const Vec2& lodBounds)
+{
+	const bool	canBeMagnified	= lodBounds.x() <= sampler.lodThreshold;
+	const bool	canBeMinified	= lodBounds.y() > sampler.lodThreshold;
+
+	return (!canBeMagnified || isNearestFilter(sampler.magFilter)) &&
+		   (!canBeMinified || isNearestFilter(sampler.minFilter));
+}
+
+//! Check result against samples at exact coordinate and both lod bounds and update stats.
+template<typename TextureViewType, typename CoordType>
+static bool matchesReferenceSample (const TextureViewType&	texture,
+									const Sampler&			sampler,
+									const LookupPrecision&	prec,
+									const CoordType&		coord,
+									const Vec2&				lodBounds,
+									const Vec4&				result,
+									LookupVerifierStats*	stats)
+{
+	// \note Full search evaluates linear filter weights in discrete steps and may reject results
+	//		 within threshold of the exact sample. Reference comparison must never accept a result
+	//		 the search rejects, so it is limited to lookups without texel interpolation.
+	const bool isMatch = isNearestTexelLookup(sampler, lodBounds) &&
+						 (isColorValid(prec, sampleReference(texture, sampler, coord, lodBounds.x()), result) ||
+						  (lodBounds.y() != lodBounds.x() && isColorValid(prec, sampleReference(texture, sampler, coord, lodBounds.y()), result)));
+
+	if (stats)
+	{
+		if (isMatch)
+			stats->numReferenceMatches += 1;
+		else
+			stats->numSearched += 1;
+	}
+
+	return isMatch;
+}
+
 // Range search utilities
 
 static bool isLinearRangeValid (const LookupPrecision&	prec,
@@ -1310,7 +1386,7 @@ static bool isMipmapLinearSampleResultValid (const ConstPixelBufferAccess&		leve
 		return isNearestMipmapLinearSampleResultValid(level0, level1, sampler, prec, coord, coordZ, fBounds, result);
 }
 
-bool isLookupResultValid (const Texture2DView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec2& coord, const Vec2& lodBounds, const Vec4& result)
+static bool isLookupResultValidBySearch (const Texture2DView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec2& coord, const Vec2& lodBounds, const Vec4& result)
 {
 	const float		minLod			= lodBounds.x();
 	const float		maxLod			= lodBounds.y();
@@ -1375,7 +1451,13 @@ bool isLookupResultValid (const Texture2DView& texture, const Sampler& sampler,
 	return false;
 }
 
-bool isLookupResultValid (const Texture1DView& texture, const Sampler& sampler, const LookupPrecision& prec, const float coord, const Vec2& lodBounds, const Vec4& result)
+bool isLookupResultValid (const Texture2DView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec2& coord, const Vec2& lodBounds, const Vec4& result, LookupVerifierStats* stats)
+{
+	return matchesReferenceSample(texture, sampler, prec, coord, lodBounds, result, stats) ||
+		   isLookupResultValidBySearch(texture, sampler, prec, coord, lodBounds, result);
+}
+
+static bool isLookupResultValidBySearch (const Texture1DView& texture, const Sampler& sampler, const LookupPrecision& prec, const float coord, const Vec2& lodBounds, const Vec4& result)
 {
 	const float		minLod			= lodBounds.x();
 	const float		maxLod			= lodBounds.y();
@@ -1440,6 +1522,12 @@ bool isLookupResultValid (const Texture1DView& texture, const Sampler& sampler,
 	return false;
 }
 
+bool isLookupResultValid (const Texture1DView& texture, const Sampler& sampler, const LookupPrecision& prec, const float coord, const Vec2& lodBounds, const Vec4& result, LookupVerifierStats* stats)
+{
+	return matchesReferenceSample(texture, sampler, prec, coord, lodBounds, result, stats) ||
+		   isLookupResultValidBySearch(texture, sampler, prec, coord, lodBounds, result);
+}
+
 static bool isSeamlessLinearSampleResultValid (const ConstPixelBufferAccess (&faces)[CUBEFACE_LAST],
 											   const Sampler&				sampler,
 											   const LookupPrecision&		prec,
@@ -1662,7 +1750,7 @@ static void getCubeLevelFaces (const TextureCubeView& texture, const int levelNd
 		out[faceNdx] = texture.getLevelFace(levelNdx, (CubeFace)faceNdx);
 }
 
-bool isLookupResultValid (const TextureCubeView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec3& coord, const Vec2& lodBounds, const Vec4& result)
+static bool isLookupResultValidBySearch (const TextureCubeView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec3& coord, const Vec2& lodBounds, const Vec4& result)
 {
 	int			numPossibleFaces				= 0;
 	CubeFace	possibleFaces[CUBEFACE_LAST];
@@ -1754,6 +1842,12 @@ bool isLookupResultValid (const TextureCubeView& texture, const Sampler& sampler
 	return false;
 }
 
+bool isLookupResultValid (const TextureCubeView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec3& coord, const Vec2& lodBounds, const Vec4& result, LookupVerifierStats* stats)
+{
+	return matchesReferenceSample(texture, sampler, prec, coord, lodBounds, result, stats) ||
+		   isLookupResultValidBySearch(texture, sampler, prec, coord, lodBounds, result);
+}
+
 static inline IVec2 computeLayerRange (int numLayers, int numCoordBits, float layerCoord)
 {
 	const float	err		= computeFloatingPointError(layerCoord, numCoordBits);
@@ -1765,7 +1859,7 @@ static inline IVec2 computeLayerRange (int numLayers, int numCoordBits, float la
 	return IVec2(de::clamp(minL, 0, numLayers-1), de::clamp(maxL, 0, numLayers-1));
 }
 
-bool isLookupResultValid (const Texture1DArrayView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec2& coord, const Vec2& lodBounds, const Vec4& result)
+static bool isLookupResultValidBySearch (const Texture1DArrayView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec2& coord, const Vec2& lodBounds, const Vec4& result)
 {
 	const IVec2		layerRange		= computeLayerRange(texture.getNumLayers(), prec.coordBits.y(), coord.y());
 	const float		coordX			= coord.x();
@@ -1835,7 +1929,13 @@ bool isLookupResultValid (const Texture1DArrayView& texture, const Sampler& samp
 	return false;
 }
 
-bool isLookupResultValid (const Texture2DArrayView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec3& coord, const Vec2& lodBounds, const Vec4& result)
+bool isLookupResultValid (const Texture1DArrayView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec2& coord, const Vec2& lodBounds, const Vec4& result, LookupVerifierStats* stats)
+{
+	return matchesReferenceSample(texture, sampler, prec, coord, lodBounds, result, stats) ||
+		   isLookupResultValidBySearch(texture, sampler, prec, coord, lodBounds, result);
+}
+
+static bool isLookupResultValidBySearch (const Texture2DArrayView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec3& coord, const Vec2& lodBounds, const Vec4& result)
 {
 	const IVec2		layerRange		= computeLayerRange(texture.getNumLayers(), prec.coordBits.z(), coord.z());
 	const Vec2		coordXY			= coord.swizzle(0,1);
@@ -1905,6 +2005,12 @@ bool isLookupResultValid (const Texture2DArrayView& texture, const Sampler& samp
 	return false;
 }
 
+bool isLookupResultValid (const Texture2DArrayView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec3& coord, const Vec2& lodBounds, const Vec4& result, LookupVerifierStats* stats)
+{
+	return matchesReferenceSample(texture, sampler, prec, coord, lodBounds, result, stats) ||
+		   isLookupResultValidBySearch(texture, sampler, prec, coord, lodBounds, result);
+}
+
 static bool isLevelSampleResultValid (const ConstPixelBufferAccess&		level,
 									  const Sampler&					sampler,
 									  const Sampler::FilterMode			filterMode,
@@ -1933,7 +2039,7 @@ static bool isMipmapLinearSampleResultValid (const ConstPixelBufferAccess&		leve
 		return isNearestMipmapLinearSampleResultValid(level0, level1, sampler, prec, coord, fBounds, result);
 }
 
-bool isLookupResultValid (const Texture3DView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec3& coord, const Vec2& lodBounds, const Vec4& result)
+static bool isLookupResultValidBySearch (const Texture3DView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec3& coord, const Vec2& lodBounds, const Vec4& result)
 {
 	const float		minLod			= lodBounds.x();
 	const float		maxLod			= lodBounds.y();
@@ -1998,6 +2104,12 @@ bool isLookupResultValid (const Texture3DView& texture, const Sampler& sampler,
 	return false;
 }
 
+bool isLookupResultValid (const Texture3DView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec3& coord, const Vec2& lodBounds, const Vec4& result, LookupVerifierStats* stats)
+{
+	return matchesReferenceSample(texture, sampler, prec, coord, lodBounds, result, stats) ||
+		   isLookupResultValidBySearch(texture, sampler, prec, coord, lodBounds, result);
+}
+
 static void getCubeArrayLevelFaces (const TextureCubeArrayView& texture, const int levelNdx, const int layerNdx, ConstPixelBufferAccess (&out)[CUBEFACE_LAST])
 {
 	const ConstPixelBufferAccess&	level		= texture.getLevel(levelNdx);
@@ -2010,7 +2122,7 @@ static void getCubeArrayLevelFaces (const TextureCubeArrayView& texture, const i
 	}
 }
 
-bool isLookupResultValid (const TextureCubeArrayView& texture, const Sampler& sampler, const LookupPrecision& prec, const IVec4& coordBits, const Vec4& coord, const Vec2& lodBounds, const Vec4& result)
+static bool isLookupResultValidBySearch (const TextureCubeArrayView& texture, const Sampler& sampler, const LookupPrecision& prec, const IVec4& coordBits, const Vec4& coord, const Vec2& lodBounds, const Vec4& result)
 {
 	const IVec2	layerRange						= computeLayerRange(texture.getNumLayers(), coordBits.w(), coord.w());
 	const Vec3	layerCoord						= coord.toWidth<3>();
@@ -2107,6 +2219,12 @@ bool isLookupResultValid (const TextureCubeArrayView& texture, const Sampler& sa
 	return false;
 }
 
+bool isLookupResultValid (const TextureCubeArrayView& texture, const Sampler& sampler, const LookupPrecision& prec, const IVec4& coordBits, const Vec4& coord, const Vec2& lodBounds, const Vec4& result, LookupVerifierStats* stats)
+{
+	return matchesReferenceSample(texture, sampler, prec, coord, lodBounds, result, stats) ||
+		   isLookupResultValidBySearch(texture, sampler, prec, coordBits, coord, lodBounds, result);
+}
+
 Vec4 computeFixedPointThreshold (const IVec4& bits)
 {
 	return computeFixedPointError(bits);
@@ -2608,4 +2726,181 @@ bool isGatherResultValid (const TextureCubeView&		texture,
 	return isCubeGatherResultValid(texture, sampler, prec, coord, componentNdx, result);
 }
 
+namespace
+{
+
+void fillRandom (de::Random& rnd, const PixelBufferAccess& access)
+{
+	for (int z = 0; z < access.getDepth(); z++)
+	for (int y = 0; y < access.getHeight(); y++)
+	for (int x = 0; x < access.getWidth(); x++)
+		access.setPixel(Vec4(rnd.getFloat(), rnd.getFloat(), rnd.getFloat(), rnd.getFloat()), x, y, z);
+}
+
+template<typename TextureType>
+void fillRandom (de::Random& rnd, TextureType& texture)
+{
+	for (int levelNdx = 0; levelNdx < texture.getNumLevels(); levelNdx++)
+	{
+		texture.allocLevel(levelNdx);
+		fillRandom(rnd, texture.getLevel(levelNdx));
+	}
+}
+
+void fillRandom (de::Random& rnd, TextureCube& texture)
+{
+	for (int levelNdx = 0; levelNdx < texture.getNumLevels(); levelNdx++)
+	for (int faceNdx = 0; faceNdx < CUBEFACE_LAST; faceNdx++)
+	{
+		texture.allocLevel((CubeFace)faceNdx, levelNdx);
+		fillRandom(rnd, texture.getLevelFace(levelNdx, (CubeFace)faceNdx));
+	}
+}
+
+float randomCoord (de::Random& rnd) { return rnd.getFloat(-1.0f, 2.0f); }
+
+//! Coordinate type and random coordinate generation for texture view type.
+template<typename TextureViewType>
+struct LookupCoord;
+
+// \note Layer coordinates are unnormalized and given as the last component.
+template<> struct LookupCoord<Texture1DView>		{ typedef float	Type; static Type random (de::Random& rnd) { return randomCoord(rnd);																	} };
+template<> struct LookupCoord<Texture2DView>		{ typedef Vec2	Type; static Type random (de::Random& rnd) { return Vec2(randomCoord(rnd), randomCoord(rnd));											} };
+template<> struct LookupCoord<Texture3DView>		{ typedef Vec3	Type; static Type random (de::Random& rnd) { return Vec3(randomCoord(rnd), randomCoord(rnd), randomCoord(rnd));						} };
+template<> struct LookupCoord<TextureCubeView>		{ typedef Vec3	Type; static Type random (de::Random& rnd) { return Vec3(randomCoord(rnd), randomCoord(rnd), randomCoord(rnd));						} };
+template<> struct LookupCoord<Texture1DArrayView>	{ typedef Vec2	Type; static Type random (de::Random& rnd) { return Vec2(randomCoord(rnd), rnd.getFloat(-1.0f, 4.0f));									} };
+template<> struct LookupCoord<Texture2DArrayView>	{ typedef Vec3	Type; static Type random (de::Random& rnd) { return Vec3(randomCoord(rnd), randomCoord(rnd), rnd.getFloat(-1.0f, 4.0f));				} };
+template<> struct LookupCoord<TextureCubeArrayView>	{ typedef Vec4	Type; static Type random (de::Random& rnd) { return Vec4(randomCoord(rnd), randomCoord(rnd), randomCoord(rnd), rnd.getFloat(-1.0f, 3.0f));	} };
+
+bool isLookupResultValidBySearch (const TextureCubeArrayView& texture, const Sampler& sampler, const LookupPrecision& prec, const Vec4& coord, const Vec2& lodBounds, const Vec4& result)
+{
+	return tcu::isLookupResultValidBySearch(texture, sampler, prec, IVec4(prec.coordBits.x(), prec.coordBits.y(), prec.coordBits.z(), 20), coord, lodBounds, result);
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Check that reference sample comparison is never more lenient than full search
+ *
+ * Results are sampled at lod bounds and perturbed within color threshold.
+ * Each result accepted by matchesReferenceSample() must also be accepted
+ * by isLookupResultValidBySearch(), otherwise the fast path would make the
+ * verifier accept results the full search rejects.
+ *//*--------------------------------------------------------------------*/
+template<typename TextureViewType>
+void selfTestReferenceSampleImpliesSearch (de::Random& rnd, const TextureViewType& texture, const Sampler& sampler, const LookupPrecision& prec, int maxLod)
+{
+	const int			numLookups				= 32;
+	const int			numResultsPerLookup		= 4;
+	LookupVerifierStats	stats;
+	int					numReferenceMatches		= 0;
+
+	for (int lookupNdx = 0; lookupNdx < numLookups; lookupNdx++)
+	{
+		const typename LookupCoord<TextureViewType>::Type	coord		= LookupCoord<TextureViewType>::random(rnd);
+		const float											minLod		= rnd.getFloat(-1.0f, (float)maxLod + 1.0f);
+		const Vec2											lodBounds	(minLod, minLod + rnd.getFloat(0.0f, 1.5f));
+
+		for (int boundNdx = 0; boundNdx < 2; boundNdx++)
+		{
+			const Vec4 reference = sampleReference(texture, sampler, coord, lodBounds[boundNdx]);
+
+			for (int resultNdx = 0; resultNdx < numResultsPerLookup; resultNdx++)
+			{
+				// \note First result is the reference itself, others are perturbed up to the edge of the threshold.
+				const Vec4 perturbation	= resultNdx == 0 ? Vec4(0.0f) : Vec4(rnd.getFloat(-1.0f, 1.0f), rnd.getFloat(-1.0f, 1.0f), rnd.getFloat(-1.0f, 1.0f), rnd.getFloat(-1.0f, 1.0f));
+				const Vec4 result		= reference + perturbation * prec.colorThreshold;
+
+				if (!matchesReferenceSample(texture, sampler, prec, coord, lodBounds, result, &stats))
+				{
+					TCU_CHECK(resultNdx != 0 || !isNearestTexelLookup(sampler, lodBounds));
+					continue;
+				}
+
+				numReferenceMatches += 1;
+
+				if (!isLookupResultValidBySearch(texture, sampler, prec, coord, lodBounds, result))
+					throw TestError("Result accepted by reference sample comparison was rejected by full search");
+			}
+		}
+	}
+
+	TCU_CHECK(stats.numReferenceMatches == numReferenceMatches);
+	TCU_CHECK(stats.numReferenceMatches + stats.numSearched == numLookups*2*numResultsPerLookup);
+}
+
+void selfTestLookupTiers (de::Random& rnd, Sampler::FilterMode minFilter, Sampler::FilterMode magFilter)
+{
+	const TextureFormat		format		(TextureFormat::RGBA, TextureFormat::UNORM_INT8);
+	const Sampler			sampler		(Sampler::REPEAT_GL, Sampler::MIRRORED_REPEAT_GL, Sampler::CLAMP_TO_EDGE, minFilter, magFilter);
+	LookupPrecision			prec;
+
+	prec.coordBits		= IVec3(20);
+	prec.uvwBits		= IVec3(7);
+	prec.colorThreshold	= computeFixedPointThreshold(IVec4(6));
+
+	{
+		Texture1D texture (format, 32);
+		fillRandom(rnd, texture);
+		selfTestReferenceSampleImpliesSearch<Texture1DView>(rnd, texture, sampler, prec, 5);
+	}
+
+	{
+		Texture2D texture (format, 32, 16);
+		fillRandom(rnd, texture);
+		selfTestReferenceSampleImpliesSearch<Texture2DView>(rnd, texture, sampler, prec, 5);
+	}
+
+	{
+		Texture3D texture (format, 16, 8, 4);
+		fillRandom(rnd, texture);
+		selfTestReferenceSampleImpliesSearch<Texture3DView>(rnd, texture, sampler, prec, 4);
+	}
+
+	{
+		Texture1DArray texture (format, 32, 4);
+		fillRandom(rnd, texture);
+		selfTestReferenceSampleImpliesSearch<Texture1DArrayView>(rnd, texture, sampler, prec, 5);
+	}
+
+	{
+		Texture2DArray texture (format, 16, 16, 4);
+		fillRandom(rnd, texture);
+		selfTestReferenceSampleImpliesSearch<Texture2DArrayView>(rnd, texture, sampler, prec, 4);
+	}
+
+	for (int seamless = 0; seamless < 2; seamless++)
+	{
+		Sampler cubeSampler = sampler;
+
+		cubeSampler.seamlessCubeMap = seamless != 0;
+
+		{
+			TextureCube texture (format, 16);
+			fillRandom(rnd, texture);
+			selfTestReferenceSampleImpliesSearch<TextureCubeView>(rnd, texture, cubeSampler, prec, 4);
+		}
+
+		{
+			TextureCubeArray texture (format, 8, 12);
+			fillRandom(rnd, texture);
+			selfTestReferenceSampleImpliesSearch<TextureCubeArrayView>(rnd, texture, cubeSampler, prec, 3);
+		}
+	}
+}
+
+} // anonymous
+
+void TexLookupVerifier_selfTest (void)
+{
+	de::Random rnd (0x5e2a91c);
+
+	selfTestLookupTiers(rnd, Sampler::NEAREST,					Sampler::NEAREST);
+	selfTestLookupTiers(rnd, Sampler::LINEAR,					Sampler::LINEAR);
+	selfTestLookupTiers(rnd, Sampler::NEAREST_MIPMAP_NEAREST,	Sampler::NEAREST);
+	selfTestLookupTiers(rnd, Sampler::LINEAR_MIPMAP_NEAREST,	Sampler::LINEAR);
+	selfTestLookupTiers(rnd, Sampler::NEAREST_MIPMAP_LINEAR,	Sampler::NEAREST);
+	selfTestLookupTiers(rnd, Sampler::LINEAR_MIPMAP_LINEAR,		Sampler::LINEAR);
+	selfTestLookupTiers(rnd, Sampler::LINEAR_MIPMAP_LINEAR,		Sampler::NEAREST);
+	selfTestLookupTiers(rnd, Sampler::NEAREST_MIPMAP_NEAREST,	Sampler::LINEAR);
+}
+
 } // tcu
@@ -105,6 +105,27 @@ enum TexLookupScaleMode
 	TEX_LOOKUP_SCALE_MODE_LAST
 };
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Lookup verification tier counters.
+ *
+ * For lookups that use only nearest filtering within lod bounds,
+ * isLookupResultValid() first compares the result against reference
+ * samples taken at the exact coordinate and at both lod bounds. All
+ * other results are verified with the full search over coordinate, lod
+ * and filtering weight ranges.
+ *//*--------------------------------------------------------------------*/
+struct LookupVerifierStats
+{
+	int			numReferenceMatches;	//!< Results accepted by reference sample comparison.
+	int			numSearched;			//!< Results verified with full search.
+
+	LookupVerifierStats (void)
+		: numReferenceMatches	(0)
+		, numSearched			(0)
+	{
+	}
+};
+
 Vec4		computeFixedPointThreshold			(const IVec4& bits);
 Vec4		computeFloatingPointThreshold		(const IVec4& bits, const Vec4& value);
 
@@ -115,13 +136,13 @@ Vec2		computeCubeLodBoundsFromDerivates	(const Vec3& coord, const Vec3& coordDx,
 
 Vec2		clampLodBounds						(const Vec2& lodBounds, const Vec2& lodMinMax, const LodPrecision& prec);
 
-bool		isLookupResultValid					(const Texture1DView&			texture, const Sampler& sampler, const LookupPrecision& prec, const float coord, const Vec2& lodBounds, const Vec4& result);
-bool		isLookupResultValid					(const Texture2DView&			texture, const Sampler& sampler, const LookupPrecision& prec, const Vec2& coord, const Vec2& lodBounds, const Vec4& result);
-bool		isLookupResultValid					(const TextureCubeView&			texture, const Sampler& sampler, const LookupPrecision& prec, const Vec3& coord, const Vec2& lodBounds, const Vec4& result);
-bool		isLookupResultValid					(const Texture1DArrayView&		texture, const Sampler& sampler, const LookupPrecision& prec, const Vec2& coord, const Vec2& lodBounds, const Vec4& result);
-bool		isLookupResultValid					(const Texture2DArrayView&		texture, const Sampler& sampler, const LookupPrecision& prec, const Vec3& coord, const Vec2& lodBounds, const Vec4& result);
-bool		isLookupResultValid					(const Texture3DView&			texture, const Sampler& sampler, const LookupPrecision& prec, const Vec3& coord, const Vec2& lodBounds, const Vec4& result);
-bool		isLookupResultValid					(const TextureCubeArrayView&	texture, const Sampler& sampler, const LookupPrecision& prec, const IVec4& coordBits, const Vec4& coord, const Vec2& lodBounds, const Vec4& result);
+bool		isLookupResultValid					(const Texture1DView&			texture, const Sampler& sampler, const LookupPrecision& prec, const float coord, const Vec2& lodBounds, const Vec4& result, LookupVerifierStats* stats = DE_NULL);
+bool		isLookupResultValid					(const Texture2DView&			texture, const Sampler& sampler, const LookupPrecision& prec, const Vec2& coord, const Vec2& lodBounds, const Vec4& result, LookupVerifierStats* stats = DE_NULL);
+bool		isLookupResultValid					(const TextureCubeView&			texture, const Sampler& sampler, const LookupPrecision& prec, const Vec3& coord, const Vec2& lodBounds, const Vec4& result, LookupVerifierStats* stats = DE_NULL);
+bool		isLookupResultValid					(const Texture1DArrayView&		texture, const Sampler& sampler, const LookupPrecision& prec, const Vec2& coord, const Vec2& lodBounds, const Vec4& result, LookupVerifierStats* stats = DE_NULL);
+bool		isLookupResultValid					(const Texture2DArrayView&		texture, const Sampler& sampler, const LookupPrecision& prec, const Vec3& coord, const Vec2& lodBounds, const Vec4& result, LookupVerifierStats* stats = DE_NULL);
+bool		isLookupResultValid					(const Texture3DView&			texture, const Sampler& sampler, const LookupPrecision& prec, const Vec3& coord, const Vec2& lodBounds, const Vec4& result, LookupVerifierStats* stats = DE_NULL);
+bool		isLookupResultValid					(const TextureCubeArrayView&	texture, const Sampler& sampler, const LookupPrecision& prec, const IVec4& coordBits, const Vec4& coord, const Vec2& lodBounds, const Vec4& result, LookupVerifierStats* stats = DE_NULL);
 
 bool		isLevel1DLookupResultValid			(const ConstPixelBufferAccess& access, const Sampler& sampler, TexLookupScaleMode scaleMode, const LookupPrecision& prec, const float coordX, const int coordY, const Vec4& result);
 bool		isLevel1DLookupResultValid			(const ConstPixelBufferAccess& access, const Sampler& sampler, TexLookupScaleMode scaleMode, const IntLookupPrecision& prec, const float coordX, const int coordY, const IVec4& result);
@@ -150,6 +171,8 @@ bool		isGatherResultValid					(const TextureCubeView&		texture, const Sampler& s
 bool		isGatherResultValid					(const TextureCubeView&		texture, const Sampler& sampler, const IntLookupPrecision& prec,	const Vec3& coord, int componentNdx, const IVec4& result);
 bool		isGatherResultValid					(const TextureCubeView&		texture, const Sampler& sampler, const IntLookupPrecision& prec,	const Vec3& coord, int componentNdx, const UVec4& result);
 
+void		TexLookupVerifier_selfTest			(void);
+
 } // tcu
 
 #endif // _TCUTEXLOOKUPVERIFIER_HPP
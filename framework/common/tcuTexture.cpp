@@ -1121,6 +1121,181 @@ UVec4 ConstPixelBufferAccess::getPixelT (int x, int y, int z) const
 	return getPixelUint(x, y, z);
 }
 
+// Span accessors
+//
+// Format is resolved once per span and the pixel loop is instantiated for
+// each channel type, so that per-pixel format dispatch is eliminated.
+// Packed formats fall back to per-pixel access.
+
+//! Channel read layout: byte offset of source channel for each output component, or -1 for constant component.
+struct ChannelReadLayout
+{
+	int		offsets[4];
+	int		constants[4];
+
+	ChannelReadLayout (const TextureFormat& format)
+	{
+		const TextureSwizzle::Channel*	channelMap	= getChannelReadSwizzle(format.order).components;
+		const int						channelSize	= getChannelSize(format.type);
+
+		for (int c = 0; c < 4; c++)
+		{
+			if (de::inRange<int>(channelMap[c], TextureSwizzle::CHANNEL_0, TextureSwizzle::CHANNEL_3))
+			{
+				offsets[c]		= channelSize*(int)channelMap[c];
+				constants[c]	= 0;
+			}
+			else
+			{
+				DE_ASSERT(channelMap[c] == TextureSwizzle::CHANNEL_ZERO || channelMap[c] == TextureSwizzle::CHANNEL_ONE);
+				offsets[c]		= -1;
+				constants[c]	= (channelMap[c] == TextureSwizzle::CHANNEL_ONE) ? 1 : 0;
+			}
+		}
+	}
+};
+
+template<TextureFormat::ChannelType Type>
+struct ReadSpanFloatKernel
+{
+	static void exec (const ChannelReadLayout& layout, const deUint8* src, int pixelPitch, int numPixels, Vec4* dst)
+	{
+		for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+		{
+			const deUint8* const pixelPtr = src + pixelNdx*pixelPitch;
+
+			for (int c = 0; c < 4; c++)
+				dst[pixelNdx][c] = (layout.offsets[c] >= 0) ? channelToFloat(pixelPtr + layout.offsets[c], Type) : (float)layout.constants[c];
+		}
+	}
+};
+
+template<TextureFormat::ChannelType Type>
+struct ReadSpanIntKernel
+{
+	static void exec (const ChannelReadLayout& layout, const deUint8* src, int pixelPitch, int numPixels, IVec4* dst)
+	{
+		for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+		{
+			const deUint8* const pixelPtr = src + pixelNdx*pixelPitch;
+
+			for (int c = 0; c < 4; c++)
+				dst[pixelNdx][c] = (layout.offsets[c] >= 0) ? channelToInt(pixelPtr + layout.offsets[c], Type) : layout.constants[c];
+		}
+	}
+};
+
+//! Execute span kernel instantiated for channel type. Returns false if type is not supported (packed formats).
+template<template<TextureFormat::ChannelType> class Kernel, typename Layout, typename PtrType, typename ValueType>
+static bool execSpanKernel (const TextureFormat& format, PtrType ptr, int pixelPitch, int numPixels, ValueType* values)
+{
+	// make sure this table is updated if format table is updated
+	DE_STATIC_ASSERT(TextureFormat::CHANNELTYPE_LAST == 38);
+
+	switch (format.type)
+	{
+		case TextureFormat::SNORM_INT8:		Kernel<TextureFormat::SNORM_INT8>::exec		(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::SNORM_INT16:	Kernel<TextureFormat::SNORM_INT16>::exec	(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::SNORM_INT32:	Kernel<TextureFormat::SNORM_INT32>::exec	(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::UNORM_INT8:		Kernel<TextureFormat::UNORM_INT8>::exec		(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::UNORM_INT16:	Kernel<TextureFormat::UNORM_INT16>::exec	(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::UNORM_INT24:	Kernel<TextureFormat::UNORM_INT24>::exec	(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::UNORM_INT32:	Kernel<TextureFormat::UNORM_INT32>::exec	(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::SIGNED_INT8:	Kernel<TextureFormat::SIGNED_INT8>::exec	(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::SIGNED_INT16:	Kernel<TextureFormat::SIGNED_INT16>::exec	(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::SIGNED_INT32:	Kernel<TextureFormat::SIGNED_INT32>::exec	(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::UNSIGNED_INT8:	Kernel<TextureFormat::UNSIGNED_INT8>::exec	(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::UNSIGNED_INT16:	Kernel<TextureFormat::UNSIGNED_INT16>::exec	(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::UNSIGNED_INT24:	Kernel<TextureFormat::UNSIGNED_INT24>::exec	(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::UNSIGNED_INT32:	Kernel<TextureFormat::UNSIGNED_INT32>::exec	(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::HALF_FLOAT:		Kernel<TextureFormat::HALF_FLOAT>::exec		(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::FLOAT:			Kernel<TextureFormat::FLOAT>::exec			(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		case TextureFormat::FLOAT64:		Kernel<TextureFormat::FLOAT64>::exec		(Layout(format), ptr, pixelPitch, numPixels, values);	return true;
+		default:
+			return false;
+	}
+}
+
+void ConstPixelBufferAccess::getPixels (Vec4* dst, int numPixels, int x, int y, int z) const
+{
+	DE_ASSERT(numPixels >= 0);
+	DE_ASSERT(numPixels == 0 || (de::inBounds(x, 0, m_size.x()) && de::inRange(x + numPixels, 0, m_size.x())));
+	DE_ASSERT(de::inBounds(y, 0, m_size.y()));
+	DE_ASSERT(de::inBounds(z, 0, m_size.z()));
+	DE_ASSERT(!isCombinedDepthStencilType(m_format.type)); // combined types cannot be accessed directly
+	DE_ASSERT(m_format.order != TextureFormat::DS); // combined formats cannot be accessed directly
+
+	const deUint8* const	basePtr		= (const deUint8*)getPixelPtr(x, y, z);
+	const int				pixelPitch	= m_pitch.x();
+
+	if (numPixels == 0)
+		return;
+
+	// Optimized formats.
+	if (m_format.type == TextureFormat::UNORM_INT8)
+	{
+		if (m_format.order == TextureFormat::RGBA || m_format.order == TextureFormat::sRGBA)
+		{
+			for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+				dst[pixelNdx] = readRGBA8888Float(basePtr + pixelNdx*pixelPitch);
+			return;
+		}
+		else if (m_format.order == TextureFormat::RGB || m_format.order == TextureFormat::sRGB)
+		{
+			for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+				dst[pixelNdx] = readRGB888Float(basePtr + pixelNdx*pixelPitch);
+			return;
+		}
+	}
+
+	if (execSpanKernel<ReadSpanFloatKernel, ChannelReadLayout>(m_format, basePtr, pixelPitch, numPixels, dst))
+		return;
+
+	// Packed formats.
+	for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+		dst[pixelNdx] = getPixel(x + pixelNdx, y, z);
+}
+
+void ConstPixelBufferAccess::getPixelsInt (IVec4* dst, int numPixels, int x, int y, int z) const
+{
+	DE_ASSERT(numPixels >= 0);
+	DE_ASSERT(numPixels == 0 || (de::inBounds(x, 0, m_size.x()) && de::inRange(x + numPixels, 0, m_size.x())));
+	DE_ASSERT(de::inBounds(y, 0, m_size.y()));
+	DE_ASSERT(de::inBounds(z, 0, m_size.z()));
+	DE_ASSERT(!isCombinedDepthStencilType(m_format.type)); // combined types cannot be accessed directly
+	DE_ASSERT(m_format.order != TextureFormat::DS); // combined formats cannot be accessed directly
+
+	const deUint8* const	basePtr		= (const deUint8*)getPixelPtr(x, y, z);
+	const int				pixelPitch	= m_pitch.x();
+
+	if (numPixels == 0)
+		return;
+
+	// Optimized formats.
+	if (m_format.type == TextureFormat::UNORM_INT8)
+	{
+		if (m_format.order == TextureFormat::RGBA || m_format.order == TextureFormat::sRGBA)
+		{
+			for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+				dst[pixelNdx] = readRGBA8888Int(basePtr + pixelNdx*pixelPitch);
+			return;
+		}
+		else if (m_format.order == TextureFormat::RGB || m_format.order == TextureFormat::sRGB)
+		{
+			for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+				dst[pixelNdx] = readRGB888Int(basePtr + pixelNdx*pixelPitch);
+			return;
+		}
+	}
+
+	if (execSpanKernel<ReadSpanIntKernel, ChannelReadLayout>(m_format, basePtr, pixelPitch, numPixels, dst))
+		return;
+
+	// Packed formats.
+	for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+		dst[pixelNdx] = getPixelInt(x + pixelNdx, y, z);
+}
+
 float ConstPixelBufferAccess::getPixDepth (int x, int y, int z) const
 {
 	DE_ASSERT(de::inBounds(x, 0, getWidth()));
@@ -1442,6 +1617,139 @@ void PixelBufferAccess::setPixel (const IVec4& color, int x, int y, int z) const
 #undef PI
 }
 
+//! Channel write layout: source component for each stored channel.
+struct ChannelWriteLayout
+{
+	int		numChannels;
+	int		channelSize;
+	int		components[4];
+
+	ChannelWriteLayout (const TextureFormat& format)
+		: numChannels	(getNumUsedChannels(format.order))
+		, channelSize	(getChannelSize(format.type))
+	{
+		const TextureSwizzle::Channel* map = getChannelWriteSwizzle(format.order).components;
+
+		for (int c = 0; c < numChannels; c++)
+		{
+			DE_ASSERT(deInRange32(map[c], TextureSwizzle::CHANNEL_0, TextureSwizzle::CHANNEL_3));
+			components[c] = (int)map[c];
+		}
+	}
+};
+
+template<TextureFormat::ChannelType Type>
+struct WriteSpanFloatKernel
+{
+	static void exec (const ChannelWriteLayout& layout, deUint8* dst, int pixelPitch, int numPixels, const Vec4* src)
+	{
+		for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+		{
+			deUint8* const pixelPtr = dst + pixelNdx*pixelPitch;
+
+			for (int c = 0; c < layout.numChannels; c++)
+				floatToChannel(pixelPtr + layout.channelSize*c, src[pixelNdx][layout.components[c]], Type);
+		}
+	}
+};
+
+template<TextureFormat::ChannelType Type>
+struct WriteSpanIntKernel
+{
+	static void exec (const ChannelWriteLayout& layout, deUint8* dst, int pixelPitch, int numPixels, const IVec4* src)
+	{
+		for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+		{
+			deUint8* const pixelPtr = dst + pixelNdx*pixelPitch;
+
+			for (int c = 0; c < layout.numChannels; c++)
+				intToChannel(pixelPtr + layout.channelSize*c, src[pixelNdx][layout.components[c]], Type);
+		}
+	}
+};
+
+void PixelBufferAccess::setPixels (const Vec4* colors, int numPixels, int x, int y, int z) const
+{
+	DE_ASSERT(numPixels >= 0);
+	DE_ASSERT(numPixels == 0 || (de::inBounds(x, 0, getWidth()) && de::inRange(x + numPixels, 0, getWidth())));
+	DE_ASSERT(de::inBounds(y, 0, getHeight()));
+	DE_ASSERT(de::inBounds(z, 0, getDepth()));
+	DE_ASSERT(!isCombinedDepthStencilType(m_format.type)); // combined types cannot be accessed directly
+	DE_ASSERT(m_format.order != TextureFormat::DS); // combined formats cannot be accessed directly
+
+	deUint8* const	basePtr		= (deUint8*)getPixelPtr(x, y, z);
+	const int		pixelPitch	= m_pitch.x();
+
+	if (numPixels == 0)
+		return;
+
+	// Optimized formats.
+	if (m_format.type == TextureFormat::UNORM_INT8)
+	{
+		if (m_format.order == TextureFormat::RGBA || m_format.order == TextureFormat::sRGBA)
+		{
+			for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+				writeRGBA8888Float(basePtr + pixelNdx*pixelPitch, colors[pixelNdx]);
+			return;
+		}
+		else if (m_format.order == TextureFormat::RGB || m_format.order == TextureFormat::sRGB)
+		{
+			for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+				writeRGB888Float(basePtr + pixelNdx*pixelPitch, colors[pixelNdx]);
+			return;
+		}
+	}
+
+	if (execSpanKernel<WriteSpanFloatKernel, ChannelWriteLayout>(m_format, basePtr, pixelPitch, numPixels, colors))
+		return;
+
+	// Packed formats.
+	for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+		setPixel(colors[pixelNdx], x + pixelNdx, y, z);
+}
+
+void PixelBufferAccess::setPixels (const IVec4* colors, int numPixels, int x, int y, int z) const
+{
+	DE_ASSERT(numPixels >= 0);
+	DE_ASSERT(numPixels == 0 || (de::inBounds(x, 0, getWidth()) && de::inRange(x + numPixels, 0, getWidth())));
+	DE_ASSERT(de::inBounds(y, 0, getHeight()));
+	DE_ASSERT(de::inBounds(z, 0, getDepth()));
+	DE_ASSERT(!isCombinedDepthStencilType(m_format.type)); // combined types cannot be accessed directly
+	DE_ASSERT(m_format.order != TextureFormat::DS); // combined formats cannot be accessed directly
+
+	deUint8* const	basePtr		= (deUint8*)getPixelPtr(x, y, z);
+	const int		pixelPitch	= m_pitch.x();
+
+	if (numPixels == 0)
+		return;
+
+	// Optimized formats.
+	if (m_format.type == TextureFormat::UNORM_INT8)
+	{
+		if (m_format.order == TextureFormat::RGBA || m_format.order == TextureFormat::sRGBA)
+		{
+			for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+				writeRGBA8888Int(basePtr + pixelNdx*pixelPitch, colors[pixelNdx]);
+			return;
+		}
+		else if (m_format.order == TextureFormat::RGB || m_format.order == TextureFormat::sRGB)
+		{
+			for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+				writeRGB888Int(basePtr + pixelNdx*pixelPitch, colors[pixelNdx]);
+			return;
+		}
+	}
+
+	// \note intToChannel() does not support SNORM_INT32 and UNORM_INT32
+	if (m_format.type != TextureFormat::SNORM_INT32 && m_format.type != TextureFormat::UNORM_INT32 &&
+		execSpanKernel<WriteSpanIntKernel, ChannelWriteLayout>(m_format, basePtr, pixelPitch, numPixels, colors))
+		return;
+
+	// Packed formats.
+	for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+		setPixel(colors[pixelNdx], x + pixelNdx, y, z);
+}
+
 void PixelBufferAccess::setPixDepth (float depth, int x, int y, int z) const
 {
 	DE_ASSERT(de::inBounds(x, 0, getWidth()));
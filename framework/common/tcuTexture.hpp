@@ -344,6 +344,10 @@ public:
 	template<typename T>
 	Vector<T, 4>			getPixelT					(int x, int y, int z = 0) const;
 
+	// Read numPixels consecutive pixels starting from (x, y, z). Results are identical to getPixel() / getPixelInt().
+	void					getPixels					(Vec4* dst, int numPixels, int x, int y, int z = 0) const;
+	void					getPixelsInt				(IVec4* dst, int numPixels, int x, int y, int z = 0) const;
+
 	float					getPixDepth					(int x, int y, int z = 0) const;
 	int						getPixStencil				(int x, int y, int z = 0) const;
 
@@ -391,6 +395,10 @@ public:
 	void				setPixel			(const tcu::IVec4& color, int x, int y, int z = 0) const;
 	void				setPixel			(const tcu::UVec4& color, int x, int y, int z = 0) const { setPixel(color.cast<int>(), x, y, z); }
 
+	// Write numPixels consecutive pixels starting from (x, y, z). Results are identical to setPixel().
+	void				setPixels			(const tcu::Vec4* colors, int numPixels, int x, int y, int z = 0) const;
+	void				setPixels			(const tcu::IVec4* colors, int numPixels, int x, int y, int z = 0) const;
+
 	void				setPixDepth			(float depth, int x, int y, int z = 0) const;
 	void				setPixStencil		(int stencil, int x, int y, int z = 0) const;
 } DE_WARN_UNUSED_TYPE;
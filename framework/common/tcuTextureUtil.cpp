@@ -1081,19 +1081,30 @@ void copy (const PixelBufferAccess& dst, const ConstPixelBufferAccess& src)
 		bool					srcIsInt	= srcClass == TEXTURECHANNELCLASS_SIGNED_INTEGER || srcClass == TEXTURECHANNELCLASS_UNSIGNED_INTEGER;
 		bool					dstIsInt	= dstClass == TEXTURECHANNELCLASS_SIGNED_INTEGER || dstClass == TEXTURECHANNELCLASS_UNSIGNED_INTEGER;
 
+		if (width == 0)
+			return;
+
 		if (srcIsInt && dstIsInt)
 		{
+			std::vector<IVec4> row (width);
+
 			for (int z = 0; z < depth; z++)
 			for (int y = 0; y < height; y++)
-			for (int x = 0; x < width; x++)
-				dst.setPixel(src.getPixelInt(x, y, z), x, y, z);
+			{
+				src.getPixelsInt(&row[0], width, 0, y, z);
+				dst.setPixels(&row[0], width, 0, y, z);
+			}
 		}
 		else
 		{
+			std::vector<Vec4> row (width);
+
 			for (int z = 0; z < depth; z++)
 			for (int y = 0; y < height; y++)
-			for (int x = 0; x < width; x++)
-				dst.setPixel(src.getPixel(x, y, z), x, y, z);
+			{
+				src.getPixels(&row[0], width, 0, y, z);
+				dst.setPixels(&row[0], width, 0, y, z);
+			}
 		}
 	}
 }
@@ -41,6 +41,8 @@ public:
 	static Sha1	parse		(const std::string& str);
 	static Sha1	compute		(size_t size, const void* data);
 
+	std::string	toString	(void) const;
+
 	bool		operator==	(const Sha1& other) const { return deSha1_equal(&m_hash, &other.m_hash) == DE_TRUE; }
 	bool		operator!=	(const Sha1& other) const { return !(*this == other); }
 
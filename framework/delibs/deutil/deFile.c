@@ -112,6 +112,11 @@ void deFile_destroy (deFile* file)
 	deFree(file);
 }
 
+deUintptr deFile_getHandle (const deFile* file)
+{
+	return (deUintptr)file->fd;
+}
+
 deBool deFile_setFlags (deFile* file, deUint32 flags)
 {
 	/* Non-blocking. */
@@ -297,6 +302,11 @@ void deFile_destroy (deFile* file)
 	deFree(file);
 }
 
+deUintptr deFile_getHandle (const deFile* file)
+{
+	return (deUintptr)file->handle;
+}
+
 deBool deFile_setFlags (deFile* file, deUint32 flags)
 {
 	/* Non-blocking. */
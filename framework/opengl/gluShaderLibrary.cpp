@@ -30,12 +30,19 @@
 #include "deStringUtil.hpp"
 #include "deUniquePtr.hpp"
 #include "deFilePath.hpp"
+#include "deSha1.hpp"
+#include "deClock.h"
+#include "deFile.h"
+
+#include "qpInfo.h"
 
 #include "glwEnums.hpp"
 
 #include <sstream>
 #include <map>
 #include <cstdlib>
+#include <cstdio>
+#include <fstream>
 
 #if 0
 #	define PARSE_DBG(X) printf X
@@ -1664,6 +1671,606 @@ std::vector<tcu::TestNode*> parseFile (const tcu::Archive& archive, const std::s
 	return parser.parse();
 }
 
+// Parsed file cache
+
+namespace
+{
+
+enum
+{
+	CACHE_MAGIC		= 0x31434c73,	//!< "sLC1"
+	CACHE_VERSION	= 1
+};
+
+//! Factory call recorded while parsing, replayed in order on cache hit.
+struct CacheRecord
+{
+	enum Type
+	{
+		TYPE_CASE = 0,
+		TYPE_GROUP,
+
+		TYPE_LAST
+	};
+
+	Type						type;
+	string						name;
+	string						description;
+	int							numChildren;	//!< Groups only, children are the preceding numChildren top-level nodes.
+	ShaderCaseSpecification		spec;			//!< Cases only.
+
+	CacheRecord (void)
+		: type			(TYPE_LAST)
+		, numChildren	(0)
+	{
+	}
+};
+
+class RecordingFactory : public ShaderCaseFactory
+{
+public:
+	RecordingFactory (ShaderCaseFactory& factory, vector<CacheRecord>& records)
+		: m_factory	(factory)
+		, m_records	(records)
+	{
+	}
+
+	tcu::TestCaseGroup* createGroup (const string& name, const string& description, const vector<tcu::TestNode*>& children)
+	{
+		tcu::TestCaseGroup* const group = m_factory.createGroup(name, description, children);
+
+		m_records.push_back(CacheRecord());
+		m_records.back().type			= CacheRecord::TYPE_GROUP;
+		m_records.back().name			= name;
+		m_records.back().description	= description;
+		m_records.back().numChildren	= (int)children.size();
+
+		return group;
+	}
+
+	tcu::TestCase* createCase (const string& name, const string& description, const ShaderCaseSpecification& spec)
+	{
+		tcu::TestCase* const testCase = m_factory.createCase(name, description, spec);
+
+		m_records.push_back(CacheRecord());
+		m_records.back().type			= CacheRecord::TYPE_CASE;
+		m_records.back().name			= name;
+		m_records.back().description	= description;
+		m_records.back().spec			= spec;
+
+		return testCase;
+	}
+
+private:
+	ShaderCaseFactory&		m_factory;
+	vector<CacheRecord>&	m_records;
+};
+
+//! Archive wrapper collecting names of all opened resources, i.e. the file and its imports.
+class RecordingArchive : public tcu::Archive
+{
+public:
+	RecordingArchive (const tcu::Archive& archive)
+		: m_archive(archive)
+	{
+	}
+
+	tcu::Resource* getResource (const char* name) const
+	{
+		m_names.push_back(name);
+		return m_archive.getResource(name);
+	}
+
+	const vector<string>& getNames (void) const { return m_names; }
+
+private:
+	const tcu::Archive&		m_archive;
+	mutable vector<string>	m_names;
+};
+
+class CacheWriter
+{
+public:
+	void writeU32 (deUint32 value)
+	{
+		for (int byteNdx = 0; byteNdx < 4; byteNdx++)
+			m_data.push_back((deUint8)(value >> (8*byteNdx)));
+	}
+
+	void writeBool (bool value)
+	{
+		m_data.push_back(value ? 1u : 0u);
+	}
+
+	void writeString (const string& str)
+	{
+		writeU32((deUint32)str.size());
+		m_data.insert(m_data.end(), str.begin(), str.end());
+	}
+
+	void writeStrings (const vector<string>& strings)
+	{
+		writeU32((deUint32)strings.size());
+		for (vector<string>::const_iterator str = strings.begin(); str != strings.end(); ++str)
+			writeString(*str);
+	}
+
+	const vector<deUint8>& getData (void) const { return m_data; }
+
+private:
+	vector<deUint8>		m_data;
+};
+
+class CacheReader
+{
+public:
+	CacheReader (const vector<deUint8>& data)
+		: m_data	(data)
+		, m_pos		(0)
+	{
+	}
+
+	deUint32 readU32 (void)
+	{
+		deUint32 value = 0;
+
+		require(4);
+		for (int byteNdx = 0; byteNdx < 4; byteNdx++)
+			value |= (deUint32)m_data[m_pos++] << (8*byteNdx);
+
+		return value;
+	}
+
+	//! Read enum value, value must be less than numValues.
+	deUint32 readEnum (deUint32 numValues)
+	{
+		const deUint32 value = readU32();
+
+		if (value >= numValues)
+			throw tcu::Exception("Invalid enum value");
+
+		return value;
+	}
+
+	//! Read element count, each element is assumed to take at least one byte.
+	size_t readCount (void)
+	{
+		const deUint32 count = readU32();
+
+		require((size_t)count);
+		return (size_t)count;
+	}
+
+	bool readBool (void)
+	{
+		require(1);
+		return m_data[m_pos++] != 0;
+	}
+
+	void readString (string& dst)
+	{
+		const size_t length = readCount();
+
+		dst.assign((const char*)&m_data[m_pos], length);
+		m_pos += length;
+	}
+
+	void readStrings (vector<string>& dst)
+	{
+		dst.resize(readCount());
+		for (vector<string>::iterator str = dst.begin(); str != dst.end(); ++str)
+			readString(*str);
+	}
+
+	bool isAtEnd (void) const { return m_pos == m_data.size(); }
+
+private:
+	void require (size_t numBytes) const
+	{
+		if (m_data.size() - m_pos < numBytes)
+			throw tcu::Exception("Unexpected end of cache entry");
+	}
+
+	const vector<deUint8>&	m_data;
+	size_t					m_pos;
+};
+
+void writeValues (CacheWriter& writer, const vector<Value>& values)
+{
+	writer.writeU32((deUint32)values.size());
+
+	for (vector<Value>::const_iterator value = values.begin(); value != values.end(); ++value)
+	{
+		// \note Parser only produces basic types without precision.
+		DE_ASSERT(value->type.isBasicType() && value->type.getPrecision() == PRECISION_LAST);
+
+		writer.writeU32((deUint32)value->type.getBasicType());
+		writer.writeString(value->name);
+		writer.writeU32((deUint32)value->elements.size());
+
+		for (vector<Value::Element>::const_iterator element = value->elements.begin(); element != value->elements.end(); ++element)
+			writer.writeU32((deUint32)element->int32);
+	}
+}
+
+void readValues (CacheReader& reader, vector<Value>& values)
+{
+	values.resize(reader.readCount());
+
+	for (vector<Value>::iterator value = values.begin(); value != values.end(); ++value)
+	{
+		value->type = VarType((DataType)reader.readEnum(TYPE_LAST), PRECISION_LAST);
+		reader.readString(value->name);
+		value->elements.resize(reader.readCount());
+
+		for (vector<Value::Element>::iterator element = value->elements.begin(); element != value->elements.end(); ++element)
+			element->int32 = (deInt32)reader.readU32();
+	}
+}
+
+void writeProgram (CacheWriter& writer, const ProgramSpecification& program)
+{
+	const ProgramSources& sources = program.sources;
+
+	for (int shaderType = 0; shaderType < SHADERTYPE_LAST; shaderType++)
+		writer.writeStrings(sources.sources[shaderType]);
+
+	writer.writeU32((deUint32)sources.attribLocationBindings.size());
+	for (vector<AttribLocationBinding>::const_iterator binding = sources.attribLocationBindings.begin(); binding != sources.attribLocationBindings.end(); ++binding)
+	{
+		writer.writeString(binding->name);
+		writer.writeU32(binding->location);
+	}
+
+	writer.writeU32(sources.transformFeedbackBufferMode);
+	writer.writeStrings(sources.transformFeedbackVaryings);
+	writer.writeBool(sources.separable);
+
+	writer.writeU32((deUint32)program.requiredExtensions.size());
+	for (vector<RequiredExtension>::const_iterator extension = program.requiredExtensions.begin(); extension != program.requiredExtensions.end(); ++extension)
+	{
+		writer.writeStrings(extension->alternatives);
+		writer.writeU32(extension->effectiveStages);
+	}
+
+	writer.writeU32(program.activeStages);
+}
+
+void readProgram (CacheReader& reader, ProgramSpecification& program)
+{
+	ProgramSources& sources = program.sources;
+
+	for (int shaderType = 0; shaderType < SHADERTYPE_LAST; shaderType++)
+		reader.readStrings(sources.sources[shaderType]);
+
+	sources.attribLocationBindings.resize(reader.readCount());
+	for (vector<AttribLocationBinding>::iterator binding = sources.attribLocationBindings.begin(); binding != sources.attribLocationBindings.end(); ++binding)
+	{
+		reader.readString(binding->name);
+		binding->location = reader.readU32();
+	}
+
+	sources.transformFeedbackBufferMode = reader.readU32();
+	reader.readStrings(sources.transformFeedbackVaryings);
+	sources.separable = reader.readBool();
+
+	program.requiredExtensions.resize(reader.readCount());
+	for (vector<RequiredExtension>::iterator extension = program.requiredExtensions.begin(); extension != program.requiredExtensions.end(); ++extension)
+	{
+		reader.readStrings(extension->alternatives);
+		extension->effectiveStages = reader.readU32();
+	}
+
+	program.activeStages = reader.readU32();
+}
+
+void writeSpec (CacheWriter& writer, const ShaderCaseSpecification& spec)
+{
+	writer.writeU32((deUint32)spec.caseType);
+	writer.writeU32((deUint32)spec.expectResult);
+	writer.writeU32((deUint32)spec.targetVersion);
+
+	writer.writeU32((deUint32)spec.requiredCaps.size());
+	for (vector<RequiredCapability>::const_iterator cap = spec.requiredCaps.begin(); cap != spec.requiredCaps.end(); ++cap)
+	{
+		writer.writeU32(cap->enumName);
+		writer.writeU32((deUint32)cap->referenceValue);
+	}
+
+	writer.writeBool(spec.fullGLSLES100Required);
+
+	writeValues(writer, spec.values.inputs);
+	writeValues(writer, spec.values.outputs);
+	writeValues(writer, spec.values.uniforms);
+
+	writer.writeU32((deUint32)spec.programs.size());
+	for (vector<ProgramSpecification>::const_iterator program = spec.programs.begin(); program != spec.programs.end(); ++program)
+		writeProgram(writer, *program);
+}
+
+void readSpec (CacheReader& reader, ShaderCaseSpecification& spec)
+{
+	spec.caseType		= (CaseType)reader.readEnum(CASETYPE_LAST);
+	spec.expectResult	= (ExpectResult)reader.readEnum(EXPECT_LAST);
+	spec.targetVersion	= (GLSLVersion)reader.readEnum(GLSL_VERSION_LAST);
+
+	spec.requiredCaps.resize(reader.readCount());
+	for (vector<RequiredCapability>::iterator cap = spec.requiredCaps.begin(); cap != spec.requiredCaps.end(); ++cap)
+	{
+		cap->enumName		= reader.readU32();
+		cap->referenceValue	= (int)reader.readU32();
+	}
+
+	spec.fullGLSLES100Required = reader.readBool();
+
+	readValues(reader, spec.values.inputs);
+	readValues(reader, spec.values.outputs);
+	readValues(reader, spec.values.uniforms);
+
+	spec.programs.resize(reader.readCount());
+	for (vector<ProgramSpecification>::iterator program = spec.programs.begin(); program != spec.programs.end(); ++program)
+		readProgram(reader, *program);
+}
+
+vector<deUint8> readResource (const tcu::Archive& archive, const string& filename)
+{
+	const UniquePtr<tcu::Resource>	resource	(archive.getResource(filename.c_str()));
+	vector<deUint8>					data		((size_t)resource->getSize());
+
+	resource->setPosition(0);
+
+	if (!data.empty())
+		resource->read(&data[0], (int)data.size());
+
+	return data;
+}
+
+de::Sha1 hashResource (const tcu::Archive& archive, const string& filename)
+{
+	const vector<deUint8> data = readResource(archive, filename);
+
+	return de::Sha1::compute(data.size(), data.empty() ? DE_NULL : &data[0]);
+}
+
+//! Cache entry is keyed by release and contents of the top-level file.
+string getCacheEntryPath (const tcu::Archive& archive, const string& filename, const string& cacheDir)
+{
+	const vector<deUint8>	data	= readResource(archive, filename);
+	de::Sha1Stream			stream;
+
+	stream << string(qpGetReleaseName()) << filename;
+
+	if (!data.empty())
+		stream.process(data.size(), &data[0]);
+
+	return de::FilePath::join(cacheDir, stream.finalize().toString() + ".slc").getPath();
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Load records from cache entry
+ *
+ * Returns false if entry doesn't exist, is malformed or any of the files
+ * imported by filename have changed.
+ *//*--------------------------------------------------------------------*/
+bool loadCacheEntry (const tcu::Archive& archive, const string& entryPath, const string& filename, vector<CacheRecord>& records)
+{
+	vector<deUint8> data;
+
+	{
+		std::ifstream in (entryPath.c_str(), std::ios_base::binary);
+
+		if (!in.is_open())
+			return false;
+
+		in.seekg(0, std::ios_base::end);
+		data.resize((size_t)in.tellg());
+		in.seekg(0, std::ios_base::beg);
+
+		if (!data.empty())
+			in.read((char*)&data[0], (std::streamsize)data.size());
+
+		if (!in.good())
+			return false;
+	}
+
+	try
+	{
+		CacheReader	reader		(data);
+		string		entryFilename;
+		int			numNodes	= 0;
+
+		if (reader.readU32() != CACHE_MAGIC || reader.readU32() != CACHE_VERSION)
+			return false;
+
+		reader.readString(entryFilename);
+
+		if (entryFilename != filename)
+			return false;
+
+		// Imported files are not part of the key, compare their hashes.
+		{
+			const size_t numImports = reader.readCount();
+
+			for (size_t importNdx = 0; importNdx < numImports; importNdx++)
+			{
+				string importName;
+				string importHash;
+
+				reader.readString(importName);
+				reader.readString(importHash);
+
+				if (hashResource(archive, importName).toString() != importHash)
+					return false;
+			}
+		}
+
+		records.resize(reader.readCount());
+
+		for (vector<CacheRecord>::iterator record = records.begin(); record != records.end(); ++record)
+		{
+			record->type = (CacheRecord::Type)reader.readEnum(CacheRecord::TYPE_LAST);
+			reader.readString(record->name);
+			reader.readString(record->description);
+
+			if (record->type == CacheRecord::TYPE_GROUP)
+			{
+				record->numChildren = (int)reader.readU32();
+
+				if (record->numChildren < 0 || record->numChildren > numNodes)
+					return false;
+
+				numNodes -= record->numChildren;
+			}
+			else
+				readSpec(reader, record->spec);
+
+			numNodes += 1;
+		}
+
+		return reader.isAtEnd();
+	}
+	catch (const tcu::Exception&)
+	{
+		// Malformed entry or missing import
+		return false;
+	}
+}
+
+//! Write cache entry, failures are ignored.
+void storeCacheEntry (const tcu::Archive& archive, const string& entryPath, const string& filename, const vector<string>& sourceNames, const vector<CacheRecord>& records)
+{
+	CacheWriter writer;
+
+	writer.writeU32(CACHE_MAGIC);
+	writer.writeU32(CACHE_VERSION);
+	writer.writeString(filename);
+
+	DE_ASSERT(!sourceNames.empty() && sourceNames[0] == filename);
+
+	writer.writeU32((deUint32)sourceNames.size()-1u);
+	for (size_t sourceNdx = 1; sourceNdx < sourceNames.size(); sourceNdx++)
+	{
+		writer.writeString(sourceNames[sourceNdx]);
+		writer.writeString(hashResource(archive, sourceNames[sourceNdx]).toString());
+	}
+
+	writer.writeU32((deUint32)records.size());
+	for (vector<CacheRecord>::const_iterator record = records.begin(); record != records.end(); ++record)
+	{
+		writer.writeU32((deUint32)record->type);
+		writer.writeString(record->name);
+		writer.writeString(record->description);
+
+		if (record->type == CacheRecord::TYPE_GROUP)
+			writer.writeU32((deUint32)record->numChildren);
+		else
+			writeSpec(writer, record->spec);
+	}
+
+	{
+		const vector<deUint8>&	data	= writer.getData();
+		const string			tmpPath	= entryPath + "." + de::toString(deGetMicroseconds()) + ".tmp";
+
+		{
+			std::ofstream out (tmpPath.c_str(), std::ios_base::binary);
+
+			if (!out.is_open())
+				return;
+
+			out.write((const char*)&data[0], (std::streamsize)data.size());
+
+			if (!out.good())
+			{
+				out.close();
+				deDeleteFile(tmpPath.c_str());
+				return;
+			}
+		}
+
+		// \note Another process may have stored the same entry already.
+		if (std::rename(tmpPath.c_str(), entryPath.c_str()) != 0)
+			deDeleteFile(tmpPath.c_str());
+	}
+}
+
+vector<tcu::TestNode*> replayRecords (const vector<CacheRecord>& records, ShaderCaseFactory* caseFactory)
+{
+	vector<tcu::TestNode*> nodes;
+
+	try
+	{
+		for (vector<CacheRecord>::const_iterator record = records.begin(); record != records.end(); ++record)
+		{
+			if (record->type == CacheRecord::TYPE_GROUP)
+			{
+				const vector<tcu::TestNode*> children (nodes.end() - record->numChildren, nodes.end());
+
+				nodes.resize(nodes.size() - children.size());
+
+				try
+				{
+					nodes.push_back(caseFactory->createGroup(record->name, record->description, children));
+				}
+				catch (...)
+				{
+					nodes.insert(nodes.end(), children.begin(), children.end());
+					throw;
+				}
+			}
+			else
+				nodes.push_back(caseFactory->createCase(record->name, record->description, record->spec));
+		}
+	}
+	catch (...)
+	{
+		for (size_t nodeNdx = 0; nodeNdx < nodes.size(); nodeNdx++)
+			delete nodes[nodeNdx];
+		throw;
+	}
+
+	return nodes;
+}
+
+} // anonymous
+
+std::vector<tcu::TestNode*> parseFile (const tcu::Archive& archive, const std::string& filename, ShaderCaseFactory* caseFactory, const char* cacheDir)
+{
+	if (!cacheDir)
+		return parseFile(archive, filename, caseFactory);
+
+	if (!de::FilePath(cacheDir).exists())
+		de::createDirectoryAndParents(cacheDir);
+
+	{
+		const string		entryPath	= getCacheEntryPath(archive, filename, cacheDir);
+		vector<CacheRecord>	records;
+
+		if (loadCacheEntry(archive, entryPath, filename, records))
+			return replayRecords(records, caseFactory);
+
+		records.clear();
+
+		{
+			RecordingArchive				recordingArchive	(archive);
+			RecordingFactory				recordingFactory	(*caseFactory, records);
+			const vector<tcu::TestNode*>	nodes				= parseFile(recordingArchive, filename, &recordingFactory);
+
+			try
+			{
+				storeCacheEntry(archive, entryPath, filename, recordingArchive.getNames(), records);
+			}
+			catch (...)
+			{
+				for (size_t nodeNdx = 0; nodeNdx < nodes.size(); nodeNdx++)
+					delete nodes[nodeNdx];
+				throw;
+			}
+
+			return nodes;
+		}
+	}
+}
+
 // Execution utilities
 
 static void dumpValue (tcu::TestLog& log, const Value& val, const char* storageName, int arrayNdx)
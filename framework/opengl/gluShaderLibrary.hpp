@@ -167,6 +167,17 @@ public:
 
 std::vector<tcu::TestNode*>		parseFile	(const tcu::Archive& archive, const std::string& filename, ShaderCaseFactory* caseFactory);
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Parse file using on-disk cache of parsed files
+ *
+ * Parsed groups and case specifications are stored into cacheDir, keyed by
+ * release name, file name and file contents. Imported files are validated
+ * by their hashes. On a cache hit cases are created from stored
+ * specifications without tokenizing the file. If cacheDir is DE_NULL
+ * this is equivalent to parseFile() without cache.
+ *//*--------------------------------------------------------------------*/
+std::vector<tcu::TestNode*>		parseFile	(const tcu::Archive& archive, const std::string& filename, ShaderCaseFactory* caseFactory, const char* cacheDir);
+
 // Specialization utilties
 
 struct ProgramSpecializationParams
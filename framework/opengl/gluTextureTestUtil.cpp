@@ -27,6 +27,7 @@
 
 #include "tcuFloat.hpp"
 #include "tcuImageCompare.hpp"
+#include "tcuParallelRows.hpp"
 #include "tcuTestLog.hpp"
 #include "tcuVectorUtil.hpp"
 
@@ -1221,16 +1222,219 @@ void computeQuadTexCoordCubeArray (std::vector<float>& dst, tcu::CubeFace face,
 
 // Texture result verification
 
-//! Verifies texture lookup results and returns number of failed pixels.
-int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
+namespace
+{
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Row band task running a row verifier
+ *
+ * Failed pixel counts and lookup verifier stats are stored per band and
+ * summed in band order, and each band only writes its own rows of the
+ * error mask, so results do not depend on the number of bands.
+ *//*--------------------------------------------------------------------*/
+template<typename RowVerifier>
+class VerifyRowBandsTask : public tcu::RowBandTask
+{
+public:
+	VerifyRowBandsTask (const RowVerifier& verifier, int numBands)
+		: m_verifier		(verifier)
+		, m_bandNumFailed	(numBands, 0)
+		, m_bandStats		(numBands)
+	{
+	}
+
+	void processRows (int bandNdx, int rowBegin, int rowEnd)
+	{
+		m_bandNumFailed[bandNdx] = m_verifier.verifyRows(rowBegin, rowEnd, &m_bandStats[bandNdx]);
+	}
+
+	int getNumFailed (void) const
+	{
+		int numFailed = 0;
+		for (size_t bandNdx = 0; bandNdx < m_bandNumFailed.size(); bandNdx++)
+			numFailed += m_bandNumFailed[bandNdx];
+		return numFailed;
+	}
+
+	void addStats (tcu::LookupVerifierStats& dst) const
+	{
+		for (size_t bandNdx = 0; bandNdx < m_bandStats.size(); bandNdx++)
+		{
+			dst.numReferenceMatches	+= m_bandStats[bandNdx].numReferenceMatches;
+			dst.numSearched			+= m_bandStats[bandNdx].numSearched;
+		}
+	}
+
+private:
+	const RowVerifier&						m_verifier;
+	std::vector<int>						m_bandNumFailed;
+	std::vector<tcu::LookupVerifierStats>	m_bandStats;
+};
+
+//! Clear error mask and verify all rows in bands using up to getImageCompareNumThreads() threads. Lookup verifier stats are added to stats if given.
+template<typename RowVerifier>
+int verifyRowBands (const RowVerifier& verifier, const tcu::PixelBufferAccess& errorMask, tcu::LookupVerifierStats* stats = DE_NULL)
+{
+	const int						numRows		= errorMask.getHeight();
+	const int						numBands	= tcu::getNumRowBands(numRows, errorMask.getWidth(), tcu::getImageCompareNumThreads());
+	VerifyRowBandsTask<RowVerifier>	task		(verifier, numBands);
+
+	tcu::clear(errorMask, tcu::RGBA::green().toVec());
+	tcu::executeRowBands(task, numRows, numBands);
+
+	if (stats)
+		task.addStats(*stats);
+
+	return task.getNumFailed();
+}
+
+void logLookupVerifierStats (tcu::TestLog& log, const tcu::LookupVerifierStats& stats)
+{
+	log << tcu::TestLog::Message << "Lookup verification: " << stats.numReferenceMatches << " lookups matched reference samples, "
+								 << stats.numSearched << " lookups required full search"
+		<< tcu::TestLog::EndMessage;
+}
+
+template<typename TextureViewType>
+class TextureLookupRowVerifier
+{
+public:
+	TextureLookupRowVerifier (const tcu::ConstPixelBufferAccess&	result,
 							  const tcu::ConstPixelBufferAccess&	reference,
 							  const tcu::PixelBufferAccess&			errorMask,
-							  const tcu::Texture1DView&				baseView,
+							  const TextureViewType&				src,
 							  const float*							texCoord,
 							  const ReferenceParams&				sampleParams,
 							  const tcu::LookupPrecision&			lookupPrec,
 							  const tcu::LodPrecision&				lodPrec,
 							  qpWatchDog*							watchDog)
+		: m_result			(result)
+		, m_reference		(reference)
+		, m_errorMask		(errorMask)
+		, m_src				(src)
+		, m_texCoord		(texCoord)
+		, m_sampleParams	(sampleParams)
+		, m_lookupPrec		(lookupPrec)
+		, m_lodPrec			(lodPrec)
+		, m_watchDog		(watchDog)
+	{
+	}
+
+	int verifyRows (int rowBegin, int rowEnd, tcu::LookupVerifierStats* stats) const
+	{
+		return computeTextureLookupDiffRows(m_result, m_reference, m_errorMask, m_src, m_texCoord, m_sampleParams, m_lookupPrec, m_lodPrec, m_watchDog, stats, rowBegin, rowEnd);
+	}
+
+private:
+	const tcu::ConstPixelBufferAccess&	m_result;
+	const tcu::ConstPixelBufferAccess&	m_reference;
+	const tcu::PixelBufferAccess&		m_errorMask;
+	const TextureViewType&				m_src;
+	const float*						m_texCoord;
+	const ReferenceParams&				m_sampleParams;
+	const tcu::LookupPrecision&			m_lookupPrec;
+	const tcu::LodPrecision&			m_lodPrec;
+	qpWatchDog*							m_watchDog;
+};
+
+class TextureCubeArrayLookupRowVerifier
+{
+public:
+	TextureCubeArrayLookupRowVerifier (const tcu::ConstPixelBufferAccess&	result,
+									   const tcu::ConstPixelBufferAccess&	reference,
+									   const tcu::PixelBufferAccess&		errorMask,
+									   const tcu::TextureCubeArrayView&		src,
+									   const float*							texCoord,
+									   const ReferenceParams&				sampleParams,
+									   const tcu::LookupPrecision&			lookupPrec,
+									   const tcu::IVec4&					coordBits,
+									   const tcu::LodPrecision&				lodPrec,
+									   qpWatchDog*							watchDog)
+		: m_result			(result)
+		, m_reference		(reference)
+		, m_errorMask		(errorMask)
+		, m_src				(src)
+		, m_texCoord		(texCoord)
+		, m_sampleParams	(sampleParams)
+		, m_lookupPrec		(lookupPrec)
+		, m_coordBits		(coordBits)
+		, m_lodPrec			(lodPrec)
+		, m_watchDog		(watchDog)
+	{
+	}
+
+	int verifyRows (int rowBegin, int rowEnd, tcu::LookupVerifierStats* stats) const;
+
+private:
+	const tcu::ConstPixelBufferAccess&	m_result;
+	const tcu::ConstPixelBufferAccess&	m_reference;
+	const tcu::PixelBufferAccess&		m_errorMask;
+	const tcu::TextureCubeArrayView&	m_src;
+	const float*						m_texCoord;
+	const ReferenceParams&				m_sampleParams;
+	const tcu::LookupPrecision&			m_lookupPrec;
+	const tcu::IVec4&					m_coordBits;
+	const tcu::LodPrecision&			m_lodPrec;
+	qpWatchDog*							m_watchDog;
+};
+
+template<typename TextureViewType>
+class TextureCompareRowVerifier
+{
+public:
+	TextureCompareRowVerifier (const tcu::ConstPixelBufferAccess&	result,
+							   const tcu::ConstPixelBufferAccess&	reference,
+							   const tcu::PixelBufferAccess&		errorMask,
+							   const TextureViewType&				src,
+							   const float*							texCoord,
+							   const ReferenceParams&				sampleParams,
+							   const tcu::TexComparePrecision&		comparePrec,
+							   const tcu::LodPrecision&				lodPrec,
+							   const tcu::Vec3&						nonShadowThreshold)
+		: m_result				(result)
+		, m_reference			(reference)
+		, m_errorMask			(errorMask)
+		, m_src					(src)
+		, m_texCoord			(texCoord)
+		, m_sampleParams		(sampleParams)
+		, m_comparePrec			(comparePrec)
+		, m_lodPrec				(lodPrec)
+		, m_nonShadowThreshold	(nonShadowThreshold)
+	{
+	}
+
+	int verifyRows (int rowBegin, int rowEnd, tcu::LookupVerifierStats* stats) const
+	{
+		DE_UNREF(stats);
+		return computeTextureCompareDiffRows(m_result, m_reference, m_errorMask, m_src, m_texCoord, m_sampleParams, m_comparePrec, m_lodPrec, m_nonShadowThreshold, rowBegin, rowEnd);
+	}
+
+private:
+	const tcu::ConstPixelBufferAccess&	m_result;
+	const tcu::ConstPixelBufferAccess&	m_reference;
+	const tcu::PixelBufferAccess&		m_errorMask;
+	const TextureViewType&				m_src;
+	const float*						m_texCoord;
+	const ReferenceParams&				m_sampleParams;
+	const tcu::TexComparePrecision&		m_comparePrec;
+	const tcu::LodPrecision&			m_lodPrec;
+	const tcu::Vec3&					m_nonShadowThreshold;
+};
+
+} // anonymous
+
+static int computeTextureLookupDiffRows (const tcu::ConstPixelBufferAccess&	result,
+										 const tcu::ConstPixelBufferAccess&	reference,
+										 const tcu::PixelBufferAccess&		errorMask,
+										 const tcu::Texture1DView&			baseView,
+										 const float*						texCoord,
+										 const ReferenceParams&				sampleParams,
+										 const tcu::LookupPrecision&		lookupPrec,
+										 const tcu::LodPrecision&			lodPrec,
+										 qpWatchDog*						watchDog,
+										 tcu::LookupVerifierStats*			stats,
+										 int								rowBegin,
+										 int								rowEnd)
 {
 	DE_ASSERT(result.getWidth() == reference.getWidth() && result.getHeight() == reference.getHeight());
 	DE_ASSERT(result.getWidth() == errorMask.getWidth() && result.getHeight() == errorMask.getHeight());
@@ -1261,9 +1465,7 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 		tcu::Vec2( 0, +1),
 	};
 
-	tcu::clear(errorMask, tcu::RGBA::green().toVec());
-
-	for (int py = 0; py < result.getHeight(); py++)
+	for (int py = rowBegin; py < rowEnd; py++)
 	{
 		// Ugly hack, validation can take way too long at the moment.
 		if (watchDog)
@@ -1311,7 +1513,7 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 				}
 
 				const tcu::Vec2	clampedLod	= tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
-				const bool		isOk		= tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix);
+				const bool		isOk		= tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix, stats);
 
 				if (!isOk)
 				{
@@ -1325,15 +1527,34 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 	return numFailed;
 }
 
+//! Verifies texture lookup results and returns number of failed pixels.
 int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 							  const tcu::ConstPixelBufferAccess&	reference,
 							  const tcu::PixelBufferAccess&			errorMask,
-							  const tcu::Texture2DView&				baseView,
+							  const tcu::Texture1DView&				baseView,
 							  const float*							texCoord,
 							  const ReferenceParams&				sampleParams,
 							  const tcu::LookupPrecision&			lookupPrec,
 							  const tcu::LodPrecision&				lodPrec,
-							  qpWatchDog*							watchDog)
+							  qpWatchDog*							watchDog,
+							  tcu::LookupVerifierStats*				stats)
+{
+	const TextureLookupRowVerifier<tcu::Texture1DView>	verifier	(result, reference, errorMask, baseView, texCoord, sampleParams, lookupPrec, lodPrec, watchDog);
+	return verifyRowBands(verifier, errorMask, stats);
+}
+
+static int computeTextureLookupDiffRows (const tcu::ConstPixelBufferAccess&	result,
+										 const tcu::ConstPixelBufferAccess&	reference,
+										 const tcu::PixelBufferAccess&		errorMask,
+										 const tcu::Texture2DView&			baseView,
+										 const float*						texCoord,
+										 const ReferenceParams&				sampleParams,
+										 const tcu::LookupPrecision&		lookupPrec,
+										 const tcu::LodPrecision&			lodPrec,
+										 qpWatchDog*						watchDog,
+										 tcu::LookupVerifierStats*			stats,
+										 int								rowBegin,
+										 int								rowEnd)
 {
 	DE_ASSERT(result.getWidth() == reference.getWidth() && result.getHeight() == reference.getHeight());
 	DE_ASSERT(result.getWidth() == errorMask.getWidth() && result.getHeight() == errorMask.getHeight());
@@ -1366,9 +1587,7 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 		tcu::Vec2( 0, +1),
 	};
 
-	tcu::clear(errorMask, tcu::RGBA::green().toVec());
-
-	for (int py = 0; py < result.getHeight(); py++)
+	for (int py = rowBegin; py < rowEnd; py++)
 	{
 		// Ugly hack, validation can take way too long at the moment.
 		if (watchDog)
@@ -1421,7 +1640,7 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 				}
 
 				const tcu::Vec2	clampedLod	= tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
-				const bool		isOk		= tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix);
+				const bool		isOk		= tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix, stats);
 
 				if (!isOk)
 				{
@@ -1435,6 +1654,21 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 	return numFailed;
 }
 
+int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
+							  const tcu::ConstPixelBufferAccess&	reference,
+							  const tcu::PixelBufferAccess&			errorMask,
+							  const tcu::Texture2DView&				baseView,
+							  const float*							texCoord,
+							  const ReferenceParams&				sampleParams,
+							  const tcu::LookupPrecision&			lookupPrec,
+							  const tcu::LodPrecision&				lodPrec,
+							  qpWatchDog*							watchDog,
+							  tcu::LookupVerifierStats*				stats)
+{
+	const TextureLookupRowVerifier<tcu::Texture2DView>	verifier	(result, reference, errorMask, baseView, texCoord, sampleParams, lookupPrec, lodPrec, watchDog);
+	return verifyRowBands(verifier, errorMask, stats);
+}
+
 bool verifyTextureResult (tcu::TestContext&						testCtx,
 						  const tcu::ConstPixelBufferAccess&	result,
 						  const tcu::Texture1DView&				src,
@@ -1444,15 +1678,18 @@ bool verifyTextureResult (tcu::TestContext&						testCtx,
 						  const tcu::LodPrecision&				lodPrec,
 						  const tcu::PixelFormat&				pixelFormat)
 {
-	tcu::TestLog&	log				= testCtx.getLog();
-	tcu::Surface	reference		(result.getWidth(), result.getHeight());
-	tcu::Surface	errorMask		(result.getWidth(), result.getHeight());
-	int				numFailedPixels;
+	tcu::TestLog&				log				= testCtx.getLog();
+	tcu::Surface				reference		(result.getWidth(), result.getHeight());
+	tcu::Surface				errorMask		(result.getWidth(), result.getHeight());
+	tcu::LookupVerifierStats	verifierStats;
+	int							numFailedPixels;
 
 	DE_ASSERT(getCompareMask(pixelFormat) == lookupPrec.colorMask);
 
 	sampleTexture(tcu::SurfaceAccess(reference, pixelFormat), src, texCoord, sampleParams);
-	numFailedPixels = computeTextureLookupDiff(result, reference.getAccess(), errorMask.getAccess(), src, texCoord, sampleParams, lookupPrec, lodPrec, testCtx.getWatchDog());
+	numFailedPixels = computeTextureLookupDiff(result, reference.getAccess(), errorMask.getAccess(), src, texCoord, sampleParams, lookupPrec, lodPrec, testCtx.getWatchDog(), &verifierStats);
+
+	logLookupVerifierStats(log, verifierStats);
 
 	if (numFailedPixels > 0)
 		log << tcu::TestLog::Message << "ERROR: Result verification failed, got " << numFailedPixels << " invalid pixels!" << tcu::TestLog::EndMessage;
@@ -1480,15 +1717,18 @@ bool verifyTextureResult (tcu::TestContext&						testCtx,
 						  const tcu::LodPrecision&				lodPrec,
 						  const tcu::PixelFormat&				pixelFormat)
 {
-	tcu::TestLog&	log				= testCtx.getLog();
-	tcu::Surface	reference		(result.getWidth(), result.getHeight());
-	tcu::Surface	errorMask		(result.getWidth(), result.getHeight());
-	int				numFailedPixels;
+	tcu::TestLog&				log				= testCtx.getLog();
+	tcu::Surface				reference		(result.getWidth(), result.getHeight());
+	tcu::Surface				errorMask		(result.getWidth(), result.getHeight());
+	tcu::LookupVerifierStats	verifierStats;
+	int							numFailedPixels;
 
 	DE_ASSERT(getCompareMask(pixelFormat) == lookupPrec.colorMask);
 
 	sampleTexture(tcu::SurfaceAccess(reference, pixelFormat), src, texCoord, sampleParams);
-	numFailedPixels = computeTextureLookupDiff(result, reference.getAccess(), errorMask.getAccess(), src, texCoord, sampleParams, lookupPrec, lodPrec, testCtx.getWatchDog());
+	numFailedPixels = computeTextureLookupDiff(result, reference.getAccess(), errorMask.getAccess(), src, texCoord, sampleParams, lookupPrec, lodPrec, testCtx.getWatchDog(), &verifierStats);
+
+	logLookupVerifierStats(log, verifierStats);
 
 	if (numFailedPixels > 0)
 		log << tcu::TestLog::Message << "ERROR: Result verification failed, got " << numFailedPixels << " invalid pixels!" << tcu::TestLog::EndMessage;
@@ -1507,16 +1747,18 @@ bool verifyTextureResult (tcu::TestContext&						testCtx,
 	return numFailedPixels == 0;
 }
 
-//! Verifies texture lookup results and returns number of failed pixels.
-int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
-							  const tcu::ConstPixelBufferAccess&	reference,
-							  const tcu::PixelBufferAccess&			errorMask,
-							  const tcu::TextureCubeView&			baseView,
-							  const float*							texCoord,
-							  const ReferenceParams&				sampleParams,
-							  const tcu::LookupPrecision&			lookupPrec,
-							  const tcu::LodPrecision&				lodPrec,
-							  qpWatchDog*							watchDog)
+static int computeTextureLookupDiffRows (const tcu::ConstPixelBufferAccess&	result,
+										 const tcu::ConstPixelBufferAccess&	reference,
+										 const tcu::PixelBufferAccess&		errorMask,
+										 const tcu::TextureCubeView&		baseView,
+										 const float*						texCoord,
+										 const ReferenceParams&				sampleParams,
+										 const tcu::LookupPrecision&		lookupPrec,
+										 const tcu::LodPrecision&			lodPrec,
+										 qpWatchDog*						watchDog,
+										 tcu::LookupVerifierStats*			stats,
+										 int								rowBegin,
+										 int								rowEnd)
 {
 	DE_ASSERT(result.getWidth() == reference.getWidth() && result.getHeight() == reference.getHeight());
 	DE_ASSERT(result.getWidth() == errorMask.getWidth() && result.getHeight() == errorMask.getHeight());
@@ -1559,9 +1801,7 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 		tcu::Vec2(+1, +1),
 	};
 
-	tcu::clear(errorMask, tcu::RGBA::green().toVec());
-
-	for (int py = 0; py < result.getHeight(); py++)
+	for (int py = rowBegin; py < rowEnd; py++)
 	{
 		// Ugly hack, validation can take way too long at the moment.
 		if (watchDog)
@@ -1632,7 +1872,7 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 
 					const tcu::Vec2	clampedLod	= tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
 
-					if (tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix))
+					if (tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix, stats))
 					{
 						isOk = true;
 						break;
@@ -1651,6 +1891,22 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 	return numFailed;
 }
 
+//! Verifies texture lookup results and returns number of failed pixels.
+int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
+							  const tcu::ConstPixelBufferAccess&	reference,
+							  const tcu::PixelBufferAccess&			errorMask,
+							  const tcu::TextureCubeView&			baseView,
+							  const float*							texCoord,
+							  const ReferenceParams&				sampleParams,
+							  const tcu::LookupPrecision&			lookupPrec,
+							  const tcu::LodPrecision&				lodPrec,
+							  qpWatchDog*							watchDog,
+							  tcu::LookupVerifierStats*				stats)
+{
+	const TextureLookupRowVerifier<tcu::TextureCubeView>	verifier	(result, reference, errorMask, baseView, texCoord, sampleParams, lookupPrec, lodPrec, watchDog);
+	return verifyRowBands(verifier, errorMask, stats);
+}
+
 bool verifyTextureResult (tcu::TestContext&						testCtx,
 						  const tcu::ConstPixelBufferAccess&	result,
 						  const tcu::TextureCubeView&			src,
@@ -1660,15 +1916,18 @@ bool verifyTextureResult (tcu::TestContext&						testCtx,
 						  const tcu::LodPrecision&				lodPrec,
 						  const tcu::PixelFormat&				pixelFormat)
 {
-	tcu::TestLog&	log				= testCtx.getLog();
-	tcu::Surface	reference		(result.getWidth(), result.getHeight());
-	tcu::Surface	errorMask		(result.getWidth(), result.getHeight());
-	int				numFailedPixels;
+	tcu::TestLog&				log				= testCtx.getLog();
+	tcu::Surface				reference		(result.getWidth(), result.getHeight());
+	tcu::Surface				errorMask		(result.getWidth(), result.getHeight());
+	tcu::LookupVerifierStats	verifierStats;
+	int							numFailedPixels;
 
 	DE_ASSERT(getCompareMask(pixelFormat) == lookupPrec.colorMask);
 
 	sampleTexture(tcu::SurfaceAccess(reference, pixelFormat), src, texCoord, sampleParams);
-	numFailedPixels = computeTextureLookupDiff(result, reference.getAccess(), errorMask.getAccess(), src, texCoord, sampleParams, lookupPrec, lodPrec, testCtx.getWatchDog());
+	numFailedPixels = computeTextureLookupDiff(result, reference.getAccess(), errorMask.getAccess(), src, texCoord, sampleParams, lookupPrec, lodPrec, testCtx.getWatchDog(), &verifierStats);
+
+	logLookupVerifierStats(log, verifierStats);
 
 	if (numFailedPixels > 0)
 		log << tcu::TestLog::Message << "ERROR: Result verification failed, got " << numFailedPixels << " invalid pixels!" << tcu::TestLog::EndMessage;
@@ -1687,16 +1946,18 @@ bool verifyTextureResult (tcu::TestContext&						testCtx,
 	return numFailedPixels == 0;
 }
 
-//! Verifies texture lookup results and returns number of failed pixels.
-int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
-							  const tcu::ConstPixelBufferAccess&	reference,
-							  const tcu::PixelBufferAccess&			errorMask,
-							  const tcu::Texture3DView&				baseView,
-							  const float*							texCoord,
-							  const ReferenceParams&				sampleParams,
-							  const tcu::LookupPrecision&			lookupPrec,
-							  const tcu::LodPrecision&				lodPrec,
-							  qpWatchDog*							watchDog)
+static int computeTextureLookupDiffRows (const tcu::ConstPixelBufferAccess&	result,
+										 const tcu::ConstPixelBufferAccess&	reference,
+										 const tcu::PixelBufferAccess&		errorMask,
+										 const tcu::Texture3DView&			baseView,
+										 const float*						texCoord,
+										 const ReferenceParams&				sampleParams,
+										 const tcu::LookupPrecision&		lookupPrec,
+										 const tcu::LodPrecision&			lodPrec,
+										 qpWatchDog*						watchDog,
+										 tcu::LookupVerifierStats*			stats,
+										 int								rowBegin,
+										 int								rowEnd)
 {
 	DE_ASSERT(result.getWidth() == reference.getWidth() && result.getHeight() == reference.getHeight());
 	DE_ASSERT(result.getWidth() == errorMask.getWidth() && result.getHeight() == errorMask.getHeight());
@@ -1733,9 +1994,7 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 		tcu::Vec2( 0, +1),
 	};
 
-	tcu::clear(errorMask, tcu::RGBA::green().toVec());
-
-	for (int py = 0; py < result.getHeight(); py++)
+	for (int py = rowBegin; py < rowEnd; py++)
 	{
 		// Ugly hack, validation can take way too long at the moment.
 		if (watchDog)
@@ -1803,7 +2062,7 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 
 					const tcu::Vec2	clampedLod	= tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
 
-					if (tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix))
+					if (tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix, stats))
 					{
 						isOk = true;
 						break;
@@ -1822,6 +2081,22 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 	return numFailed;
 }
 
+//! Verifies texture lookup results and returns number of failed pixels.
+int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
+							  const tcu::ConstPixelBufferAccess&	reference,
+							  const tcu::PixelBufferAccess&			errorMask,
+							  const tcu::Texture3DView&				baseView,
+							  const float*							texCoord,
+							  const ReferenceParams&				sampleParams,
+							  const tcu::LookupPrecision&			lookupPrec,
+							  const tcu::LodPrecision&				lodPrec,
+							  qpWatchDog*							watchDog,
+							  tcu::LookupVerifierStats*				stats)
+{
+	const TextureLookupRowVerifier<tcu::Texture3DView>	verifier	(result, reference, errorMask, baseView, texCoord, sampleParams, lookupPrec, lodPrec, watchDog);
+	return verifyRowBands(verifier, errorMask, stats);
+}
+
 bool verifyTextureResult (tcu::TestContext&						testCtx,
 						  const tcu::ConstPixelBufferAccess&	result,
 						  const tcu::Texture3DView&				src,
@@ -1831,15 +2106,18 @@ bool verifyTextureResult (tcu::TestContext&						testCtx,
 						  const tcu::LodPrecision&				lodPrec,
 						  const tcu::PixelFormat&				pixelFormat)
 {
-	tcu::TestLog&	log				= testCtx.getLog();
-	tcu::Surface	reference		(result.getWidth(), result.getHeight());
-	tcu::Surface	errorMask		(result.getWidth(), result.getHeight());
-	int				numFailedPixels;
+	tcu::TestLog&				log				= testCtx.getLog();
+	tcu::Surface				reference		(result.getWidth(), result.getHeight());
+	tcu::Surface				errorMask		(result.getWidth(), result.getHeight());
+	tcu::LookupVerifierStats	verifierStats;
+	int							numFailedPixels;
 
 	DE_ASSERT(getCompareMask(pixelFormat) == lookupPrec.colorMask);
 
 	sampleTexture(tcu::SurfaceAccess(reference, pixelFormat), src, texCoord, sampleParams);
-	numFailedPixels = computeTextureLookupDiff(result, reference.getAccess(), errorMask.getAccess(), src, texCoord, sampleParams, lookupPrec, lodPrec, testCtx.getWatchDog());
+	numFailedPixels = computeTextureLookupDiff(result, reference.getAccess(), errorMask.getAccess(), src, texCoord, sampleParams, lookupPrec, lodPrec, testCtx.getWatchDog(), &verifierStats);
+
+	logLookupVerifierStats(log, verifierStats);
 
 	if (numFailedPixels > 0)
 		log << tcu::TestLog::Message << "ERROR: Result verification failed, got " << numFailedPixels << " invalid pixels!" << tcu::TestLog::EndMessage;
@@ -1858,16 +2136,18 @@ bool verifyTextureResult (tcu::TestContext&						testCtx,
 	return numFailedPixels == 0;
 }
 
-//! Verifies texture lookup results and returns number of failed pixels.
-int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
-							  const tcu::ConstPixelBufferAccess&	reference,
-							  const tcu::PixelBufferAccess&			errorMask,
-							  const tcu::Texture1DArrayView&		baseView,
-							  const float*							texCoord,
-							  const ReferenceParams&				sampleParams,
-							  const tcu::LookupPrecision&			lookupPrec,
-							  const tcu::LodPrecision&				lodPrec,
-							  qpWatchDog*							watchDog)
+static int computeTextureLookupDiffRows (const tcu::ConstPixelBufferAccess&	result,
+										 const tcu::ConstPixelBufferAccess&	reference,
+										 const tcu::PixelBufferAccess&		errorMask,
+										 const tcu::Texture1DArrayView&		baseView,
+										 const float*						texCoord,
+										 const ReferenceParams&				sampleParams,
+										 const tcu::LookupPrecision&		lookupPrec,
+										 const tcu::LodPrecision&			lodPrec,
+										 qpWatchDog*						watchDog,
+										 tcu::LookupVerifierStats*			stats,
+										 int								rowBegin,
+										 int								rowEnd)
 {
 	DE_ASSERT(result.getWidth() == reference.getWidth() && result.getHeight() == reference.getHeight());
 	DE_ASSERT(result.getWidth() == errorMask.getWidth() && result.getHeight() == errorMask.getHeight());
@@ -1900,9 +2180,7 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 		tcu::Vec2( 0, +1),
 	};
 
-	tcu::clear(errorMask, tcu::RGBA::green().toVec());
-
-	for (int py = 0; py < result.getHeight(); py++)
+	for (int py = rowBegin; py < rowEnd; py++)
 	{
 		// Ugly hack, validation can take way too long at the moment.
 		if (watchDog)
@@ -1951,7 +2229,7 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 				}
 
 				const tcu::Vec2	clampedLod	= tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
-				const bool		isOk		= tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix);
+				const bool		isOk		= tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix, stats);
 
 				if (!isOk)
 				{
@@ -1969,12 +2247,30 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 							  const tcu::ConstPixelBufferAccess&	reference,
 							  const tcu::PixelBufferAccess&			errorMask,
-							  const tcu::Texture2DArrayView&		baseView,
+							  const tcu::Texture1DArrayView&		baseView,
 							  const float*							texCoord,
 							  const ReferenceParams&				sampleParams,
 							  const tcu::LookupPrecision&			lookupPrec,
 							  const tcu::LodPrecision&				lodPrec,
-							  qpWatchDog*							watchDog)
+							  qpWatchDog*							watchDog,
+							  tcu::LookupVerifierStats*				stats)
+{
+	const TextureLookupRowVerifier<tcu::Texture1DArrayView>	verifier	(result, reference, errorMask, baseView, texCoord, sampleParams, lookupPrec, lodPrec, watchDog);
+	return verifyRowBands(verifier, errorMask, stats);
+}
+
+static int computeTextureLookupDiffRows (const tcu::ConstPixelBufferAccess&	result,
+										 const tcu::ConstPixelBufferAccess&	reference,
+										 const tcu::PixelBufferAccess&		errorMask,
+										 const tcu::Texture2DArrayView&		baseView,
+										 const float*						texCoord,
+										 const ReferenceParams&				sampleParams,
+										 const tcu::LookupPrecision&		lookupPrec,
+										 const tcu::LodPrecision&			lodPrec,
+										 qpWatchDog*						watchDog,
+										 tcu::LookupVerifierStats*			stats,
+										 int								rowBegin,
+										 int								rowEnd)
 {
 	DE_ASSERT(result.getWidth() == reference.getWidth() && result.getHeight() == reference.getHeight());
 	DE_ASSERT(result.getWidth() == errorMask.getWidth() && result.getHeight() == errorMask.getHeight());
@@ -2009,9 +2305,7 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 		tcu::Vec2( 0, +1),
 	};
 
-	tcu::clear(errorMask, tcu::RGBA::green().toVec());
-
-	for (int py = 0; py < result.getHeight(); py++)
+	for (int py = rowBegin; py < rowEnd; py++)
 	{
 		// Ugly hack, validation can take way too long at the moment.
 		if (watchDog)
@@ -2065,7 +2359,7 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 				}
 
 				const tcu::Vec2	clampedLod	= tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
-				const bool		isOk		= tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix);
+				const bool		isOk		= tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix, stats);
 
 				if (!isOk)
 				{
@@ -2079,6 +2373,22 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 	return numFailed;
 }
 
+//! Verifies texture lookup results and returns number of failed pixels.
+int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
+							  const tcu::ConstPixelBufferAccess&	reference,
+							  const tcu::PixelBufferAccess&			errorMask,
+							  const tcu::Texture2DArrayView&		baseView,
+							  const float*							texCoord,
+							  const ReferenceParams&				sampleParams,
+							  const tcu::LookupPrecision&			lookupPrec,
+							  const tcu::LodPrecision&				lodPrec,
+							  qpWatchDog*							watchDog,
+							  tcu::LookupVerifierStats*				stats)
+{
+	const TextureLookupRowVerifier<tcu::Texture2DArrayView>	verifier	(result, reference, errorMask, baseView, texCoord, sampleParams, lookupPrec, lodPrec, watchDog);
+	return verifyRowBands(verifier, errorMask, stats);
+}
+
 bool verifyTextureResult (tcu::TestContext&						testCtx,
 						  const tcu::ConstPixelBufferAccess&	result,
 						  const tcu::Texture1DArrayView&		src,
@@ -2088,15 +2398,18 @@ bool verifyTextureResult (tcu::TestContext&						testCtx,
 						  const tcu::LodPrecision&				lodPrec,
 						  const tcu::PixelFormat&				pixelFormat)
 {
-	tcu::TestLog&	log				= testCtx.getLog();
-	tcu::Surface	reference		(result.getWidth(), result.getHeight());
-	tcu::Surface	errorMask		(result.getWidth(), result.getHeight());
-	int				numFailedPixels;
+	tcu::TestLog&				log				= testCtx.getLog();
+	tcu::Surface				reference		(result.getWidth(), result.getHeight());
+	tcu::Surface				errorMask		(result.getWidth(), result.getHeight());
+	tcu::LookupVerifierStats	verifierStats;
+	int							numFailedPixels;
 
 	DE_ASSERT(getCompareMask(pixelFormat) == lookupPrec.colorMask);
 
 	sampleTexture(tcu::SurfaceAccess(reference, pixelFormat), src, texCoord, sampleParams);
-	numFailedPixels = computeTextureLookupDiff(result, reference.getAccess(), errorMask.getAccess(), src, texCoord, sampleParams, lookupPrec, lodPrec, testCtx.getWatchDog());
+	numFailedPixels = computeTextureLookupDiff(result, reference.getAccess(), errorMask.getAccess(), src, texCoord, sampleParams, lookupPrec, lodPrec, testCtx.getWatchDog(), &verifierStats);
+
+	logLookupVerifierStats(log, verifierStats);
 
 	if (numFailedPixels > 0)
 		log << tcu::TestLog::Message << "ERROR: Result verification failed, got " << numFailedPixels << " invalid pixels!" << tcu::TestLog::EndMessage;
@@ -2124,15 +2437,18 @@ bool verifyTextureResult (tcu::TestContext&						testCtx,
 						  const tcu::LodPrecision&				lodPrec,
 						  const tcu::PixelFormat&				pixelFormat)
 {
-	tcu::TestLog&	log				= testCtx.getLog();
-	tcu::Surface	reference		(result.getWidth(), result.getHeight());
-	tcu::Surface	errorMask		(result.getWidth(), result.getHeight());
-	int				numFailedPixels;
+	tcu::TestLog&				log				= testCtx.getLog();
+	tcu::Surface				reference		(result.getWidth(), result.getHeight());
+	tcu::Surface				errorMask		(result.getWidth(), result.getHeight());
+	tcu::LookupVerifierStats	verifierStats;
+	int							numFailedPixels;
 
 	DE_ASSERT(getCompareMask(pixelFormat) == lookupPrec.colorMask);
 
 	sampleTexture(tcu::SurfaceAccess(reference, pixelFormat), src, texCoord, sampleParams);
-	numFailedPixels = computeTextureLookupDiff(result, reference.getAccess(), errorMask.getAccess(), src, texCoord, sampleParams, lookupPrec, lodPrec, testCtx.getWatchDog());
+	numFailedPixels = computeTextureLookupDiff(result, reference.getAccess(), errorMask.getAccess(), src, texCoord, sampleParams, lookupPrec, lodPrec, testCtx.getWatchDog(), &verifierStats);
+
+	logLookupVerifierStats(log, verifierStats);
 
 	if (numFailedPixels > 0)
 		log << tcu::TestLog::Message << "ERROR: Result verification failed, got " << numFailedPixels << " invalid pixels!" << tcu::TestLog::EndMessage;
@@ -2151,17 +2467,19 @@ bool verifyTextureResult (tcu::TestContext&						testCtx,
 	return numFailedPixels == 0;
 }
 
-//! Verifies texture lookup results and returns number of failed pixels.
-int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
-							  const tcu::ConstPixelBufferAccess&	reference,
-							  const tcu::PixelBufferAccess&			errorMask,
-							  const tcu::TextureCubeArrayView&		baseView,
-							  const float*							texCoord,
-							  const ReferenceParams&				sampleParams,
-							  const tcu::LookupPrecision&			lookupPrec,
-							  const tcu::IVec4&						coordBits,
-							  const tcu::LodPrecision&				lodPrec,
-							  qpWatchDog*							watchDog)
+static int computeTextureLookupDiffRows (const tcu::ConstPixelBufferAccess&	result,
+										 const tcu::ConstPixelBufferAccess&	reference,
+										 const tcu::PixelBufferAccess&		errorMask,
+										 const tcu::TextureCubeArrayView&	baseView,
+										 const float*						texCoord,
+										 const ReferenceParams&				sampleParams,
+										 const tcu::LookupPrecision&		lookupPrec,
+										 const tcu::IVec4&					coordBits,
+										 const tcu::LodPrecision&			lodPrec,
+										 qpWatchDog*						watchDog,
+										 tcu::LookupVerifierStats*			stats,
+										 int								rowBegin,
+										 int								rowEnd)
 {
 	DE_ASSERT(result.getWidth() == reference.getWidth() && result.getHeight() == reference.getHeight());
 	DE_ASSERT(result.getWidth() == errorMask.getWidth() && result.getHeight() == errorMask.getHeight());
@@ -2206,9 +2524,7 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 		tcu::Vec2(+1, +1),
 	};
 
-	tcu::clear(errorMask, tcu::RGBA::green().toVec());
-
-	for (int py = 0; py < result.getHeight(); py++)
+	for (int py = rowBegin; py < rowEnd; py++)
 	{
 		// Ugly hack, validation can take way too long at the moment.
 		if (watchDog)
@@ -2280,7 +2596,7 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 
 					const tcu::Vec2	clampedLod	= tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
 
-					if (tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coordBits, coord, clampedLod, resPix))
+					if (tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coordBits, coord, clampedLod, resPix, stats))
 					{
 						isOk = true;
 						break;
@@ -2299,6 +2615,28 @@ int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
 	return numFailed;
 }
 
+int TextureCubeArrayLookupRowVerifier::verifyRows (int rowBegin, int rowEnd, tcu::LookupVerifierStats* stats) const
+{
+	return computeTextureLookupDiffRows(m_result, m_reference, m_errorMask, m_src, m_texCoord, m_sampleParams, m_lookupPrec, m_coordBits, m_lodPrec, m_watchDog, stats, rowBegin, rowEnd);
+}
+
+//! Verifies texture lookup results and returns number of failed pixels.
+int computeTextureLookupDiff (const tcu::ConstPixelBufferAccess&	result,
+							  const tcu::ConstPixelBufferAccess&	reference,
+							  const tcu::PixelBufferAccess&			errorMask,
+							  const tcu::TextureCubeArrayView&		baseView,
+							  const float*							texCoord,
+							  const ReferenceParams&				sampleParams,
+							  const tcu::LookupPrecision&			lookupPrec,
+							  const tcu::IVec4&						coordBits,
+							  const tcu::LodPrecision&				lodPrec,
+							  qpWatchDog*							watchDog,
+							  tcu::LookupVerifierStats*				stats)
+{
+	const TextureCubeArrayLookupRowVerifier	verifier	(result, reference, errorMask, baseView, texCoord, sampleParams, lookupPrec, coordBits, lodPrec, watchDog);
+	return verifyRowBands(verifier, errorMask, stats);
+}
+
 bool verifyTextureResult (tcu::TestContext&						testCtx,
 						  const tcu::ConstPixelBufferAccess&	result,
 						  const tcu::TextureCubeArrayView&		src,
@@ -2309,15 +2647,18 @@ bool verifyTextureResult (tcu::TestContext&						testCtx,
 						  const tcu::LodPrecision&				lodPrec,
 						  const tcu::PixelFormat&				pixelFormat)
 {
-	tcu::TestLog&	log				= testCtx.getLog();
-	tcu::Surface	reference		(result.getWidth(), result.getHeight());
-	tcu::Surface	errorMask		(result.getWidth(), result.getHeight());
-	int				numFailedPixels;
+	tcu::TestLog&				log				= testCtx.getLog();
+	tcu::Surface				reference		(result.getWidth(), result.getHeight());
+	tcu::Surface				errorMask		(result.getWidth(), result.getHeight());
+	tcu::LookupVerifierStats	verifierStats;
+	int							numFailedPixels;
 
 	DE_ASSERT(getCompareMask(pixelFormat) == lookupPrec.colorMask);
 
 	sampleTexture(tcu::SurfaceAccess(reference, pixelFormat), src, texCoord, sampleParams);
-	numFailedPixels = computeTextureLookupDiff(result, reference.getAccess(), errorMask.getAccess(), src, texCoord, sampleParams, lookupPrec, coordBits, lodPrec, testCtx.getWatchDog());
+	numFailedPixels = computeTextureLookupDiff(result, reference.getAccess(), errorMask.getAccess(), src, texCoord, sampleParams, lookupPrec, coordBits, lodPrec, testCtx.getWatchDog(), &verifierStats);
+
+	logLookupVerifierStats(log, verifierStats);
 
 	if (numFailedPixels > 0)
 		log << tcu::TestLog::Message << "ERROR: Result verification failed, got " << numFailedPixels << " invalid pixels!" << tcu::TestLog::EndMessage;
@@ -2338,15 +2679,17 @@ bool verifyTextureResult (tcu::TestContext&						testCtx,
 
 // Shadow lookup verification
 
-int computeTextureCompareDiff (const tcu::ConstPixelBufferAccess&	result,
-							   const tcu::ConstPixelBufferAccess&	reference,
-							   const tcu::PixelBufferAccess&		errorMask,
-							   const tcu::Texture2DView&			src,
-							   const float*							texCoord,
-							   const ReferenceParams&				sampleParams,
-							   const tcu::TexComparePrecision&		comparePrec,
-							   const tcu::LodPrecision&				lodPrec,
-							   const tcu::Vec3&						nonShadowThreshold)
+static int computeTextureCompareDiffRows (const tcu::ConstPixelBufferAccess&	result,
+										  const tcu::ConstPixelBufferAccess&	reference,
+										  const tcu::PixelBufferAccess&			errorMask,
+										  const tcu::Texture2DView&				src,
+										  const float*							texCoord,
+										  const ReferenceParams&				sampleParams,
+										  const tcu::TexComparePrecision&		comparePrec,
+										  const tcu::LodPrecision&				lodPrec,
+										  const tcu::Vec3&						nonShadowThreshold,
+										  int									rowBegin,
+										  int									rowEnd)
 {
 	DE_ASSERT(result.getWidth() == reference.getWidth() && result.getHeight() == reference.getHeight());
 	DE_ASSERT(result.getWidth() == errorMask.getWidth() && result.getHeight() == errorMask.getHeight());
@@ -2376,9 +2719,7 @@ int computeTextureCompareDiff (const tcu::ConstPixelBufferAccess&	result,
 		tcu::Vec2( 0, +1),
 	};
 
-	tcu::clear(errorMask, tcu::RGBA::green().toVec());
-
-	for (int py = 0; py < result.getHeight(); py++)
+	for (int py = rowBegin; py < rowEnd; py++)
 	{
 		for (int px = 0; px < result.getWidth(); px++)
 		{
@@ -2453,12 +2794,28 @@ int computeTextureCompareDiff (const tcu::ConstPixelBufferAccess&	result,
 int computeTextureCompareDiff (const tcu::ConstPixelBufferAccess&	result,
 							   const tcu::ConstPixelBufferAccess&	reference,
 							   const tcu::PixelBufferAccess&		errorMask,
-							   const tcu::TextureCubeView&			src,
+							   const tcu::Texture2DView&			src,
 							   const float*							texCoord,
 							   const ReferenceParams&				sampleParams,
 							   const tcu::TexComparePrecision&		comparePrec,
 							   const tcu::LodPrecision&				lodPrec,
 							   const tcu::Vec3&						nonShadowThreshold)
+{
+	const TextureCompareRowVerifier<tcu::Texture2DView>	verifier	(result, reference, errorMask, src, texCoord, sampleParams, comparePrec, lodPrec, nonShadowThreshold);
+	return verifyRowBands(verifier, errorMask);
+}
+
+static int computeTextureCompareDiffRows (const tcu::ConstPixelBufferAccess&	result,
+										  const tcu::ConstPixelBufferAccess&	reference,
+										  const tcu::PixelBufferAccess&			errorMask,
+										  const tcu::TextureCubeView&			src,
+										  const float*							texCoord,
+										  const ReferenceParams&				sampleParams,
+										  const tcu::TexComparePrecision&		comparePrec,
+										  const tcu::LodPrecision&				lodPrec,
+										  const tcu::Vec3&						nonShadowThreshold,
+										  int									rowBegin,
+										  int									rowEnd)
 {
 	DE_ASSERT(result.getWidth() == reference.getWidth() && result.getHeight() == reference.getHeight());
 	DE_ASSERT(result.getWidth() == errorMask.getWidth() && result.getHeight() == errorMask.getHeight());
@@ -2490,9 +2847,7 @@ int computeTextureCompareDiff (const tcu::ConstPixelBufferAccess&	result,
 		tcu::Vec2( 0, +1),
 	};
 
-	tcu::clear(errorMask, tcu::RGBA::green().toVec());
-
-	for (int py = 0; py < result.getHeight(); py++)
+	for (int py = rowBegin; py < rowEnd; py++)
 	{
 		for (int px = 0; px < result.getWidth(); px++)
 		{
@@ -2575,12 +2930,28 @@ int computeTextureCompareDiff (const tcu::ConstPixelBufferAccess&	result,
 int computeTextureCompareDiff (const tcu::ConstPixelBufferAccess&	result,
 							   const tcu::ConstPixelBufferAccess&	reference,
 							   const tcu::PixelBufferAccess&		errorMask,
-							   const tcu::Texture2DArrayView&		src,
+							   const tcu::TextureCubeView&			src,
 							   const float*							texCoord,
 							   const ReferenceParams&				sampleParams,
 							   const tcu::TexComparePrecision&		comparePrec,
 							   const tcu::LodPrecision&				lodPrec,
 							   const tcu::Vec3&						nonShadowThreshold)
+{
+	const TextureCompareRowVerifier<tcu::TextureCubeView>	verifier	(result, reference, errorMask, src, texCoord, sampleParams, comparePrec, lodPrec, nonShadowThreshold);
+	return verifyRowBands(verifier, errorMask);
+}
+
+static int computeTextureCompareDiffRows (const tcu::ConstPixelBufferAccess&	result,
+										  const tcu::ConstPixelBufferAccess&	reference,
+										  const tcu::PixelBufferAccess&			errorMask,
+										  const tcu::Texture2DArrayView&		src,
+										  const float*							texCoord,
+										  const ReferenceParams&				sampleParams,
+										  const tcu::TexComparePrecision&		comparePrec,
+										  const tcu::LodPrecision&				lodPrec,
+										  const tcu::Vec3&						nonShadowThreshold,
+										  int									rowBegin,
+										  int									rowEnd)
 {
 	DE_ASSERT(result.getWidth() == reference.getWidth() && result.getHeight() == reference.getHeight());
 	DE_ASSERT(result.getWidth() == errorMask.getWidth() && result.getHeight() == errorMask.getHeight());
@@ -2612,9 +2983,7 @@ int computeTextureCompareDiff (const tcu::ConstPixelBufferAccess&	result,
 		tcu::Vec2( 0, +1),
 	};
 
-	tcu::clear(errorMask, tcu::RGBA::green().toVec());
-
-	for (int py = 0; py < result.getHeight(); py++)
+	for (int py = rowBegin; py < rowEnd; py++)
 	{
 		for (int px = 0; px < result.getWidth(); px++)
 		{
@@ -2687,6 +3056,20 @@ int computeTextureCompareDiff (const tcu::ConstPixelBufferAccess&	result,
 	return numFailed;
 }
 
+int computeTextureCompareDiff (const tcu::ConstPixelBufferAccess&	result,
+							   const tcu::ConstPixelBufferAccess&	reference,
+							   const tcu::PixelBufferAccess&		errorMask,
+							   const tcu::Texture2DArrayView&		src,
+							   const float*							texCoord,
+							   const ReferenceParams&				sampleParams,
+							   const tcu::TexComparePrecision&		comparePrec,
+							   const tcu::LodPrecision&				lodPrec,
+							   const tcu::Vec3&						nonShadowThreshold)
+{
+	const TextureCompareRowVerifier<tcu::Texture2DArrayView>	verifier	(result, reference, errorMask, src, texCoord, sampleParams, comparePrec, lodPrec, nonShadowThreshold);
+	return verifyRowBands(verifier, errorMask);
+}
+
 // Mipmap generation comparison.
 
 static int compareGenMipmapBilinear (const tcu::ConstPixelBufferAccess& dst, const tcu::ConstPixelBufferAccess& src, const tcu::PixelBufferAccess& errorMask, const GenMipmapPrecision& precision)
@@ -188,7 +188,8 @@ int				computeTextureLookupDiff	(const tcu::ConstPixelBufferAccess&	result,
 											 const ReferenceParams&				sampleParams,
 											 const tcu::LookupPrecision&		lookupPrec,
 											 const tcu::LodPrecision&			lodPrec,
-											 qpWatchDog*						watchDog);
+											 qpWatchDog*						watchDog,
+											 tcu::LookupVerifierStats*			stats = DE_NULL);
 
 int				computeTextureLookupDiff	(const tcu::ConstPixelBufferAccess&	result,
 											 const tcu::ConstPixelBufferAccess&	reference,
@@ -198,7 +199,8 @@ int				computeTextureLookupDiff	(const tcu::ConstPixelBufferAccess&	result,
 											 const ReferenceParams&				sampleParams,
 											 const tcu::LookupPrecision&		lookupPrec,
 											 const tcu::LodPrecision&			lodPrec,
-											 qpWatchDog*						watchDog);
+											 qpWatchDog*						watchDog,
+											 tcu::LookupVerifierStats*			stats = DE_NULL);
 
 int				computeTextureLookupDiff	(const tcu::ConstPixelBufferAccess&	result,
 											 const tcu::ConstPixelBufferAccess&	reference,
@@ -208,7 +210,8 @@ int				computeTextureLookupDiff	(const tcu::ConstPixelBufferAccess&	result,
 											 const ReferenceParams&				sampleParams,
 											 const tcu::LookupPrecision&		lookupPrec,
 											 const tcu::LodPrecision&			lodPrec,
-											 qpWatchDog*						watchDog);
+											 qpWatchDog*						watchDog,
+											 tcu::LookupVerifierStats*			stats = DE_NULL);
 
 int				computeTextureLookupDiff	(const tcu::ConstPixelBufferAccess&	result,
 											 const tcu::ConstPixelBufferAccess&	reference,
@@ -218,7 +221,8 @@ int				computeTextureLookupDiff	(const tcu::ConstPixelBufferAccess&	result,
 											 const ReferenceParams&				sampleParams,
 											 const tcu::LookupPrecision&		lookupPrec,
 											 const tcu::LodPrecision&			lodPrec,
-											 qpWatchDog*						watchDog);
+											 qpWatchDog*						watchDog,
+											 tcu::LookupVerifierStats*			stats = DE_NULL);
 
 int				computeTextureLookupDiff	(const tcu::ConstPixelBufferAccess&	result,
 											 const tcu::ConstPixelBufferAccess&	reference,
@@ -228,7 +232,8 @@ int				computeTextureLookupDiff	(const tcu::ConstPixelBufferAccess&	result,
 											 const ReferenceParams&				sampleParams,
 											 const tcu::LookupPrecision&		lookupPrec,
 											 const tcu::LodPrecision&			lodPrec,
-											 qpWatchDog*						watchDog);
+											 qpWatchDog*						watchDog,
+											 tcu::LookupVerifierStats*			stats = DE_NULL);
 
 int				computeTextureLookupDiff	(const tcu::ConstPixelBufferAccess&	result,
 											 const tcu::ConstPixelBufferAccess&	reference,
@@ -238,7 +243,8 @@ int				computeTextureLookupDiff	(const tcu::ConstPixelBufferAccess&	result,
 											 const ReferenceParams&				sampleParams,
 											 const tcu::LookupPrecision&		lookupPrec,
 											 const tcu::LodPrecision&			lodPrec,
-											 qpWatchDog*						watchDog);
+											 qpWatchDog*						watchDog,
+											 tcu::LookupVerifierStats*			stats = DE_NULL);
 
 int				computeTextureLookupDiff	(const tcu::ConstPixelBufferAccess&	result,
 											 const tcu::ConstPixelBufferAccess&	reference,
@@ -249,7 +255,8 @@ int				computeTextureLookupDiff	(const tcu::ConstPixelBufferAccess&	result,
 											 const tcu::LookupPrecision&		lookupPrec,
 											 const tcu::IVec4&					coordBits,
 											 const tcu::LodPrecision&			lodPrec,
-											 qpWatchDog*						watchDog);
+											 qpWatchDog*						watchDog,
+											 tcu::LookupVerifierStats*			stats = DE_NULL);
 
 bool			verifyTextureResult			(tcu::TestContext&					testCtx,
 											 const tcu::ConstPixelBufferAccess&	result,
@@ -27,6 +27,8 @@
 #include "tcuApp.hpp"
 #include "tcuResource.hpp"
 #include "tcuTestLog.hpp"
+#include "tcuImageCompare.hpp"
+#include "rrRenderState.hpp"
 #include "deUniquePtr.hpp"
 
 #include <cstdio>
@@ -46,6 +48,16 @@ int main (int argc, char** argv)
 		tcu::CommandLine				cmdLine		(argc, argv);
 		tcu::DirArchive					archive		(".");
 		tcu::TestLog					log			(cmdLine.getLogFileName(), cmdLine.getLogFlags());
+		if (cmdLine.getRefRendererNumThreads() < 0)
+			throw tcu::Exception("Invalid --deqp-ref-renderer-threads value");
+
+		rr::setDefaultNumRasterizationThreads(cmdLine.getRefRendererNumThreads());
+
+		if (cmdLine.getImageCompareNumThreads() < 0)
+			throw tcu::Exception("Invalid --deqp-image-compare-threads value");
+
+		tcu::setImageCompareNumThreads(cmdLine.getImageCompareNumThreads());
+
 		de::UniquePtr<tcu::Platform>	platform	(createPlatform());
 		de::UniquePtr<tcu::App>			app			(new tcu::App(*platform, archive, log, cmdLine));
 
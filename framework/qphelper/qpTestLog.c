@@ -31,6 +31,8 @@
 #include "deString.h"
 
 #include "deMutex.h"
+#include "deSemaphore.h"
+#include "deThread.h"
 
 #if defined(QP_SUPPORT_PNG)
 #	include <png.h>
@@ -119,6 +121,9 @@ DE_INLINE ContainerType ContainerStack_getTop (const ContainerStack* stack)
 
 #endif
 
+typedef struct ImageEncoder_s	ImageEncoder;
+typedef struct PendingItem_s	PendingItem;
+
 /* qpTestLog instance */
 struct qpTestLog_s
 {
@@ -132,11 +137,31 @@ struct qpTestLog_s
 	deBool					isSessionOpen;
 	deBool					isCaseOpen;
 
+	deBool					isBuffer;			/*!< Output goes to temporary file, see qpTestLog_createBufferLog(). */
+	long					bufferStart;		/*!< Offset of first unread byte in buffer log. */
+
 #if defined(DE_DEBUG)
 	ContainerStack			containerStack;		/*!< For container usage verification.	*/
 #endif
+
+	/* Asynchronous image writing, see qpTestLog_writeImage(). */
+	ImageEncoder*			imageEncoder;		/*!< Background encoder, or DE_NULL.	*/
+	PendingItem*			firstPendingItem;	/*!< Items waiting to be written.		*/
+	PendingItem*			lastPendingItem;
+	int						numPendingImages;
 };
 
+static ImageEncoder*	ImageEncoder_create		(void);
+static void				ImageEncoder_destroy	(ImageEncoder* encoder);
+static void				flushPendingItems		(qpTestLog* log, int maxPendingImages);
+
+/* Acquire log lock and write out all pending images before anything else is written. */
+DE_INLINE void lockLog (qpTestLog* log)
+{
+	deMutex_lock(log->lock);
+	flushPendingItems(log, 0);
+}
+
 /* Maps integer to string. */
 typedef struct qpKeyStringMap_s
 {
@@ -323,6 +348,37 @@ static deBool endSession (qpTestLog* log)
 	return DE_TRUE;
 }
 
+static deBool initLog (qpTestLog* log, deUint32 flags)
+{
+	log->flags			= flags;
+	log->writer			= qpXmlWriter_createFileWriter(log->outputFile, 0, !(flags & QP_TEST_LOG_NO_FLUSH));
+	log->lock			= deMutex_create(DE_NULL);
+	log->isSessionOpen	= DE_FALSE;
+	log->isCaseOpen		= DE_FALSE;
+
+	if (!log->writer)
+	{
+		qpPrintf("ERROR: Unable to create output XML writer.\n");
+		return DE_FALSE;
+	}
+
+	if (!log->lock)
+	{
+		qpPrintf("ERROR: Unable to create mutex.\n");
+		return DE_FALSE;
+	}
+
+	if ((flags & QP_TEST_LOG_ASYNC_IMAGES) && !(flags & QP_TEST_LOG_EXCLUDE_IMAGES))
+	{
+		log->imageEncoder = ImageEncoder_create();
+
+		if (!log->imageEncoder)
+			qpPrintf("WARNING: Unable to create image encoder threads -- writing images synchronously.\n");
+	}
+
+	return DE_TRUE;
+}
+
 /*--------------------------------------------------------------------*//*!
  * \brief Create a file based logger instance
  * \param fileName Name of the file where to put logs
@@ -351,27 +407,54 @@ qpTestLog* qpTestLog_createFileLog (const char* fileName, deUint32 flags)
 		return DE_NULL;
 	}
 
-	log->flags			= flags;
-	log->writer			= qpXmlWriter_createFileWriter(log->outputFile, 0, !(flags & QP_TEST_LOG_NO_FLUSH));
-	log->lock			= deMutex_create(DE_NULL);
-	log->isSessionOpen	= DE_FALSE;
-	log->isCaseOpen		= DE_FALSE;
+	if (!initLog(log, flags))
+	{
+		qpTestLog_destroy(log);
+		return DE_NULL;
+	}
 
-	if (!log->writer)
+	beginSession(log);
+
+	return log;
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Create a logger instance buffering output in a temporary file
+ * \param flags Logging flags
+ * \return qpTestLog instance, or DE_NULL if cannot create file
+ *
+ * Buffer logs have no session; they are used to record complete case
+ * results that are later moved into a file log with
+ * qpTestLog_readBuffer() and qpTestLog_writeBufferData(). This allows
+ * writing results of concurrently executed cases in a fixed order.
+ *//*--------------------------------------------------------------------*/
+qpTestLog* qpTestLog_createBufferLog (deUint32 flags)
+{
+	qpTestLog* log = (qpTestLog*)deCalloc(sizeof(qpTestLog));
+	if (!log)
+		return DE_NULL;
+
+#if defined(DE_DEBUG)
+	ContainerStack_reset(&log->containerStack);
+#endif
+
+	log->outputFile = tmpfile();
+	if (!log->outputFile)
 	{
-		qpPrintf("ERROR: Unable to create output XML writer to file '%s'.\n", fileName);
+		qpPrintf("ERROR: Unable to create temporary file for test log buffer.\n");
 		qpTestLog_destroy(log);
 		return DE_NULL;
 	}
 
-	if (!log->lock)
+	/* \note Nothing is gained from flushing a temporary file. */
+	if (!initLog(log, flags | QP_TEST_LOG_NO_FLUSH))
 	{
-		qpPrintf("ERROR: Unable to create mutex.\n");
 		qpTestLog_destroy(log);
 		return DE_NULL;
 	}
 
-	beginSession(log);
+	log->isBuffer		= DE_TRUE;
+	log->bufferStart	= 0;
 
 	return log;
 }
@@ -384,6 +467,15 @@ void qpTestLog_destroy (qpTestLog* log)
 {
 	DE_ASSERT(log);
 
+	if (log->imageEncoder)
+	{
+		/* Write out remaining images before ending session. */
+		lockLog(log);
+		deMutex_unlock(log->lock);
+
+		ImageEncoder_destroy(log->imageEncoder);
+	}
+
 	if (log->isSessionOpen)
 		endSession(log);
 
@@ -413,7 +505,7 @@ deBool qpTestLog_startCase (qpTestLog* log, const char* testCasePath, qpTestCase
 	qpXmlAttribute	resultAttribs[8];
 
 	DE_ASSERT(log && testCasePath && (testCasePath[0] != 0));
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(!log->isCaseOpen);
 	DE_ASSERT(ContainerStack_isEmpty(&log->containerStack));
@@ -455,7 +547,7 @@ deBool qpTestLog_endCase (qpTestLog* log, qpTestResult result, const char* resul
 	const char*		statusStr		= QP_LOOKUP_STRING(s_qpTestResultMap, result);
 	qpXmlAttribute	statusAttrib	= qpSetStringAttrib("StatusCode", statusStr);
 
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(log->isCaseOpen);
 	DE_ASSERT(ContainerStack_isEmpty(&log->containerStack));
@@ -499,7 +591,7 @@ deBool qpTestLog_terminateCase (qpTestLog* log, qpTestResult result)
 	DE_ASSERT(log);
 	DE_ASSERT(result == QP_TEST_RESULT_CRASH || result == QP_TEST_RESULT_TIMEOUT);
 
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	if (!log->isCaseOpen)
 	{
@@ -512,6 +604,8 @@ deBool qpTestLog_terminateCase (qpTestLog* log, qpTestResult result)
 	fprintf(log->outputFile, "\n#terminateTestCaseResult %s\n", resultStr);
 	qpTestLog_flushFile(log);
 
+	/* Log can be used for further cases, e.g. by fork server in tcu::App. */
+	qpXmlWriter_abandonDocument(log->writer);
 	log->isCaseOpen = DE_FALSE;
 
 #if defined(DE_DEBUG)
@@ -522,6 +616,83 @@ deBool qpTestLog_terminateCase (qpTestLog* log, qpTestResult result)
 	return DE_TRUE;
 }
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Get number of bytes written to buffer log since last read
+ * \param log Buffer log instance
+ * \return Number of buffered bytes
+ *//*--------------------------------------------------------------------*/
+size_t qpTestLog_getBufferSize (qpTestLog* log)
+{
+	long end;
+
+	DE_ASSERT(log && log->isBuffer);
+	lockLog(log);
+
+	qpXmlWriter_flush(log->writer);
+	fflush(log->outputFile);
+	end = ftell(log->outputFile);
+
+	deMutex_unlock(log->lock);
+
+	return end > log->bufferStart ? (size_t)(end - log->bufferStart) : 0;
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Read and discard buffered data
+ * \param log Buffer log instance
+ * \param dst Destination, must hold qpTestLog_getBufferSize() bytes
+ * \param size Number of bytes to read, as returned by qpTestLog_getBufferSize()
+ * \return true if ok, false otherwise
+ *//*--------------------------------------------------------------------*/
+deBool qpTestLog_readBuffer (qpTestLog* log, void* dst, size_t size)
+{
+	deBool isOk;
+
+	DE_ASSERT(log && log->isBuffer);
+	lockLog(log);
+
+	DE_ASSERT(!log->isCaseOpen);
+
+	qpXmlWriter_flush(log->writer);
+	fflush(log->outputFile);
+
+	isOk = fseek(log->outputFile, log->bufferStart, SEEK_SET) == 0 &&
+		   fread(dst, 1, size, log->outputFile) == size;
+
+	/* Continue writing at the end, past any data that was not read. */
+	fseek(log->outputFile, 0, SEEK_END);
+	log->bufferStart = ftell(log->outputFile);
+
+	deMutex_unlock(log->lock);
+	return isOk;
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Write case results read from a buffer log
+ * \param log qpTestLog instance
+ * \param data Data read with qpTestLog_readBuffer()
+ * \param size Data size in bytes
+ * \return true if ok, false otherwise
+ *//*--------------------------------------------------------------------*/
+deBool qpTestLog_writeBufferData (qpTestLog* log, const void* data, size_t size)
+{
+	deBool isOk;
+
+	DE_ASSERT(log && (data || size == 0));
+	lockLog(log);
+
+	DE_ASSERT(!log->isCaseOpen);
+
+	qpXmlWriter_flush(log->writer);
+	isOk = fwrite(data, 1, size, log->outputFile) == size;
+
+	if (!(log->flags & QP_TEST_LOG_NO_FLUSH))
+		qpTestLog_flushFile(log);
+
+	deMutex_unlock(log->lock);
+	return isOk;
+}
+
 static deBool qpTestLog_writeKeyValuePair (qpTestLog* log, const char* elementName, const char* name, const char* description, const char* unit, qpKeyValueTag tag, const char* text)
 {
 	const char*		tagString = QP_LOOKUP_STRING(s_qpTagMap, tag);
@@ -529,7 +700,7 @@ static deBool qpTestLog_writeKeyValuePair (qpTestLog* log, const char* elementNa
 	int				numAttribs = 0;
 
 	DE_ASSERT(log && elementName && text);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	/* Fill in attributes. */
 	if (name)			attribs[numAttribs++] = qpSetStringAttrib("Name", name);
@@ -763,6 +934,483 @@ static deBool compressImagePNG (Buffer* buffer, qpImageFormat imageFormat, int w
 }
 #endif /* QP_SUPPORT_PNG */
 
+/* Asynchronous image writing.
+ *
+ * With QP_TEST_LOG_ASYNC_IMAGES qpTestLog_writeImage() only copies the pixels
+ * and hands them to a pool of encoder threads that do the PNG compression and
+ * base64 encoding. Images and the image set elements around them are kept in
+ * a pending item queue that is written out in submission order. Any other log
+ * write waits for all pending images first (see lockLog()), so the resulting
+ * log is identical to one written synchronously.
+ */
+
+enum
+{
+	MAX_IMAGE_ENCODER_THREADS	= 4,	/*!< Upper limit for number of encoder threads.			*/
+	MAX_PENDING_IMAGES			= 16	/*!< Max images in flight before writeImage() blocks.	*/
+};
+
+typedef struct ImageJob_s ImageJob;
+
+struct ImageJob_s
+{
+	/* Set by submitter. */
+	qpImageCompressionMode	compressionMode;
+	qpImageFormat			imageFormat;
+	int						width;
+	int						height;
+	Buffer					pixels;				/*!< Tightly packed copy of pixel data.	*/
+
+	/* Set by encoder thread before signaling done. */
+	qpImageCompressionMode	resultMode;			/*!< Compression mode actually used.	*/
+	char*					encoded;			/*!< Base64 data, DE_NULL on failure.	*/
+	size_t					numEncodedChars;
+
+	deSemaphore				done;
+	ImageJob*				next;				/*!< Next job in encoder queue.			*/
+};
+
+typedef enum PendingItemType_e
+{
+	PENDINGITEMTYPE_IMAGE = 0,
+	PENDINGITEMTYPE_START_IMAGESET,
+	PENDINGITEMTYPE_END_IMAGESET,
+
+	PENDINGITEMTYPE_LAST
+} PendingItemType;
+
+struct PendingItem_s
+{
+	PendingItemType			type;
+	char*					name;
+	char*					description;
+	ImageJob*				job;				/*!< Only for PENDINGITEMTYPE_IMAGE.	*/
+	PendingItem*			next;
+};
+
+struct ImageEncoder_s
+{
+	deMutex					lock;				/*!< Lock for job queue.				*/
+	deSemaphore				numQueuedJobs;
+	ImageJob*				firstJob;
+	ImageJob*				lastJob;
+
+	int						numThreads;
+	deThread				threads[MAX_IMAGE_ENCODER_THREADS];
+};
+
+static void ImageJob_destroy (ImageJob* job)
+{
+	if (job->done)
+		deSemaphore_destroy(job->done);
+
+	Buffer_deinit(&job->pixels);
+	deFree(job->encoded);
+	deFree(job);
+}
+
+static ImageJob* ImageJob_create (qpImageCompressionMode compressionMode, qpImageFormat imageFormat, int width, int height, int stride, const void* data)
+{
+	const int	pixelSize		= imageFormat == QP_IMAGE_FORMAT_RGB888 ? 3 : 4;
+	const int	packedStride	= pixelSize*width;
+	ImageJob*	job				= (ImageJob*)deCalloc(sizeof(ImageJob));
+	int			row;
+
+	if (!job)
+		return DE_NULL;
+
+	job->compressionMode	= compressionMode;
+	job->imageFormat		= imageFormat;
+	job->width				= width;
+	job->height				= height;
+	job->done				= deSemaphore_create(0, DE_NULL);
+
+	Buffer_init(&job->pixels);
+
+	if (!job->done || !Buffer_resize(&job->pixels, (size_t)(packedStride*height)))
+	{
+		ImageJob_destroy(job);
+		return DE_NULL;
+	}
+
+	/* Caller may reuse data as soon as writeImage() returns. */
+	for (row = 0; row < height; row++)
+		memcpy(&job->pixels.data[packedStride*row], &((const deUint8*)data)[row*stride], (size_t)packedStride);
+
+	return job;
+}
+
+static void ImageJob_execute (ImageJob* job)
+{
+	const deUint8*	data		= job->pixels.data;
+	size_t			dataSize	= job->pixels.size;
+	Buffer			compressedBuffer;
+
+	Buffer_init(&compressedBuffer);
+	job->resultMode = job->compressionMode;
+
+#if defined(QP_SUPPORT_PNG)
+	if (job->compressionMode == QP_IMAGE_COMPRESSION_MODE_PNG)
+	{
+		const int pixelSize = job->imageFormat == QP_IMAGE_FORMAT_RGB888 ? 3 : 4;
+
+		if (compressImagePNG(&compressedBuffer, job->imageFormat, job->width, job->height, pixelSize*job->width, data))
+		{
+			data		= compressedBuffer.data;
+			dataSize	= compressedBuffer.size;
+		}
+		else
+		{
+			/* Fall-back to default compression. */
+			qpPrintf("WARNING: PNG compression failed -- storing image uncompressed.\n");
+			job->resultMode = QP_IMAGE_COMPRESSION_MODE_NONE;
+		}
+	}
+#endif
+
+	job->numEncodedChars	= qpXmlWriter_getBase64EncodedLength(dataSize);
+	job->encoded			= (char*)deMalloc(job->numEncodedChars);
+
+	if (job->encoded)
+		qpXmlWriter_encodeBase64(job->encoded, data, dataSize);
+
+	Buffer_deinit(&compressedBuffer);
+	Buffer_deinit(&job->pixels);
+}
+
+static void imageEncoderThread (void* arg)
+{
+	ImageEncoder* encoder = (ImageEncoder*)arg;
+
+	for (;;)
+	{
+		ImageJob* job;
+
+		deSemaphore_decrement(encoder->numQueuedJobs);
+
+		deMutex_lock(encoder->lock);
+		job = encoder->firstJob;
+		if (job)
+		{
+			encoder->firstJob = job->next;
+			if (!encoder->firstJob)
+				encoder->lastJob = DE_NULL;
+		}
+		deMutex_unlock(encoder->lock);
+
+		/* Empty queue means ImageEncoder_destroy() wants us to exit. */
+		if (!job)
+			break;
+
+		ImageJob_execute(job);
+		deSemaphore_increment(job->done);
+	}
+}
+
+static void ImageEncoder_destroy (ImageEncoder* encoder)
+{
+	int ndx;
+
+	/* \note All jobs must have completed, so each thread exits after one wake-up. */
+	DE_ASSERT(!encoder->firstJob);
+
+	for (ndx = 0; ndx < encoder->numThreads; ndx++)
+		deSemaphore_increment(encoder->numQueuedJobs);
+
+	for (ndx = 0; ndx < encoder->numThreads; ndx++)
+	{
+		deThread_join(encoder->threads[ndx]);
+		deThread_destroy(encoder->threads[ndx]);
+	}
+
+	if (encoder->numQueuedJobs)
+		deSemaphore_destroy(encoder->numQueuedJobs);
+
+	if (encoder->lock)
+		deMutex_destroy(encoder->lock);
+
+	deFree(encoder);
+}
+
+static ImageEncoder* ImageEncoder_create (void)
+{
+	const int		numThreads	= deClamp32((int)deGetNumAvailableLogicalCores(), 1, MAX_IMAGE_ENCODER_THREADS);
+	ImageEncoder*	encoder		= (ImageEncoder*)deCalloc(sizeof(ImageEncoder));
+	int				ndx;
+
+	if (!encoder)
+		return DE_NULL;
+
+	encoder->lock			= deMutex_create(DE_NULL);
+	encoder->numQueuedJobs	= deSemaphore_create(0, DE_NULL);
+
+	if (!encoder->lock || !encoder->numQueuedJobs)
+	{
+		ImageEncoder_destroy(encoder);
+		return DE_NULL;
+	}
+
+	for (ndx = 0; ndx < numThreads; ndx++)
+	{
+		encoder->threads[ndx] = deThread_create(imageEncoderThread, encoder, DE_NULL);
+
+		if (!encoder->threads[ndx])
+		{
+			ImageEncoder_destroy(encoder);
+			return DE_NULL;
+		}
+
+		encoder->numThreads += 1;
+	}
+
+	return encoder;
+}
+
+static void ImageEncoder_submit (ImageEncoder* encoder, ImageJob* job)
+{
+	job->next = DE_NULL;
+
+	deMutex_lock(encoder->lock);
+	if (encoder->lastJob)
+		encoder->lastJob->next = job;
+	else
+		encoder->firstJob = job;
+	encoder->lastJob = job;
+	deMutex_unlock(encoder->lock);
+
+	deSemaphore_increment(encoder->numQueuedJobs);
+}
+
+static void PendingItem_destroy (PendingItem* item)
+{
+	if (item->job)
+		ImageJob_destroy(item->job);
+
+	deFree(item->name);
+	deFree(item->description);
+	deFree(item);
+}
+
+/* \note On failure job is not destroyed and remains owned by caller. */
+static PendingItem* PendingItem_create (PendingItemType type, const char* name, const char* description, ImageJob* job)
+{
+	PendingItem* item = (PendingItem*)deCalloc(sizeof(PendingItem));
+
+	if (!item)
+		return DE_NULL;
+
+	item->type			= type;
+	item->name			= name ? deStrdup(name) : DE_NULL;
+	item->description	= description ? deStrdup(description) : DE_NULL;
+
+	if ((name && !item->name) || (description && !item->description))
+	{
+		PendingItem_destroy(item);
+		return DE_NULL;
+	}
+
+	item->job = job;
+	return item;
+}
+
+static void enqueuePendingItem (qpTestLog* log, PendingItem* item)
+{
+	item->next = DE_NULL;
+
+	if (log->lastPendingItem)
+		log->lastPendingItem->next = item;
+	else
+		log->firstPendingItem = item;
+	log->lastPendingItem = item;
+
+	if (item->type == PENDINGITEMTYPE_IMAGE)
+		log->numPendingImages += 1;
+}
+
+static deBool writeImageSetStart (qpTestLog* log, const char* name, const char* description)
+{
+	qpXmlAttribute	attribs[4];
+	int				numAttribs = 0;
+
+	attribs[numAttribs++] = qpSetStringAttrib("Name", name);
+	if (description)
+		attribs[numAttribs++] = qpSetStringAttrib("Description", description);
+
+	/* <ImageSet Name="<name>"> */
+	if (!qpXmlWriter_startElement(log->writer, "ImageSet", numAttribs, attribs))
+	{
+		qpPrintf("qpTestLog_startImageSet(): Writing XML failed\n");
+		return DE_FALSE;
+	}
+
+	return DE_TRUE;
+}
+
+static deBool writeImageSetEnd (qpTestLog* log)
+{
+	/* <ImageSet Name="<name>"> */
+	if (!qpXmlWriter_endElement(log->writer, "ImageSet"))
+	{
+		qpPrintf("qpTestLog_endImageSet(): Writing XML failed\n");
+		return DE_FALSE;
+	}
+
+	return DE_TRUE;
+}
+
+static deBool startImageElement (qpTestLog* log, const char* name, const char* description, qpImageCompressionMode compressionMode, qpImageFormat imageFormat, int width, int height)
+{
+	char			widthStr[32];
+	char			heightStr[32];
+	qpXmlAttribute	attribs[8];
+	int				numAttribs			= 0;
+
+	int32ToString(width, widthStr);
+	int32ToString(height, heightStr);
+	attribs[numAttribs++] = qpSetStringAttrib("Name", name);
+	attribs[numAttribs++] = qpSetStringAttrib("Width", widthStr);
+	attribs[numAttribs++] = qpSetStringAttrib("Height", heightStr);
+	attribs[numAttribs++] = qpSetStringAttrib("Format", QP_LOOKUP_STRING(s_qpImageFormatMap, imageFormat));
+	attribs[numAttribs++] = qpSetStringAttrib("CompressionMode", QP_LOOKUP_STRING(s_qpImageCompressionModeMap, compressionMode));
+	if (description) attribs[numAttribs++] = qpSetStringAttrib("Description", description);
+
+	/* <Image ID="result" Name="Foobar" Width="640" Height="480" Format="RGB888" CompressionMode="None">base64 data</Image> */
+	return qpXmlWriter_startElement(log->writer, "Image", numAttribs, attribs);
+}
+
+static deBool writePendingItem (qpTestLog* log, const PendingItem* item)
+{
+	switch (item->type)
+	{
+		case PENDINGITEMTYPE_IMAGE:
+		{
+			const ImageJob* job = item->job;
+
+			if (!job->encoded)
+			{
+				qpPrintf("ERROR: Failed to encode image '%s' for writing.\n", item->name);
+				return DE_FALSE;
+			}
+
+			if (!startImageElement(log, item->name, item->description, job->resultMode, job->imageFormat, job->width, job->height) ||
+				!qpXmlWriter_writeBase64Encoded(log->writer, job->encoded, job->numEncodedChars) ||
+				!qpXmlWriter_endElement(log->writer, "Image"))
+			{
+				qpPrintf("qpTestLog_writeImage(): Writing XML failed\n");
+				return DE_FALSE;
+			}
+
+			return DE_TRUE;
+		}
+
+		case PENDINGITEMTYPE_START_IMAGESET:
+			return writeImageSetStart(log, item->name, item->description);
+
+		case PENDINGITEMTYPE_END_IMAGESET:
+			return writeImageSetEnd(log);
+
+		default:
+			DE_ASSERT(DE_FALSE);
+			return DE_FALSE;
+	}
+}
+
+/* Write items from the head of the pending queue, waiting for encoding until at most maxPendingImages images remain. */
+static void flushPendingItems (qpTestLog* log, int maxPendingImages)
+{
+	while (log->firstPendingItem)
+	{
+		PendingItem* item = log->firstPendingItem;
+
+		if (item->type == PENDINGITEMTYPE_IMAGE)
+		{
+			if (log->numPendingImages > maxPendingImages)
+				deSemaphore_decrement(item->job->done);
+			else if (!deSemaphore_tryDecrement(item->job->done))
+				break;
+
+			log->numPendingImages -= 1;
+		}
+
+		/* \note Failures are reported by writePendingItem(); the call that queued the item has already returned. */
+		writePendingItem(log, item);
+
+		log->firstPendingItem = item->next;
+		if (!log->firstPendingItem)
+			log->lastPendingItem = DE_NULL;
+
+		PendingItem_destroy(item);
+	}
+}
+
+/* Write items that can be written without waiting. */
+DE_INLINE void writeCompletedPendingItems (qpTestLog* log)
+{
+	flushPendingItems(log, log->numPendingImages);
+}
+
+/* Append element to pending queue, or write it directly if nothing is pending. */
+static deBool writeOrQueueImageSetElement (qpTestLog* log, PendingItemType type, const char* name, const char* description)
+{
+	writeCompletedPendingItems(log);
+
+	if (log->firstPendingItem)
+	{
+		PendingItem* item = PendingItem_create(type, name, description, DE_NULL);
+
+		if (!item)
+		{
+			qpPrintf("ERROR: Failed to queue image set for writing.\n");
+			return DE_FALSE;
+		}
+
+		enqueuePendingItem(log, item);
+		return DE_TRUE;
+	}
+	else if (type == PENDINGITEMTYPE_START_IMAGESET)
+		return writeImageSetStart(log, name, description);
+	else
+		return writeImageSetEnd(log);
+}
+
+static deBool writeImageAsync (qpTestLog* log, const char* name, const char* description, qpImageCompressionMode compressionMode, qpImageFormat imageFormat, int width, int height, int stride, const void* data)
+{
+	ImageJob*		job		= DE_NULL;
+	PendingItem*	item	= DE_NULL;
+
+#if defined(QP_SUPPORT_PNG)
+	if (compressionMode != QP_IMAGE_COMPRESSION_MODE_NONE && compressionMode != QP_IMAGE_COMPRESSION_MODE_PNG)
+#else
+	if (compressionMode != QP_IMAGE_COMPRESSION_MODE_NONE)
+#endif
+	{
+		qpPrintf("qpTestLog_writeImage(): Unknown compression mode: %s\n", QP_LOOKUP_STRING(s_qpImageCompressionModeMap, compressionMode));
+		return DE_FALSE;
+	}
+
+	job		= ImageJob_create(compressionMode, imageFormat, width, height, stride, data);
+	item	= job ? PendingItem_create(PENDINGITEMTYPE_IMAGE, name, description, job) : DE_NULL;
+
+	if (!item)
+	{
+		qpPrintf("ERROR: Failed to queue image for writing.\n");
+		if (job)
+			ImageJob_destroy(job);
+		return DE_FALSE;
+	}
+
+	deMutex_lock(log->lock);
+
+	/* Bound memory held by images in flight. */
+	flushPendingItems(log, MAX_PENDING_IMAGES-1);
+
+	enqueuePendingItem(log, item);
+	ImageEncoder_submit(log->imageEncoder, job);
+
+	deMutex_unlock(log->lock);
+	return DE_TRUE;
+}
+
 /*--------------------------------------------------------------------*//*!
  * \brief Start image set
  * \param log			qpTestLog instance
@@ -772,20 +1420,12 @@ static deBool compressImagePNG (Buffer* buffer, qpImageFormat imageFormat, int w
  *//*--------------------------------------------------------------------*/
 deBool qpTestLog_startImageSet (qpTestLog* log, const char* name, const char* description)
 {
-	qpXmlAttribute	attribs[4];
-	int				numAttribs = 0;
-
 	DE_ASSERT(log && name);
 	deMutex_lock(log->lock);
 
-	attribs[numAttribs++] = qpSetStringAttrib("Name", name);
-	if (description)
-		attribs[numAttribs++] = qpSetStringAttrib("Description", description);
-
-	/* <ImageSet Name="<name>"> */
-	if (!qpXmlWriter_startElement(log->writer, "ImageSet", numAttribs, attribs))
+	/* \note Image set may have to wait for images still being encoded. */
+	if (!writeOrQueueImageSetElement(log, PENDINGITEMTYPE_START_IMAGESET, name, description))
 	{
-		qpPrintf("qpTestLog_startImageSet(): Writing XML failed\n");
 		deMutex_unlock(log->lock);
 		return DE_FALSE;
 	}
@@ -806,10 +1446,8 @@ deBool qpTestLog_endImageSet (qpTestLog* log)
 	DE_ASSERT(log);
 	deMutex_lock(log->lock);
 
-	/* <ImageSet Name="<name>"> */
-	if (!qpXmlWriter_endElement(log->writer, "ImageSet"))
+	if (!writeOrQueueImageSetElement(log, PENDINGITEMTYPE_END_IMAGESET, DE_NULL, DE_NULL))
 	{
-		qpPrintf("qpTestLog_endImageSet(): Writing XML failed\n");
 		deMutex_unlock(log->lock);
 		return DE_FALSE;
 	}
@@ -832,6 +1470,10 @@ deBool qpTestLog_endImageSet (qpTestLog* log)
  * \param stride			Data stride (offset between rows)
  * \param data				Pointer to pixel data
  * \return 0 if OK, otherwise <0
+ *
+ * If log was created with QP_TEST_LOG_ASYNC_IMAGES, pixel data is copied
+ * and compression and encoding happen on a background thread. Errors
+ * from that point on are only reported in the output.
  *//*--------------------------------------------------------------------*/
 deBool qpTestLog_writeImage	(
 	qpTestLog*				log,
@@ -844,10 +1486,6 @@ deBool qpTestLog_writeImage	(
 	int						stride,
 	const void*				data)
 {
-	char			widthStr[32];
-	char			heightStr[32];
-	qpXmlAttribute	attribs[8];
-	int				numAttribs			= 0;
 	Buffer			compressedBuffer;
 	const void*		writeDataPtr		= DE_NULL;
 	size_t			writeDataBytes		= ~(size_t)0;
@@ -860,8 +1498,6 @@ deBool qpTestLog_writeImage	(
 	if (log->flags & QP_TEST_LOG_EXCLUDE_IMAGES)
 		return DE_TRUE; /* Image not logged. */
 
-	Buffer_init(&compressedBuffer);
-
 	/* BEST compression mode defaults to PNG. */
 	if (compressionMode == QP_IMAGE_COMPRESSION_MODE_BEST)
 	{
@@ -872,6 +1508,11 @@ deBool qpTestLog_writeImage	(
 #endif
 	}
 
+	if (log->imageEncoder)
+		return writeImageAsync(log, name, description, compressionMode, imageFormat, width, height, stride, data);
+
+	Buffer_init(&compressedBuffer);
+
 #if defined(QP_SUPPORT_PNG)
 	/* Try storing with PNG compression. */
 	if (compressionMode == QP_IMAGE_COMPRESSION_MODE_PNG)
@@ -909,6 +1550,8 @@ deBool qpTestLog_writeImage	(
 					int row;
 					for (row = 0; row < height; row++)
 						memcpy(&compressedBuffer.data[packedStride*row], &((const deUint8*)data)[row*stride], (size_t)(pixelSize*width));
+
+					writeDataPtr = compressedBuffer.data;
 				}
 				else
 				{
@@ -934,21 +1577,10 @@ deBool qpTestLog_writeImage	(
 			return DE_FALSE;
 	}
 
-	/* Fill in attributes. */
-	int32ToString(width, widthStr);
-	int32ToString(height, heightStr);
-	attribs[numAttribs++] = qpSetStringAttrib("Name", name);
-	attribs[numAttribs++] = qpSetStringAttrib("Width", widthStr);
-	attribs[numAttribs++] = qpSetStringAttrib("Height", heightStr);
-	attribs[numAttribs++] = qpSetStringAttrib("Format", QP_LOOKUP_STRING(s_qpImageFormatMap, imageFormat));
-	attribs[numAttribs++] = qpSetStringAttrib("CompressionMode", QP_LOOKUP_STRING(s_qpImageCompressionModeMap, compressionMode));
-	if (description) attribs[numAttribs++] = qpSetStringAttrib("Description", description);
-
 	/* \note Log lock is acquired after compression! */
-	deMutex_lock(log->lock);
+	lockLog(log);
 
-	/* <Image ID="result" Name="Foobar" Width="640" Height="480" Format="RGB888" CompressionMode="None">base64 data</Image> */
-	if (!qpXmlWriter_startElement(log->writer, "Image", numAttribs, attribs) ||
+	if (!startImageElement(log, name, description, compressionMode, imageFormat, width, height) ||
 		!qpXmlWriter_writeBase64(log->writer, (const deUint8*)writeDataPtr, writeDataBytes) ||
 		!qpXmlWriter_endElement(log->writer, "Image"))
 	{
@@ -977,7 +1609,7 @@ deBool qpTestLog_startShaderProgram (qpTestLog* log, deBool linkOk, const char*
 	int				numProgramAttribs = 0;
 
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	programAttribs[numProgramAttribs++] = qpSetStringAttrib("LinkStatus", linkOk ? "OK" : "Fail");
 
@@ -1003,7 +1635,7 @@ deBool qpTestLog_startShaderProgram (qpTestLog* log, deBool linkOk, const char*
 deBool qpTestLog_endShaderProgram (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	/* </ShaderProgram> */
 	if (!qpXmlWriter_endElement(log->writer, "ShaderProgram"))
@@ -1033,7 +1665,7 @@ deBool qpTestLog_writeShader (qpTestLog* log, qpShaderType type, const char* sou
 	int				numShaderAttribs	= 0;
 	qpXmlAttribute	shaderAttribs[4];
 
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(source);
 	DE_ASSERT(ContainerStack_getTop(&log->containerStack) == CONTAINERTYPE_SHADERPROGRAM);
@@ -1063,7 +1695,7 @@ deBool qpTestLog_startEglConfigSet (qpTestLog* log, const char* name, const char
 	int				numAttribs = 0;
 
 	DE_ASSERT(log && name);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	attribs[numAttribs++] = qpSetStringAttrib("Name", name);
 	if (description)
@@ -1089,7 +1721,7 @@ deBool qpTestLog_startEglConfigSet (qpTestLog* log, const char* name, const char
 deBool qpTestLog_endEglConfigSet (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	/* <EglConfigSet Name="<name>"> */
 	if (!qpXmlWriter_endElement(log->writer, "EglConfigSet"))
@@ -1115,7 +1747,7 @@ deBool qpTestLog_writeEglConfig (qpTestLog* log, const qpEglConfigInfo* config)
 	int				numAttribs = 0;
 
 	DE_ASSERT(log && config);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	attribs[numAttribs++] = qpSetIntAttrib		("BufferSize", config->bufferSize);
 	attribs[numAttribs++] = qpSetIntAttrib		("RedSize", config->redSize);
@@ -1174,7 +1806,7 @@ deBool qpTestLog_startSection (qpTestLog* log, const char* name, const char* des
 	int				numAttribs = 0;
 
 	DE_ASSERT(log && name);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	attribs[numAttribs++] = qpSetStringAttrib("Name", name);
 	if (description)
@@ -1202,7 +1834,7 @@ deBool qpTestLog_startSection (qpTestLog* log, const char* name, const char* des
 deBool qpTestLog_endSection (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	/* </Section> */
 	if (!qpXmlWriter_endElement(log->writer, "Section"))
@@ -1226,7 +1858,7 @@ deBool qpTestLog_writeKernelSource (qpTestLog* log, const char* source)
 	const char*		sourceStr	= (log->flags & QP_TEST_LOG_EXCLUDE_SHADER_SOURCES) != 0 ? "" : source;
 
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	if (!qpXmlWriter_writeStringElement(log->writer, "KernelSource", sourceStr))
 	{
@@ -1246,7 +1878,7 @@ deBool qpTestLog_writeSpirVAssemblySource (qpTestLog* log, const char* source)
 {
 	const char* const	sourceStr	= (log->flags & QP_TEST_LOG_EXCLUDE_SHADER_SOURCES) != 0 ? "" : source;
 
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(ContainerStack_getTop(&log->containerStack) == CONTAINERTYPE_SHADERPROGRAM);
 
@@ -1270,7 +1902,7 @@ deBool qpTestLog_writeCompileInfo (qpTestLog* log, const char* name, const char*
 	qpXmlAttribute	attribs[3];
 
 	DE_ASSERT(log && name && description && infoLog);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	attribs[numAttribs++] = qpSetStringAttrib("Name", name);
 	attribs[numAttribs++] = qpSetStringAttrib("Description", description);
@@ -1295,7 +1927,7 @@ deBool qpTestLog_startSampleList (qpTestLog* log, const char* name, const char*
 	qpXmlAttribute	attribs[2];
 
 	DE_ASSERT(log && name && description);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	attribs[numAttribs++] = qpSetStringAttrib("Name", name);
 	attribs[numAttribs++] = qpSetStringAttrib("Description", description);
@@ -1316,7 +1948,7 @@ deBool qpTestLog_startSampleList (qpTestLog* log, const char* name, const char*
 deBool qpTestLog_startSampleInfo (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	if (!qpXmlWriter_startElement(log->writer, "SampleInfo", 0, DE_NULL))
 	{
@@ -1338,7 +1970,7 @@ deBool qpTestLog_writeValueInfo (qpTestLog* log, const char* name, const char* d
 	qpXmlAttribute	attribs[4];
 
 	DE_ASSERT(log && name && description && tagName);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(ContainerStack_getTop(&log->containerStack) == CONTAINERTYPE_SAMPLEINFO);
 
@@ -1364,7 +1996,7 @@ deBool qpTestLog_writeValueInfo (qpTestLog* log, const char* name, const char* d
 deBool qpTestLog_endSampleInfo (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	if (!qpXmlWriter_endElement(log->writer, "SampleInfo"))
 	{
@@ -1382,7 +2014,7 @@ deBool qpTestLog_endSampleInfo (qpTestLog* log)
 deBool qpTestLog_startSample (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(ContainerStack_getTop(&log->containerStack) == CONTAINERTYPE_SAMPLELIST);
 
@@ -1404,7 +2036,7 @@ deBool qpTestLog_writeValueFloat (qpTestLog* log, double value)
 	char tmpString[512];
 	doubleToString(value, tmpString, (int)sizeof(tmpString));
 
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(ContainerStack_getTop(&log->containerStack) == CONTAINERTYPE_SAMPLE);
 
@@ -1424,7 +2056,7 @@ deBool qpTestLog_writeValueInteger (qpTestLog* log, deInt64 value)
 	char tmpString[64];
 	int64ToString(value, tmpString);
 
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(ContainerStack_getTop(&log->containerStack) == CONTAINERTYPE_SAMPLE);
 
@@ -1442,7 +2074,7 @@ deBool qpTestLog_writeValueInteger (qpTestLog* log, deInt64 value)
 deBool qpTestLog_endSample (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	if (!qpXmlWriter_endElement(log->writer, "Sample"))
 	{
@@ -1460,7 +2092,7 @@ deBool qpTestLog_endSample (qpTestLog* log)
 deBool qpTestLog_endSampleList (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	if (!qpXmlWriter_endElement(log->writer, "SampleList"))
 	{
@@ -134,7 +134,8 @@ typedef enum qpTestLogFlag_e
 {
 	QP_TEST_LOG_EXCLUDE_IMAGES			= (1<<0),		/*!< Do not log images. This reduces log size considerably.			*/
 	QP_TEST_LOG_EXCLUDE_SHADER_SOURCES	= (1<<1),		/*!< Do not log shader sources. Helps to reduce log size further.	*/
-	QP_TEST_LOG_NO_FLUSH				= (1<<2)		/*!< Do not do a fflush after writing the log.						*/
+	QP_TEST_LOG_NO_FLUSH				= (1<<2),		/*!< Do not do a fflush after writing the log.						*/
+	QP_TEST_LOG_ASYNC_IMAGES			= (1<<3)		/*!< Compress and encode images on background threads.				*/
 } qpTestLogFlag;
 
 /* Shader type. */
@@ -189,8 +190,13 @@ typedef struct qpEglConfigInfo_s
 
 
 qpTestLog*		qpTestLog_createFileLog			(const char* fileName, deUint32 flags);
+qpTestLog*		qpTestLog_createBufferLog		(deUint32 flags);
 void			qpTestLog_destroy				(qpTestLog* log);
 
+size_t			qpTestLog_getBufferSize			(qpTestLog* log);
+deBool			qpTestLog_readBuffer			(qpTestLog* log, void* dst, size_t size);
+deBool			qpTestLog_writeBufferData		(qpTestLog* log, const void* data, size_t size);
+
 deBool			qpTestLog_startCase				(qpTestLog* log, const char* testCasePath, qpTestCaseType testCaseType);
 deBool			qpTestLog_endCase				(qpTestLog* log, qpTestResult result, const char* description);
 deBool			qpTestLog_terminateCase			(qpTestLog* log, qpTestResult result);
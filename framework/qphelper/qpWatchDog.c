@@ -146,3 +146,13 @@ void qpWatchDog_touch (qpWatchDog* dog)
 	DBGPRINT(("qpWatchDog::touch()\n"));
 	dog->lastTouchTime = deGetMicroseconds();
 }
+
+/* Set reset and touch times (in deGetMicroseconds() time base) explicitly. Used when cases are
+ * executed concurrently, in which case the times of the oldest running case are tracked. */
+void qpWatchDog_setTimes (qpWatchDog* dog, deUint64 resetTime, deUint64 lastTouchTime)
+{
+	DE_ASSERT(dog);
+	DBGPRINT(("qpWatchDog::setTimes()\n"));
+	dog->resetTime		= resetTime;
+	dog->lastTouchTime	= lastTouchTime;
+}
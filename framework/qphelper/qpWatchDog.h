@@ -35,6 +35,7 @@ qpWatchDog*		qpWatchDog_create		(qpWatchDogFunc watchDogFunc, void* userPtr, int
 void			qpWatchDog_destroy		(qpWatchDog* dog);
 void			qpWatchDog_reset		(qpWatchDog* dog);
 void			qpWatchDog_touch		(qpWatchDog* dog);
+void			qpWatchDog_setTimes		(qpWatchDog* dog, deUint64 resetTime, deUint64 lastTouchTime);
 
 DE_END_EXTERN_C
 
@@ -185,6 +185,14 @@ deBool qpXmlWriter_endDocument (qpXmlWriter* writer)
 	return DE_TRUE;
 }
 
+void qpXmlWriter_abandonDocument (qpXmlWriter* writer)
+{
+	DE_ASSERT(writer);
+	writer->xmlIsWriting			= DE_FALSE;
+	writer->xmlElementDepth			= 0;
+	writer->xmlPrevIsStartElement	= DE_FALSE;
+}
+
 deBool qpXmlWriter_writeString (qpXmlWriter* writer, const char* str)
 {
 	if (writer->xmlPrevIsStartElement)
@@ -253,7 +261,17 @@ deBool qpXmlWriter_endElement (qpXmlWriter* writer, const char* elementName)
 	return DE_TRUE;
 }
 
-deBool qpXmlWriter_writeBase64 (qpXmlWriter* writer, const deUint8* data, size_t numBytes)
+enum
+{
+	BASE64_LINE_LENGTH	= 64	/*!< Characters per line in base64 encoded data. */
+};
+
+size_t qpXmlWriter_getBase64EncodedLength (size_t numBytes)
+{
+	return (numBytes + 2) / 3 * 4;
+}
+
+void qpXmlWriter_encodeBase64 (char* dst, const deUint8* data, size_t numBytes)
 {
 	static const char s_base64Table[64] =
 	{
@@ -264,61 +282,80 @@ deBool qpXmlWriter_writeBase64 (qpXmlWriter* writer, const deUint8* data, size_t
 		'0','1','2','3','4','5','6','7','8','9','+','/'
 	};
 
-	int			numWritten	= 0;
-	size_t		srcNdx		= 0;
-	deBool		writeIndent	= DE_TRUE;
-	const char*	indentStr	= getIndentStr(writer->xmlElementDepth);
-
-	DE_ASSERT(writer && data && (numBytes > 0));
+	size_t srcNdx = 0;
 
-	/* Close and pending writes. */
-	closePending(writer);
+	DE_ASSERT(dst && (data || numBytes == 0));
 
 	/* Loop all input chars. */
 	while (srcNdx < numBytes)
 	{
-		size_t	numRead = (size_t)deMin32(3, (int)(numBytes - srcNdx));
+		size_t	numRead = (numBytes - srcNdx < 3) ? (numBytes - srcNdx) : 3;
 		deUint8	s0 = data[srcNdx];
 		deUint8	s1 = (numRead >= 2) ? data[srcNdx+1] : 0;
 		deUint8	s2 = (numRead >= 3) ? data[srcNdx+2] : 0;
-		char	d[5];
 
 		srcNdx += numRead;
 
-		d[0] = s_base64Table[s0 >> 2];
-		d[1] = s_base64Table[((s0&0x3)<<4) | (s1>>4)];
-		d[2] = s_base64Table[((s1&0xF)<<2) | (s2>>6)];
-		d[3] = s_base64Table[s2&0x3F];
-		d[4] = 0;
+		dst[0] = s_base64Table[s0 >> 2];
+		dst[1] = s_base64Table[((s0&0x3)<<4) | (s1>>4)];
+		dst[2] = s_base64Table[((s1&0xF)<<2) | (s2>>6)];
+		dst[3] = s_base64Table[s2&0x3F];
 
-		if (numRead < 3) d[3] = '=';
-		if (numRead < 2) d[2] = '=';
+		if (numRead < 3) dst[3] = '=';
+		if (numRead < 2) dst[2] = '=';
 
-		/* Write indent (if needed). */
-		if (writeIndent)
-		{
-			fprintf(writer->outputFile, "%s", indentStr);
-			writeIndent = DE_FALSE;
-		}
+		dst += 4;
+	}
+}
+
+deBool qpXmlWriter_writeBase64Encoded (qpXmlWriter* writer, const char* encoded, size_t numChars)
+{
+	const char*	indentStr	= getIndentStr(writer->xmlElementDepth);
+	size_t		ndx			= 0;
 
-		/* Write data. */
-		fprintf(writer->outputFile, "%s", &d[0]);
+	DE_ASSERT(writer && encoded && (numChars > 0));
 
-		/* EOL every now and then. */
-		numWritten += 4;
-		if (numWritten >= 64)
-		{
-			fprintf(writer->outputFile, "\n");
-			numWritten = 0;
-			writeIndent = DE_TRUE;
-		}
+	/* Close and pending writes. */
+	closePending(writer);
+
+	/* Write indented lines. */
+	while (ndx < numChars)
+	{
+		const size_t lineLength = (numChars - ndx < BASE64_LINE_LENGTH) ? (numChars - ndx) : BASE64_LINE_LENGTH;
+
+		fputs(indentStr, writer->outputFile);
+		fwrite(encoded + ndx, 1, lineLength, writer->outputFile);
+		fputc('\n', writer->outputFile);
+
+		ndx += lineLength;
 	}
 
-	/* Last EOL. */
-	if (numWritten > 0)
-		fprintf(writer->outputFile, "\n");
+	return DE_TRUE;
+}
+
+deBool qpXmlWriter_writeBase64 (qpXmlWriter* writer, const deUint8* data, size_t numBytes)
+{
+	/* \note Chunk size is a multiple of input bytes per line, so chunks don't split lines. */
+	enum { CHUNK_SIZE = 64 * BASE64_LINE_LENGTH/4*3 };
+
+	char	encoded[64 * BASE64_LINE_LENGTH];
+	size_t	srcNdx		= 0;
+
+	DE_STATIC_ASSERT(CHUNK_SIZE % (BASE64_LINE_LENGTH/4*3) == 0);
+	DE_ASSERT(writer && data && (numBytes > 0));
+
+	while (srcNdx < numBytes)
+	{
+		const size_t chunkSize = (numBytes - srcNdx < CHUNK_SIZE) ? (numBytes - srcNdx) : CHUNK_SIZE;
+
+		qpXmlWriter_encodeBase64(&encoded[0], data + srcNdx, chunkSize);
+
+		if (!qpXmlWriter_writeBase64Encoded(writer, &encoded[0], qpXmlWriter_getBase64EncodedLength(chunkSize)))
+			return DE_FALSE;
+
+		srcNdx += chunkSize;
+	}
 
-	DE_ASSERT(srcNdx == numBytes);
 	return DE_TRUE;
 }
 
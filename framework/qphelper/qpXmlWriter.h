@@ -116,6 +116,15 @@ deBool			qpXmlWriter_startDocument (qpXmlWriter* writer);
  *//*--------------------------------------------------------------------*/
 deBool			qpXmlWriter_endDocument (qpXmlWriter* writer);
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Abandon XML document without closing open elements
+ * \param writer qpXmlWriter instance
+ *
+ * Nothing is written. Used when test case log is terminated abruptly
+ * and writer is used again for the next document.
+ *//*--------------------------------------------------------------------*/
+void			qpXmlWriter_abandonDocument (qpXmlWriter* writer);
+
 /*--------------------------------------------------------------------*//*!
  * \brief Start XML element
  * \param writer qpXmlWriter instance
@@ -149,6 +158,35 @@ deBool			qpXmlWriter_writeString (qpXmlWriter* writer, const char* content);
  *//*--------------------------------------------------------------------*/
 deBool			qpXmlWriter_writeBase64 (qpXmlWriter* writer, const deUint8* data, size_t numBytes);
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Get length of base64 encoded data
+ * \param numBytes	Length of data in bytes
+ * \return Number of characters written by qpXmlWriter_encodeBase64()
+ *//*--------------------------------------------------------------------*/
+size_t			qpXmlWriter_getBase64EncodedLength (size_t numBytes);
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Encode data as base64
+ *
+ * Encoding does not depend on writer state, so it can be done in any
+ * thread. Result can be written with qpXmlWriter_writeBase64Encoded().
+ * \param dst		Destination buffer, qpXmlWriter_getBase64EncodedLength(numBytes) chars. Not null-terminated.
+ * \param data		Pointer to data to be encoded
+ * \param numBytes	Length of data in bytes
+ *//*--------------------------------------------------------------------*/
+void			qpXmlWriter_encodeBase64 (char* dst, const deUint8* data, size_t numBytes);
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Write already base64 encoded data into XML document
+ *
+ * Output is identical to qpXmlWriter_writeBase64() for the original data.
+ * \param writer	qpXmlWriter instance
+ * \param encoded	Base64 encoded data
+ * \param numChars	Length of encoded data
+ * \return true on success, false on error
+ *//*--------------------------------------------------------------------*/
+deBool			qpXmlWriter_writeBase64Encoded (qpXmlWriter* writer, const char* encoded, size_t numChars);
+
 /*--------------------------------------------------------------------*//*!
  * \brief Convenience function for writing XML element
  * \param writer qpXmlWriter instance
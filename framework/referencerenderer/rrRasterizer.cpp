@@ -23,8 +23,17 @@
 
 #include "rrRasterizer.hpp"
 #include "deMath.h"
+#include "deRandom.hpp"
 #include "tcuVectorUtil.hpp"
 
+#if (DE_CPU == DE_CPU_X86_64) || ((DE_CPU == DE_CPU_X86) && defined(__SSE2__))
+#	define RR_RASTERIZER_SSE2 1
+#	include <emmintrin.h>
+#elif ((DE_CPU == DE_CPU_ARM) || (DE_CPU == DE_CPU_ARM_64)) && defined(__ARM_NEON)
+#	define RR_RASTERIZER_NEON 1
+#	include <arm_neon.h>
+#endif
+
 namespace rr
 {
 
@@ -445,6 +454,194 @@ bool doesLineSegmentExitDiamond (const SubpixelLineSegment& line, const tcu::Vec
 
 } // LineRasterUtil
 
+// Sample positions - ordered as (x, y) list.
+
+// \note Macros are used to eliminate function calls even in debug builds.
+#define SAMPLE_POS_TO_SUBPIXEL_COORD(POS)	\
+	(deInt64)((POS) * (1<<RASTERIZER_SUBPIXEL_BITS) + 0.5f)
+
+#define SAMPLE_POS(X, Y)	\
+	SAMPLE_POS_TO_SUBPIXEL_COORD(X), SAMPLE_POS_TO_SUBPIXEL_COORD(Y)
+
+static const deInt64 s_samplePos1[] =
+{
+	SAMPLE_POS(0.5f, 0.5f)
+};
+
+static const deInt64 s_samplePos2[] =
+{
+	SAMPLE_POS(0.3f, 0.3f),
+	SAMPLE_POS(0.7f, 0.7f)
+};
+
+static const deInt64 s_samplePos4[] =
+{
+	SAMPLE_POS(0.25f, 0.25f),
+	SAMPLE_POS(0.75f, 0.25f),
+	SAMPLE_POS(0.25f, 0.75f),
+	SAMPLE_POS(0.75f, 0.75f)
+};
+DE_STATIC_ASSERT(DE_LENGTH_OF_ARRAY(s_samplePos4) == 4*2);
+
+static const deInt64 s_samplePos8[] =
+{
+	SAMPLE_POS( 7.f/16.f,  9.f/16.f),
+	SAMPLE_POS( 9.f/16.f, 13.f/16.f),
+	SAMPLE_POS(11.f/16.f,  3.f/16.f),
+	SAMPLE_POS(13.f/16.f, 11.f/16.f),
+	SAMPLE_POS( 1.f/16.f,  7.f/16.f),
+	SAMPLE_POS( 5.f/16.f,  1.f/16.f),
+	SAMPLE_POS(15.f/16.f,  5.f/16.f),
+	SAMPLE_POS( 3.f/16.f, 15.f/16.f)
+};
+DE_STATIC_ASSERT(DE_LENGTH_OF_ARRAY(s_samplePos8) == 8*2);
+
+static const deInt64 s_samplePos16[] =
+{
+	SAMPLE_POS(1.f/8.f, 1.f/8.f),
+	SAMPLE_POS(3.f/8.f, 1.f/8.f),
+	SAMPLE_POS(5.f/8.f, 1.f/8.f),
+	SAMPLE_POS(7.f/8.f, 1.f/8.f),
+	SAMPLE_POS(1.f/8.f, 3.f/8.f),
+	SAMPLE_POS(3.f/8.f, 3.f/8.f),
+	SAMPLE_POS(5.f/8.f, 3.f/8.f),
+	SAMPLE_POS(7.f/8.f, 3.f/8.f),
+	SAMPLE_POS(1.f/8.f, 5.f/8.f),
+	SAMPLE_POS(3.f/8.f, 5.f/8.f),
+	SAMPLE_POS(5.f/8.f, 5.f/8.f),
+	SAMPLE_POS(7.f/8.f, 5.f/8.f),
+	SAMPLE_POS(1.f/8.f, 7.f/8.f),
+	SAMPLE_POS(3.f/8.f, 7.f/8.f),
+	SAMPLE_POS(5.f/8.f, 7.f/8.f),
+	SAMPLE_POS(7.f/8.f, 7.f/8.f)
+};
+DE_STATIC_ASSERT(DE_LENGTH_OF_ARRAY(s_samplePos16) == 16*2);
+
+#undef SAMPLE_POS
+#undef SAMPLE_POS_TO_SUBPIXEL_COORD
+
+static const deInt64* getSamplePositions (const int numSamples)
+{
+	switch (numSamples)
+	{
+		case 1:		return s_samplePos1;
+		case 2:		return s_samplePos2;
+		case 4:		return s_samplePos4;
+		case 8:		return s_samplePos8;
+		case 16:	return s_samplePos16;
+		default:
+			DE_ASSERT(false);
+			return DE_NULL;
+	}
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Compute edge function offsets for packet sample positions
+ *
+ * Since edge functions are linear, edge value at any sample in a 2x2
+ * packet is edge value at packet origin plus a constant offset. Offsets
+ * are stored in coverage bit order. Exclusive edges are biased by -1 so
+ * that inside test becomes a sign test for both edge types.
+ *//*--------------------------------------------------------------------*/
+static void computeSampleEdgeOffsets (deInt64* dst, const EdgeFunction& edge, const int numSamples)
+{
+	const deInt64*	samplePos	= getSamplePositions(numSamples);
+	const deInt64	bias		= edge.inclusive ? 0 : 1;
+
+	for (int fragNdx = 0; fragNdx < 4; fragNdx++)
+	{
+		const int		xo		= fragNdx%2;
+		const int		yo		= fragNdx/2;
+		const int		offset	= getCoverageOffset(numSamples, xo, yo);
+
+		for (int sampleNdx = 0; sampleNdx < numSamples; sampleNdx++)
+		{
+			const deInt64 ox = toSubpixelCoord(xo) + samplePos[sampleNdx*2 + 0];
+			const deInt64 oy = toSubpixelCoord(yo) + samplePos[sampleNdx*2 + 1];
+
+			dst[offset + sampleNdx] = edge.a*ox + edge.b*oy - bias;
+		}
+	}
+}
+
+//! Compute mask of sample values outside any of the edges. Scalar version.
+static inline deUint64 computeOutsideMaskScalar (const deInt64 e01, const deInt64 e12, const deInt64 e20, const deInt64* off01, const deInt64* off12, const deInt64* off20, const int numValues)
+{
+	deUint64 outside = 0;
+
+	for (int ndx = 0; ndx < numValues; ndx++)
+	{
+		// Sign bit is set if value is outside any of the edges
+		const deInt64 combined = (e01 + off01[ndx]) | (e12 + off12[ndx]) | (e20 + off20[ndx]);
+		outside |= (deUint64)(combined < 0) << ndx;
+	}
+
+	return outside;
+}
+
+#if defined(RR_RASTERIZER_SSE2)
+
+//! Compute mask of sample values outside any of the edges. SSE2 version, numValues must be even.
+static inline deUint64 computeOutsideMaskSSE2 (const deInt64 e01, const deInt64 e12, const deInt64 e20, const deInt64* off01, const deInt64* off12, const deInt64* off20, const int numValues)
+{
+	const __m128i	b01		= _mm_set1_epi64x(e01);
+	const __m128i	b12		= _mm_set1_epi64x(e12);
+	const __m128i	b20		= _mm_set1_epi64x(e20);
+	deUint64		outside	= 0;
+
+	DE_ASSERT(numValues % 2 == 0);
+
+	for (int ndx = 0; ndx < numValues; ndx += 2)
+	{
+		const __m128i	v01			= _mm_add_epi64(b01, _mm_loadu_si128((const __m128i*)(off01 + ndx)));
+		const __m128i	v12			= _mm_add_epi64(b12, _mm_loadu_si128((const __m128i*)(off12 + ndx)));
+		const __m128i	v20			= _mm_add_epi64(b20, _mm_loadu_si128((const __m128i*)(off20 + ndx)));
+		const __m128i	combined	= _mm_or_si128(_mm_or_si128(v01, v12), v20);
+
+		outside |= (deUint64)_mm_movemask_pd(_mm_castsi128_pd(combined)) << ndx;
+	}
+
+	return outside;
+}
+
+#elif defined(RR_RASTERIZER_NEON)
+
+//! Compute mask of sample values outside any of the edges. NEON version, numValues must be even.
+static inline deUint64 computeOutsideMaskNEON (const deInt64 e01, const deInt64 e12, const deInt64 e20, const deInt64* off01, const deInt64* off12, const deInt64* off20, const int numValues)
+{
+	const int64x2_t	b01		= vdupq_n_s64(e01);
+	const int64x2_t	b12		= vdupq_n_s64(e12);
+	const int64x2_t	b20		= vdupq_n_s64(e20);
+	deUint64		outside	= 0;
+
+	DE_ASSERT(numValues % 2 == 0);
+
+	for (int ndx = 0; ndx < numValues; ndx += 2)
+	{
+		const int64x2_t		v01			= vaddq_s64(b01, vld1q_s64((const int64_t*)(off01 + ndx)));
+		const int64x2_t		v12			= vaddq_s64(b12, vld1q_s64((const int64_t*)(off12 + ndx)));
+		const int64x2_t		v20			= vaddq_s64(b20, vld1q_s64((const int64_t*)(off20 + ndx)));
+		const uint64x2_t	signBits	= vshrq_n_u64(vreinterpretq_u64_s64(vorrq_s64(vorrq_s64(v01, v12), v20)), 63);
+
+		outside |= (deUint64)(vgetq_lane_u64(signBits, 0) | (vgetq_lane_u64(signBits, 1) << 1)) << ndx;
+	}
+
+	return outside;
+}
+
+#endif
+
+static inline deUint64 computeOutsideMask (const deInt64 e01, const deInt64 e12, const deInt64 e20, const deInt64* off01, const deInt64* off12, const deInt64* off20, const int numValues)
+{
+#if defined(RR_RASTERIZER_SSE2)
+	return computeOutsideMaskSSE2(e01, e12, e20, off01, off12, off20, numValues);
+#elif defined(RR_RASTERIZER_NEON)
+	return computeOutsideMaskNEON(e01, e12, e20, off01, off12, off20, numValues);
+#else
+	return computeOutsideMaskScalar(e01, e12, e20, off01, off12, off20, numValues);
+#endif
+}
+
 TriangleRasterizer::TriangleRasterizer (const tcu::IVec4& viewport, const int numSamples, const RasterizationState& state)
 	: m_viewport		(viewport)
 	, m_numSamples		(numSamples)
@@ -503,6 +700,11 @@ void TriangleRasterizer::init (const tcu::Vec4& v0, const tcu::Vec4& v1, const t
 		reverseEdge(m_edge20);
 	}
 
+	// Edge offsets for coverage evaluation
+	computeSampleEdgeOffsets(m_sampleEdgeOffsets[0], m_edge01, m_numSamples);
+	computeSampleEdgeOffsets(m_sampleEdgeOffsets[1], m_edge12, m_numSamples);
+	computeSampleEdgeOffsets(m_sampleEdgeOffsets[2], m_edge20, m_numSamples);
+
 	// Bounding box
 	const deInt64	xMin	= de::min(de::min(x0, x1), x2);
 	const deInt64	xMax	= de::max(de::max(x0, x1), x2);
@@ -528,6 +730,65 @@ void TriangleRasterizer::init (const tcu::Vec4& v0, const tcu::Vec4& v1, const t
 	m_curPos = m_bboxMin;
 }
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Limit rasterization to packets overlapping given rectangle
+ * \param rect Rectangle (x, y, width, height) in pixels.
+ *
+ * Packet grid alignment is not changed, and thus generated packets are
+ * identical to the packets generated without the restriction. Packets
+ * crossing the rectangle boundary are not clipped.
+ *//*--------------------------------------------------------------------*/
+void TriangleRasterizer::restrictToRect (const tcu::IVec4& rect)
+{
+	const tcu::IVec2	rectMin		= rect.swizzle(0, 1);
+	const tcu::IVec2	rectMax		= rect.swizzle(0, 1) + rect.swizzle(2, 3) - tcu::IVec2(1);
+
+	for (int ndx = 0; ndx < 2; ndx++)
+	{
+		// Keep the 2x2 packet grid anchored to the original bounding box
+		if (rectMin[ndx] > m_bboxMin[ndx])
+			m_bboxMin[ndx] += (rectMin[ndx] - m_bboxMin[ndx]) & ~1;
+
+		m_bboxMax[ndx] = de::min(m_bboxMax[ndx], rectMax[ndx]);
+	}
+
+	m_curPos = m_bboxMin;
+
+	// Nothing to rasterize
+	if (m_bboxMin.x() > m_bboxMax.x())
+		m_curPos.y() = m_bboxMax.y() + 1;
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Compute coverage mask for 2x2 packet at (x0, y0)
+ *
+ * All samples of the packet are evaluated at once by adding precomputed
+ * sample offsets to edge function values at packet origin.
+ *//*--------------------------------------------------------------------*/
+deUint64 TriangleRasterizer::computePacketCoverage (const int x0, const int y0, const bool outX1, const bool outY1) const
+{
+	const deInt64	sx			= toSubpixelCoord(x0);
+	const deInt64	sy			= toSubpixelCoord(y0);
+	const int		numValues	= 4*m_numSamples;
+	const deUint64	packetMask	= (numValues == 64) ? ~0ull : ((1ull << numValues) - 1ull);
+	deUint64		coverage	= packetMask & ~computeOutsideMask(evaluateEdge(m_edge01, sx, sy),
+																evaluateEdge(m_edge12, sx, sy),
+																evaluateEdge(m_edge20, sx, sy),
+																m_sampleEdgeOffsets[0],
+																m_sampleEdgeOffsets[1],
+																m_sampleEdgeOffsets[2],
+																numValues);
+
+	// Viewport test
+	if (outX1)
+		coverage &= ~(getCoverageFragmentSampleBits(m_numSamples, 1, 0) | getCoverageFragmentSampleBits(m_numSamples, 1, 1));
+
+	if (outY1)
+		coverage &= ~(getCoverageFragmentSampleBits(m_numSamples, 0, 1) | getCoverageFragmentSampleBits(m_numSamples, 1, 1));
+
+	return coverage;
+}
+
 void TriangleRasterizer::rasterizeSingleSample (FragmentPacket* const fragmentPackets, float* const depthValues, const int maxFragmentPackets, int& numPacketsRasterized)
 {
 	DE_ASSERT(maxFragmentPackets > 0);
@@ -563,27 +824,8 @@ void TriangleRasterizer::rasterizeSingleSample (FragmentPacket* const fragmentPa
 		DE_ASSERT(x0 < m_viewport.x()+m_viewport.z());
 		DE_ASSERT(y0 < m_viewport.y()+m_viewport.w());
 
-		// Edge values
-		tcu::Vector<deInt64, 4>	e01;
-		tcu::Vector<deInt64, 4>	e12;
-		tcu::Vector<deInt64, 4>	e20;
-
-		// Coverage
-		deUint64		coverage	= 0;
-
-		// Evaluate edge values
-		for (int i = 0; i < 4; i++)
-		{
-			e01[i] = evaluateEdge(m_edge01, sx[i], sy[i]);
-			e12[i] = evaluateEdge(m_edge12, sx[i], sy[i]);
-			e20[i] = evaluateEdge(m_edge20, sx[i], sy[i]);
-		}
-
 		// Compute coverage mask
-		coverage = setCoverageValue(coverage, 1, 0, 0, 0,						isInsideCCW(m_edge01, e01[0]) && isInsideCCW(m_edge12, e12[0]) && isInsideCCW(m_edge20, e20[0]));
-		coverage = setCoverageValue(coverage, 1, 1, 0, 0, !outX1 &&				isInsideCCW(m_edge01, e01[1]) && isInsideCCW(m_edge12, e12[1]) && isInsideCCW(m_edge20, e20[1]));
-		coverage = setCoverageValue(coverage, 1, 0, 1, 0, !outY1 &&				isInsideCCW(m_edge01, e01[2]) && isInsideCCW(m_edge12, e12[2]) && isInsideCCW(m_edge20, e20[2]));
-		coverage = setCoverageValue(coverage, 1, 1, 1, 0, !outX1 && !outY1 &&	isInsideCCW(m_edge01, e01[3]) && isInsideCCW(m_edge12, e12[3]) && isInsideCCW(m_edge20, e20[3]));
+		const deUint64	coverage	= computePacketCoverage(x0, y0, outX1, outY1);
 
 		// Advance to next location
 		m_curPos.x() += 2;
@@ -596,6 +838,18 @@ void TriangleRasterizer::rasterizeSingleSample (FragmentPacket* const fragmentPa
 		if (coverage == 0)
 			continue; // Discard.
 
+		// Edge values
+		tcu::Vector<deInt64, 4>	e01;
+		tcu::Vector<deInt64, 4>	e12;
+		tcu::Vector<deInt64, 4>	e20;
+
+		for (int i = 0; i < 4; i++)
+		{
+			e01[i] = evaluateEdge(m_edge01, sx[i], sy[i]);
+			e12[i] = evaluateEdge(m_edge12, sx[i], sy[i]);
+			e20[i] = evaluateEdge(m_edge20, sx[i], sy[i]);
+		}
+
 		// Floating-point edge values for barycentrics etc.
 		const tcu::Vec4		e01f	= e01.asFloat();
 		const tcu::Vec4		e12f	= e12.asFloat();
@@ -637,73 +891,12 @@ void TriangleRasterizer::rasterizeSingleSample (FragmentPacket* const fragmentPa
 	numPacketsRasterized = packetNdx;
 }
 
-// Sample positions - ordered as (x, y) list.
-
-// \note Macros are used to eliminate function calls even in debug builds.
-#define SAMPLE_POS_TO_SUBPIXEL_COORD(POS)	\
-	(deInt64)((POS) * (1<<RASTERIZER_SUBPIXEL_BITS) + 0.5f)
-
-#define SAMPLE_POS(X, Y)	\
-	SAMPLE_POS_TO_SUBPIXEL_COORD(X), SAMPLE_POS_TO_SUBPIXEL_COORD(Y)
-
-static const deInt64 s_samplePos2[] =
-{
-	SAMPLE_POS(0.3f, 0.3f),
-	SAMPLE_POS(0.7f, 0.7f)
-};
-
-static const deInt64 s_samplePos4[] =
-{
-	SAMPLE_POS(0.25f, 0.25f),
-	SAMPLE_POS(0.75f, 0.25f),
-	SAMPLE_POS(0.25f, 0.75f),
-	SAMPLE_POS(0.75f, 0.75f)
-};
-DE_STATIC_ASSERT(DE_LENGTH_OF_ARRAY(s_samplePos4) == 4*2);
-
-static const deInt64 s_samplePos8[] =
-{
-	SAMPLE_POS( 7.f/16.f,  9.f/16.f),
-	SAMPLE_POS( 9.f/16.f, 13.f/16.f),
-	SAMPLE_POS(11.f/16.f,  3.f/16.f),
-	SAMPLE_POS(13.f/16.f, 11.f/16.f),
-	SAMPLE_POS( 1.f/16.f,  7.f/16.f),
-	SAMPLE_POS( 5.f/16.f,  1.f/16.f),
-	SAMPLE_POS(15.f/16.f,  5.f/16.f),
-	SAMPLE_POS( 3.f/16.f, 15.f/16.f)
-};
-DE_STATIC_ASSERT(DE_LENGTH_OF_ARRAY(s_samplePos8) == 8*2);
-
-static const deInt64 s_samplePos16[] =
-{
-	SAMPLE_POS(1.f/8.f, 1.f/8.f),
-	SAMPLE_POS(3.f/8.f, 1.f/8.f),
-	SAMPLE_POS(5.f/8.f, 1.f/8.f),
-	SAMPLE_POS(7.f/8.f, 1.f/8.f),
-	SAMPLE_POS(1.f/8.f, 3.f/8.f),
-	SAMPLE_POS(3.f/8.f, 3.f/8.f),
-	SAMPLE_POS(5.f/8.f, 3.f/8.f),
-	SAMPLE_POS(7.f/8.f, 3.f/8.f),
-	SAMPLE_POS(1.f/8.f, 5.f/8.f),
-	SAMPLE_POS(3.f/8.f, 5.f/8.f),
-	SAMPLE_POS(5.f/8.f, 5.f/8.f),
-	SAMPLE_POS(7.f/8.f, 5.f/8.f),
-	SAMPLE_POS(1.f/8.f, 7.f/8.f),
-	SAMPLE_POS(3.f/8.f, 7.f/8.f),
-	SAMPLE_POS(5.f/8.f, 7.f/8.f),
-	SAMPLE_POS(7.f/8.f, 7.f/8.f)
-};
-DE_STATIC_ASSERT(DE_LENGTH_OF_ARRAY(s_samplePos16) == 16*2);
-
-#undef SAMPLE_POS
-#undef SAMPLE_POS_TO_SUBPIXEL_COORD
-
 template<int NumSamples>
 void TriangleRasterizer::rasterizeMultiSample (FragmentPacket* const fragmentPackets, float* const depthValues, const int maxFragmentPackets, int& numPacketsRasterized)
 {
 	DE_ASSERT(maxFragmentPackets > 0);
 
-	const deInt64*	samplePos	= DE_NULL;
+	const deInt64*	samplePos	= getSamplePositions(NumSamples);
 	const deUint64	halfPixel	= 1ll << (RASTERIZER_SUBPIXEL_BITS-1);
 	int				packetNdx	= 0;
 
@@ -712,16 +905,6 @@ void TriangleRasterizer::rasterizeMultiSample (FragmentPacket* const fragmentPac
 	const float		zb			= m_v1.z()-m_v2.z();
 	const float		zc			= m_v2.z();
 
-	switch (NumSamples)
-	{
-		case 2:		samplePos = s_samplePos2;	break;
-		case 4:		samplePos = s_samplePos4;	break;
-		case 8:		samplePos = s_samplePos8;	break;
-		case 16:	samplePos = s_samplePos16;	break;
-		default:
-			DE_ASSERT(false);
-	}
-
 	while (m_curPos.y() <= m_bboxMax.y() && packetNdx < maxFragmentPackets)
 	{
 		const int		x0		= m_curPos.x();
@@ -743,36 +926,8 @@ void TriangleRasterizer::rasterizeMultiSample (FragmentPacket* const fragmentPac
 		DE_ASSERT(x0 < m_viewport.x()+m_viewport.z());
 		DE_ASSERT(y0 < m_viewport.y()+m_viewport.w());
 
-		// Edge values
-		tcu::Vector<deInt64, 4>	e01[NumSamples];
-		tcu::Vector<deInt64, 4>	e12[NumSamples];
-		tcu::Vector<deInt64, 4>	e20[NumSamples];
-
-		// Coverage
-		deUint64		coverage	= 0;
-
-		// Evaluate edge values at sample positions
-		for (int sampleNdx = 0; sampleNdx < NumSamples; sampleNdx++)
-		{
-			const deInt64 ox = samplePos[sampleNdx*2 + 0];
-			const deInt64 oy = samplePos[sampleNdx*2 + 1];
-
-			for (int fragNdx = 0; fragNdx < 4; fragNdx++)
-			{
-				e01[sampleNdx][fragNdx] = evaluateEdge(m_edge01, sx[fragNdx] + ox, sy[fragNdx] + oy);
-				e12[sampleNdx][fragNdx] = evaluateEdge(m_edge12, sx[fragNdx] + ox, sy[fragNdx] + oy);
-				e20[sampleNdx][fragNdx] = evaluateEdge(m_edge20, sx[fragNdx] + ox, sy[fragNdx] + oy);
-			}
-		}
-
 		// Compute coverage mask
-		for (int sampleNdx = 0; sampleNdx < NumSamples; sampleNdx++)
-		{
-			coverage = setCoverageValue(coverage, NumSamples, 0, 0, sampleNdx,						isInsideCCW(m_edge01, e01[sampleNdx][0]) && isInsideCCW(m_edge12, e12[sampleNdx][0]) && isInsideCCW(m_edge20, e20[sampleNdx][0]));
-			coverage = setCoverageValue(coverage, NumSamples, 1, 0, sampleNdx, !outX1 &&			isInsideCCW(m_edge01, e01[sampleNdx][1]) && isInsideCCW(m_edge12, e12[sampleNdx][1]) && isInsideCCW(m_edge20, e20[sampleNdx][1]));
-			coverage = setCoverageValue(coverage, NumSamples, 0, 1, sampleNdx, !outY1 &&			isInsideCCW(m_edge01, e01[sampleNdx][2]) && isInsideCCW(m_edge12, e12[sampleNdx][2]) && isInsideCCW(m_edge20, e20[sampleNdx][2]));
-			coverage = setCoverageValue(coverage, NumSamples, 1, 1, sampleNdx, !outX1 && !outY1 &&	isInsideCCW(m_edge01, e01[sampleNdx][3]) && isInsideCCW(m_edge12, e12[sampleNdx][3]) && isInsideCCW(m_edge20, e20[sampleNdx][3]));
-		}
+		const deUint64	coverage	= computePacketCoverage(x0, y0, outX1, outY1);
 
 		// Advance to next location
 		m_curPos.x() += 2;
@@ -790,10 +945,20 @@ void TriangleRasterizer::rasterizeMultiSample (FragmentPacket* const fragmentPac
 		{
 			for (int sampleNdx = 0; sampleNdx < NumSamples; sampleNdx++)
 			{
+				const deInt64	ox		= samplePos[sampleNdx*2 + 0];
+				const deInt64	oy		= samplePos[sampleNdx*2 + 1];
+
 				// Floating-point edge values at sample coordinates.
-				const tcu::Vec4&	e01f	= e01[sampleNdx].asFloat();
-				const tcu::Vec4&	e12f	= e12[sampleNdx].asFloat();
-				const tcu::Vec4&	e20f	= e20[sampleNdx].asFloat();
+				tcu::Vec4		e01f;
+				tcu::Vec4		e12f;
+				tcu::Vec4		e20f;
+
+				for (int fragNdx = 0; fragNdx < 4; fragNdx++)
+				{
+					e01f[fragNdx] = float(evaluateEdge(m_edge01, sx[fragNdx] + ox, sy[fragNdx] + oy));
+					e12f[fragNdx] = float(evaluateEdge(m_edge12, sx[fragNdx] + ox, sy[fragNdx] + oy));
+					e20f[fragNdx] = float(evaluateEdge(m_edge20, sx[fragNdx] + ox, sy[fragNdx] + oy));
+				}
 
 				const tcu::Vec4		edgeSum	= e01f + e12f + e20f;
 				const tcu::Vec4		z0		= e12f / edgeSum;
@@ -1154,4 +1319,84 @@ void LineExitDiamondGenerator::rasterize (LineExitDiamond* const lineDiamonds, c
 	numWritten = diamondNdx;
 }
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Verify packet coverage kernels against per-sample edge evaluation
+ *//*--------------------------------------------------------------------*/
+void TriangleRasterizer_selfTest (void)
+{
+	static const int	sampleCounts[]	= { 1, 2, 4, 8, 16 };
+	const int			numTriangles	= 500;
+	const int			numPackets		= 64;
+	de::Random			rnd				(0x5a3e79c1);
+
+	for (int triNdx = 0; triNdx < numTriangles; triNdx++)
+	{
+		const int				numSamples		= rnd.choose<int>(DE_ARRAY_BEGIN(sampleCounts), DE_ARRAY_END(sampleCounts));
+		const HorizontalFill	horizontalFill	= rnd.getBool() ? FILL_LEFT : FILL_RIGHT;
+		const VerticalFill		verticalFill	= rnd.getBool() ? FILL_TOP : FILL_BOTTOM;
+		const int				numValues		= 4*numSamples;
+		const deUint64			packetMask		= (numValues == 64) ? ~0ull : ((1ull << numValues) - 1ull);
+		const deInt64*			samplePos		= getSamplePositions(numSamples);
+		deInt64					x[3];
+		deInt64					y[3];
+		EdgeFunction			edges[3];
+		deInt64					offsets[3][4*RASTERIZER_MAX_SAMPLES_PER_FRAGMENT];
+
+		// Use coarse coordinates for some triangles so that samples land exactly on edges
+		for (int vtxNdx = 0; vtxNdx < 3; vtxNdx++)
+		{
+			const bool coarse = (triNdx % 2) == 0;
+
+			x[vtxNdx] = coarse ? toSubpixelCoord((float)rnd.getInt(-64, 64) * 0.25f) : toSubpixelCoord(rnd.getFloat(-20.0f, 20.0f));
+			y[vtxNdx] = coarse ? toSubpixelCoord((float)rnd.getInt(-64, 64) * 0.25f) : toSubpixelCoord(rnd.getFloat(-20.0f, 20.0f));
+		}
+
+		initEdgeCCW(edges[0], horizontalFill, verticalFill, x[0], y[0], x[1], y[1]);
+		initEdgeCCW(edges[1], horizontalFill, verticalFill, x[1], y[1], x[2], y[2]);
+		initEdgeCCW(edges[2], horizontalFill, verticalFill, x[2], y[2], x[0], y[0]);
+
+		if (rnd.getBool())
+		{
+			for (int edgeNdx = 0; edgeNdx < 3; edgeNdx++)
+				reverseEdge(edges[edgeNdx]);
+		}
+
+		for (int edgeNdx = 0; edgeNdx < 3; edgeNdx++)
+			computeSampleEdgeOffsets(offsets[edgeNdx], edges[edgeNdx], numSamples);
+
+		for (int packetNdx = 0; packetNdx < numPackets; packetNdx++)
+		{
+			const int		x0			= rnd.getInt(-22, 21);
+			const int		y0			= rnd.getInt(-22, 21);
+			const deInt64	sx			= toSubpixelCoord(x0);
+			const deInt64	sy			= toSubpixelCoord(y0);
+			deUint64		refOutside	= 0;
+
+			for (int fragNdx = 0; fragNdx < 4; fragNdx++)
+			for (int sampleNdx = 0; sampleNdx < numSamples; sampleNdx++)
+			{
+				const int		xo		= fragNdx%2;
+				const int		yo		= fragNdx/2;
+				const deInt64	px		= toSubpixelCoord(x0+xo) + samplePos[sampleNdx*2 + 0];
+				const deInt64	py		= toSubpixelCoord(y0+yo) + samplePos[sampleNdx*2 + 1];
+				const bool		inside	= isInsideCCW(edges[0], evaluateEdge(edges[0], px, py)) &&
+										  isInsideCCW(edges[1], evaluateEdge(edges[1], px, py)) &&
+										  isInsideCCW(edges[2], evaluateEdge(edges[2], px, py));
+
+				if (!inside)
+					refOutside |= getCoverageBit(numSamples, xo, yo, sampleNdx);
+			}
+
+			{
+				const deInt64	e0	= evaluateEdge(edges[0], sx, sy);
+				const deInt64	e1	= evaluateEdge(edges[1], sx, sy);
+				const deInt64	e2	= evaluateEdge(edges[2], sx, sy);
+
+				TCU_CHECK((computeOutsideMaskScalar(e0, e1, e2, offsets[0], offsets[1], offsets[2], numValues) & packetMask) == refOutside);
+				TCU_CHECK((computeOutsideMask(e0, e1, e2, offsets[0], offsets[1], offsets[2], numValues) & packetMask) == refOutside);
+			}
+		}
+	}
+}
+
 } // rr
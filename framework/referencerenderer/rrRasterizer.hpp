@@ -133,9 +133,12 @@ public:
 
 	// Following functions are only available after init()
 	FaceType				getVisibleFace			(void) const { return m_face; }
+	void					restrictToRect			(const tcu::IVec4& rect);
 	void					rasterize				(FragmentPacket* const fragmentPackets, float* const depthValues, const int maxFragmentPackets, int& numPacketsRasterized);
 
 private:
+	deUint64				computePacketCoverage	(const int x0, const int y0, const bool outX1, const bool outY1) const;
+
 	void					rasterizeSingleSample	(FragmentPacket* const fragmentPackets, float* const depthValues, const int maxFragmentPackets, int& numPacketsRasterized);
 
 	template<int NumSamples>
@@ -159,6 +162,7 @@ private:
 	tcu::IVec2				m_bboxMin;		//!< Bounding box min (inclusive).
 	tcu::IVec2				m_bboxMax;		//!< Bounding box max (inclusive).
 	tcu::IVec2				m_curPos;		//!< Current rasterization position.
+	deInt64					m_sampleEdgeOffsets[3][4*RASTERIZER_MAX_SAMPLES_PER_FRAGMENT];	//!< Edge function offsets for packet samples in coverage bit order.
 } DE_WARN_UNUSED_TYPE;
 
 
@@ -281,6 +285,8 @@ private:
 	tcu::IVec2						m_curPos;			//!< Current rasterization position.
 };
 
+void TriangleRasterizer_selfTest (void);
+
 } // rr
 
 #endif // _RRRASTERIZER_HPP
@@ -346,6 +346,35 @@ struct RestartState
 	}
 };
 
+//! Get default number of tile rasterization threads.
+int		getDefaultNumRasterizationThreads	(void);
+
+//! Set default number of tile rasterization threads. Value 0 selects number of available cores.
+void	setDefaultNumRasterizationThreads	(int numThreads);
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Tiled rasterization state
+ *
+ * If numThreads is larger than one, primitives are binned into screen-space
+ * tiles of tileSize x tileSize pixels, and tiles are rasterized, shaded and
+ * written by a group of threads. Primitives are processed in submission
+ * order within each tile, so the output is identical to sequential
+ * rasterization.
+ *
+ * \note Fragment shader must support concurrent shadeFragments() calls.
+ *//*--------------------------------------------------------------------*/
+struct TilingState
+{
+	int		numThreads;
+	int		tileSize;
+
+	TilingState (void)
+		: numThreads	(getDefaultNumRasterizationThreads())
+		, tileSize		(64)
+	{
+	}
+};
+
 struct RenderState
 {
 	explicit RenderState (const ViewportState& viewport_)
@@ -363,6 +392,7 @@ struct RenderState
 	ViewportState				viewport;
 	LineState					line;
 	RestartState				restart;
+	TilingState					tiling;
 };
 
 } // rr
@@ -29,6 +29,9 @@
 #include "rrFragmentOperations.hpp"
 #include "rrRasterizer.hpp"
 #include "deMemory.h"
+#include "deAtomic.h"
+#include "deThread.hpp"
+#include "deSharedPtr.hpp"
 
 #include <set>
 
@@ -1095,21 +1098,71 @@ void writeFragmentPackets (const RenderState&					state,
 	}
 }
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Removes fragments outside rect from fragment packets
+ *
+ * Fully discarded packets are removed and remaining packets (and their
+ * depth values) are compacted to the beginning of the buffers.
+ *
+ * \return Number of remaining packets
+ *//*--------------------------------------------------------------------*/
+int clipFragmentPacketsToRect (FragmentPacket* packets, float* depthValues, int numPackets, int numSamples, const tcu::IVec4& rect)
+{
+	const int	numDepthValuesPerPacket	= 4*numSamples;
+	int			numRemainingPackets		= 0;
+
+	for (int packetNdx = 0; packetNdx < numPackets; ++packetNdx)
+	{
+		deUint64 coverage = packets[packetNdx].coverage;
+
+		for (int fragNdx = 0; fragNdx < 4; fragNdx++)
+		{
+			const int			xo		= fragNdx%2;
+			const int			yo		= fragNdx/2;
+			const tcu::IVec2	pos		= packets[packetNdx].position + tcu::IVec2(xo, yo);
+
+			if (!de::inBounds(pos.x(), rect.x(), rect.x() + rect.z()) || !de::inBounds(pos.y(), rect.y(), rect.y() + rect.w()))
+				coverage &= ~getCoverageFragmentSampleBits(numSamples, xo, yo);
+		}
+
+		if (coverage == 0)
+			continue;
+
+		if (numRemainingPackets != packetNdx)
+		{
+			packets[numRemainingPackets] = packets[packetNdx];
+
+			if (depthValues)
+				deMemcpy(&depthValues[numRemainingPackets*numDepthValuesPerPacket], &depthValues[packetNdx*numDepthValuesPerPacket], sizeof(float)*numDepthValuesPerPacket);
+		}
+
+		packets[numRemainingPackets].coverage = coverage;
+		numRemainingPackets += 1;
+	}
+
+	return numRemainingPackets;
+}
+
 void rasterizePrimitive (const RenderState&					state,
 						 const RenderTarget&				renderTarget,
 						 const Program&						program,
 						 const pa::Triangle&				triangle,
 						 const tcu::IVec4&					renderTargetRect,
+						 const tcu::IVec4&					tileRect,
 						 RasterizationInternalBuffers&		buffers)
 {
 	const int			numSamples		= renderTarget.getNumSamples();
 	const float			depthClampMin	= de::min(state.viewport.zn, state.viewport.zf);
 	const float			depthClampMax	= de::max(state.viewport.zn, state.viewport.zf);
 	TriangleRasterizer	rasterizer		(renderTargetRect, numSamples, state.rasterization);
+	const bool			clipToTile		= tileRect != renderTargetRect;
 	float				depthOffset		= 0.0f;
 
 	rasterizer.init(triangle.v0->position, triangle.v1->position, triangle.v2->position);
 
+	if (clipToTile)
+		rasterizer.restrictToRect(tileRect);
+
 	// Culling
 	const FaceType visibleFace = rasterizer.getVisibleFace();
 	if ((state.cullMode == CULLMODE_FRONT	&& visibleFace == FACETYPE_FRONT) ||
@@ -1143,6 +1196,14 @@ void rasterizePrimitive (const RenderState&					state,
 		if (!numRasterizedPackets)
 			break; // Rasterization finished.
 
+		if (clipToTile)
+		{
+			numRasterizedPackets = clipFragmentPacketsToRect(&buffers.fragmentPackets[0], buffers.fragmentDepthBuffer, numRasterizedPackets, numSamples, tileRect);
+
+			if (!numRasterizedPackets)
+				continue; // Everything was outside the tile.
+		}
+
 		// Polygon offset
 		if (buffers.fragmentDepthBuffer && state.fragOps.polygonOffsetEnabled)
 			for (int sampleNdx = 0; sampleNdx < numRasterizedPackets * 4 * numSamples; ++sampleNdx)
@@ -1168,12 +1229,14 @@ void rasterizePrimitive (const RenderState&					state,
 						 const Program&						program,
 						 const pa::Line&					line,
 						 const tcu::IVec4&					renderTargetRect,
+						 const tcu::IVec4&					tileRect,
 						 RasterizationInternalBuffers&		buffers)
 {
 	const int					numSamples			= renderTarget.getNumSamples();
 	const float					depthClampMin		= de::min(state.viewport.zn, state.viewport.zf);
 	const float					depthClampMax		= de::max(state.viewport.zn, state.viewport.zf);
 	const bool					msaa				= numSamples > 1;
+	const bool					clipToTile			= tileRect != renderTargetRect;
 	FragmentShadingContext		shadingContext		(line.v0->outputs, line.v1->outputs, DE_NULL, &buffers.shaderOutputs[0], buffers.fragmentDepthBuffer, line.v1->primitiveID, (int)program.fragmentShader->getOutputs().size(), numSamples);
 	SingleSampleLineRasterizer	aliasedRasterizer	(renderTargetRect);
 	MultiSampleLineRasterizer	msaaRasterizer		(numSamples, renderTargetRect);
@@ -1201,6 +1264,14 @@ void rasterizePrimitive (const RenderState&					state,
 		if (!numRasterizedPackets)
 			break; // Rasterization finished.
 
+		if (clipToTile)
+		{
+			numRasterizedPackets = clipFragmentPacketsToRect(&buffers.fragmentPackets[0], buffers.fragmentDepthBuffer, numRasterizedPackets, numSamples, tileRect);
+
+			if (!numRasterizedPackets)
+				continue; // Everything was outside the tile.
+		}
+
 		// Shade
 
 		program.fragmentShader->shadeFragments(&buffers.fragmentPackets[0], numRasterizedPackets, shadingContext);
@@ -1221,6 +1292,7 @@ void rasterizePrimitive (const RenderState&					state,
 						 const Program&						program,
 						 const pa::Point&					point,
 						 const tcu::IVec4&					renderTargetRect,
+						 const tcu::IVec4&					tileRect,
 						 RasterizationInternalBuffers&		buffers)
 {
 	const int			numSamples		= renderTarget.getNumSamples();
@@ -1228,6 +1300,7 @@ void rasterizePrimitive (const RenderState&					state,
 	const float			depthClampMax	= de::max(state.viewport.zn, state.viewport.zf);
 	TriangleRasterizer	rasterizer1		(renderTargetRect, numSamples, state.rasterization);
 	TriangleRasterizer	rasterizer2		(renderTargetRect, numSamples, state.rasterization);
+	const bool			clipToTile		= tileRect != renderTargetRect;
 
 	// draw point as two triangles
 	const float offset				= point.v0->pointSize / 2.0f;
@@ -1239,6 +1312,12 @@ void rasterizePrimitive (const RenderState&					state,
 	rasterizer1.init(w0, w1, w2);
 	rasterizer2.init(w0, w2, w3);
 
+	if (clipToTile)
+	{
+		rasterizer1.restrictToRect(tileRect);
+		rasterizer2.restrictToRect(tileRect);
+	}
+
 	// Shading context
 	FragmentShadingContext shadingContext(point.v0->outputs, DE_NULL, DE_NULL, &buffers.shaderOutputs[0], buffers.fragmentDepthBuffer, point.v0->primitiveID, (int)program.fragmentShader->getOutputs().size(), numSamples);
 
@@ -1266,6 +1345,14 @@ void rasterizePrimitive (const RenderState&					state,
 		if (!numRasterizedPackets)
 			break; // Rasterization finished.
 
+		if (clipToTile)
+		{
+			numRasterizedPackets = clipFragmentPacketsToRect(&buffers.fragmentPackets[0], buffers.fragmentDepthBuffer, numRasterizedPackets, numSamples, tileRect);
+
+			if (!numRasterizedPackets)
+				continue; // Everything was outside the tile.
+		}
+
 		// Shade
 
 		program.fragmentShader->shadeFragments(&buffers.fragmentPackets[0], numRasterizedPackets, shadingContext);
@@ -1281,45 +1368,224 @@ void rasterizePrimitive (const RenderState&					state,
 	}
 }
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Per-thread rasterization buffers
+ *//*--------------------------------------------------------------------*/
+class RasterizationBufferStorage
+{
+public:
+	RasterizationBufferStorage (const RenderTarget& renderTarget, const Program& program)
+	{
+		const int		numSamples			= renderTarget.getNumSamples();
+		const int		numFragmentOutputs	= (int)program.fragmentShader->getOutputs().size();
+		const size_t	maxFragmentPackets	= 128;
+
+		m_buffers.fragmentPackets.resize(maxFragmentPackets);
+		m_buffers.shaderOutputs.resize(maxFragmentPackets*4*numFragmentOutputs);
+		m_buffers.shadedFragments.resize(maxFragmentPackets*4);
+		m_buffers.fragmentDepthBuffer = DE_NULL;
+
+		// calculate depth only if we have a depth buffer
+		if (!isEmpty(renderTarget.getDepthBuffer()))
+		{
+			m_depthValues.resize(maxFragmentPackets*4*numSamples);
+			m_buffers.fragmentDepthBuffer = &m_depthValues[0];
+		}
+	}
+
+	RasterizationInternalBuffers&	getBuffers	(void) { return m_buffers; }
+
+private:
+									RasterizationBufferStorage	(const RasterizationBufferStorage&); // not allowed
+	RasterizationBufferStorage&		operator=					(const RasterizationBufferStorage&); // not allowed
+
+	RasterizationInternalBuffers	m_buffers;
+	std::vector<float>				m_depthValues;
+};
+
+tcu::IVec4 getRenderTargetRect (const RenderState& state, const RenderTarget& renderTarget)
+{
+	const tcu::IVec4 viewportRect	= tcu::IVec4(state.viewport.rect.left, state.viewport.rect.bottom, state.viewport.rect.width, state.viewport.rect.height);
+	const tcu::IVec4 bufferRect		= getBufferSize(renderTarget.getColorBuffer(0));
+
+	return rectIntersection(viewportRect, bufferRect);
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Get conservative screen-space bounds of a primitive
+ *
+ * Bounds are given as inclusive (xMin, yMin, xMax, yMax) pixel coordinates.
+ *//*--------------------------------------------------------------------*/
+tcu::IVec4 getPrimitiveScreenBounds (const RenderState&, const pa::Triangle& triangle)
+{
+	const tcu::Vec2 minPos = tcu::min(tcu::min(triangle.v0->position.swizzle(0, 1), triangle.v1->position.swizzle(0, 1)), triangle.v2->position.swizzle(0, 1));
+	const tcu::Vec2 maxPos = tcu::max(tcu::max(triangle.v0->position.swizzle(0, 1), triangle.v1->position.swizzle(0, 1)), triangle.v2->position.swizzle(0, 1));
+
+	return tcu::IVec4(deFloorFloatToInt32(minPos.x()) - 1, deFloorFloatToInt32(minPos.y()) - 1, deCeilFloatToInt32(maxPos.x()) + 1, deCeilFloatToInt32(maxPos.y()) + 1);
+}
+
+tcu::IVec4 getPrimitiveScreenBounds (const RenderState& state, const pa::Line& line)
+{
+	// \note Wide lines are offset in the minor direction and endpoints may be perturbed
+	const int		margin	= deCeilFloatToInt32(state.line.lineWidth) + 2;
+	const tcu::Vec2 minPos	= tcu::min(line.v0->position.swizzle(0, 1), line.v1->position.swizzle(0, 1));
+	const tcu::Vec2 maxPos	= tcu::max(line.v0->position.swizzle(0, 1), line.v1->position.swizzle(0, 1));
+
+	return tcu::IVec4(deFloorFloatToInt32(minPos.x()) - margin, deFloorFloatToInt32(minPos.y()) - margin, deCeilFloatToInt32(maxPos.x()) + margin, deCeilFloatToInt32(maxPos.y()) + margin);
+}
+
+tcu::IVec4 getPrimitiveScreenBounds (const RenderState&, const pa::Point& point)
+{
+	const float		offset	= point.v0->pointSize / 2.0f + 1.0f;
+	const tcu::Vec2 pos		= point.v0->position.swizzle(0, 1);
+
+	return tcu::IVec4(deFloorFloatToInt32(pos.x() - offset), deFloorFloatToInt32(pos.y() - offset), deCeilFloatToInt32(pos.x() + offset), deCeilFloatToInt32(pos.y() + offset));
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Tile-parallel rasterization of a primitive list
+ *
+ * Primitives are binned to screen-space tiles in submission order. Worker
+ * threads pick the next unprocessed tile until all tiles are done, and
+ * rasterize only the fragments inside the tile. Since each pixel belongs to
+ * exactly one tile and primitives are processed in order within a tile, the
+ * output is identical to sequential rasterization.
+ *//*--------------------------------------------------------------------*/
+template <typename ContainerType>
+class TiledRasterizer
+{
+public:
+	TiledRasterizer (const RenderState& state, const RenderTarget& renderTarget, const Program& program, const ContainerType& list, const tcu::IVec4& renderTargetRect)
+		: m_state				(state)
+		, m_renderTarget		(renderTarget)
+		, m_program				(program)
+		, m_list				(list)
+		, m_renderTargetRect	(renderTargetRect)
+		, m_tileSize			(de::max(state.tiling.tileSize, 2))
+		, m_numTiles			(deDivRoundUp32(renderTargetRect.z(), m_tileSize), deDivRoundUp32(renderTargetRect.w(), m_tileSize))
+		, m_bins				(m_numTiles.x() * m_numTiles.y())
+		, m_nextTileNdx			(0)
+	{
+		for (size_t primitiveNdx = 0; primitiveNdx < list.size(); ++primitiveNdx)
+		{
+			const tcu::IVec4	bounds		= getPrimitiveScreenBounds(state, list[primitiveNdx]);
+			const tcu::IVec2	tileMin		= tcu::max((bounds.swizzle(0, 1) - renderTargetRect.swizzle(0, 1)) / m_tileSize, tcu::IVec2(0));
+			const tcu::IVec2	tileMax		= tcu::min((bounds.swizzle(2, 3) - renderTargetRect.swizzle(0, 1)) / m_tileSize, m_numTiles - tcu::IVec2(1));
+
+			if (bounds.z() < renderTargetRect.x() || bounds.w() < renderTargetRect.y())
+				continue;
+
+			for (int tileY = tileMin.y(); tileY <= tileMax.y(); ++tileY)
+			for (int tileX = tileMin.x(); tileX <= tileMax.x(); ++tileX)
+				m_bins[tileY*m_numTiles.x() + tileX].push_back((int)primitiveNdx);
+		}
+	}
+
+	int getNumTiles (void) const
+	{
+		return (int)m_bins.size();
+	}
+
+	//! Process tiles until none are left. Called concurrently from all worker threads.
+	void execute (void)
+	{
+		RasterizationBufferStorage storage (m_renderTarget, m_program);
+
+		for (;;)
+		{
+			const int tileNdx = deAtomicIncrement32(&m_nextTileNdx) - 1;
+
+			if (tileNdx >= (int)m_bins.size())
+				break;
+
+			rasterizeTile(tileNdx, storage.getBuffers());
+		}
+	}
+
+private:
+	void rasterizeTile (int tileNdx, RasterizationInternalBuffers& buffers) const
+	{
+		const std::vector<int>&	bin			= m_bins[tileNdx];
+		const tcu::IVec2		tilePos		= tcu::IVec2(tileNdx % m_numTiles.x(), tileNdx / m_numTiles.x()) * m_tileSize;
+		const tcu::IVec4		tileRect	= rectIntersection(m_renderTargetRect, tcu::IVec4(m_renderTargetRect.x() + tilePos.x(), m_renderTargetRect.y() + tilePos.y(), m_tileSize, m_tileSize));
+
+		for (size_t ndx = 0; ndx < bin.size(); ++ndx)
+			rasterizePrimitive(m_state, m_renderTarget, m_program, m_list[bin[ndx]], m_renderTargetRect, tileRect, buffers);
+	}
+
+	const RenderState&				m_state;
+	const RenderTarget&				m_renderTarget;
+	const Program&					m_program;
+	const ContainerType&			m_list;
+	const tcu::IVec4				m_renderTargetRect;
+	const int						m_tileSize;
+	const tcu::IVec2				m_numTiles;
+	std::vector<std::vector<int> >	m_bins;
+	volatile deInt32				m_nextTileNdx;
+};
+
+template <typename ContainerType>
+class TileRasterizationThread : public de::Thread
+{
+public:
+	TileRasterizationThread (TiledRasterizer<ContainerType>& rasterizer)
+		: m_rasterizer(rasterizer)
+	{
+	}
+
+	void run (void)
+	{
+		m_rasterizer.execute();
+	}
+
+private:
+	TiledRasterizer<ContainerType>&	m_rasterizer;
+};
+
 template <typename ContainerType>
 void rasterize (const RenderState&					state,
 				const RenderTarget&					renderTarget,
 				const Program&						program,
 				const ContainerType&				list)
 {
-	const int						numSamples			= renderTarget.getNumSamples();
-	const int						numFragmentOutputs	= (int)program.fragmentShader->getOutputs().size();
-	const size_t					maxFragmentPackets	= 128;
+	const tcu::IVec4 renderTargetRect = getRenderTargetRect(state, renderTarget);
 
-	const tcu::IVec4				viewportRect		= tcu::IVec4(state.viewport.rect.left, state.viewport.rect.bottom, state.viewport.rect.width, state.viewport.rect.height);
-	const tcu::IVec4				bufferRect			= getBufferSize(renderTarget.getColorBuffer(0));
-	const tcu::IVec4				renderTargetRect	= rectIntersection(viewportRect, bufferRect);
+	if (list.empty() || renderTargetRect.z() <= 0 || renderTargetRect.w() <= 0)
+		return;
 
-	// shared buffers for all primitives
-	std::vector<FragmentPacket>		fragmentPackets		(maxFragmentPackets);
-	std::vector<GenericVec4>		shaderOutputs		(maxFragmentPackets*4*numFragmentOutputs);
-	std::vector<Fragment>			shadedFragments		(maxFragmentPackets*4);
-	std::vector<float>				depthValues			(0);
-	float*							depthBufferPointer	= DE_NULL;
+	if (state.tiling.numThreads > 1 && list.size() > 1)
+	{
+		typedef de::SharedPtr<TileRasterizationThread<ContainerType> > ThreadSp;
 
-	RasterizationInternalBuffers	buffers;
+		TiledRasterizer<ContainerType>	tiledRasterizer	(state, renderTarget, program, list, renderTargetRect);
+		const int						numThreads		= de::min(state.tiling.numThreads, tiledRasterizer.getNumTiles());
 
-	// calculate depth only if we have a depth buffer
-	if (!isEmpty(renderTarget.getDepthBuffer()))
-	{
-		depthValues.resize(maxFragmentPackets*4*numSamples);
-		depthBufferPointer = &depthValues[0];
+		if (numThreads > 1)
+		{
+			std::vector<ThreadSp> threads (numThreads - 1);
+
+			for (size_t ndx = 0; ndx < threads.size(); ++ndx)
+			{
+				threads[ndx] = ThreadSp(new TileRasterizationThread<ContainerType>(tiledRasterizer));
+				threads[ndx]->start();
+			}
+
+			// Calling thread participates as well
+			tiledRasterizer.execute();
+
+			for (size_t ndx = 0; ndx < threads.size(); ++ndx)
+				threads[ndx]->join();
+
+			return;
+		}
 	}
 
-	// set buffers
-	buffers.fragmentPackets.swap(fragmentPackets);
-	buffers.shaderOutputs.swap(shaderOutputs);
-	buffers.shadedFragments.swap(shadedFragments);
-	buffers.fragmentDepthBuffer = depthBufferPointer;
+	// shared buffers for all primitives
+	RasterizationBufferStorage storage (renderTarget, program);
 
 	// rasterize
 	for (typename ContainerType::const_iterator it = list.begin(); it != list.end(); ++it)
-		rasterizePrimitive(state, renderTarget, program, *it, renderTargetRect, buffers);
+		rasterizePrimitive(state, renderTarget, program, *it, renderTargetRect, renderTargetRect, storage.getBuffers());
 }
 
 /*--------------------------------------------------------------------*//*!
@@ -1731,6 +1997,19 @@ bool PrimitiveList::isRestartIndex (size_t elementNdx, deUint32 restartIndex) co
 		return elementNdx == (size_t)restartIndex;
 }
 
+static volatile deInt32 s_defaultNumRasterizationThreads = 1;
+
+int getDefaultNumRasterizationThreads (void)
+{
+	return s_defaultNumRasterizationThreads;
+}
+
+void setDefaultNumRasterizationThreads (int numThreads)
+{
+	DE_ASSERT(numThreads >= 0);
+	s_defaultNumRasterizationThreads = (numThreads == 0) ? (int)deGetNumAvailableLogicalCores() : numThreads;
+}
+
 Renderer::Renderer (void)
 {
 }
@@ -33,6 +33,7 @@
 #include "deUniquePtr.hpp"
 #include "deSharedPtr.hpp"
 #include "deArrayUtil.hpp"
+#include "deThread.h"
 
 #include "tcuCommandLine.hpp"
 #include "tcuFloatFormat.hpp"
@@ -42,6 +43,7 @@
 #include "tcuVector.hpp"
 #include "tcuMatrix.hpp"
 #include "tcuResultCollector.hpp"
+#include "tcuParallelRows.hpp"
 
 #include "gluContextInfo.hpp"
 #include "gluVarType.hpp"
@@ -63,15 +65,6 @@
 // set this to true to dump even passing results
 #define GLS_LOG_ALL_RESULTS false
 
-enum
-{
-	// Computing reference intervals can take a non-trivial amount of time, especially on
-	// platforms where toggling floating-point rounding mode is slow (emulated arm on x86).
-	// As a workaround watchdog is kept happy by touching it periodically during reference
-	// interval computation.
-	TOUCH_WATCHDOG_VALUE_FREQUENCY	= 4096
-};
-
 namespace deqp
 {
 namespace gls
@@ -613,6 +606,155 @@ struct EvalContext
 	int				callDepth;
 };
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Instruction of a compiled statement.
+ *
+ * A compiled statement is a flat list of instructions operating on slots of
+ * a frame. A frame is a block of memory holding the values of all variables
+ * and temporaries of a single evaluation, and a slot is the byte offset of
+ * one value in the frame. Each instruction is executed over a whole batch of
+ * frames at a time.
+ *
+ *//*--------------------------------------------------------------------*/
+class Instruction
+{
+public:
+	virtual			~Instruction	(void) {}
+	virtual void	execute			(const EvalContext&	ctx,
+									 deUint8*			frames,
+									 size_t				frameSize,
+									 size_t				numFrames) const = 0;
+};
+
+template <typename T>
+typename Traits<T>::IVal& getSlot (deUint8* frame, int slot)
+{
+	return *reinterpret_cast<typename Traits<T>::IVal*>(frame + slot);
+}
+
+template <typename T>
+class CopyInstruction : public Instruction
+{
+public:
+					CopyInstruction	(int dst, int src) : m_dst(dst), m_src(src) {}
+
+	void			execute			(const EvalContext&, deUint8* frames, size_t frameSize, size_t numFrames) const
+	{
+		for (size_t frameNdx = 0; frameNdx < numFrames; ++frameNdx)
+		{
+			deUint8* const frame = frames + frameNdx * frameSize;
+
+			getSlot<T>(frame, m_dst) = getSlot<T>(frame, m_src);
+		}
+	}
+
+private:
+	int				m_dst;
+	int				m_src;
+};
+
+/*--------------------------------------------------------------------*//*!
+ * \brief A statement flattened into a linear list of instructions.
+ *
+ * Evaluating a compiled statement is equivalent to executing the original
+ * statement in an environment where the variables are bound, but avoids the
+ * virtual call per expression node and the variable lookups by name.
+ *
+ * Initial values of the slots are kept in a template frame that is copied
+ * to the frames before evaluation. Constants are stored there directly.
+ *
+ * \note Values are copied bytewise into the template frame, just as the
+ *		 Environment does.
+ *//*--------------------------------------------------------------------*/
+class CompiledStatement
+{
+public:
+	template <typename T>
+	int				allocSlot		(const typename Traits<T>::IVal& initial = typename Traits<T>::IVal())
+	{
+		typedef typename Traits<T>::IVal IVal;
+
+		const int slot = deAlign32((int)m_initialFrame.size(), SLOT_ALIGNMENT);
+
+		m_initialFrame.resize(deAlign32(slot + (int)sizeof(IVal), SLOT_ALIGNMENT), 0u);
+		deMemcpy(&m_initialFrame[slot], &initial, sizeof(IVal));
+
+		return slot;
+	}
+
+	void			addInstruction	(const Instruction* instruction)
+	{
+		m_instructions.push_back(SharedPtr<const Instruction>(instruction));
+	}
+
+	size_t			getFrameSize	(void) const { return m_initialFrame.size(); }
+
+	void			initFrames		(deUint8* frames, size_t numFrames) const
+	{
+		for (size_t frameNdx = 0; frameNdx < numFrames; ++frameNdx)
+			deMemcpy(frames + frameNdx * getFrameSize(), &m_initialFrame[0], getFrameSize());
+	}
+
+	void			execute			(const EvalContext& ctx, deUint8* frames, size_t numFrames) const
+	{
+		for (size_t instrNdx = 0; instrNdx < m_instructions.size(); ++instrNdx)
+			m_instructions[instrNdx]->execute(ctx, frames, getFrameSize(), numFrames);
+	}
+
+private:
+	enum
+	{
+		SLOT_ALIGNMENT	= (int)sizeof(double)	//!< Intervals consist of doubles.
+	};
+
+	vector<deUint8>							m_initialFrame;
+	vector<SharedPtr<const Instruction> >	m_instructions;
+};
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Compilation context.
+ *
+ * The compilation context maps the variables visible in the statement being
+ * compiled to their slots. Bodies of derived functions are compiled in a
+ * scope of their own.
+ *
+ *//*--------------------------------------------------------------------*/
+class CompileContext
+{
+public:
+	typedef map<string, int>	Scope;
+
+						CompileContext	(CompiledStatement& statement) : m_statement(statement) {}
+
+	CompiledStatement&	getStatement	(void) { return m_statement; }
+
+	//! Allocate a slot for `variable` and bind it in the current scope.
+	template <typename T>
+	int					declare			(const Variable<T>& variable)
+	{
+		const int slot = m_statement.allocSlot<T>();
+
+		m_scope[variable.getName()] = slot;
+		return slot;
+	}
+
+	template <typename T>
+	int					lookup			(const Variable<T>& variable) const
+	{
+		return de::lookup(m_scope, variable.getName());
+	}
+
+	//! Exchange the current scope with `scope`.
+	void				swapScope		(Scope& scope)
+	{
+		m_scope.swap(scope);
+	}
+
+private:
+	CompiledStatement&	m_statement;
+	Scope				m_scope;
+};
+
 /*--------------------------------------------------------------------*//*!
  * \brief Simple incremental counter.
  *
@@ -678,11 +820,14 @@ public:
 	void	print			(ostream&		os)		const	{ this->doPrint(os);			 }
 	//! Add the functions used in this statement to `dst`.
 	void	getUsedFuncs	(FuncSet& dst)			const	{ this->doGetUsedFuncs(dst);	 }
+	//! Compile the statement into the instruction list of `ctx`.
+	void	compile			(CompileContext& ctx)	const	{ this->doCompile(ctx);			 }
 
 protected:
 	virtual void	doPrint			(ostream& os)			const	= 0;
 	virtual void	doExecute		(EvalContext& ctx)		const	= 0;
 	virtual void	doGetUsedFuncs	(FuncSet& dst)			const	= 0;
+	virtual void	doCompile		(CompileContext& ctx)	const	= 0;
 };
 
 ostream& operator<<(ostream& os, const Statement& stmt)
@@ -745,6 +890,14 @@ protected:
 		m_value->getUsedFuncs(dst);
 	}
 
+	void			doCompile			(CompileContext& ctx)					const
+	{
+		const int	value	= m_value->compile(ctx);
+		const int	dst		= m_isDeclaration ? ctx.declare(*m_variable) : ctx.lookup(*m_variable);
+
+		ctx.getStatement().addInstruction(new CopyInstruction<T>(dst, value));
+	}
+
 	VariableP<T>	m_variable;
 	ExprP<T>		m_value;
 	bool			m_isDeclaration;
@@ -806,6 +959,12 @@ protected:
 			m_statements[ndx]->getUsedFuncs(dst);
 	}
 
+	void				doCompile			(CompileContext& ctx)					const
+	{
+		for (size_t ndx = 0; ndx < m_statements.size(); ++ndx)
+			m_statements[ndx]->compile(ctx);
+	}
+
 	vector<StatementP>	m_statements;
 };
 
@@ -841,9 +1000,12 @@ public:
 	typedef typename	Traits<T>::IVal	IVal;
 
 	IVal				evaluate		(const EvalContext&	ctx) const;
+	//! Compile the expression into `ctx`, returning the slot that holds its value.
+	int					compile			(CompileContext&	ctx) const { return this->doCompile(ctx); }
 
 protected:
 	virtual IVal		doEvaluate		(const EvalContext&	ctx) const = 0;
+	virtual int			doCompile		(CompileContext&	ctx) const = 0;
 };
 
 //! Evaluate an expression with the given context, optionally tracing the calls to stderr.
@@ -1020,6 +1182,10 @@ protected:
 	{
 		return ctx.env.lookup<T>(*this);
 	}
+	int				doCompile	(CompileContext& ctx)			const
+	{
+		return ctx.lookup<T>(*this);
+	}
 
 private:
 	string	m_name;
@@ -1056,6 +1222,7 @@ public:
 protected:
 	void	doPrintExpr		(ostream& os) const			{ os << m_value; }
 	IVal	doEvaluate		(const EvalContext&) const	{ return makeIVal(m_value); }
+	int		doCompile		(CompileContext& ctx) const	{ return ctx.getStatement().allocSlot<T>(makeIVal(m_value)); }
 
 private:
 	T		m_value;
@@ -1134,6 +1301,9 @@ struct Signature
 
 typedef vector<const ExprBase*> BaseArgExprs;
 
+//! Slots of the arguments of a compiled function application.
+typedef Tuple4<int, int, int, int> ArgSlots;
+
 /*--------------------------------------------------------------------*//*!
  * \brief Type-independent operations for function objects.
  *
@@ -1225,9 +1395,20 @@ public:
 		return this->doGetParamNames();
 	}
 
+	//! Compile an application of this function to `args`, returning the slot of the result.
+	int					compileApply	(CompileContext&	ctx,
+										 const ArgSlots&	args,
+										 bool				argsAreVariables)		const
+	{
+		return this->doCompileApply(ctx, args, argsAreVariables);
+	}
+
 protected:
 	virtual IRet		doApply			(const EvalContext&,
 										 const IArgs&)							const = 0;
+	virtual int			doCompileApply	(CompileContext&	ctx,
+										 const ArgSlots&	args,
+										 bool				argsAreVariables)		const;
 	virtual void		doPrint			(ostream& os, const BaseArgExprs& args)	const
 	{
 		os << getName() << "(";
@@ -1298,6 +1479,16 @@ protected:
 							m_args.c->evaluate(ctx), m_args.d->evaluate(ctx));
 	}
 
+	int					doCompile		(CompileContext& ctx) const
+	{
+		const int	arg0	= m_args.a->compile(ctx);
+		const int	arg1	= m_args.b->compile(ctx);
+		const int	arg2	= m_args.c->compile(ctx);
+		const int	arg3	= m_args.d->compile(ctx);
+
+		return m_func.compileApply(ctx, ArgSlots(arg0, arg1, arg2, arg3), false);
+	}
+
 	void				doGetUsedFuncs	(FuncSet& dst) const
 	{
 		m_func.getUsedFuncs(dst);
@@ -1311,6 +1502,76 @@ protected:
 	ArgExprs			m_args;
 };
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Compiled function application.
+ *
+ * Arguments are passed by value as in Apply, unless they are variables as in
+ * ApplyVar. Then output parameters are written directly to the variables.
+ *
+ *//*--------------------------------------------------------------------*/
+template <typename Sig>
+class ApplyInstruction : public Instruction
+{
+public:
+	typedef typename Sig::Ret		Ret;
+	typedef typename Sig::Arg0		Arg0;
+	typedef typename Sig::Arg1		Arg1;
+	typedef typename Sig::Arg2		Arg2;
+	typedef typename Sig::Arg3		Arg3;
+	typedef typename Sig::IArg0		IArg0;
+	typedef typename Sig::IArg1		IArg1;
+	typedef typename Sig::IArg2		IArg2;
+	typedef typename Sig::IArg3		IArg3;
+
+						ApplyInstruction	(const Func<Sig>&	func,
+											 const ArgSlots&	args,
+											 int				dst,
+											 bool				argsAreVariables)
+							: m_func				(func)
+							, m_args				(args)
+							, m_dst					(dst)
+							, m_argsAreVariables	(argsAreVariables) {}
+
+	void				execute				(const EvalContext& ctx, deUint8* frames, size_t frameSize, size_t numFrames) const
+	{
+		for (size_t frameNdx = 0; frameNdx < numFrames; ++frameNdx)
+		{
+			deUint8* const frame = frames + frameNdx * frameSize;
+
+			if (m_argsAreVariables)
+			{
+				getSlot<Ret>(frame, m_dst) = m_func.apply(ctx,
+														  getSlot<Arg0>(frame, m_args.a), getSlot<Arg1>(frame, m_args.b),
+														  getSlot<Arg2>(frame, m_args.c), getSlot<Arg3>(frame, m_args.d));
+			}
+			else
+			{
+				IArg0	arg0	= getSlot<Arg0>(frame, m_args.a);
+				IArg1	arg1	= getSlot<Arg1>(frame, m_args.b);
+				IArg2	arg2	= getSlot<Arg2>(frame, m_args.c);
+				IArg3	arg3	= getSlot<Arg3>(frame, m_args.d);
+
+				getSlot<Ret>(frame, m_dst) = m_func.apply(ctx, arg0, arg1, arg2, arg3);
+			}
+		}
+	}
+
+private:
+	const Func<Sig>&	m_func;
+	const ArgSlots		m_args;
+	const int			m_dst;
+	const bool			m_argsAreVariables;
+};
+
+template <typename Sig>
+int Func<Sig>::doCompileApply (CompileContext& ctx, const ArgSlots& args, bool argsAreVariables) const
+{
+	const int dst = ctx.getStatement().allocSlot<Ret>();
+
+	ctx.getStatement().addInstruction(new ApplyInstruction<Sig>(*this, args, dst, argsAreVariables));
+	return dst;
+}
+
 template<typename T>
 class Alternatives : public Func<Signature<T, T, T> >
 {
@@ -1420,6 +1681,18 @@ protected:
 								  ctx.env.lookup(var0), ctx.env.lookup(var1),
 								  ctx.env.lookup(var2), ctx.env.lookup(var3));
 	}
+
+	int					doCompile		(CompileContext& ctx) const
+	{
+		const Variable<Arg0>&	var0 = static_cast<const Variable<Arg0>&>(*this->m_args.a);
+		const Variable<Arg1>&	var1 = static_cast<const Variable<Arg1>&>(*this->m_args.b);
+		const Variable<Arg2>&	var2 = static_cast<const Variable<Arg2>&>(*this->m_args.c);
+		const Variable<Arg3>&	var3 = static_cast<const Variable<Arg3>&>(*this->m_args.d);
+		return this->m_func.compileApply(ctx,
+										  ArgSlots(ctx.lookup(var0), ctx.lookup(var1),
+												   ctx.lookup(var2), ctx.lookup(var3)),
+										  true);
+	}
 };
 
 template <typename Sig>
@@ -1506,6 +1779,49 @@ protected:
 		return ret;
 	}
 
+	int							doCompileApply	(CompileContext&	ctx,
+												 const ArgSlots&	args,
+												 bool				argsAreVariables) const
+	{
+		CompiledStatement&		statement	= ctx.getStatement();
+		CompileContext::Scope	scope;
+		ArgSlots				params;
+		int						ret;
+
+		initialize();
+
+		// Inline the body in a scope of its own with copies of the arguments, as in doApply().
+		ctx.swapScope(scope);
+
+		params.a = ctx.declare(*m_var0);
+		params.b = ctx.declare(*m_var1);
+		params.c = ctx.declare(*m_var2);
+		params.d = ctx.declare(*m_var3);
+
+		statement.addInstruction(new CopyInstruction<Arg0>(params.a, args.a));
+		statement.addInstruction(new CopyInstruction<Arg1>(params.b, args.b));
+		statement.addInstruction(new CopyInstruction<Arg2>(params.c, args.c));
+		statement.addInstruction(new CopyInstruction<Arg3>(params.d, args.d));
+
+		for (size_t ndx = 0; ndx < m_body.size(); ++ndx)
+			m_body[ndx]->compile(ctx);
+
+		ret = m_ret->compile(ctx);
+
+		// Writes to parameters are only visible to the caller through variables.
+		if (argsAreVariables)
+		{
+			statement.addInstruction(new CopyInstruction<Arg0>(args.a, params.a));
+			statement.addInstruction(new CopyInstruction<Arg1>(args.b, params.b));
+			statement.addInstruction(new CopyInstruction<Arg2>(args.c, params.c));
+			statement.addInstruction(new CopyInstruction<Arg3>(args.d, params.d));
+		}
+
+		ctx.swapScope(scope);
+
+		return ret;
+	}
+
 	void						doGetUsedFuncs	(FuncSet& dst) const
 	{
 		initialize();
@@ -4384,6 +4700,208 @@ struct Variables
 	VariableP<typename Out::Out1>	out1;
 };
 
+template<typename Out>
+struct ReferenceOutputs
+{
+	ReferenceOutputs	(size_t size) : out0(size), out1(size) {}
+
+	vector<typename Traits<typename Out::Out0>::IVal>	out0;
+	vector<typename Traits<typename Out::Out1>::IVal>	out1;
+};
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Computes reference intervals of a compiled statement.
+ *
+ * Input values are evaluated in batches of frames. Disjoint ranges of input
+ * values ("rows") can be processed concurrently by separate threads.
+ *
+ *//*--------------------------------------------------------------------*/
+template<typename In, typename Out>
+class ReferenceEvalTask : public tcu::RowBandTask
+{
+public:
+	typedef typename	In::In0		In0;
+	typedef typename	In::In1		In1;
+	typedef typename	In::In2		In2;
+	typedef typename	In::In3		In3;
+	typedef typename	Out::Out0	Out0;
+	typedef typename	Out::Out1	Out1;
+
+	enum
+	{
+		BATCH_SIZE			= 64,
+		MIN_VALUES_PER_BAND	= 256
+	};
+
+						ReferenceEvalTask	(const Variables<In, Out>&	variables,
+											 const Statement&			stmt,
+											 const Inputs<In>&			inputs,
+											 const FloatFormat&			fmt,
+											 const FloatFormat&			highpFmt,
+											 Precision					precision,
+											 TestContext&				testCtx,
+											 ReferenceOutputs<Out>&		dst)
+							: m_inputs		(inputs)
+							, m_fmt			(fmt)
+							, m_highpFmt	(highpFmt)
+							, m_precision	(precision)
+							, m_testCtx		(testCtx)
+							, m_dst			(dst)
+	{
+		CompileContext ctx (m_statement);
+
+		m_in0Slot	= ctx.declare(*variables.in0);
+		m_in1Slot	= ctx.declare(*variables.in1);
+		m_in2Slot	= ctx.declare(*variables.in2);
+		m_in3Slot	= ctx.declare(*variables.in3);
+		m_out0Slot	= ctx.declare(*variables.out0);
+		m_out1Slot	= ctx.declare(*variables.out1);
+
+		stmt.compile(ctx);
+	}
+
+	void				processRows			(int bandNdx, int rowBegin, int rowEnd)
+	{
+		const size_t		frameSize	= m_statement.getFrameSize();
+		vector<deUint8>		frames		(frameSize * BATCH_SIZE);
+		Environment			env;
+		const EvalContext	ctx			(m_fmt, m_precision, env);
+
+		m_statement.initFrames(&frames[0], BATCH_SIZE);
+
+		for (int batchBegin = rowBegin; batchBegin < rowEnd; batchBegin += BATCH_SIZE)
+		{
+			const int numFrames = de::min<int>(rowEnd - batchBegin, BATCH_SIZE);
+
+			for (int frameNdx = 0; frameNdx < numFrames; frameNdx++)
+			{
+				deUint8* const	frame		= &frames[frameNdx * frameSize];
+				const size_t	valueNdx	= (size_t)(batchBegin + frameNdx);
+
+				getSlot<In0>(frame, m_in0Slot) = convert<In0>(m_fmt, round(m_fmt, m_inputs.in0[valueNdx]));
+				getSlot<In1>(frame, m_in1Slot) = convert<In1>(m_fmt, round(m_fmt, m_inputs.in1[valueNdx]));
+				getSlot<In2>(frame, m_in2Slot) = convert<In2>(m_fmt, round(m_fmt, m_inputs.in2[valueNdx]));
+				getSlot<In3>(frame, m_in3Slot) = convert<In3>(m_fmt, round(m_fmt, m_inputs.in3[valueNdx]));
+			}
+
+			m_statement.execute(ctx, &frames[0], (size_t)numFrames);
+
+			for (int frameNdx = 0; frameNdx < numFrames; frameNdx++)
+			{
+				deUint8* const	frame		= &frames[frameNdx * frameSize];
+				const size_t	valueNdx	= (size_t)(batchBegin + frameNdx);
+
+				m_dst.out0[valueNdx] = convert<Out0>(m_highpFmt, getSlot<Out0>(frame, m_out0Slot));
+				m_dst.out1[valueNdx] = convert<Out1>(m_highpFmt, getSlot<Out1>(frame, m_out1Slot));
+			}
+
+			// Computing reference intervals can take a non-trivial amount of time, especially on
+			// platforms where toggling floating-point rounding mode is slow (emulated arm on x86).
+			// As a workaround watchdog is kept happy by touching it periodically during reference
+			// interval computation. Only the calling thread may touch it.
+			if (bandNdx == 0)
+				m_testCtx.touchWatchdog();
+		}
+	}
+
+private:
+	CompiledStatement			m_statement;
+	int							m_in0Slot;
+	int							m_in1Slot;
+	int							m_in2Slot;
+	int							m_in3Slot;
+	int							m_out0Slot;
+	int							m_out1Slot;
+
+	const Inputs<In>&			m_inputs;
+	const FloatFormat			m_fmt;
+	const FloatFormat			m_highpFmt;
+	const Precision				m_precision;
+	TestContext&				m_testCtx;
+	ReferenceOutputs<Out>&		m_dst;
+};
+
+//! Compute reference intervals by interpreting `stmt` separately for each input.
+template<typename In, typename Out>
+void interpretReferenceOutputs (const Variables<In, Out>&	variables,
+								const Statement&			stmt,
+								const Inputs<In>&			inputs,
+								const FloatFormat&			fmt,
+								const FloatFormat&			highpFmt,
+								Precision					precision,
+								ReferenceOutputs<Out>&		dst)
+{
+	typedef typename	In::In0		In0;
+	typedef typename	In::In1		In1;
+	typedef typename	In::In2		In2;
+	typedef typename	In::In3		In3;
+	typedef typename	Out::Out0	Out0;
+	typedef typename	Out::Out1	Out1;
+
+	Environment env;
+
+	// Initialize environment with dummy values so we don't need to bind in inner loop.
+	env.bind(*variables.in0, typename Traits<In0>::IVal());
+	env.bind(*variables.in1, typename Traits<In1>::IVal());
+	env.bind(*variables.in2, typename Traits<In2>::IVal());
+	env.bind(*variables.in3, typename Traits<In3>::IVal());
+	env.bind(*variables.out0, typename Traits<Out0>::IVal());
+	env.bind(*variables.out1, typename Traits<Out1>::IVal());
+
+	for (size_t valueNdx = 0; valueNdx < dst.out0.size(); valueNdx++)
+	{
+		env.lookup(*variables.in0) = convert<In0>(fmt, round(fmt, inputs.in0[valueNdx]));
+		env.lookup(*variables.in1) = convert<In1>(fmt, round(fmt, inputs.in1[valueNdx]));
+		env.lookup(*variables.in2) = convert<In2>(fmt, round(fmt, inputs.in2[valueNdx]));
+		env.lookup(*variables.in3) = convert<In3>(fmt, round(fmt, inputs.in3[valueNdx]));
+
+		{
+			EvalContext	ctx (fmt, precision, env);
+			stmt.execute(ctx);
+		}
+
+		dst.out0[valueNdx] = convert<Out0>(highpFmt, env.lookup(*variables.out0));
+		dst.out1[valueNdx] = convert<Out1>(highpFmt, env.lookup(*variables.out1));
+	}
+}
+
+//! Compute reference intervals of `stmt` for all inputs, using at most numThreads threads (0 = number of cores).
+template<typename In, typename Out>
+void computeReferenceOutputs (const Variables<In, Out>&	variables,
+							  const Statement&			stmt,
+							  const Inputs<In>&			inputs,
+							  const FloatFormat&		fmt,
+							  const FloatFormat&		highpFmt,
+							  Precision					precision,
+							  int						numThreads,
+							  TestContext&				testCtx,
+							  ReferenceOutputs<Out>&	dst)
+{
+#ifdef GLS_ENABLE_TRACE
+	// Traces are printed as expressions are evaluated, so interpret the statement instead.
+	DE_UNREF(numThreads);
+	DE_UNREF(testCtx);
+
+	interpretReferenceOutputs(variables, stmt, inputs, fmt, highpFmt, precision, dst);
+#else
+	typedef ReferenceEvalTask<In, Out> Task;
+
+	const int	numValues	= (int)dst.out0.size();
+	const int	maxThreads	= (numThreads == 0) ? (int)deGetNumAvailableLogicalCores() : de::max(numThreads, 1);
+	const int	numBands	= de::clamp(numValues / (int)Task::MIN_VALUES_PER_BAND, 1, maxThreads);
+	FuncSet		funcs;
+
+	// \note Derived functions expand their bodies on first use. Expand all of them before any threads are started.
+	stmt.getUsedFuncs(funcs);
+
+	{
+		Task task (variables, stmt, inputs, fmt, highpFmt, precision, testCtx, dst);
+
+		tcu::executeRowBands(task, numValues, numBands);
+	}
+#endif
+}
+
 template<typename In>
 struct Samplings
 {
@@ -4468,10 +4986,6 @@ void PrecisionCase::testStatement (const Variables<In, Out>&	variables,
 {
 	using namespace ShaderExecUtil;
 
-	typedef typename	In::In0		In0;
-	typedef typename	In::In1		In1;
-	typedef typename	In::In2		In2;
-	typedef typename	In::In3		In3;
 	typedef typename	Out::Out0	Out0;
 	typedef typename	Out::Out1	Out1;
 
@@ -4484,7 +4998,7 @@ void PrecisionCase::testStatement (const Variables<In, Out>&	variables,
 	const FloatFormat	highpFmt	= m_ctx.highpFormat;
 	const int			maxMsgs		= 100;
 	int					numErrors	= 0;
-	Environment			env;		// Hoisted out of the inner loop for optimization.
+	ReferenceOutputs<Out>	references	(numValues);
 
 	switch (inCount)
 	{
@@ -4567,53 +5081,27 @@ void PrecisionCase::testStatement (const Variables<In, Out>&	variables,
 		executor->execute(int(numValues), inputArr, outputArr);
 	}
 
-	// Initialize environment with dummy values so we don't need to bind in inner loop.
-	{
-		const typename Traits<In0>::IVal		in0;
-		const typename Traits<In1>::IVal		in1;
-		const typename Traits<In2>::IVal		in2;
-		const typename Traits<In3>::IVal		in3;
-		const typename Traits<Out0>::IVal		reference0;
-		const typename Traits<Out1>::IVal		reference1;
-
-		env.bind(*variables.in0, in0);
-		env.bind(*variables.in1, in1);
-		env.bind(*variables.in2, in2);
-		env.bind(*variables.in3, in3);
-		env.bind(*variables.out0, reference0);
-		env.bind(*variables.out1, reference1);
-	}
+	// Compute output reference intervals for all inputs.
+	computeReferenceOutputs(variables, stmt, inputs, fmt, highpFmt, m_ctx.precision,
+							m_testCtx.getCommandLine().getPrecisionEvalNumThreads(),
+							m_testCtx, references);
 
-	// For each input tuple, compute output reference interval and compare
-	// shader output to the reference.
+	// For each input tuple, compare shader output to the reference.
 	for (size_t valueNdx = 0; valueNdx < numValues; valueNdx++)
 	{
 		bool						result		= true;
 		typename Traits<Out0>::IVal	reference0;
 		typename Traits<Out1>::IVal	reference1;
 
-		if (valueNdx % (size_t)TOUCH_WATCHDOG_VALUE_FREQUENCY == 0)
-			m_testCtx.touchWatchdog();
-
-		env.lookup(*variables.in0) = convert<In0>(fmt, round(fmt, inputs.in0[valueNdx]));
-		env.lookup(*variables.in1) = convert<In1>(fmt, round(fmt, inputs.in1[valueNdx]));
-		env.lookup(*variables.in2) = convert<In2>(fmt, round(fmt, inputs.in2[valueNdx]));
-		env.lookup(*variables.in3) = convert<In3>(fmt, round(fmt, inputs.in3[valueNdx]));
-
-		{
-			EvalContext	ctx (fmt, m_ctx.precision, env);
-			stmt.execute(ctx);
-		}
-
 		switch (outCount)
 		{
 			case 2:
-				reference1 = convert<Out1>(highpFmt, env.lookup(*variables.out1));
+				reference1 = references.out1[valueNdx];
 				if (!m_status.check(contains(reference1, outputs.out1[valueNdx]),
 									"Shader output 1 is outside acceptable range"))
 					result = false;
 			case 1:
-				reference0 = convert<Out0>(highpFmt, env.lookup(*variables.out0));
+				reference0 = references.out0[valueNdx];
 				if (!m_status.check(contains(reference0, outputs.out0[valueNdx]),
 									"Shader output 0 is outside acceptable range"))
 					result = false;
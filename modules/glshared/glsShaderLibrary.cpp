@@ -23,6 +23,7 @@
 
 #include "glsShaderLibrary.hpp"
 #include "glsShaderLibraryCase.hpp"
+#include "tcuCommandLine.hpp"
 
 namespace deqp
 {
@@ -75,7 +76,7 @@ std::vector<tcu::TestNode*> ShaderLibrary::loadShaderFile (const char* fileName)
 {
 	CaseFactory	caseFactory	(m_testCtx, m_renderCtx, m_contextInfo);
 
-	return glu::sl::parseFile(m_testCtx.getArchive(), fileName, &caseFactory);
+	return glu::sl::parseFile(m_testCtx.getArchive(), fileName, &caseFactory, m_testCtx.getCommandLine().getShaderLibraryCacheDir());
 }
 
 } // gls
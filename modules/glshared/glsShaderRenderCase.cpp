@@ -31,6 +31,7 @@
 #include "tcuImageCompare.hpp"
 #include "tcuTestLog.hpp"
 #include "tcuRenderTarget.hpp"
+#include "tcuParallelRows.hpp"
 
 #include "gluPixelTransfer.hpp"
 #include "gluTexture.hpp"
@@ -40,6 +41,8 @@
 #include "glwFunctions.hpp"
 #include "glwEnums.hpp"
 
+#include "rrRenderState.hpp"
+
 #include "deRandom.hpp"
 #include "deMemory.h"
 #include "deString.h"
@@ -63,6 +66,7 @@ static const int			GRID_SIZE				= 64;
 static const int			MAX_RENDER_WIDTH		= 128;
 static const int			MAX_RENDER_HEIGHT		= 112;
 static const tcu::Vec4		DEFAULT_CLEAR_COLOR		= tcu::Vec4(0.125f, 0.25f, 0.5f, 1.0f);
+static const int			MIN_EVALS_PER_BAND		= 1024;		//!< Shader evaluation is costly enough to split small images.
 
 // TextureBinding
 
@@ -632,118 +636,218 @@ void ShaderRenderCase::render (Surface& result, int programID, const QuadGrid& q
 	GLU_EXPECT_NO_ERROR(gl.getError(), "post render");
 }
 
-void ShaderRenderCase::computeVertexReference (Surface& result, const QuadGrid& quadGrid)
+namespace
 {
-	// Buffer info.
-	int					width		= result.getWidth();
-	int					height		= result.getHeight();
-	int					gridSize	= quadGrid.getGridSize();
-	int					stride		= gridSize + 1;
-	bool				hasAlpha	= m_renderCtx.getRenderTarget().getPixelFormat().alphaBits > 0;
-	ShaderEvalContext	evalCtx		(quadGrid);
 
-	// Evaluate color for each vertex.
-	vector<Vec4> colors((gridSize+1)*(gridSize+1));
-	for (int y = 0; y < gridSize+1; y++)
-	for (int x = 0; x < gridSize+1; x++)
+int getNumEvalBands (int numRows, int rowLength)
+{
+	const int maxThreads = de::max(rr::getDefaultNumRasterizationThreads(), 1);
+
+	return de::clamp(numRows*rowLength / MIN_EVALS_PER_BAND, 1, de::min(maxThreads, numRows));
+}
+
+// \note Evaluators are shared between bands, each band uses its own ShaderEvalContext.
+
+class VertexEvalTask : public tcu::RowBandTask
+{
+public:
+	VertexEvalTask (ShaderEvaluator& evaluator, const QuadGrid& quadGrid, bool hasAlpha, vector<Vec4>& colors)
+		: m_evaluator	(evaluator)
+		, m_quadGrid	(quadGrid)
+		, m_hasAlpha	(hasAlpha)
+		, m_colors		(colors)
 	{
-		float				sx			= (float)x / (float)gridSize;
-		float				sy			= (float)y / (float)gridSize;
-		int					vtxNdx		= ((y * (gridSize+1)) + x);
+	}
+
+	void processRows (int bandNdx, int rowBegin, int rowEnd)
+	{
+		const int			gridSize	= m_quadGrid.getGridSize();
+		ShaderEvalContext	evalCtx		(m_quadGrid);
+
+		DE_UNREF(bandNdx);
 
-		evalCtx.reset(sx, sy);
-		m_evaluator.evaluate(evalCtx);
-		DE_ASSERT(!evalCtx.isDiscarded); // Discard is not available in vertex shader.
-		Vec4 color = evalCtx.color;
+		for (int y = rowBegin; y < rowEnd; y++)
+		for (int x = 0; x < gridSize+1; x++)
+		{
+			float				sx			= (float)x / (float)gridSize;
+			float				sy			= (float)y / (float)gridSize;
+			int					vtxNdx		= ((y * (gridSize+1)) + x);
 
-		if (!hasAlpha)
-			color.w() = 1.0f;
+			evalCtx.reset(sx, sy);
+			m_evaluator.evaluate(evalCtx);
+			DE_ASSERT(!evalCtx.isDiscarded); // Discard is not available in vertex shader.
+			Vec4 color = evalCtx.color;
 
-		colors[vtxNdx] = color;
+			if (!m_hasAlpha)
+				color.w() = 1.0f;
+
+			m_colors[vtxNdx] = color;
+		}
 	}
 
-	// Render quads.
-	for (int y = 0; y < gridSize; y++)
-	for (int x = 0; x < gridSize; x++)
+private:
+	ShaderEvaluator&	m_evaluator;
+	const QuadGrid&		m_quadGrid;
+	const bool			m_hasAlpha;
+	vector<Vec4>&		m_colors;
+};
+
+class VertexColorRasterTask : public tcu::RowBandTask
+{
+public:
+	VertexColorRasterTask (Surface& result, int gridSize, const vector<Vec4>& colors)
+		: m_result		(result)
+		, m_gridSize	(gridSize)
+		, m_colors		(colors)
 	{
-		float x0 = (float)x       / (float)gridSize;
-		float x1 = (float)(x + 1) / (float)gridSize;
-		float y0 = (float)y       / (float)gridSize;
-		float y1 = (float)(y + 1) / (float)gridSize;
-
-		float sx0 = x0 * (float)width;
-		float sx1 = x1 * (float)width;
-		float sy0 = y0 * (float)height;
-		float sy1 = y1 * (float)height;
-		float oosx = 1.0f / (sx1 - sx0);
-		float oosy = 1.0f / (sy1 - sy0);
-
-		int ix0 = deCeilFloatToInt32(sx0 - 0.5f);
-		int ix1 = deCeilFloatToInt32(sx1 - 0.5f);
-		int iy0 = deCeilFloatToInt32(sy0 - 0.5f);
-		int iy1 = deCeilFloatToInt32(sy1 - 0.5f);
-
-		int		v00 = (y * stride) + x;
-		int		v01 = (y * stride) + x + 1;
-		int		v10 = ((y + 1) * stride) + x;
-		int		v11 = ((y + 1) * stride) + x + 1;
-		Vec4	c00 = colors[v00];
-		Vec4	c01 = colors[v01];
-		Vec4	c10 = colors[v10];
-		Vec4	c11 = colors[v11];
-
-		//printf("(%d,%d) -> (%f..%f, %f..%f) (%d..%d, %d..%d)\n", x, y, sx0, sx1, sy0, sy1, ix0, ix1, iy0, iy1);
-
-		for (int iy = iy0; iy < iy1; iy++)
-		for (int ix = ix0; ix < ix1; ix++)
+	}
+
+	// \note Rows are rows of grid quads. Adjacent quad rows share edge coordinates and thus cover disjoint pixel rows.
+	void processRows (int bandNdx, int rowBegin, int rowEnd)
+	{
+		const int	width		= m_result.getWidth();
+		const int	height		= m_result.getHeight();
+		const int	gridSize	= m_gridSize;
+		const int	stride		= gridSize + 1;
+
+		DE_UNREF(bandNdx);
+
+		for (int y = rowBegin; y < rowEnd; y++)
+		for (int x = 0; x < gridSize; x++)
 		{
-			DE_ASSERT(deInBounds32(ix, 0, width));
-			DE_ASSERT(deInBounds32(iy, 0, height));
-
-			float		sfx		= (float)ix + 0.5f;
-			float		sfy		= (float)iy + 0.5f;
-			float		fx1		= deFloatClamp((sfx - sx0) * oosx, 0.0f, 1.0f);
-			float		fy1		= deFloatClamp((sfy - sy0) * oosy, 0.0f, 1.0f);
-
-			// Triangle quad interpolation.
-			bool		tri		= fx1 + fy1 <= 1.0f;
-			float		tx		= tri ? fx1 : (1.0f-fx1);
-			float		ty		= tri ? fy1 : (1.0f-fy1);
-			const Vec4&	t0		= tri ? c00 : c11;
-			const Vec4&	t1		= tri ? c01 : c10;
-			const Vec4&	t2		= tri ? c10 : c01;
-			Vec4		color	= t0 + (t1-t0)*tx + (t2-t0)*ty;
-
-			result.setPixel(ix, iy, tcu::RGBA(color));
+			float x0 = (float)x       / (float)gridSize;
+			float x1 = (float)(x + 1) / (float)gridSize;
+			float y0 = (float)y       / (float)gridSize;
+			float y1 = (float)(y + 1) / (float)gridSize;
+
+			float sx0 = x0 * (float)width;
+			float sx1 = x1 * (float)width;
+			float sy0 = y0 * (float)height;
+			float sy1 = y1 * (float)height;
+			float oosx = 1.0f / (sx1 - sx0);
+			float oosy = 1.0f / (sy1 - sy0);
+
+			int ix0 = deCeilFloatToInt32(sx0 - 0.5f);
+			int ix1 = deCeilFloatToInt32(sx1 - 0.5f);
+			int iy0 = deCeilFloatToInt32(sy0 - 0.5f);
+			int iy1 = deCeilFloatToInt32(sy1 - 0.5f);
+
+			int		v00 = (y * stride) + x;
+			int		v01 = (y * stride) + x + 1;
+			int		v10 = ((y + 1) * stride) + x;
+			int		v11 = ((y + 1) * stride) + x + 1;
+			Vec4	c00 = m_colors[v00];
+			Vec4	c01 = m_colors[v01];
+			Vec4	c10 = m_colors[v10];
+			Vec4	c11 = m_colors[v11];
+
+			for (int iy = iy0; iy < iy1; iy++)
+			for (int ix = ix0; ix < ix1; ix++)
+			{
+				DE_ASSERT(deInBounds32(ix, 0, width));
+				DE_ASSERT(deInBounds32(iy, 0, height));
+
+				float		sfx		= (float)ix + 0.5f;
+				float		sfy		= (float)iy + 0.5f;
+				float		fx1		= deFloatClamp((sfx - sx0) * oosx, 0.0f, 1.0f);
+				float		fy1		= deFloatClamp((sfy - sy0) * oosy, 0.0f, 1.0f);
+
+				// Triangle quad interpolation.
+				bool		tri		= fx1 + fy1 <= 1.0f;
+				float		tx		= tri ? fx1 : (1.0f-fx1);
+				float		ty		= tri ? fy1 : (1.0f-fy1);
+				const Vec4&	t0		= tri ? c00 : c11;
+				const Vec4&	t1		= tri ? c01 : c10;
+				const Vec4&	t2		= tri ? c10 : c01;
+				Vec4		color	= t0 + (t1-t0)*tx + (t2-t0)*ty;
+
+				m_result.setPixel(ix, iy, tcu::RGBA(color));
+			}
 		}
 	}
-}
 
-void ShaderRenderCase::computeFragmentReference (Surface& result, const QuadGrid& quadGrid)
+private:
+	Surface&				m_result;
+	const int				m_gridSize;
+	const vector<Vec4>&		m_colors;
+};
+
+class FragmentEvalTask : public tcu::RowBandTask
 {
-	// Buffer info.
-	int					width		= result.getWidth();
-	int					height		= result.getHeight();
-	bool				hasAlpha	= m_renderCtx.getRenderTarget().getPixelFormat().alphaBits > 0;
-	ShaderEvalContext	evalCtx		(quadGrid);
+public:
+	FragmentEvalTask (ShaderEvaluator& evaluator, const QuadGrid& quadGrid, bool hasAlpha, const Vec4& clearColor, Surface& result)
+		: m_evaluator	(evaluator)
+		, m_quadGrid	(quadGrid)
+		, m_hasAlpha	(hasAlpha)
+		, m_clearColor	(clearColor)
+		, m_result		(result)
+	{
+	}
 
-	// Render.
-	for (int y = 0; y < height; y++)
-	for (int x = 0; x < width; x++)
+	void processRows (int bandNdx, int rowBegin, int rowEnd)
 	{
-		float sx = ((float)x + 0.5f) / (float)width;
-		float sy = ((float)y + 0.5f) / (float)height;
+		const int			width		= m_result.getWidth();
+		const int			height		= m_result.getHeight();
+		ShaderEvalContext	evalCtx		(m_quadGrid);
 
-		evalCtx.reset(sx, sy);
-		m_evaluator.evaluate(evalCtx);
-		// Select either clear color or computed color based on discarded bit.
-		Vec4 color = evalCtx.isDiscarded ? m_clearColor : evalCtx.color;
+		DE_UNREF(bandNdx);
 
-		if (!hasAlpha)
-			color.w() = 1.0f;
+		for (int y = rowBegin; y < rowEnd; y++)
+		for (int x = 0; x < width; x++)
+		{
+			float sx = ((float)x + 0.5f) / (float)width;
+			float sy = ((float)y + 0.5f) / (float)height;
+
+			evalCtx.reset(sx, sy);
+			m_evaluator.evaluate(evalCtx);
+			// Select either clear color or computed color based on discarded bit.
+			Vec4 color = evalCtx.isDiscarded ? m_clearColor : evalCtx.color;
+
+			if (!m_hasAlpha)
+				color.w() = 1.0f;
 
-		result.setPixel(x, y, tcu::RGBA(color));
+			m_result.setPixel(x, y, tcu::RGBA(color));
+		}
 	}
+
+private:
+	ShaderEvaluator&	m_evaluator;
+	const QuadGrid&		m_quadGrid;
+	const bool			m_hasAlpha;
+	const Vec4			m_clearColor;
+	Surface&			m_result;
+};
+
+} // anonymous
+
+void ShaderRenderCase::computeVertexReference (Surface& result, const QuadGrid& quadGrid)
+{
+	const int		gridSize	= quadGrid.getGridSize();
+	const bool		hasAlpha	= m_renderCtx.getRenderTarget().getPixelFormat().alphaBits > 0;
+	vector<Vec4>	colors		((gridSize+1)*(gridSize+1));
+
+	// Evaluate color for each vertex.
+	{
+		VertexEvalTask task (m_evaluator, quadGrid, hasAlpha, colors);
+
+		tcu::executeRowBands(task, gridSize+1, getNumEvalBands(gridSize+1, gridSize+1));
+	}
+
+	// Render quads.
+	{
+		const int				quadRowLength	= result.getWidth()*result.getHeight() / de::max(gridSize, 1);
+		VertexColorRasterTask	task			(result, gridSize, colors);
+
+		tcu::executeRowBands(task, gridSize, tcu::getNumRowBands(gridSize, quadRowLength, rr::getDefaultNumRasterizationThreads()));
+	}
+}
+
+void ShaderRenderCase::computeFragmentReference (Surface& result, const QuadGrid& quadGrid)
+{
+	const bool			hasAlpha	= m_renderCtx.getRenderTarget().getPixelFormat().alphaBits > 0;
+	FragmentEvalTask	task		(m_evaluator, quadGrid, hasAlpha, m_clearColor, result);
+
+	tcu::executeRowBands(task, result.getHeight(), getNumEvalBands(result.getHeight(), result.getWidth()));
 }
 
 bool ShaderRenderCase::compareImages (const Surface& resImage, const Surface& refImage, float errorThreshold)
@@ -182,6 +182,7 @@ inline void evalCoordsSwizzleWZYX		(ShaderEvalContext& c) { c.color = c.coords.s
 
 // ShaderEvaluator
 // Either inherit a class with overridden evaluate() or just pass in an evalFunc.
+// evaluate() is called concurrently from several threads when computing reference images and must not modify evaluator state.
 
 class ShaderEvaluator
 {
@@ -30,16 +30,47 @@
 #include "tcuEither.hpp"
 #include "tcuTestLog.hpp"
 #include "tcuCommandLine.hpp"
+#include "tcuImageCompare.hpp"
+#include "tcuParallelRows.hpp"
+#include "tcuTexLookupVerifier.hpp"
+#include "tcuTestPackage.hpp"
+#include "tcuTestHierarchyIndex.hpp"
+#include "tcuTestSessionExecutor.hpp"
+#include "tcuResource.hpp"
+#include "tcuApp.hpp"
+
+#include "gluShaderLibrary.hpp"
+#include "gluShaderUtil.hpp"
 
 #include "rrRenderer.hpp"
+#include "rrRasterizer.hpp"
 #include "tcuTextureUtil.hpp"
 #include "tcuVectorUtil.hpp"
 #include "tcuFloat.hpp"
+#include "tcuFormatUtil.hpp"
 
 #include "deRandom.hpp"
 #include "deArrayUtil.hpp"
+#include "deStringUtil.hpp"
+#include "deString.h"
+#include "deFile.h"
+#include "deDirectoryIterator.hpp"
+
+#include "qpTestLog.h"
 
 #include <stdexcept>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <algorithm>
+
+#if (DE_OS == DE_OS_UNIX)
+#	include <new>
+#	include <signal.h>
+#	include <unistd.h>
+#	include <sys/mman.h>
+#	include <sys/wait.h>
+#endif
 
 namespace dit
 {
@@ -53,7 +84,7 @@ using tcu::TestLog;
 
 struct MatchCase
 {
-	enum Expected { NO_MATCH, MATCH_GROUP, MATCH_CASE, EXPECTED_LAST };
+	enum Expected { NO_MATCH, MATCH_GROUP, MATCH_CASE, MATCH_GROUP_AND_CASE, EXPECTED_LAST };
 
 	const char*	path;
 	Expected	expected;
@@ -65,7 +96,8 @@ const char* getMatchCaseExpectedDesc (MatchCase::Expected expected)
 	{
 		"no match",
 		"group to match",
-		"case to match"
+		"case to match",
+		"group and case to match"
 	};
 	return de::getSizedArrayElement<MatchCase::EXPECTED_LAST>(descs, expected);
 }
@@ -73,11 +105,12 @@ const char* getMatchCaseExpectedDesc (MatchCase::Expected expected)
 class CaseListParserCase : public tcu::TestCase
 {
 public:
-	CaseListParserCase (tcu::TestContext& testCtx, const char* name, const char* caseList, const MatchCase* subCases, int numSubCases)
+	CaseListParserCase (tcu::TestContext& testCtx, const char* name, const char* caseList, const MatchCase* subCases, int numSubCases, const char* filterOption = "--deqp-caselist")
 		: tcu::TestCase	(testCtx, name, "")
 		, m_caseList	(caseList)
 		, m_subCases	(subCases)
 		, m_numSubCases	(numSubCases)
+		, m_filterOption(filterOption)
 	{
 	}
 
@@ -94,7 +127,7 @@ public:
 			const char* argv[] =
 			{
 				"deqp",
-				"--deqp-caselist",
+				m_filterOption,
 				m_caseList
 			};
 
@@ -107,6 +140,8 @@ public:
 		for (int subCaseNdx = 0; subCaseNdx < m_numSubCases; subCaseNdx++)
 		{
 			const MatchCase&	curCase		= m_subCases[subCaseNdx];
+			const bool			expectGroup	= curCase.expected == MatchCase::MATCH_GROUP || curCase.expected == MatchCase::MATCH_GROUP_AND_CASE;
+			const bool			expectCase	= curCase.expected == MatchCase::MATCH_CASE || curCase.expected == MatchCase::MATCH_GROUP_AND_CASE;
 			bool				matchGroup;
 			bool				matchCase;
 
@@ -117,8 +152,7 @@ public:
 			matchGroup	= caseListFilter->checkTestGroupName(curCase.path);
 			matchCase	= caseListFilter->checkTestCaseName(curCase.path);
 
-			if ((matchGroup	== (curCase.expected == MatchCase::MATCH_GROUP)) &&
-				(matchCase	== (curCase.expected == MatchCase::MATCH_CASE)))
+			if (matchGroup == expectGroup && matchCase == expectCase)
 			{
 				log << TestLog::Message << "   pass" << TestLog::EndMessage;
 				numPass += 1;
@@ -137,6 +171,7 @@ private:
 	const char* const			m_caseList;
 	const MatchCase* const		m_subCases;
 	const int					m_numSubCases;
+	const char* const			m_filterOption;
 };
 
 class NegativeCaseListCase : public tcu::TestCase
@@ -556,6 +591,90 @@ public:
 	}
 };
 
+class CasePathTests : public tcu::TestCaseGroup
+{
+public:
+	CasePathTests (tcu::TestContext& testCtx)
+		: tcu::TestCaseGroup(testCtx, "case_path", "Test case path pattern tests")
+	{
+	}
+
+	void init (void)
+	{
+		{
+			static const char* const	casePath	= "a.b.c";
+			static const MatchCase		subCases[]	=
+			{
+				{ "a",			MatchCase::MATCH_GROUP			},
+				{ "a.b",		MatchCase::MATCH_GROUP			},
+				{ "a.b.c",		MatchCase::MATCH_GROUP_AND_CASE	},
+				{ "a.b.d",		MatchCase::NO_MATCH				},
+				{ "a.b.c.d",	MatchCase::NO_MATCH				},
+				{ "a.bx",		MatchCase::NO_MATCH				},
+				{ "b",			MatchCase::NO_MATCH				},
+			};
+			addChild(new CaseListParserCase(m_testCtx, "exact", casePath, subCases, DE_LENGTH_OF_ARRAY(subCases), "--deqp-case"));
+		}
+		{
+			static const char* const	casePath	= "a.*.c";
+			static const MatchCase		subCases[]	=
+			{
+				{ "a",			MatchCase::MATCH_GROUP			},
+				{ "a.x",		MatchCase::MATCH_GROUP			},
+				{ "a.x.c",		MatchCase::MATCH_GROUP_AND_CASE	},
+				{ "a.x.y.c",	MatchCase::MATCH_GROUP_AND_CASE	},
+				{ "a.x.d",		MatchCase::MATCH_GROUP			},
+				{ "a..c",		MatchCase::MATCH_GROUP_AND_CASE	},
+				{ "a.c",		MatchCase::MATCH_GROUP			},
+				{ "b",			MatchCase::NO_MATCH				},
+				{ "b.x.c",		MatchCase::NO_MATCH				},
+			};
+			addChild(new CaseListParserCase(m_testCtx, "wildcard", casePath, subCases, DE_LENGTH_OF_ARRAY(subCases), "--deqp-case"));
+		}
+		{
+			static const char* const	casePath	= "*.c";
+			static const MatchCase		subCases[]	=
+			{
+				{ "c",			MatchCase::MATCH_GROUP			},
+				{ "x.c",		MatchCase::MATCH_GROUP_AND_CASE	},
+				{ "x.y.c",		MatchCase::MATCH_GROUP_AND_CASE	},
+				{ "x.c.d",		MatchCase::MATCH_GROUP			},
+			};
+			addChild(new CaseListParserCase(m_testCtx, "leading_wildcard", casePath, subCases, DE_LENGTH_OF_ARRAY(subCases), "--deqp-case"));
+		}
+		{
+			static const char* const	casePath	= "a.b**c";
+			static const MatchCase		subCases[]	=
+			{
+				{ "a.bc",		MatchCase::MATCH_GROUP_AND_CASE	},
+				{ "a.bxc",		MatchCase::MATCH_GROUP_AND_CASE	},
+				{ "a.bx",		MatchCase::MATCH_GROUP			},
+				{ "a.c",		MatchCase::NO_MATCH				},
+			};
+			addChild(new CaseListParserCase(m_testCtx, "double_wildcard", casePath, subCases, DE_LENGTH_OF_ARRAY(subCases), "--deqp-case"));
+		}
+		{
+			static const char* const	casePath	= "a.b,c.*,a.bc*,a.b*d";
+			static const MatchCase		subCases[]	=
+			{
+				{ "a",			MatchCase::MATCH_GROUP			},
+				{ "a.b",		MatchCase::MATCH_GROUP_AND_CASE	},
+				{ "a.bc",		MatchCase::MATCH_GROUP_AND_CASE	},
+				{ "a.bce",		MatchCase::MATCH_GROUP_AND_CASE	},
+				{ "a.bd",		MatchCase::MATCH_GROUP_AND_CASE	},
+				{ "a.bxd",		MatchCase::MATCH_GROUP_AND_CASE	},
+				{ "a.bx",		MatchCase::MATCH_GROUP			},
+				{ "a.c",		MatchCase::NO_MATCH				},
+				{ "c",			MatchCase::MATCH_GROUP			},
+				{ "c.d",		MatchCase::MATCH_GROUP_AND_CASE	},
+				{ "c.d.e",		MatchCase::MATCH_GROUP_AND_CASE	},
+				{ "b",			MatchCase::NO_MATCH				},
+			};
+			addChild(new CaseListParserCase(m_testCtx, "multiple", casePath, subCases, DE_LENGTH_OF_ARRAY(subCases), "--deqp-case"));
+		}
+	}
+};
+
 class CaseListParserTests : public tcu::TestCaseGroup
 {
 public:
@@ -568,6 +687,7 @@ public:
 	{
 		addChild(new TrieParserTests(m_testCtx));
 		addChild(new ListParserTests(m_testCtx));
+		addChild(new CasePathTests(m_testCtx));
 	}
 };
 
@@ -880,34 +1000,1373 @@ protected:
 	vector<SubCase>::const_iterator	m_caseIter;
 };
 
-class CommonFrameworkTests : public tcu::TestCaseGroup
+class TiledRasterizationTest : public tcu::TestCase
 {
 public:
-	CommonFrameworkTests (tcu::TestContext& testCtx)
-		: tcu::TestCaseGroup(testCtx, "common", "Tests for the common utility framework")
+	TiledRasterizationTest (tcu::TestContext& testCtx, const char* name, rr::PrimitiveType primitiveType, int numSamples, int tileSize)
+		: tcu::TestCase		(testCtx, name, "Compare tiled and sequential rasterization results")
+		, m_primitiveType	(primitiveType)
+		, m_numSamples		(numSamples)
+		, m_tileSize		(tileSize)
 	{
 	}
 
-	void init (void)
+	IterateResult iterate (void)
 	{
-		addChild(new SelfCheckCase(m_testCtx, "float_format","tcu::FloatFormat_selfTest()",
-								   tcu::FloatFormat_selfTest));
-		addChild(new SelfCheckCase(m_testCtx, "either","tcu::Either_selfTest()",
-								   tcu::Either_selfTest));
+		using namespace tcu;
+
+		const int			width			= 157;
+		const int			height			= 129;
+		const int			numVertices		= 3*64;
+		const int			numThreads		= 4;
+		de::Random			rnd				(deStringHash(getName()));
+		vector<Vec4>		positions		(numVertices);
+		vector<Vec4>		colors			(numVertices);
+
+		for (int vtxNdx = 0; vtxNdx < numVertices; vtxNdx++)
+		{
+			positions[vtxNdx]	= Vec4(rnd.getFloat(-1.2f, 1.2f), rnd.getFloat(-1.2f, 1.2f), rnd.getFloat(-1.0f, 1.0f), 1.0f);
+			colors[vtxNdx]		= Vec4(rnd.getFloat(), rnd.getFloat(), rnd.getFloat(), rnd.getFloat());
+		}
+
+		TextureLevel	refColor		(TextureFormat(TextureFormat::RGBA, TextureFormat::FLOAT), m_numSamples, width, height);
+		TextureLevel	refDepthStencil	(TextureFormat(TextureFormat::DS, TextureFormat::UNSIGNED_INT_24_8), m_numSamples, width, height);
+		TextureLevel	tiledColor		(refColor.getFormat(), m_numSamples, width, height);
+		TextureLevel	tiledDepthStencil(refDepthStencil.getFormat(), m_numSamples, width, height);
+
+		render(refColor.getAccess(), refDepthStencil.getAccess(), positions, colors, 1);
+		render(tiledColor.getAccess(), tiledDepthStencil.getAccess(), positions, colors, numThreads);
+
+		m_testCtx.getLog() << TestLog::Message
+						   << "Rendered " << numVertices << " vertices to " << width << "x" << height << " target with " << m_numSamples << " sample(s), "
+						   << "tiled using " << numThreads << " threads and " << m_tileSize << "x" << m_tileSize << " tiles"
+						   << TestLog::EndMessage;
+
+		{
+			const bool colorOk	= deMemCmp(refColor.getAccess().getDataPtr(), tiledColor.getAccess().getDataPtr(), getDataSize(refColor)) == 0;
+			const bool dsOk		= deMemCmp(refDepthStencil.getAccess().getDataPtr(), tiledDepthStencil.getAccess().getDataPtr(), getDataSize(refDepthStencil)) == 0;
+
+			if (!colorOk)
+				m_testCtx.getLog() << TestLog::Message << "FAIL: Color buffers differ" << TestLog::EndMessage;
+
+			if (!dsOk)
+				m_testCtx.getLog() << TestLog::Message << "FAIL: Depth-stencil buffers differ" << TestLog::EndMessage;
+
+			if (colorOk && dsOk)
+				m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+			else
+				m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Tiled rasterization result differs");
+		}
+
+		return STOP;
+	}
+
+private:
+	static size_t getDataSize (const tcu::TextureLevel& level)
+	{
+		return (size_t)level.getFormat().getPixelSize() * level.getWidth() * level.getHeight() * level.getDepth();
+	}
+
+	void render (const tcu::PixelBufferAccess& color, const tcu::PixelBufferAccess& depthStencil, const vector<tcu::Vec4>& positions, const vector<tcu::Vec4>& colors, int numThreads) const
+	{
+		class VtxShader : public rr::VertexShader
+		{
+		public:
+			VtxShader (void)
+				: rr::VertexShader(2, 1)
+			{
+				m_inputs[0].type	= rr::GENERICVECTYPE_FLOAT;
+				m_inputs[1].type	= rr::GENERICVECTYPE_FLOAT;
+				m_outputs[0].type	= rr::GENERICVECTYPE_FLOAT;
+			}
+
+			void shadeVertices (const rr::VertexAttrib* inputs, rr::VertexPacket* const* packets, const int numPackets) const
+			{
+				for (int packetNdx = 0; packetNdx < numPackets; packetNdx++)
+				{
+					rr::readVertexAttrib(packets[packetNdx]->position, inputs[0], packets[packetNdx]->instanceNdx, packets[packetNdx]->vertexNdx);
+					packets[packetNdx]->outputs[0]	= rr::readVertexAttribFloat(inputs[1], packets[packetNdx]->instanceNdx, packets[packetNdx]->vertexNdx);
+					packets[packetNdx]->pointSize	= 7.0f;
+				}
+			}
+		} vtxShader;
+
+		class FragShader : public rr::FragmentShader
+		{
+		public:
+			FragShader (void)
+				: rr::FragmentShader(1, 1)
+			{
+				m_inputs[0].type	= rr::GENERICVECTYPE_FLOAT;
+				m_outputs[0].type	= rr::GENERICVECTYPE_FLOAT;
+			}
+
+			void shadeFragments (rr::FragmentPacket* packets, const int numPackets, const rr::FragmentShadingContext& context) const
+			{
+				for (int packetNdx = 0; packetNdx < numPackets; packetNdx++)
+				{
+					// Include derivatives to verify that 2x2 packets are not split at tile boundaries
+					const tcu::Vec4 dx = rr::readVarying<float>(packets[packetNdx], context, 0, 1) - rr::readVarying<float>(packets[packetNdx], context, 0, 0);
+
+					for (int fragNdx = 0; fragNdx < rr::NUM_FRAGMENTS_PER_PACKET; fragNdx++)
+						rr::writeFragmentOutput(context, packetNdx, fragNdx, 0, rr::readVarying<float>(packets[packetNdx], context, 0, fragNdx) + dx);
+				}
+			}
+		} fragShader;
+
+		tcu::clear			(color, tcu::Vec4(0.0f, 0.0f, 0.0f, 1.0f));
+		tcu::clearDepth		(depthStencil, 1.0f);
+		tcu::clearStencil	(depthStencil, 0);
+
+		const rr::Program						program			(&vtxShader, &fragShader);
+		const rr::MultisamplePixelBufferAccess	colorAccess		= rr::MultisamplePixelBufferAccess::fromMultisampleAccess(color);
+		const rr::MultisamplePixelBufferAccess	dsAccess		= rr::MultisamplePixelBufferAccess::fromMultisampleAccess(depthStencil);
+		const rr::RenderTarget					renderTarget	(colorAccess, dsAccess, dsAccess);
+		const rr::VertexAttrib					vertexAttribs[]	=
+		{
+			rr::VertexAttrib(rr::VERTEXATTRIBTYPE_FLOAT, 4, 0, 0, &positions[0]),
+			rr::VertexAttrib(rr::VERTEXATTRIBTYPE_FLOAT, 4, 0, 0, &colors[0])
+		};
+		rr::RenderState							state			((rr::ViewportState(colorAccess)));
+		const rr::Renderer						renderer;
+
+		state.tiling.numThreads									= numThreads;
+		state.tiling.tileSize									= m_tileSize;
+		state.line.lineWidth									= 3.0f;
+		state.fragOps.depthTestEnabled							= true;
+		state.fragOps.depthFunc									= rr::TESTFUNC_LESS;
+		state.fragOps.stencilTestEnabled						= true;
+		state.fragOps.stencilStates[rr::FACETYPE_BACK].func		= rr::TESTFUNC_ALWAYS;
+		state.fragOps.stencilStates[rr::FACETYPE_BACK].dpPass	= rr::STENCILOP_INCR;
+		state.fragOps.stencilStates[rr::FACETYPE_FRONT]			= state.fragOps.stencilStates[rr::FACETYPE_BACK];
+		state.fragOps.blendMode									= rr::BLENDMODE_STANDARD;
+		state.fragOps.blendRGBState.srcFunc						= rr::BLENDFUNC_SRC_ALPHA;
+		state.fragOps.blendRGBState.dstFunc						= rr::BLENDFUNC_ONE_MINUS_SRC_ALPHA;
+		state.fragOps.blendAState								= state.fragOps.blendRGBState;
+
+		renderer.draw(rr::DrawCommand(state, renderTarget, program, DE_LENGTH_OF_ARRAY(vertexAttribs), vertexAttribs, rr::PrimitiveList(m_primitiveType, (int)positions.size(), 0)));
 	}
+
+	const rr::PrimitiveType	m_primitiveType;
+	const int				m_numSamples;
+	const int				m_tileSize;
 };
 
-class ReferenceRendererTests : public tcu::TestCaseGroup
+class AsyncImageLogCase : public tcu::TestCase
 {
 public:
-	ReferenceRendererTests (tcu::TestContext& testCtx)
-		: tcu::TestCaseGroup(testCtx, "reference_renderer", "Reference renderer tests")
+	AsyncImageLogCase (tcu::TestContext& testCtx)
+		: tcu::TestCase(testCtx, "async_image_log", "Compare test log written with and without asynchronous image encoding")
 	{
 	}
 
-	void init (void)
+	IterateResult iterate (void)
 	{
-		addChild(new ConstantInterpolationTest(m_testCtx));
+		const char* const	syncFileName	= "dit-async-image-log-sync.qpa";
+		const char* const	asyncFileName	= "dit-async-image-log-async.qpa";
+		vector<deUint8>		syncLog;
+		vector<deUint8>		asyncLog;
+
+		writeLog(syncFileName, 0u);
+		writeLog(asyncFileName, QP_TEST_LOG_ASYNC_IMAGES);
+
+		readFile(syncFileName, syncLog);
+		readFile(asyncFileName, asyncLog);
+
+		deDeleteFile(syncFileName);
+		deDeleteFile(asyncFileName);
+
+		m_testCtx.getLog() << TestLog::Message << "Log sizes: " << syncLog.size() << " and " << asyncLog.size() << " bytes" << TestLog::EndMessage;
+
+		if (!syncLog.empty() && syncLog == asyncLog)
+			m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+		else
+			m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Logs differ");
+
+		return STOP;
+	}
+
+private:
+	static void writeLog (const char* fileName, deUint32 flags)
+	{
+		qpTestLog* const	log			= qpTestLog_createFileLog(fileName, flags);
+		de::Random			rnd			(0x4a12);
+		const int			numImages	= 40;
+
+		if (!log)
+			throw tcu::ResourceError(string("Failed to create ") + fileName);
+
+		qpTestLog_startCase(log, "dit.async_image_log", QP_TEST_CASE_TYPE_SELF_VALIDATE);
+		qpTestLog_writeMessage(log, "Before images");
+		qpTestLog_startImageSet(log, "Set", "Images in set");
+
+		for (int imageNdx = 0; imageNdx < numImages; imageNdx++)
+		{
+			const qpImageFormat				format		= (imageNdx % 2) ? QP_IMAGE_FORMAT_RGBA8888 : QP_IMAGE_FORMAT_RGB888;
+			const qpImageCompressionMode	mode		= (imageNdx % 3) ? QP_IMAGE_COMPRESSION_MODE_BEST : QP_IMAGE_COMPRESSION_MODE_NONE;
+			const int						width		= rnd.getInt(1, 67);
+			const int						height		= rnd.getInt(1, 33);
+			const int						stride		= width*(format == QP_IMAGE_FORMAT_RGB888 ? 3 : 4) + rnd.getInt(0, 5);
+			const string					name		= "Image" + de::toString(imageNdx);
+			vector<deUint8>					pixels		((size_t)(stride*height));
+
+			for (size_t ndx = 0; ndx < pixels.size(); ndx++)
+				pixels[ndx] = (deUint8)(rnd.getBool() ? rnd.getUint32() : ndx/7);
+
+			qpTestLog_writeImage(log, name.c_str(), (imageNdx % 4) ? DE_NULL : "Description", mode, format, width, height, stride, &pixels[0]);
+
+			// Image sets and other elements in between must keep their place.
+			if (imageNdx % 10 == 9)
+			{
+				qpTestLog_endImageSet(log);
+				if (imageNdx % 20 == 9)
+					qpTestLog_writeMessage(log, "Between sets");
+				qpTestLog_startImageSet(log, "Set", DE_NULL);
+			}
+		}
+
+		qpTestLog_endImageSet(log);
+		qpTestLog_endCase(log, QP_TEST_RESULT_PASS, "Pass");
+		qpTestLog_destroy(log);
+	}
+
+	static void readFile (const char* fileName, vector<deUint8>& dst)
+	{
+		std::ifstream file (fileName, std::ios_base::binary);
+
+		dst.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+};
+
+class BufferLogCase : public tcu::TestCase
+{
+public:
+	BufferLogCase (tcu::TestContext& testCtx)
+		: tcu::TestCase(testCtx, "buffer_log", "Compare test log written directly and through buffer logs")
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		const char* const	directFileName		= "dit-buffer-log-direct.qpa";
+		const char* const	bufferedFileName	= "dit-buffer-log-buffered.qpa";
+		const int			numCases			= 3;
+		vector<deUint8>		directLog;
+		vector<deUint8>		bufferedLog;
+
+		{
+			TestLog log (directFileName);
+
+			for (int caseNdx = 0; caseNdx < numCases; caseNdx++)
+				writeCase(log, caseNdx);
+		}
+
+		{
+			TestLog			log		(bufferedFileName);
+			TestLog			buffer	(TestLog::Buffer);
+			vector<deUint8>	data;
+
+			// Buffer is consumed after each case, as done by TestSessionExecutor.
+			for (int caseNdx = 0; caseNdx < numCases; caseNdx++)
+			{
+				writeCase(buffer, caseNdx);
+				buffer.readBuffer(data);
+				log.writeBufferData(data);
+			}
+
+			buffer.readBuffer(data);
+			TCU_CHECK(data.empty());
+		}
+
+		readFile(directFileName, directLog);
+		readFile(bufferedFileName, bufferedLog);
+
+		deDeleteFile(directFileName);
+		deDeleteFile(bufferedFileName);
+
+		m_testCtx.getLog() << TestLog::Message << "Log sizes: " << directLog.size() << " and " << bufferedLog.size() << " bytes" << TestLog::EndMessage;
+
+		if (!directLog.empty() && directLog == bufferedLog)
+			m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+		else
+			m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Logs differ");
+
+		return STOP;
+	}
+
+	bool isContextFree (void) const
+	{
+		return true;
+	}
+
+private:
+	static void writeCase (TestLog& log, int caseNdx)
+	{
+		const string casePath = "dit.buffer_log.case" + de::toString(caseNdx);
+
+		log.startCase(casePath.c_str(), QP_TEST_CASE_TYPE_SELF_VALIDATE);
+		log << TestLog::Message << "Message " << caseNdx << TestLog::EndMessage
+			<< TestLog::Section("Section", "Section with <escaped> & characters")
+			<< TestLog::Integer("Value", "Value", "us", QP_KEY_TAG_TIME, (deInt64)caseNdx*1000)
+			<< TestLog::EndSection;
+		log.endCase(caseNdx == 1 ? QP_TEST_RESULT_FAIL : QP_TEST_RESULT_PASS, "Done");
+	}
+
+	static void readFile (const char* fileName, vector<deUint8>& dst)
+	{
+		std::ifstream file (fileName, std::ios_base::binary);
+
+		dst.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+};
+
+class HierarchyIndexCase : public tcu::TestCase
+{
+public:
+	HierarchyIndexCase (tcu::TestContext& testCtx)
+		: tcu::TestCase(testCtx, "hierarchy_index", "Compare test hierarchy index against the inflated hierarchy")
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		const char* const					fileName	= "dit-hierarchy-index.bin";
+		tcu::TestPackageRoot				root		(m_testCtx, vector<tcu::TestNode*>(1, new Package(m_testCtx, "package")));
+		const de::MovePtr<tcu::TestHierarchyIndex>	index	= tcu::TestHierarchyIndex::build(root, m_testCtx);
+		de::MovePtr<tcu::TestHierarchyIndex>	loaded;
+		bool								allOk		= true;
+
+		index->save(fileName);
+		loaded = tcu::TestHierarchyIndex::load(fileName, root);
+
+		if (!loaded || !isSameIndex(*index, *loaded))
+		{
+			m_testCtx.getLog() << TestLog::Message << "ERROR: Loaded index differs from the saved one" << TestLog::EndMessage;
+			allOk = false;
+		}
+
+		// Truncated index must be rejected
+		{
+			vector<deUint8> data;
+
+			readFile(fileName, data);
+			data.resize(data.size() - 1);
+
+			{
+				std::ofstream out (fileName, std::ios_base::binary);
+				out.write((const char*)&data[0], (std::streamsize)data.size());
+			}
+
+			if (tcu::TestHierarchyIndex::load(fileName, root))
+			{
+				m_testCtx.getLog() << TestLog::Message << "ERROR: Truncated index was accepted" << TestLog::EndMessage;
+				allOk = false;
+			}
+		}
+
+		// Index built for other packages must be rejected
+		{
+			tcu::TestPackageRoot otherRoot (m_testCtx, vector<tcu::TestNode*>(1, new Package(m_testCtx, "other_package")));
+
+			index->save(fileName);
+
+			if (tcu::TestHierarchyIndex::load(fileName, otherRoot))
+			{
+				m_testCtx.getLog() << TestLog::Message << "ERROR: Index of another hierarchy was accepted" << TestLog::EndMessage;
+				allOk = false;
+			}
+		}
+
+		deDeleteFile(fileName);
+
+		// Unfiltered, iterating the index must match iterating the hierarchy
+		allOk = checkIteration(root, *index, DE_NULL, "package.a,package.a.x,package.a.x.c0,package.a.x.c1,package.a.y,package.a.y.c0,package.b,package.b.c0") && allOk;
+
+		// Groups without matching cases are skipped when filter has access to index
+		allOk = checkIteration(root, *index, "package.*.c1", "package.a,package.a.x,package.a.x.c1") && allOk;
+
+		m_testCtx.setTestResult(allOk ? QP_TEST_RESULT_PASS : QP_TEST_RESULT_FAIL, allOk ? "Pass" : "Index doesn't match hierarchy");
+		return STOP;
+	}
+
+private:
+	class Case : public tcu::TestCase
+	{
+	public:
+		Case (tcu::TestContext& testCtx, const char* name)
+			: tcu::TestCase(testCtx, name, "Case")
+		{
+		}
+
+		IterateResult iterate (void)
+		{
+			m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+			return STOP;
+		}
+	};
+
+	class Package : public tcu::TestPackage
+	{
+	public:
+		Package (tcu::TestContext& testCtx, const char* name)
+			: tcu::TestPackage(testCtx, name, "Package")
+		{
+		}
+
+		void init (void)
+		{
+			tcu::TestCaseGroup* const a = new tcu::TestCaseGroup(m_testCtx, "a", "Group a");
+			tcu::TestCaseGroup* const x = new tcu::TestCaseGroup(m_testCtx, "x", "Group x");
+			tcu::TestCaseGroup* const y = new tcu::TestCaseGroup(m_testCtx, "y", "Group y");
+			tcu::TestCaseGroup* const b = new tcu::TestCaseGroup(m_testCtx, "b", "Group b");
+
+			x->addChild(new Case(m_testCtx, "c0"));
+			x->addChild(new Case(m_testCtx, "c1"));
+			y->addChild(new Case(m_testCtx, "c0"));
+			b->addChild(new Case(m_testCtx, "c0"));
+
+			a->addChild(x);
+			a->addChild(y);
+			addChild(a);
+			addChild(b);
+		}
+
+		tcu::TestCaseExecutor* createExecutor (void) const
+		{
+			return DE_NULL;
+		}
+	};
+
+	static bool isSameIndex (const tcu::TestHierarchyIndex& a, const tcu::TestHierarchyIndex& b)
+	{
+		if (a.getNumNodes() != b.getNumNodes())
+			return false;
+
+		for (int nodeNdx = 0; nodeNdx < a.getNumNodes(); nodeNdx++)
+		{
+			const tcu::TestHierarchyIndex::Node& nodeA = a.getNode(nodeNdx);
+			const tcu::TestHierarchyIndex::Node& nodeB = b.getNode(nodeNdx);
+
+			if (nodeA.name != nodeB.name || nodeA.description != nodeB.description ||
+				nodeA.nodeType != nodeB.nodeType || nodeA.subtreeEnd != nodeB.subtreeEnd)
+				return false;
+		}
+
+		return true;
+	}
+
+	template<typename Iterator>
+	static string getEnteredPaths (Iterator& iter)
+	{
+		string paths;
+
+		for (; iter.getState() != tcu::TestHierarchyIterator::STATE_FINISHED; iter.next())
+		{
+			if (iter.getState() == tcu::TestHierarchyIterator::STATE_ENTER_NODE && iter.getNode()->getNodeType() != tcu::NODETYPE_PACKAGE)
+				paths += (paths.empty() ? "" : ",") + iter.getNodePath();
+		}
+
+		return paths;
+	}
+
+	bool checkIteration (tcu::TestPackageRoot& root, const tcu::TestHierarchyIndex& index, const char* casePath, const char* expected)
+	{
+		tcu::CommandLine	cmdLine;
+		const char*			argv[]		= { "deqp", "--deqp-case", casePath };
+		string				treePaths;
+		string				indexPaths;
+
+		if (!cmdLine.parse(casePath ? DE_LENGTH_OF_ARRAY(argv) : 1, argv))
+			TCU_FAIL("Failed to parse command line");
+
+		{
+			tcu::DefaultHierarchyInflater				inflater	(m_testCtx);
+			const de::MovePtr<tcu::CaseListFilter>		filter		= cmdLine.createCaseListFilter(m_testCtx.getArchive(), &index);
+			tcu::TestHierarchyIterator					iter		(root, inflater, *filter);
+
+			treePaths = getEnteredPaths(iter);
+		}
+
+		{
+			const de::MovePtr<tcu::CaseListFilter>		filter		= cmdLine.createCaseListFilter(m_testCtx.getArchive(), &index);
+			tcu::IndexedHierarchyIterator				iter		(index, *filter);
+
+			indexPaths = getEnteredPaths(iter);
+		}
+
+		m_testCtx.getLog() << TestLog::Message << "Filter " << (casePath ? casePath : "(none)") << "\n"
+											   << "  hierarchy: " << treePaths << "\n"
+											   << "  index:     " << indexPaths
+						   << TestLog::EndMessage;
+
+		return treePaths == expected && indexPaths == expected;
+	}
+
+	static void readFile (const char* fileName, vector<deUint8>& dst)
+	{
+		std::ifstream file (fileName, std::ios_base::binary);
+
+		dst.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+};
+
+//! Case executor that calls case methods directly, for packages built by tests.
+class DirectCaseExecutor : public tcu::TestCaseExecutor
+{
+public:
+	void							init		(tcu::TestCase* testCase, const std::string&)	{ testCase->init();				}
+	void							deinit		(tcu::TestCase* testCase)						{ testCase->deinit();			}
+	tcu::TestNode::IterateResult	iterate		(tcu::TestCase* testCase)						{ return testCase->iterate();	}
+};
+
+class SharedProgressCrashCase : public tcu::TestCase
+{
+public:
+	SharedProgressCrashCase (tcu::TestContext& testCtx)
+		: tcu::TestCase(testCtx, "shared_progress_crash", "Check that crash of a child process is attributed to the crashing context-free case")
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+#if (DE_OS == DE_OS_UNIX)
+		void* const					ptr			= mmap(DE_NULL, sizeof(tcu::TestSessionProgress), PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
+		tcu::TestSessionProgress*	progress	= DE_NULL;
+		int							status		= 0;
+		bool						childOk		= false;
+		bool						allOk		= false;
+
+		if (ptr == MAP_FAILED)
+			TCU_THROW(ResourceError, "Failed to allocate shared memory");
+
+		progress = new (ptr) tcu::TestSessionProgress();
+
+		// Child process inherits unflushed output.
+		fflush(DE_NULL);
+
+		{
+			const pid_t pid = fork();
+
+			if (pid == 0)
+				runChild(*progress);
+
+			childOk = pid > 0 && waitpid(pid, &status, 0) == pid;
+		}
+
+		if (childOk)
+		{
+			m_testCtx.getLog() << TestLog::Message << "Child process " << (WIFSIGNALED(status) ? "was killed by signal " + de::toString(WTERMSIG(status)) : "exited with code " + de::toString(WEXITSTATUS(status))) << "\n"
+												   << "  last case: " << progress->lastCasePath << "\n"
+												   << "  pending case: " << progress->pendingCasePath
+							   << TestLog::EndMessage;
+
+			allOk = WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL &&
+					string(progress->lastCasePath) == "package.group.c1" && string(progress->pendingCasePath) == "package.group.c2";
+		}
+
+		progress->~TestSessionProgress();
+		munmap(ptr, sizeof(tcu::TestSessionProgress));
+
+		if (!childOk)
+			TCU_THROW(InternalError, "Failed to run child process");
+
+		m_testCtx.setTestResult(allOk ? QP_TEST_RESULT_PASS : QP_TEST_RESULT_FAIL, allOk ? "Pass" : "Crash was attributed to wrong case");
+		return STOP;
+#else
+		TCU_THROW(NotSupportedError, "Child processes are not supported on this platform");
+#endif
+	}
+
+private:
+	//! Context-free case that either passes or kills the process it runs in.
+	class ContextFreeCase : public tcu::TestCase
+	{
+	public:
+		ContextFreeCase (tcu::TestContext& testCtx, const char* name, bool killProcess)
+			: tcu::TestCase	(testCtx, name, "Case")
+			, m_killProcess	(killProcess)
+		{
+		}
+
+		IterateResult iterate (void)
+		{
+#if (DE_OS == DE_OS_UNIX)
+			// \note SIGKILL bypasses crash handler inherited from the parent process.
+			if (m_killProcess)
+				raise(SIGKILL);
+#endif
+			m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+			return STOP;
+		}
+
+		bool isContextFree (void) const
+		{
+			return true;
+		}
+
+	private:
+		const bool m_killProcess;
+	};
+
+	class Package : public tcu::TestPackage
+	{
+	public:
+		Package (tcu::TestContext& testCtx)
+			: tcu::TestPackage(testCtx, "package", "Package")
+		{
+		}
+
+		void init (void)
+		{
+			tcu::TestCaseGroup* const group = new tcu::TestCaseGroup(m_testCtx, "group", "Group");
+
+			group->addChild(new ContextFreeCase(m_testCtx, "c0", false));
+			group->addChild(new ContextFreeCase(m_testCtx, "c1", false));
+			group->addChild(new ContextFreeCase(m_testCtx, "c2", true));
+			group->addChild(new ContextFreeCase(m_testCtx, "c3", false));
+
+			addChild(group);
+		}
+
+		tcu::TestCaseExecutor* createExecutor (void) const
+		{
+			return new DirectCaseExecutor();
+		}
+	};
+
+#if (DE_OS == DE_OS_UNIX)
+	//! Runs package with case threads and given progress, as done by fork server child. Doesn't return.
+	void runChild (tcu::TestSessionProgress& progress)
+	{
+		try
+		{
+			tcu::CommandLine	cmdLine;
+			const char*			argv[]		= { "deqp", "--deqp-case-threads=4" };
+
+			if (cmdLine.parse(DE_LENGTH_OF_ARRAY(argv), argv))
+			{
+				TestLog									log			(TestLog::Buffer);
+				tcu::TestContext						childCtx	(m_testCtx.getPlatform(), m_testCtx.getRootArchive(), log, cmdLine, DE_NULL);
+				tcu::TestPackageRoot					root		(childCtx, vector<tcu::TestNode*>(1, new Package(childCtx)));
+				const de::MovePtr<tcu::CaseListFilter>	filter		= cmdLine.createCaseListFilter(childCtx.getArchive());
+				tcu::TestSessionExecutor				executor	(root, childCtx, *filter, progress);
+
+				while (executor.iterate());
+			}
+		}
+		catch (...)
+		{
+		}
+
+		_exit(0);
+	}
+#endif
+};
+
+class ResumeSessionCase : public tcu::TestCase
+{
+public:
+	ResumeSessionCase (tcu::TestContext& testCtx)
+		: tcu::TestCase(testCtx, "resume_session", "Check that resumed session skips nodes before last case without initializing them")
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		tcu::CommandLine	cmdLine;
+		const char*			argv[]		= { "deqp" };
+		std::ostringstream	events;
+
+		if (!cmdLine.parse(DE_LENGTH_OF_ARRAY(argv), argv))
+			TCU_THROW(InternalError, "Failed to parse command line");
+
+		{
+			TestLog									log			(TestLog::Buffer);
+			tcu::TestContext						sessionCtx	(m_testCtx.getPlatform(), m_testCtx.getRootArchive(), log, cmdLine, DE_NULL);
+			vector<tcu::TestNode*>					packages;
+			tcu::TestSessionProgress				progress;
+			const de::MovePtr<tcu::CaseListFilter>	filter		= cmdLine.createCaseListFilter(sessionCtx.getArchive());
+
+			packages.push_back(new Package(sessionCtx, "p0", events));
+			packages.push_back(new Package(sessionCtx, "p1", events));
+
+			{
+				tcu::TestPackageRoot root (sessionCtx, packages);
+
+				deStrcpy(&progress.lastCasePath[0], sizeof(progress.lastCasePath), "p1.g1.c");
+
+				{
+					tcu::TestSessionExecutor executor (root, sessionCtx, *filter, progress);
+
+					while (executor.iterate());
+				}
+			}
+
+			events << "last " << progress.lastCasePath;
+		}
+
+		{
+			const string	expected	= "init p1 init g1 run d init g2 run e last p1.g2.e";
+			const bool		isOk		= events.str() == expected;
+
+			m_testCtx.getLog() << TestLog::Message << "Events: " << events.str() << "\n"
+												   << "Expected: " << expected
+							   << TestLog::EndMessage;
+
+			m_testCtx.setTestResult(isOk ? QP_TEST_RESULT_PASS : QP_TEST_RESULT_FAIL, isOk ? "Pass" : "Resumed session visited wrong nodes");
+		}
+
+		return STOP;
+	}
+
+private:
+	class Case : public tcu::TestCase
+	{
+	public:
+		Case (tcu::TestContext& testCtx, const char* name, std::ostream& events)
+			: tcu::TestCase	(testCtx, name, "Case")
+			, m_events		(events)
+		{
+		}
+
+		IterateResult iterate (void)
+		{
+			m_events << "run " << getName() << " ";
+			m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+			return STOP;
+		}
+
+	private:
+		std::ostream&	m_events;
+	};
+
+	class Group : public tcu::TestCaseGroup
+	{
+	public:
+		Group (tcu::TestContext& testCtx, const char* name, const char* const* caseNames, int numCases, std::ostream& events)
+			: tcu::TestCaseGroup	(testCtx, name, "Group")
+			, m_events				(events)
+		{
+			for (int caseNdx = 0; caseNdx < numCases; caseNdx++)
+				addChild(new Case(testCtx, caseNames[caseNdx], events));
+		}
+
+		void init (void)
+		{
+			m_events << "init " << getName() << " ";
+		}
+
+	private:
+		std::ostream&	m_events;
+	};
+
+	class Package : public tcu::TestPackage
+	{
+	public:
+		Package (tcu::TestContext& testCtx, const char* name, std::ostream& events)
+			: tcu::TestPackage	(testCtx, name, "Package")
+			, m_events			(events)
+		{
+		}
+
+		void init (void)
+		{
+			static const char* const	g0Cases[]	= { "a", "b" };
+			static const char* const	g1Cases[]	= { "b", "c", "d" };
+			static const char* const	g2Cases[]	= { "e" };
+
+			m_events << "init " << getName() << " ";
+
+			addChild(new Group(m_testCtx, "g0", g0Cases, DE_LENGTH_OF_ARRAY(g0Cases), m_events));
+			addChild(new Group(m_testCtx, "g1", g1Cases, DE_LENGTH_OF_ARRAY(g1Cases), m_events));
+			addChild(new Group(m_testCtx, "g2", g2Cases, DE_LENGTH_OF_ARRAY(g2Cases), m_events));
+		}
+
+		tcu::TestCaseExecutor* createExecutor (void) const
+		{
+			return new DirectCaseExecutor();
+		}
+
+	private:
+		std::ostream&	m_events;
+	};
+};
+
+class ForkServerCase : public tcu::TestCase
+{
+public:
+	ForkServerCase (tcu::TestContext& testCtx)
+		: tcu::TestCase(testCtx, "fork_server", "Run tcu::App with fork server and check results logged for killed test processes")
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+#if (DE_OS == DE_OS_UNIX)
+		const char* const	logFileName	= "dit-fork-server.qpa";
+		bool				allOk		= true;
+
+		// Killed cases are recorded as crashed and execution resumes after them.
+		allOk = checkRun("dit-fork.crash.*", logFileName,
+						 "dit-fork.crash.g0.c0:Pass dit-fork.crash.g0.c1:Crash dit-fork.crash.g1.c2:Pass dit-fork.crash.g1.c3:Crash dit-fork.crash.g1.c4:Pass ") && allOk;
+
+		// Process killed outside a case would be killed again by a new child, so session is aborted.
+		allOk = checkRun("dit-fork.abort.*", logFileName,
+						 "dit-fork.abort.g0.c0:Pass ") && allOk;
+
+		deDeleteFile(logFileName);
+
+		m_testCtx.setTestResult(allOk ? QP_TEST_RESULT_PASS : QP_TEST_RESULT_FAIL, allOk ? "Pass" : "Unexpected results in fork server log");
+		return STOP;
+#else
+		TCU_THROW(NotSupportedError, "Fork server is not supported on this platform");
+#endif
+	}
+
+private:
+	//! Case that either passes or kills the process it runs in.
+	class Case : public tcu::TestCase
+	{
+	public:
+		Case (tcu::TestContext& testCtx, const char* name, bool killProcess)
+			: tcu::TestCase	(testCtx, name, "Case")
+			, m_killProcess	(killProcess)
+		{
+		}
+
+		IterateResult iterate (void)
+		{
+#if (DE_OS == DE_OS_UNIX)
+			if (m_killProcess)
+				raise(SIGKILL);
+#endif
+			m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+			return STOP;
+		}
+
+	private:
+		const bool m_killProcess;
+	};
+
+	//! Group that kills the process when initialized.
+	class KillGroup : public tcu::TestCaseGroup
+	{
+	public:
+		KillGroup (tcu::TestContext& testCtx, const char* name)
+			: tcu::TestCaseGroup(testCtx, name, "Group")
+		{
+			addChild(new Case(testCtx, "c1", false));
+		}
+
+		void init (void)
+		{
+#if (DE_OS == DE_OS_UNIX)
+			raise(SIGKILL);
+#endif
+		}
+	};
+
+	class Package : public tcu::TestPackage
+	{
+	public:
+		Package (tcu::TestContext& testCtx)
+			: tcu::TestPackage(testCtx, "dit-fork", "Package")
+		{
+		}
+
+		void init (void)
+		{
+			{
+				tcu::TestCaseGroup* const crashGroup	= new tcu::TestCaseGroup(m_testCtx, "crash", "Cases killing test process");
+				tcu::TestCaseGroup* const group0		= new tcu::TestCaseGroup(m_testCtx, "g0", "Group");
+				tcu::TestCaseGroup* const group1		= new tcu::TestCaseGroup(m_testCtx, "g1", "Group");
+
+				group0->addChild(new Case(m_testCtx, "c0", false));
+				group0->addChild(new Case(m_testCtx, "c1", true));
+				group1->addChild(new Case(m_testCtx, "c2", false));
+				group1->addChild(new Case(m_testCtx, "c3", true));
+				group1->addChild(new Case(m_testCtx, "c4", false));
+				crashGroup->addChild(group0);
+				crashGroup->addChild(group1);
+				addChild(crashGroup);
+			}
+
+			{
+				tcu::TestCaseGroup* const abortGroup	= new tcu::TestCaseGroup(m_testCtx, "abort", "Test process killed outside cases");
+				tcu::TestCaseGroup* const group0		= new tcu::TestCaseGroup(m_testCtx, "g0", "Group");
+				tcu::TestCaseGroup* const group2		= new tcu::TestCaseGroup(m_testCtx, "g2", "Group");
+
+				group0->addChild(new Case(m_testCtx, "c0", false));
+				group2->addChild(new Case(m_testCtx, "c2", false));
+				abortGroup->addChild(group0);
+				abortGroup->addChild(new KillGroup(m_testCtx, "g1"));
+				abortGroup->addChild(group2);
+				addChild(abortGroup);
+			}
+		}
+
+		tcu::TestCaseExecutor* createExecutor (void) const
+		{
+			return new DirectCaseExecutor();
+		}
+	};
+
+	static tcu::TestPackage* createPackage (tcu::TestContext& testCtx)
+	{
+		return new Package(testCtx);
+	}
+
+#if (DE_OS == DE_OS_UNIX)
+	bool checkRun (const char* casePattern, const char* logFileName, const char* expected)
+	{
+		const string	casePatternArg	= string("--deqp-case=") + casePattern;
+		const string	logFileArg		= string("--deqp-log-filename=") + logFileName;
+		int				status			= 0;
+		bool			childOk			= false;
+
+		// Package is registered in a child process to keep it out of this process' hierarchy.
+		fflush(DE_NULL);
+
+		{
+			const pid_t pid = fork();
+
+			if (pid == 0)
+				runApp(casePatternArg.c_str(), logFileArg.c_str());
+
+			childOk = pid > 0 && waitpid(pid, &status, 0) == pid;
+		}
+
+		if (!childOk)
+			TCU_THROW(InternalError, "Failed to run child process");
+
+		{
+			const string	results		= readCaseResults(logFileName);
+			const bool		exitOk		= WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+			m_testCtx.getLog() << TestLog::Message << "Cases: " << casePattern << "\n"
+												   << "  App process " << (exitOk ? "completed" : "failed") << "\n"
+												   << "  results:  " << results << "\n"
+												   << "  expected: " << expected
+							   << TestLog::EndMessage;
+
+			return exitOk && results == expected;
+		}
+	}
+
+	//! Runs App with fork server as done by tcuMain.cpp. Doesn't return.
+	void runApp (const char* casePatternArg, const char* logFileArg)
+	{
+		int exitCode = 1;
+
+		try
+		{
+			tcu::CommandLine	cmdLine;
+			const char*			argv[]		= { "deqp", "--deqp-fork-server=enable", casePatternArg, logFileArg };
+
+			tcu::TestPackageRegistry::getSingleton()->registerPackage("dit-fork", createPackage);
+
+			if (cmdLine.parse(DE_LENGTH_OF_ARRAY(argv), argv))
+			{
+				TestLog		log		(cmdLine.getLogFileName(), cmdLine.getLogFlags());
+				tcu::App	app		(m_testCtx.getPlatform(), m_testCtx.getRootArchive(), log, cmdLine);
+
+				while (app.iterate());
+
+				exitCode = 0;
+			}
+		}
+		catch (...)
+		{
+		}
+
+		fflush(DE_NULL);
+		_exit(exitCode);
+	}
+#endif
+
+	//! Get "path:result " for each case result in log, in log order.
+	static string readCaseResults (const char* logFileName)
+	{
+		const string	beginTag		= "#beginTestCaseResult ";
+		const string	terminateTag	= "#terminateTestCaseResult ";
+		const string	resultTag		= "<Result StatusCode=\"";
+		std::ifstream	file			(logFileName);
+		string			line;
+		string			casePath;
+		string			results;
+
+		while (std::getline(file, line))
+		{
+			const size_t resultPos = line.find(resultTag);
+
+			if (line.compare(0, beginTag.size(), beginTag) == 0)
+				casePath = line.substr(beginTag.size());
+			else if (line.compare(0, terminateTag.size(), terminateTag) == 0)
+				results += casePath + ":" + line.substr(terminateTag.size()) + " ";
+			else if (resultPos != string::npos)
+			{
+				const size_t	codeStart	= resultPos + resultTag.size();
+				const size_t	codeEnd		= line.find('"', codeStart);
+
+				results += casePath + ":" + line.substr(codeStart, codeEnd - codeStart) + " ";
+			}
+		}
+
+		return results;
+	}
+};
+
+//! Trivially passing case for building test hierarchies.
+class PassCase : public tcu::TestCase
+{
+public:
+	PassCase (tcu::TestContext& testCtx, const char* name, const char* description)
+		: tcu::TestCase(testCtx, name, description)
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+		return STOP;
+	}
+};
+
+class ShaderLibraryCacheCase : public tcu::TestCase
+{
+public:
+	ShaderLibraryCacheCase (tcu::TestContext& testCtx)
+		: tcu::TestCase(testCtx, "shader_library_cache", "Compare cached and parsed shader library files")
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		const char* const	mainFileName	= "dit-shader-library.test";
+		const char* const	importFileName	= "dit-shader-library-import.test";
+		const tcu::DirArchive	archive		("");
+		const vector<string>	oldEntries	= listCacheEntries();
+		bool				allOk			= true;
+
+		writeFile(mainFileName,
+				  "group basic \"Basic group\"\n"
+				  "	case both_case\n"
+				  "		version 300 es\n"
+				  "		desc \"Both case\"\n"
+				  "		require limit \"GL_MAX_VERTEX_ATOMIC_COUNTERS\" > 4\n"
+				  "		values\n"
+				  "		{\n"
+				  "			input float in0 = [ 1.0 | -2.5 ];\n"
+				  "			output ivec2 out0 = [ ivec2(1, 2) | ivec2(3, 4) ];\n"
+				  "			uniform bool ub = true;\n"
+				  "		}\n"
+				  "		both \"\"\n"
+				  "			#version 300 es\n"
+				  "			${DECLARATIONS}\n"
+				  "			void main() { ${OUTPUT} }\n"
+				  "		\"\"\n"
+				  "	end\n"
+				  "end\n"
+				  "import \"dit-shader-library-import.test\"\n");
+		writeFile(importFileName, getImportFile("vertex"));
+
+		try
+		{
+			const string parsed = parse(archive, mainFileName, DE_NULL);
+
+			m_testCtx.getLog() << TestLog::Message << "Parsed:\n" << parsed << TestLog::EndMessage;
+
+			// First cached parse stores the entry, second one loads it
+			allOk = check(parse(archive, mainFileName, "."), parsed, "cache miss") && allOk;
+			allOk = check(parse(archive, mainFileName, "."), parsed, "cache hit") && allOk;
+
+			// Modify entry in place to make sure it is actually used
+			{
+				const vector<string> newEntries = getNewEntries(oldEntries);
+
+				if (newEntries.size() == 1)
+				{
+					vector<deUint8>	data;
+					string			contents;
+
+					readFile(newEntries[0].c_str(), data);
+					contents.assign(data.begin(), data.end());
+
+					writeFile(newEntries[0].c_str(), replaceAll(contents, "Both case", "Both CASE"));
+					allOk = check(parse(archive, mainFileName, "."), replaceAll(parsed, "Both case", "Both CASE"), "modified entry") && allOk;
+
+					// Garbage entry is ignored and replaced
+					writeFile(newEntries[0].c_str(), contents.substr(0, contents.size()/2));
+					allOk = check(parse(archive, mainFileName, "."), parsed, "truncated entry") && allOk;
+					allOk = check(parse(archive, mainFileName, "."), parsed, "rewritten entry") && allOk;
+				}
+				else
+				{
+					m_testCtx.getLog() << TestLog::Message << "ERROR: Expected one new cache entry, got " << newEntries.size() << TestLog::EndMessage;
+					allOk = false;
+				}
+			}
+
+			// Change in imported file must invalidate entry
+			writeFile(importFileName, getImportFile("fragment"));
+			{
+				const string reparsed = parse(archive, mainFileName, DE_NULL);
+
+				allOk = (reparsed != parsed) && allOk;
+				allOk = check(parse(archive, mainFileName, "."), reparsed, "modified import") && allOk;
+			}
+		}
+		catch (...)
+		{
+			cleanup(mainFileName, importFileName, oldEntries);
+			throw;
+		}
+
+		cleanup(mainFileName, importFileName, oldEntries);
+
+		m_testCtx.setTestResult(allOk ? QP_TEST_RESULT_PASS : QP_TEST_RESULT_FAIL, allOk ? "Pass" : "Cached result differs");
+		return STOP;
+	}
+
+private:
+	class DescribingFactory : public glu::sl::ShaderCaseFactory
+	{
+	public:
+		DescribingFactory (tcu::TestContext& testCtx, std::ostringstream& str)
+			: m_testCtx	(testCtx)
+			, m_str		(str)
+		{
+		}
+
+		tcu::TestCaseGroup* createGroup (const string& name, const string& description, const vector<tcu::TestNode*>& children)
+		{
+			m_str << "group " << name << " \"" << description << "\" " << children.size() << "\n";
+			return new tcu::TestCaseGroup(m_testCtx, name.c_str(), description.c_str(), children);
+		}
+
+		tcu::TestCase* createCase (const string& name, const string& description, const glu::sl::ShaderCaseSpecification& spec)
+		{
+			m_str << "case " << name << " \"" << description << "\" type=" << spec.caseType << " expect=" << spec.expectResult
+				  << " version=" << glu::getGLSLVersionName(spec.targetVersion) << " fullES100=" << spec.fullGLSLES100Required << "\n";
+
+			for (size_t capNdx = 0; capNdx < spec.requiredCaps.size(); capNdx++)
+				m_str << "  cap " << tcu::toHex(spec.requiredCaps[capNdx].enumName) << " > " << spec.requiredCaps[capNdx].referenceValue << "\n";
+
+			describeValues(spec.values.inputs, "input");
+			describeValues(spec.values.outputs, "output");
+			describeValues(spec.values.uniforms, "uniform");
+
+			for (size_t programNdx = 0; programNdx < spec.programs.size(); programNdx++)
+			{
+				const glu::sl::ProgramSpecification& program = spec.programs[programNdx];
+
+				m_str << "  program separable=" << program.sources.separable << " stages=" << program.activeStages << "\n";
+
+				for (int shaderType = 0; shaderType < glu::SHADERTYPE_LAST; shaderType++)
+				{
+					for (size_t sourceNdx = 0; sourceNdx < program.sources.sources[shaderType].size(); sourceNdx++)
+						m_str << "    " << glu::getShaderTypeName((glu::ShaderType)shaderType) << ": " << program.sources.sources[shaderType][sourceNdx] << "\n";
+				}
+
+				for (size_t extNdx = 0; extNdx < program.requiredExtensions.size(); extNdx++)
+				{
+					m_str << "    extension stages=" << program.requiredExtensions[extNdx].effectiveStages;
+					for (size_t altNdx = 0; altNdx < program.requiredExtensions[extNdx].alternatives.size(); altNdx++)
+						m_str << " " << program.requiredExtensions[extNdx].alternatives[altNdx];
+					m_str << "\n";
+				}
+			}
+
+			return new PassCase(m_testCtx, name.c_str(), description.c_str());
+		}
+
+	private:
+		void describeValues (const vector<glu::sl::Value>& values, const char* storage)
+		{
+			for (size_t valueNdx = 0; valueNdx < values.size(); valueNdx++)
+			{
+				m_str << "  " << storage << " " << glu::getDataTypeName(values[valueNdx].type.getBasicType()) << " " << values[valueNdx].name << " =";
+				for (size_t elemNdx = 0; elemNdx < values[valueNdx].elements.size(); elemNdx++)
+					m_str << " " << tcu::toHex(values[valueNdx].elements[elemNdx].int32);
+				m_str << "\n";
+			}
+		}
+
+		tcu::TestContext&	m_testCtx;
+		std::ostringstream&	m_str;
+	};
+
+	string parse (const tcu::Archive& archive, const char* fileName, const char* cacheDir)
+	{
+		std::ostringstream				str;
+		DescribingFactory				factory		(m_testCtx, str);
+		const vector<tcu::TestNode*>	nodes		= glu::sl::parseFile(archive, fileName, &factory, cacheDir);
+
+		for (size_t nodeNdx = 0; nodeNdx < nodes.size(); nodeNdx++)
+		{
+			str << "top-level " << nodes[nodeNdx]->getName() << "\n";
+			delete nodes[nodeNdx];
+		}
+
+		return str.str();
+	}
+
+	bool check (const string& result, const string& expected, const char* what)
+	{
+		if (result == expected)
+			return true;
+
+		m_testCtx.getLog() << TestLog::Message << "ERROR: Result differs (" << what << "):\n" << result << TestLog::EndMessage;
+		return false;
+	}
+
+	static string replaceAll (string str, const string& from, const string& to)
+	{
+		for (size_t pos = str.find(from); pos != string::npos; pos = str.find(from, pos + to.size()))
+			str.replace(pos, from.size(), to);
+
+		return str;
+	}
+
+	static string getImportFile (const char* stage)
+	{
+		return string("case imported\n"
+					  "	version 310 es\n"
+					  "	desc \"Imported case\"\n"
+					  "	expect compile_fail\n"
+					  "	require extension { \"GL_EXT_a\" | \"GL_EXT_b\" } in { ") + stage + " }\n"
+					  "	vertex \"\"\n"
+					  "		#version 310 es\n"
+					  "		void main() {}\n"
+					  "	\"\"\n"
+					  "	fragment \"\"\n"
+					  "		#version 310 es\n"
+					  "		void main() {}\n"
+					  "	\"\"\n"
+					  "end\n";
+	}
+
+	static vector<string> listCacheEntries (void)
+	{
+		vector<string> entries;
+
+		for (de::DirectoryIterator iter (de::FilePath(".")); iter.hasItem(); iter.next())
+		{
+			const string path = iter.getItem().getPath();
+
+			if (de::endsWith(path, ".slc"))
+				entries.push_back(path);
+		}
+
+		return entries;
+	}
+
+	static vector<string> getNewEntries (const vector<string>& oldEntries)
+	{
+		const vector<string>	entries		= listCacheEntries();
+		vector<string>			newEntries;
+
+		for (size_t entryNdx = 0; entryNdx < entries.size(); entryNdx++)
+		{
+			if (std::find(oldEntries.begin(), oldEntries.end(), entries[entryNdx]) == oldEntries.end())
+				newEntries.push_back(entries[entryNdx]);
+		}
+
+		return newEntries;
+	}
+
+	static void cleanup (const char* mainFileName, const char* importFileName, const vector<string>& oldEntries)
+	{
+		const vector<string> newEntries = getNewEntries(oldEntries);
+
+		for (size_t entryNdx = 0; entryNdx < newEntries.size(); entryNdx++)
+			deDeleteFile(newEntries[entryNdx].c_str());
+
+		deDeleteFile(mainFileName);
+		deDeleteFile(importFileName);
+	}
+
+	static void writeFile (const char* fileName, const string& contents)
+	{
+		std::ofstream file (fileName, std::ios_base::binary);
+
+		file << contents;
+	}
+
+	static void readFile (const char* fileName, vector<deUint8>& dst)
+	{
+		std::ifstream file (fileName, std::ios_base::binary);
+
+		dst.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+};
+
+class CommonFrameworkTests : public tcu::TestCaseGroup
+{
+public:
+	CommonFrameworkTests (tcu::TestContext& testCtx)
+		: tcu::TestCaseGroup(testCtx, "common", "Tests for the common utility framework")
+	{
+	}
+
+	void init (void)
+	{
+		addChild(new SelfCheckCase(m_testCtx, "float_format","tcu::FloatFormat_selfTest()",
+								   tcu::FloatFormat_selfTest));
+		addChild(new SelfCheckCase(m_testCtx, "either","tcu::Either_selfTest()",
+								   tcu::Either_selfTest));
+		addChild(new SelfCheckCase(m_testCtx, "image_compare","tcu::ImageCompare_selfTest()",
+								   tcu::ImageCompare_selfTest));
+		addChild(new SelfCheckCase(m_testCtx, "parallel_rows","tcu::ParallelRows_selfTest()",
+								   tcu::ParallelRows_selfTest));
+		addChild(new SelfCheckCase(m_testCtx, "tex_lookup_verifier","tcu::TexLookupVerifier_selfTest()",
+								   tcu::TexLookupVerifier_selfTest));
+		addChild(new AsyncImageLogCase(m_testCtx));
+		addChild(new BufferLogCase(m_testCtx));
+		addChild(new HierarchyIndexCase(m_testCtx));
+		addChild(new SharedProgressCrashCase(m_testCtx));
+		addChild(new ResumeSessionCase(m_testCtx));
+		addChild(new ForkServerCase(m_testCtx));
+		addChild(new ShaderLibraryCacheCase(m_testCtx));
+	}
+};
+
+class ReferenceRendererTests : public tcu::TestCaseGroup
+{
+public:
+	ReferenceRendererTests (tcu::TestContext& testCtx)
+		: tcu::TestCaseGroup(testCtx, "reference_renderer", "Reference renderer tests")
+	{
+	}
+
+	void init (void)
+	{
+		addChild(new SelfCheckCase(m_testCtx, "triangle_rasterizer","rr::TriangleRasterizer_selfTest()",
+								   rr::TriangleRasterizer_selfTest));
+		addChild(new ConstantInterpolationTest(m_testCtx));
+
+		{
+			static const struct
+			{
+				const char*			name;
+				rr::PrimitiveType	primitiveType;
+			} primitiveTypes[] =
+			{
+				{ "triangles",	rr::PRIMITIVETYPE_TRIANGLES	},
+				{ "lines",		rr::PRIMITIVETYPE_LINES		},
+				{ "points",		rr::PRIMITIVETYPE_POINTS	},
+			};
+			static const int	sampleCounts[]	= { 1, 4 };
+			static const int	tileSizes[]		= { 16, 13 };
+
+			for (int primNdx = 0; primNdx < DE_LENGTH_OF_ARRAY(primitiveTypes); primNdx++)
+			for (int samplesNdx = 0; samplesNdx < DE_LENGTH_OF_ARRAY(sampleCounts); samplesNdx++)
+			for (int tileNdx = 0; tileNdx < DE_LENGTH_OF_ARRAY(tileSizes); tileNdx++)
+			{
+				const string name = string("tiled_") + primitiveTypes[primNdx].name + "_samples" + de::toString(sampleCounts[samplesNdx]) + "_tile" + de::toString(tileSizes[tileNdx]);
+				addChild(new TiledRasterizationTest(m_testCtx, name.c_str(), primitiveTypes[primNdx].primitiveType, sampleCounts[samplesNdx], tileSizes[tileNdx]));
+			}
+		}
 	}
 };
 
@@ -40,6 +40,11 @@ public:
 	{
 	}
 
+	bool isContextFree (void) const
+	{
+		return true;
+	}
+
 	IterateResult iterate (void)
 	{
 		m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
@@ -33,6 +33,7 @@
 #include "deArrayUtil.hpp"
 #include "deStringUtil.hpp"
 #include "deUniquePtr.hpp"
+#include "deMemory.h"
 
 #include <sstream>
 
@@ -52,7 +53,10 @@ using tcu::TextureAccessType;
 using tcu::PixelBufferAccess;
 using tcu::ConstPixelBufferAccess;
 using tcu::Vector;
+using tcu::Vec4;
 using tcu::IVec3;
+using tcu::IVec4;
+using tcu::UVec4;
 
 // Test data
 
@@ -1206,6 +1210,53 @@ void copyPixels (const ConstPixelBufferAccess& src, const PixelBufferAccess& dst
 		dst.setPixel(src.getPixelT<T>(ndx, 0, 0), ndx, 0, 0);
 }
 
+template<typename T>
+void getPixelSpan (const ConstPixelBufferAccess& src, vector<Vector<T, 4> >& dst);
+
+template<>
+void getPixelSpan<float> (const ConstPixelBufferAccess& src, vector<Vec4>& dst)
+{
+	dst.resize(src.getWidth());
+	src.getPixels(&dst[0], src.getWidth(), 0, 0, 0);
+}
+
+template<>
+void getPixelSpan<deInt32> (const ConstPixelBufferAccess& src, vector<IVec4>& dst)
+{
+	dst.resize(src.getWidth());
+	src.getPixelsInt(&dst[0], src.getWidth(), 0, 0, 0);
+}
+
+template<>
+void getPixelSpan<deUint32> (const ConstPixelBufferAccess& src, vector<UVec4>& dst)
+{
+	vector<IVec4> tmp (src.getWidth());
+
+	src.getPixelsInt(&tmp[0], src.getWidth(), 0, 0, 0);
+
+	dst.resize(src.getWidth());
+	for (int ndx = 0; ndx < src.getWidth(); ndx++)
+		dst[ndx] = tmp[ndx].cast<deUint32>();
+}
+
+void copyPixelSpans (const ConstPixelBufferAccess& src, const PixelBufferAccess& dst)
+{
+	const tcu::TextureChannelClass chnClass = getTextureChannelClass(dst.getFormat().type);
+
+	if (chnClass == tcu::TEXTURECHANNELCLASS_SIGNED_INTEGER || chnClass == tcu::TEXTURECHANNELCLASS_UNSIGNED_INTEGER)
+	{
+		vector<IVec4> tmp (src.getWidth());
+		src.getPixelsInt(&tmp[0], src.getWidth(), 0, 0, 0);
+		dst.setPixels(&tmp[0], src.getWidth(), 0, 0, 0);
+	}
+	else
+	{
+		vector<Vec4> tmp (src.getWidth());
+		src.getPixels(&tmp[0], src.getWidth(), 0, 0, 0);
+		dst.setPixels(&tmp[0], src.getWidth(), 0, 0, 0);
+	}
+}
+
 void copyGetSetDepth (const ConstPixelBufferAccess& src, const PixelBufferAccess& dst)
 {
 	for (int ndx = 0; ndx < src.getWidth(); ndx++)
@@ -1298,6 +1349,7 @@ protected:
 	{
 		const int				numPixels	= src.getWidth();
 		vector<Vector<T, 4> >	res			(numPixels);
+		vector<Vector<T, 4> >	spanRes;
 		vector<Vector<T, 4> >	ref;
 
 		m_testCtx.getLog()
@@ -1306,6 +1358,8 @@ protected:
 		for (int ndx = 0; ndx < numPixels; ndx++)
 			res[ndx] = src.getPixelT<T>(ndx, 0, 0);
 
+		getPixelSpan<T>(src, spanRes);
+
 		// \note m_format != src.getFormat() for DS formats, and we specifically need to
 		//		 use the combined format as storage format to get right reference values.
 		getReferenceValues<T>(m_format, src.getFormat(), ref);
@@ -1319,6 +1373,14 @@ protected:
 
 				m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Comparison failed");
 			}
+
+			if (!allComponentsEqual(spanRes[pixelNdx], ref[pixelNdx]))
+			{
+				m_testCtx.getLog()
+					<< TestLog::Message << "ERROR: at pixel " << pixelNdx << ": expected " << ref[pixelNdx] << ", got " << spanRes[pixelNdx] << " from span read" << TestLog::EndMessage;
+
+				m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Comparison failed");
+			}
 		}
 	}
 
@@ -1424,6 +1486,11 @@ public:
 			m_testCtx.getLog() << TestLog::Message << "Copying with getPixel() -> setPixel()" << TestLog::EndMessage;
 			copyPixels(inputAccess, tmpAccess);
 			verifyRead(tmpAccess);
+
+			m_testCtx.getLog() << TestLog::Message << "Copying with getPixels() -> setPixels()" << TestLog::EndMessage;
+			deMemset(&tmpMem[0], 0, tmpMem.size());
+			copyPixelSpans(inputAccess, tmpAccess);
+			verifyRead(tmpAccess);
 		}
 
 		return STOP;
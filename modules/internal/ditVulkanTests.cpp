@@ -25,17 +25,150 @@
 #include "ditTestCase.hpp"
 
 #include "vkImageUtil.hpp"
+#include "vkProgramBinaryCache.hpp"
+#include "vkMemUtil.hpp"
+#include "vkNullDriver.hpp"
+#include "vkPlatform.hpp"
+#include "vkDeviceUtil.hpp"
+#include "vkQueryUtil.hpp"
+#include "vkRefUtil.hpp"
 
 #include "deUniquePtr.hpp"
+#include "deSharedPtr.hpp"
+#include "deRandom.hpp"
+
+#include <vector>
 
 namespace dit
 {
 
+namespace
+{
+
+using de::MovePtr;
+using std::vector;
+
+struct TestAllocation
+{
+	de::SharedPtr<vk::Allocation>	allocation;
+	vk::VkDeviceSize				size;
+	deUint8							pattern;
+};
+
+bool isPatternIntact (const TestAllocation& alloc)
+{
+	const deUint8* const ptr = (const deUint8*)alloc.allocation->getHostPtr();
+
+	for (vk::VkDeviceSize ndx = 0; ndx < alloc.size; ndx++)
+	{
+		if (ptr[ndx] != alloc.pattern)
+			return false;
+	}
+
+	return true;
+}
+
+void subAllocatorSelfTest (void)
+{
+	const vk::VkDeviceSize							blockSize		= 64*1024;
+	const vk::VkDeviceSize							minSize			= 256;
+	const de::UniquePtr<vk::Library>				library			(vk::createNullDriver());
+	const vk::PlatformInterface&					vkp				= library->getPlatformInterface();
+	const vk::Unique<vk::VkInstance>				instance		(vk::createDefaultInstance(vkp));
+	const vk::InstanceDriver						vki				(vkp, *instance);
+	const vk::VkPhysicalDevice						physicalDevice	= vk::enumeratePhysicalDevices(vki, *instance)[0];
+	const vk::VkPhysicalDeviceMemoryProperties		memProps		= vk::getPhysicalDeviceMemoryProperties(vki, physicalDevice);
+	const float										queuePriority	= 1.0f;
+	vk::VkDeviceQueueCreateInfo						queueInfo;
+	vk::VkDeviceCreateInfo							deviceInfo;
+
+	deMemset(&queueInfo,	0, sizeof(queueInfo));
+	deMemset(&deviceInfo,	0, sizeof(deviceInfo));
+
+	queueInfo.sType							= vk::VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+	queueInfo.queueCount					= 1u;
+	queueInfo.pQueuePriorities				= &queuePriority;
+
+	deviceInfo.sType						= vk::VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	deviceInfo.queueCreateInfoCount			= 1u;
+	deviceInfo.pQueueCreateInfos			= &queueInfo;
+
+	const vk::Unique<vk::VkDevice>					device			(vk::createDevice(vki, physicalDevice, &deviceInfo));
+	const vk::DeviceDriver							vkd				(vki, *device);
+	vk::SubAllocator								allocator		(vkd, *device, memProps, blockSize, minSize);
+	de::Random										rnd				(0x51ab);
+	vector<TestAllocation>							allocations;
+
+	for (int iterNdx = 0; iterNdx < 500; iterNdx++)
+	{
+		if (allocations.empty() || rnd.getFloat() < 0.6f)
+		{
+			const vk::VkMemoryRequirements	memReqs		=
+			{
+				(vk::VkDeviceSize)(rnd.getFloat() < 0.05f ? rnd.getInt(1, 3) * blockSize : rnd.getInt(1, 6000)),
+				(vk::VkDeviceSize)(1u << rnd.getInt(0, 12)),
+				1u
+			};
+			TestAllocation					alloc;
+
+			alloc.allocation	= de::SharedPtr<vk::Allocation>(allocator.allocate(memReqs, vk::MemoryRequirement::HostVisible).release());
+			alloc.size			= memReqs.size;
+			alloc.pattern		= (deUint8)iterNdx;
+
+			DE_TEST_ASSERT(alloc.allocation->getOffset() % memReqs.alignment == 0);
+			DE_TEST_ASSERT(memReqs.size > blockSize || alloc.allocation->getOffset() + memReqs.size <= blockSize);
+
+			deMemset(alloc.allocation->getHostPtr(), alloc.pattern, (size_t)alloc.size);
+			allocations.push_back(alloc);
+		}
+		else
+		{
+			const size_t ndx = (size_t)rnd.getInt(0, (int)allocations.size()-1);
+
+			// Overlapping allocations would have overwritten pattern.
+			DE_TEST_ASSERT(isPatternIntact(allocations[ndx]));
+
+			allocations.erase(allocations.begin() + ndx);
+		}
+
+		{
+			const vk::SubAllocator::Statistics	stats			= allocator.getStatistics();
+			deUint32							numDedicated	= 0;
+
+			for (size_t ndx = 0; ndx < allocations.size(); ndx++)
+				numDedicated += allocations[ndx].size > blockSize ? 1u : 0u;
+
+			DE_TEST_ASSERT(stats.numDedicatedAllocations == numDedicated);
+			DE_TEST_ASSERT(stats.numSubAllocations == (deUint32)allocations.size() - numDedicated);
+			DE_TEST_ASSERT(stats.reservedBytes >= stats.requestedBytes && stats.reservedBytes <= stats.blockBytes);
+			DE_TEST_ASSERT(stats.largestFreeRange <= stats.blockBytes - stats.reservedBytes);
+			DE_TEST_ASSERT(de::inRange(stats.getExternalFragmentation(), 0.0f, 1.0f));
+		}
+	}
+
+	for (size_t ndx = 0; ndx < allocations.size(); ndx++)
+		DE_TEST_ASSERT(isPatternIntact(allocations[ndx]));
+
+	allocations.clear();
+
+	// All ranges must have merged back, leaving one whole cached block.
+	{
+		const vk::SubAllocator::Statistics stats = allocator.getStatistics();
+
+		DE_TEST_ASSERT(stats.numSubAllocations == 0 && stats.numDedicatedAllocations == 0);
+		DE_TEST_ASSERT(stats.numBlocks == 1u && stats.largestFreeRange == blockSize);
+	}
+}
+
+} // anonymous
+
 tcu::TestCaseGroup* createVulkanTests (tcu::TestContext& testCtx)
 {
 	de::MovePtr<tcu::TestCaseGroup>	group	(new tcu::TestCaseGroup(testCtx, "vulkan", "Vulkan Framework Tests"));
 
 	group->addChild(new SelfCheckCase(testCtx, "image_util", "ImageUtil self-check tests", vk::imageUtilSelfTest));
+	group->addChild(new SelfCheckCase(testCtx, "program_binary_cache", "ProgramBinaryCache self-check tests", vk::programBinaryCacheSelfTest));
+	group->addChild(new SelfCheckCase(testCtx, "sub_allocator", "SubAllocator tests using null driver", subAllocatorSelfTest));
 
 	return group.release();
 }